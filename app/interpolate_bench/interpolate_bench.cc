@@ -0,0 +1,242 @@
+/*
+This file is part of the Ristra portage project.
+Please see the license file at the root of this repository, or at:
+    https://github.com/laristra/portage/blob/master/LICENSE
+*/
+
+#include <vector>
+#include <string>
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <chrono>
+#include <memory>
+#include <limits>
+#include <algorithm>
+
+#ifdef PORTAGE_ENABLE_MPI
+#include <mpi.h>
+#else
+#define PORTAGE_SERIAL_ONLY
+#endif
+
+// portage includes
+#include "portage/support/portage.h"
+#include "portage/driver/coredriver.h"
+#include "portage/search/search_kdtree.h"
+#include "portage/intersect/intersect_r2d.h"
+#include "portage/interpolate/interpolate_1st_order.h"
+#include "portage/interpolate/interpolate_2nd_order.h"
+#include "portage/interpolate/interpolate_3rd_order.h"
+
+// wonton includes
+#include "wonton/mesh/simple/simple_mesh.h"
+#include "wonton/mesh/simple/simple_mesh_wrapper.h"
+#include "wonton/state/simple/simple_state.h"
+#include "wonton/state/simple/simple_state_wrapper.h"
+
+/*
+  Times the interpolate phase of a 2D cell remap on its own.
+
+  Search and intersection are done once; then the 1st, 2nd and 3rd
+  order interpolators are applied to all target cells several times. The
+  interpolate phase only streams through the intersection moments and
+  reads the source values (and gradients), so it should run close to
+  the memory bandwidth of the machine. To check this, the app reports
+  the effective bandwidth of each interpolator (bytes of moments and
+  field data touched per second) next to that of a simple triad over
+  arrays of the same total size.
+*/
+
+using Wonton::Simple_Mesh;
+using Wonton::Simple_State;
+using Wonton::Simple_Mesh_Wrapper;
+using Wonton::Simple_State_Wrapper;
+using Wonton::Entity_kind;
+using Wonton::Point;
+
+namespace timer {
+  using time_t = std::chrono::high_resolution_clock::time_point;
+
+  inline time_t now() { return std::chrono::high_resolution_clock::now(); }
+
+  // elapsed time in seconds
+  inline double elapsed(time_t const& tic) {
+    return std::chrono::duration<double>(now() - tic).count();
+  }
+}
+
+void usage() {
+  std::cout << "Usage: interpolate_bench nsourcecells ntargetcells [nrepeat]"
+            << std::endl;
+  std::cout << "  nsourcecells  cells per side of the source mesh" << std::endl;
+  std::cout << "  ntargetcells  cells per side of the target mesh" << std::endl;
+  std::cout << "  nrepeat       number of timed passes (default 10)" << std::endl;
+}
+
+// Best time of nrepeat passes of an interpolator over all target cells
+template <class Interpolator>
+double time_interpolate(Interpolator const& interpolator,
+                        Portage::vector<std::vector<Portage::Weights_t>> const& sources_and_weights,
+                        std::vector<double>& target_vals, int nrepeat) {
+  int const ntarget = target_vals.size();
+  double best = std::numeric_limits<double>::max();
+  for (int r = 0; r < nrepeat; r++) {
+    auto tic = timer::now();
+    Portage::transform(Portage::make_counting_iterator(0),
+                       Portage::make_counting_iterator(ntarget),
+                       sources_and_weights.begin(), target_vals.begin(),
+                       interpolator);
+    best = std::min(best, timer::elapsed(tic));
+  }
+  return best;
+}
+
+int main(int argc, char** argv) {
+  if (argc <= 2) {
+    usage();
+    return 0;
+  }
+
+  int const n_source = atoi(argv[1]);
+  int const n_target = atoi(argv[2]);
+  int const nrepeat = (argc > 3) ? atoi(argv[3]) : 10;
+
+  // Even though Simple_Mesh is serial only, we still need to initialize MPI
+  // for other Portage code.
+
+#ifdef PORTAGE_ENABLE_MPI
+  int mpi_init_flag;
+  MPI_Initialized(&mpi_init_flag);
+  if (!mpi_init_flag)
+    MPI_Init(&argc, &argv);
+  int numpe;
+  MPI_Comm_size(MPI_COMM_WORLD, &numpe);
+  if (numpe > 1) {
+    std::cerr << "Simple Mesh is only designed for a single process!"
+              << std::endl;
+    return 1;
+  }
+#endif
+
+  auto source_mesh = std::make_shared<Simple_Mesh>(0.0, 0.0, 1.0, 1.0,
+                                                   n_source, n_source);
+  auto target_mesh = std::make_shared<Simple_Mesh>(0.0, 0.0, 1.0, 1.0,
+                                                   n_target, n_target);
+  Simple_Mesh_Wrapper source_mesh_wrapper(*source_mesh);
+  Simple_Mesh_Wrapper target_mesh_wrapper(*target_mesh);
+
+  int const nsource = source_mesh_wrapper.num_owned_cells();
+  int const ntarget = target_mesh_wrapper.num_owned_cells();
+
+  // Quadratic field so that the 2nd order interpolator does real work
+  std::vector<double> source_data(nsource);
+  for (int c = 0; c < nsource; c++) {
+    Point<2> cen;
+    source_mesh_wrapper.cell_centroid(c, &cen);
+    source_data[c] = cen[0]*cen[0] + 2*cen[1];
+  }
+  std::vector<double> target_data(ntarget, 0.0);
+
+  Simple_State source_state(source_mesh);
+  Simple_State target_state(target_mesh);
+  source_state.add("density", Entity_kind::CELL, &(source_data[0]));
+  target_state.add("density", Entity_kind::CELL, &(target_data[0]));
+  Simple_State_Wrapper source_state_wrapper(source_state);
+  Simple_State_Wrapper target_state_wrapper(target_state);
+
+  Portage::CoreDriver<2, Entity_kind::CELL,
+                      Simple_Mesh_Wrapper, Simple_State_Wrapper>
+      d(source_mesh_wrapper, source_state_wrapper,
+        target_mesh_wrapper, target_state_wrapper);
+
+  auto candidates = d.search<Portage::SearchKDTree>();
+  auto sources_and_weights = d.intersect_meshes<Portage::IntersectR2D>(candidates);
+
+  // Bytes that any interpolation of this remap has to touch: the
+  // moments and source indices, one source value per intersection and
+  // one target value per target cell
+  size_t npairs = 0, nmoments = 0;
+  for (int c = 0; c < ntarget; c++) {
+    std::vector<Portage::Weights_t> const& wts = sources_and_weights[c];
+    npairs += wts.size();
+    for (auto const& wt : wts)
+      nmoments += wt.weights.size();
+  }
+  double const bytes_1st = npairs*(sizeof(Portage::Weights_t) + sizeof(double))
+      + nmoments*sizeof(double) + ntarget*sizeof(double);
+  double const bytes_2nd = bytes_1st + npairs*sizeof(Wonton::Vector<2>);
+  double const bytes_3rd = bytes_1st + npairs*(sizeof(Wonton::Vector<5>) +
+                                               sizeof(Point<2>));
+
+  Portage::NumericTolerances_t num_tols;
+  num_tols.use_default();
+
+  std::vector<double> target_vals(ntarget);
+
+  Portage::Interpolate_1stOrder<2, Entity_kind::CELL,
+                                Simple_Mesh_Wrapper, Simple_Mesh_Wrapper,
+                                Simple_State_Wrapper>
+      interpolator1(source_mesh_wrapper, target_mesh_wrapper,
+                    source_state_wrapper, num_tols);
+  interpolator1.set_interpolation_variable("density");
+  double const time_1st = time_interpolate(interpolator1, sources_and_weights,
+                                           target_vals, nrepeat);
+
+  Portage::Interpolate_2ndOrder<2, Entity_kind::CELL,
+                                Simple_Mesh_Wrapper, Simple_Mesh_Wrapper,
+                                Simple_State_Wrapper>
+      interpolator2(source_mesh_wrapper, target_mesh_wrapper,
+                    source_state_wrapper, num_tols);
+  auto tic = timer::now();
+  interpolator2.set_interpolation_variable("density", Portage::BARTH_JESPERSEN);
+  double const time_gradients = timer::elapsed(tic);
+  double const time_2nd = time_interpolate(interpolator2, sources_and_weights,
+                                           target_vals, nrepeat);
+
+  Portage::Interpolate_3rdOrder<2, Entity_kind::CELL,
+                                Simple_Mesh_Wrapper, Simple_Mesh_Wrapper,
+                                Simple_State_Wrapper>
+      interpolator3(source_mesh_wrapper, target_mesh_wrapper,
+                    source_state_wrapper, num_tols);
+  tic = timer::now();
+  interpolator3.set_interpolation_variable("density");
+  double const time_quadfits = timer::elapsed(tic);
+  double const time_3rd = time_interpolate(interpolator3, sources_and_weights,
+                                           target_vals, nrepeat);
+
+  // Reference bandwidth: a = b + s*c over arrays as large as the
+  // data touched by the 1st order interpolator
+  size_t const nstream = std::max(size_t(1), size_t(bytes_1st/(3*sizeof(double))));
+  std::vector<double> a(nstream, 0.0), b(nstream, 1.0), c(nstream, 2.0);
+  double time_triad = std::numeric_limits<double>::max();
+  for (int r = 0; r < nrepeat; r++) {
+    tic = timer::now();
+    Portage::for_each(Portage::make_counting_iterator(0),
+                      Portage::make_counting_iterator(static_cast<int>(nstream)),
+                      [&](int i) { a[i] = b[i] + 0.5*c[i]; });
+    time_triad = std::min(time_triad, timer::elapsed(tic));
+  }
+  double const bytes_triad = 3.0*nstream*sizeof(double);
+
+  auto const GB = [](double bytes, double secs) { return bytes/secs*1.0e-9; };
+
+  std::printf("source cells %d, target cells %d, intersections %zu\n",
+              nsource, ntarget, npairs);
+  std::printf("  1st order interpolate  %10.6f s  %8.3f GB/s\n",
+              time_1st, GB(bytes_1st, time_1st));
+  std::printf("  2nd order gradients    %10.6f s\n", time_gradients);
+  std::printf("  2nd order interpolate  %10.6f s  %8.3f GB/s\n",
+              time_2nd, GB(bytes_2nd, time_2nd));
+  std::printf("  3rd order quadfits     %10.6f s\n", time_quadfits);
+  std::printf("  3rd order interpolate  %10.6f s  %8.3f GB/s\n",
+              time_3rd, GB(bytes_3rd, time_3rd));
+  std::printf("  triad reference        %10.6f s  %8.3f GB/s\n",
+              time_triad, GB(bytes_triad, time_triad));
+
+#ifdef PORTAGE_ENABLE_MPI
+  MPI_Finalize();
+#endif
+
+  return 0;
+}
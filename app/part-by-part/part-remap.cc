@@ -579,18 +579,17 @@ void remap<2>(std::string field, int nb_parts,
   auto candidates = remapper.search<Portage::SearchKDTree>();
   auto weights = remapper.intersect_meshes<Portage::IntersectR2D>(candidates);
 
-  for (int i = 0; i < nb_parts; ++i) {
-    // compute volumes of intersection and test for parts boundaries mismatch.
-    parts_manager[i].check_mismatch(weights);
-
-    // interpolate field for each part and fix partially filled or empty cells.
-    remapper.interpolate_mesh_var<double, Portage::Interpolate_1stOrder>(
-      field, field, weights, lower_bound, upper_bound,
-      params.limiter, params.bnd_limiter, params.partial_fixup,
-      params.empty_fixup, params.tolerance,
-      params.fix_iter, &(parts_manager[i])
-    );
-  }
+  // compute volumes of intersection and test for parts boundaries mismatch.
+  for (auto&& part : parts_manager)
+    part.check_mismatch(weights);
+
+  // interpolate field on all parts, concurrently when their target cells
+  // are disjoint, and fix partially filled or empty cells.
+  remapper.interpolate_mesh_var<double, Portage::Interpolate_1stOrder>(
+    field, field, parts_manager, lower_bound, upper_bound,
+    params.limiter, params.bnd_limiter, params.partial_fixup,
+    params.empty_fixup, params.tolerance, params.fix_iter
+  );
 }
 
 /**
@@ -645,18 +644,17 @@ void remap<3>(std::string field, int nb_parts,
   auto candidates = remapper.search<Portage::SearchKDTree>();
   auto weights = remapper.intersect_meshes<Portage::IntersectR3D>(candidates);
 
-  for (int i = 0; i < nb_parts; ++i) {
-    // compute volumes of intersection and test for parts boundaries mismatch.
-    parts_manager[i].check_mismatch(weights);
-
-    // interpolate field for each part and fix partially filled or empty cells.
-    remapper.interpolate_mesh_var<double, Portage::Interpolate_1stOrder>(
-      field, field, weights, lower_bound, upper_bound,
-      params.limiter, params.bnd_limiter, params.partial_fixup,
-      params.empty_fixup, params.tolerance,
-      params.fix_iter, &(parts_manager[i])
-    );
-  }
+  // compute volumes of intersection and test for parts boundaries mismatch.
+  for (auto&& part : parts_manager)
+    part.check_mismatch(weights);
+
+  // interpolate field on all parts, concurrently when their target cells
+  // are disjoint, and fix partially filled or empty cells.
+  remapper.interpolate_mesh_var<double, Portage::Interpolate_1stOrder>(
+    field, field, parts_manager, lower_bound, upper_bound,
+    params.limiter, params.bnd_limiter, params.partial_fixup,
+    params.empty_fixup, params.tolerance, params.fix_iter
+  );
 }
 
 /**
@@ -18,6 +18,7 @@
 #include <type_traits>
 #include <memory>
 #include <limits>
+#include <numeric>
 
 #ifdef HAVE_TANGRAM
 #include "tangram/driver/driver.h"
@@ -26,6 +27,15 @@
 #include "portage/intersect/dummy_interface_reconstructor.h"
 
 #include "portage/support/portage.h"
+#include "portage/support/scheduler.h"
+#include "portage/interpolate/remap_matrix.h"
+#include "portage/interpolate/field_components.h"
+#include "portage/support/mesh_adjacency.h"
+#include "portage/interpolate/gradient_stencil.h"
+#include "portage/interpolate/gradient.h"
+#include "portage/interpolate/limiter.h"
+#include "portage/interpolate/material_moments.h"
+#include "portage/interpolate/source_mesh_data.h"
 #include "wonton/support/Point.h"
 #include "wonton/support/CoordinateSystem.h"
 #include "wonton/state/state_vector_multi.h"
@@ -193,7 +203,9 @@ class CoreDriverBase {
     Interpolate a mesh variable of type T residing on entity kind ONWHAT using
     previously computed intersection weights
 
-    @tparam T   type of variable
+    @tparam T   type of variable (double, or float for fields that only
+    need single precision; arithmetic and conservation checks are done
+    in double)
 
     @tparam ONWHAT  Entity_kind that field resides on
 
@@ -259,6 +271,251 @@ class CoreDriverBase {
   }
 
 
+  /*!
+    Interpolate a mesh variable of type T residing on entity kind ONWHAT
+    on several part pairs, interpolating parts with disjoint target
+    entities concurrently
+
+    @param[in] partitions  Source and target entities of each part pair,
+    whose mismatch has already been checked
+
+    See interpolate_mesh_var for the remaining parameters
+  */
+
+  template<typename T = double,
+           Entity_kind ONWHAT,
+           template<int, Entity_kind, class, class, class,
+                    template <class, int, class, class> class,
+                    class, class, class> class Interpolate
+           >
+  void interpolate_mesh_var(std::string srcvarname, std::string trgvarname,
+                            std::vector<PartPair<D, ONWHAT,
+                                                 SourceMesh, SourceState,
+                                                 TargetMesh, TargetState>> const& partitions,
+                            T lower_bound, T upper_bound,
+                            Limiter_type limiter,
+                            Boundary_Limiter_type bnd_limiter,
+                            Partial_fixup_type partial_fixup_type,
+                            Empty_fixup_type empty_fixup_type,
+                            double conservation_tol,
+                            int max_fixup_iter) {
+    assert(ONWHAT == onwhat());
+    auto derived_class_ptr = static_cast<CoreDriverType<ONWHAT> *>(this);
+    derived_class_ptr->
+        template interpolate_mesh_var<T, Interpolate>(srcvarname, trgvarname,
+                                                      partitions,
+                                                      lower_bound, upper_bound,
+                                                      limiter, bnd_limiter,
+                                                      partial_fixup_type,
+                                                      empty_fixup_type,
+                                                      conservation_tol,
+                                                      max_fixup_iter);
+  }
+
+
+  /*!
+    Interpolate a multi-component mesh variable of type T residing on
+    entity kind ONWHAT, the components being held by separate variables
+
+    @param[in] srccomponents  Source variable of each component
+
+    @param[in] trgcomponents  Target variable of each component
+
+    See interpolate_mesh_var for the remaining parameters
+  */
+
+  template<typename T = double,
+           Entity_kind ONWHAT,
+           template<int, Entity_kind, class, class, class,
+                    template <class, int, class, class> class,
+                    class, class, class> class Interpolate
+           >
+  void interpolate_mesh_var(std::vector<std::string> const& srccomponents,
+                            std::vector<std::string> const& trgcomponents,
+                            Portage::vector<std::vector<Weights_t>> const& sources_and_weights,
+                            T lower_bound, T upper_bound,
+                            Limiter_type limiter,
+                            Boundary_Limiter_type bnd_limiter,
+                            Partial_fixup_type partial_fixup_type,
+                            Empty_fixup_type empty_fixup_type,
+                            double conservation_tol,
+                            int max_fixup_iter) {
+    assert(ONWHAT == onwhat());
+    auto derived_class_ptr = static_cast<CoreDriverType<ONWHAT> *>(this);
+    derived_class_ptr->
+        template interpolate_mesh_var<T, Interpolate>(srccomponents, trgcomponents,
+                                                      sources_and_weights,
+                                                      lower_bound, upper_bound,
+                                                      limiter, bnd_limiter,
+                                                      partial_fixup_type,
+                                                      empty_fixup_type,
+                                                      conservation_tol,
+                                                      max_fixup_iter);
+  }
+
+
+  /*!
+    Interpolate several mesh variables of type T residing on entity kind
+    ONWHAT in a single pass over previously computed intersection weights
+
+    @tparam T   type of variables
+
+    @tparam ONWHAT  Entity_kind that fields reside on
+
+    @tparam Interpolate  Functor for doing the interpolate from mesh to mesh
+
+    @param[in] srcvarnames   Variable names on source mesh
+
+    @param[in] trgvarnames   Variable names on target mesh
+
+    @param[in] lower_bounds  Lower bound for each variable
+
+    @param[in] upper_bounds  Upper bound for each variable
+
+    See interpolate_mesh_var for the remaining parameters
+  */
+
+  template<typename T = double,
+           Entity_kind ONWHAT,
+           template<int, Entity_kind, class, class, class,
+                    template <class, int, class, class> class,
+                    class, class, class> class Interpolate
+           >
+  void interpolate_mesh_vars(std::vector<std::string> const& srcvarnames,
+                             std::vector<std::string> const& trgvarnames,
+                             Portage::vector<std::vector<Weights_t>> const& sources_and_weights,
+                             std::vector<T> const& lower_bounds,
+                             std::vector<T> const& upper_bounds,
+                             Limiter_type limiter,
+                             Boundary_Limiter_type bnd_limiter,
+                             Partial_fixup_type partial_fixup_type,
+                             Empty_fixup_type empty_fixup_type,
+                             double conservation_tol,
+                             int max_fixup_iter) {
+    assert(ONWHAT == onwhat());
+    auto derived_class_ptr = static_cast<CoreDriverType<ONWHAT> *>(this);
+    derived_class_ptr->
+        template interpolate_mesh_vars<T, Interpolate>(srcvarnames, trgvarnames,
+                                                       sources_and_weights,
+                                                       lower_bounds, upper_bounds,
+                                                       limiter, bnd_limiter,
+                                                       partial_fixup_type,
+                                                       empty_fixup_type,
+                                                       conservation_tol,
+                                                       max_fixup_iter);
+  }
+
+
+  /*!
+    Assemble the sparse remap operator of entity kind ONWHAT from
+    intersection weights
+
+    @param[in] sources_and_weights  Intersection sources and moments
+
+    @param[in] gradient_offsets     Whether to also store what is needed
+    to remap with fixed gradients
+
+    @tparam Real  Type in which the matrix entries are stored
+
+    @returns   The remap matrix
+  */
+
+  template<Entity_kind ONWHAT, typename Real = double>
+  RemapMatrix<D, Real>
+  assemble_remap_matrix(Portage::vector<std::vector<Weights_t>> const& sources_and_weights,
+                        bool gradient_offsets = false) {
+    assert(ONWHAT == onwhat());
+    auto derived_class_ptr = static_cast<CoreDriverType<ONWHAT> *>(this);
+    return derived_class_ptr->
+        template assemble_remap_matrix<Real>(sources_and_weights,
+                                             gradient_offsets);
+  }
+
+
+  /*!
+    Remap mesh variables of type T residing on entity kind ONWHAT to
+    first order using an assembled remap matrix
+
+    @tparam T   type of variable (double or float)
+
+    @tparam ONWHAT  Entity_kind that fields reside on
+
+    @param[in] remap_matrix  Matrix from assemble_remap_matrix (entries
+    stored in double or float)
+
+    @param[in] srcvarnames   Variable names on source mesh
+
+    @param[in] trgvarnames   Variable names on target mesh
+
+    @param[in] lower_bounds  Lower bound for each variable
+
+    @param[in] upper_bounds  Upper bound for each variable
+
+    See interpolate_mesh_var for the remaining parameters
+  */
+
+  template<typename T = double, Entity_kind ONWHAT, typename Real>
+  void apply_remap_matrix(RemapMatrix<D, Real> const& remap_matrix,
+                          std::vector<std::string> const& srcvarnames,
+                          std::vector<std::string> const& trgvarnames,
+                          std::vector<T> const& lower_bounds,
+                          std::vector<T> const& upper_bounds,
+                          Partial_fixup_type partial_fixup_type,
+                          Empty_fixup_type empty_fixup_type,
+                          double conservation_tol,
+                          int max_fixup_iter) {
+    assert(ONWHAT == onwhat());
+    auto derived_class_ptr = static_cast<CoreDriverType<ONWHAT> *>(this);
+    derived_class_ptr->
+        template apply_remap_matrix<T>(remap_matrix, srcvarnames, trgvarnames,
+                                       lower_bounds, upper_bounds,
+                                       partial_fixup_type, empty_fixup_type,
+                                       conservation_tol, max_fixup_iter);
+  }
+
+
+  /*!
+    Remap mesh variables of type T residing on entity kind ONWHAT to
+    second order using an assembled remap matrix and the limited
+    gradients of the source variables
+
+    @tparam T   type of variable (double or float)
+
+    @tparam ONWHAT  Entity_kind that fields reside on
+
+    @param[in] remap_matrix  Matrix from assemble_remap_matrix with
+    gradient offsets
+
+    @param[in] limiter       Limiter to use for the gradients
+
+    @param[in] bnd_limiter   Limiter to use for the gradients on the boundary
+
+    See the first order apply_remap_matrix for the remaining parameters
+  */
+
+  template<typename T = double, Entity_kind ONWHAT, typename Real>
+  void apply_remap_matrix(RemapMatrix<D, Real> const& remap_matrix,
+                          std::vector<std::string> const& srcvarnames,
+                          std::vector<std::string> const& trgvarnames,
+                          std::vector<T> const& lower_bounds,
+                          std::vector<T> const& upper_bounds,
+                          Limiter_type limiter,
+                          Boundary_Limiter_type bnd_limiter,
+                          Partial_fixup_type partial_fixup_type,
+                          Empty_fixup_type empty_fixup_type,
+                          double conservation_tol,
+                          int max_fixup_iter) {
+    assert(ONWHAT == onwhat());
+    auto derived_class_ptr = static_cast<CoreDriverType<ONWHAT> *>(this);
+    derived_class_ptr->
+        template apply_remap_matrix<T>(remap_matrix, srcvarnames, trgvarnames,
+                                       lower_bounds, upper_bounds,
+                                       limiter, bnd_limiter,
+                                       partial_fixup_type, empty_fixup_type,
+                                       conservation_tol, max_fixup_iter);
+  }
+
+
   /*!
     Interpolate a (multi-)material variable of type T residing on CELLs
     
@@ -319,6 +576,48 @@ class CoreDriverBase {
                                                       max_fixup_iter);
   }
 
+
+  /*!
+    Interpolate a multi-component material variable, the components
+    being held by separate variables
+
+    @param[in] srccomponents  Source material variable of each component
+
+    @param[in] trgcomponents  Target material variable of each component
+
+    See interpolate_mat_var for the remaining parameters
+  */
+
+  template <typename T = double,
+            template<int, Entity_kind, class, class, class,
+                     template <class, int, class, class> class,
+                     class, class, class> class Interpolate
+            >
+  void interpolate_mat_var(std::vector<std::string> const& srccomponents,
+                           std::vector<std::string> const& trgcomponents,
+                           std::vector<Portage::vector<std::vector<Weights_t>>> const& sources_and_weights_by_mat,
+                           T lower_bound, T upper_bound,
+                           Limiter_type limiter,
+                           Boundary_Limiter_type bnd_limiter,
+                           Partial_fixup_type partial_fixup_type,
+                           Empty_fixup_type empty_fixup_type,
+                           double conservation_tol,
+                           int max_fixup_iter) {
+
+    assert(onwhat() == CELL);
+    auto derived_class_ptr = static_cast<CoreDriverType<CELL> *>(this);
+    derived_class_ptr->
+        template interpolate_mat_var<T, Interpolate>(srccomponents,
+                                                     trgcomponents,
+                                                     sources_and_weights_by_mat,
+                                                     lower_bound, upper_bound,
+                                                     limiter, bnd_limiter,
+                                                     partial_fixup_type,
+                                                     empty_fixup_type,
+                                                     conservation_tol,
+                                                     max_fixup_iter);
+  }
+
   /*!
     @brief Check if meshes are mismatched (don't cover identical
     portions of space)
@@ -338,6 +637,25 @@ class CoreDriverBase {
   }
 
 
+  /*!
+    @brief Discard data derived from the geometry of the meshes
+
+    @tparam Entity_kind  What kind of entity the driver remaps on
+
+    Intersecting the whole meshes does this, so it only needs calling
+    to drop the data as soon as the source or target mesh has moved or
+    changed, or before intersecting part pairs of moved meshes
+  */
+
+  template<Entity_kind ONWHAT>
+  void
+  mesh_geometry_changed() {
+    assert(ONWHAT == onwhat());
+    auto derived_class_ptr = static_cast<CoreDriverType<ONWHAT> *>(this);
+    derived_class_ptr->mesh_geometry_changed();
+  }
+
+
   /*!
     @brief Set numerical tolerances for small volumes, distances, etc.
 
@@ -354,6 +672,39 @@ class CoreDriverBase {
     derived_class_ptr->set_num_tols(num_tols);
   }
 
+  /*!
+    @brief Declare that both meshes are made of axis-aligned boxes
+
+    @tparam Entity_kind  what kind of entity are we setting for
+
+    @param[in] rectangular_mesh  Whether node control volumes (dual
+    cells) can be intersected as boxes
+  */
+
+  template<Entity_kind ONWHAT>
+  void
+  set_rectangular_mesh(bool rectangular_mesh) {
+    assert(ONWHAT == onwhat());
+    auto derived_class_ptr = static_cast<CoreDriverType<ONWHAT> *>(this);
+    derived_class_ptr->set_rectangular_mesh(rectangular_mesh);
+  }
+
+  /*!
+    @brief Set the highest degree of the intersection moments
+
+    @tparam Entity_kind  what kind of entity are we setting for
+
+    @param[in] moment_order  1 (default), or 2 for 3rd order remap
+  */
+
+  template<Entity_kind ONWHAT>
+  void
+  set_moment_order(int moment_order) {
+    assert(ONWHAT == onwhat());
+    auto derived_class_ptr = static_cast<CoreDriverType<ONWHAT> *>(this);
+    derived_class_ptr->set_moment_order(moment_order);
+  }
+
 };
 
 
@@ -485,6 +836,50 @@ class CoreDriver : public CoreDriverBase<D,
   }
 
 
+  /*!
+    Find candidate entities of a source part that might intersect
+    each entity of a target part
+
+    @tparam Search Search class templated on dimension, Entity_kind
+    and both meshes
+
+    @param partition  Source and target entities of the part pair
+
+    @return Vector of intersection candidates for each target entity,
+    empty outside the target part
+
+    Candidates outside the source part are dropped right away so that
+    part-by-part remap only intersects entities of the part pair.
+  */
+
+  template<template<int, Entity_kind, class, class> class Search>
+  Portage::vector<std::vector<int>>
+  search(PartPair<D, ONWHAT, SourceMesh, SourceState,
+                  TargetMesh, TargetState> const& partition) {
+    // Get an instance of the desired search algorithm type
+    const Search<D, ONWHAT, SourceMesh, TargetMesh>
+        search_functor(source_mesh_, target_mesh_);
+
+    int ntarget_ents = target_mesh_.num_entities(ONWHAT, PARALLEL_OWNED);
+
+    // initialize search candidate vector
+    Portage::vector<std::vector<int>> candidates(ntarget_ents);
+
+    auto const& part_target_entities = partition.get_target_entities();
+    Portage::for_each(part_target_entities.begin(), part_target_entities.end(),
+                      [&](int entity) {
+      std::vector<int> entity_candidates = search_functor(entity);
+      entity_candidates.erase(
+          std::remove_if(entity_candidates.begin(), entity_candidates.end(),
+                         [&](int s) { return not partition.is_source_entity(s); }),
+          entity_candidates.end());
+      candidates[entity] = std::move(entity_candidates);
+    });
+
+    return candidates;
+  }
+
+
   /*! 
     Intersect source and target mesh entities of kind
     'ONWHAT' and return the intersecting entities and moments of
@@ -510,16 +905,114 @@ class CoreDriver : public CoreDriverBase<D,
 
     int nents = target_mesh_.num_entities(ONWHAT, PARALLEL_OWNED);
     Portage::vector<std::vector<Portage::Weights_t>> sources_and_weights(nents);
-      
+
+    // The mismatch analysis and the source mesh stencils belong to the
+    // geometry the weights are computed on, which may have moved
+    mesh_geometry_changed();
+
     Intersect<ONWHAT, SourceMesh, SourceState, TargetMesh,
               InterfaceReconstructorType, Matpoly_Splitter, Matpoly_Clipper>
-        intersector(source_mesh_, source_state_, target_mesh_, num_tols_);
+        intersector(source_mesh_, source_state_, target_mesh_, num_tols_,
+                    rectangular_mesh_);
+    intersector.set_moment_order(moment_order_);
+
+    // The cost of intersecting a target entity grows with its number
+    // of candidates, which can vary a lot (e.g. coarse target cells
+    // over a fine source mesh), and with the size of the polytopes
+    // clipped against each other, so schedule the targets by the
+    // product of the target and candidate vertex counts
+    std::vector<double> const source_sizes = source_polytope_sizes();
+    auto intersect_cost = [&](int t, std::vector<int> const& ents) {
+      double cost = 0.0;
+      for (auto const& s : ents)
+        cost += source_sizes[s];
+      return cost*polytope_size(target_mesh_, t);
+    };
+
+    Portage::balanced_transform(target_mesh_.begin(ONWHAT, PARALLEL_OWNED),
+                                target_mesh_.end(ONWHAT, PARALLEL_OWNED),
+                                candidates.begin(),
+                                sources_and_weights.begin(),
+                                intersector, intersect_cost,
+                                &intersect_stats_);
+#ifdef DEBUG
+    intersect_stats_.print("Mesh-mesh intersection");
+#endif
 
-    Portage::transform(target_mesh_.begin(ONWHAT, PARALLEL_OWNED),
-                       target_mesh_.end(ONWHAT, PARALLEL_OWNED),
-                       candidates.begin(),
-                       sources_and_weights.begin(),
-                       intersector);
+    return sources_and_weights;
+  }
+
+
+  /*!
+    Intersect the entities of a target part with the entities of a
+    source part and return the intersecting entities and moments of
+    intersection for each target entity
+
+    @param candidates Vector of intersection candidates for each target
+    entity, as returned by search(partition)
+    @param partition  Source and target entities of the part pair
+
+    @return vector of intersection moments for each target entity, empty
+    outside the target part
+  */
+
+  template<template <Entity_kind, class, class, class,
+                     template <class, int, class, class> class,
+                     class, class> class Intersect>
+  Portage::vector<std::vector<Portage::Weights_t>>
+  intersect_meshes(Portage::vector<std::vector<int>> const& candidates,
+                   PartPair<D, ONWHAT, SourceMesh, SourceState,
+                            TargetMesh, TargetState> const& partition) {
+
+    // Use default numerical tolerances in case they were not set earlier
+    if (num_tols_.tolerances_set == false) {
+        NumericTolerances_t default_num_tols;
+        default_num_tols.use_default();
+      set_num_tols(default_num_tols);
+    }
+
+    int nents = target_mesh_.num_entities(ONWHAT, PARALLEL_OWNED);
+    Portage::vector<std::vector<Portage::Weights_t>> sources_and_weights(nents);
+
+    Intersect<ONWHAT, SourceMesh, SourceState, TargetMesh,
+              InterfaceReconstructorType, Matpoly_Splitter, Matpoly_Clipper>
+        intersector(source_mesh_, source_state_, target_mesh_, num_tols_,
+                    rectangular_mesh_);
+    intersector.set_moment_order(moment_order_);
+
+    // Only visit the target part: intersect its entities (indexed by
+    // position in the part) then move the moments to their place in
+    // the mesh
+    auto const& part_target_entities = partition.get_target_entities();
+    int const target_part_size = part_target_entities.size();
+    Portage::vector<std::vector<Portage::Weights_t>> part_weights(target_part_size);
+
+    auto part_intersector = [&](int i, int) {
+      int const entity = part_target_entities[i];
+      return intersector(entity, candidates[entity]);
+    };
+    // same estimate as for the whole mesh
+    std::vector<double> const source_sizes = source_polytope_sizes();
+    auto intersect_cost = [&](int i, int) {
+      int const entity = part_target_entities[i];
+      double cost = 0.0;
+      for (auto const& s : candidates[entity])
+        cost += source_sizes[s];
+      return cost*polytope_size(target_mesh_, entity);
+    };
+
+    Portage::balanced_transform(make_counting_iterator(0),
+                                make_counting_iterator(target_part_size),
+                                make_counting_iterator(0),
+                                part_weights.begin(),
+                                part_intersector, intersect_cost,
+                                &intersect_stats_);
+#ifdef DEBUG
+    intersect_stats_.print("Part-part intersection");
+#endif
+
+    for (int i = 0; i < target_part_size; i++)
+      sources_and_weights[part_target_entities[i]] = std::move(part_weights[i]);
 
     return sources_and_weights;
   }
@@ -530,8 +1023,52 @@ class CoreDriver : public CoreDriverBase<D,
     num_tols_ = num_tols;
   }
 
+  /// Declare that both meshes are made of axis-aligned boxes, so that
+  /// the dual cells of nodes are intersected as boxes
+  void set_rectangular_mesh(bool rectangular_mesh) {
+    rectangular_mesh_ = rectangular_mesh;
+  }
 
-  /*! 
+  /// Highest degree of the intersection moments to compute: 1 (the
+  /// default) for 1st and 2nd order remap, 2 for 3rd order remap so
+  /// that the quadratic fits are integrated exactly
+  void set_moment_order(int moment_order) {
+    assert(moment_order == 1 || moment_order == 2);
+    moment_order_ = moment_order;
+  }
+
+  /*!
+    @brief Discard data derived from the geometry of the meshes
+
+    The mismatch analysis (entity and intersection volumes, layers of
+    empty target entities) and the neighbor lists, gradient, limiter
+    and quadratic fit stencils of the source mesh are computed once
+    and reused by every remap, so that remapping new field values on
+    the same meshes (e.g. at every time step) only pays for the
+    interpolation. Intersecting the whole meshes calls this, since new
+    weights may come from moved meshes, so the data never outlives the
+    weights it goes with; intersecting a part pair does not, as the
+    part pairs of a remap share the data of the whole meshes. The data
+    is rebuilt the next time it is needed.
+
+    The material moments are kept: they belong to the interface
+    reconstruction, which intersect_materials redoes (and gathers them
+    again) whenever it is called.
+  */
+  void mesh_geometry_changed() {
+    mismatch_fixer_.reset();
+    auto material_moments = std::move(source_mesh_data_.material_moments);
+    source_mesh_data_ = SourceMeshData<D>();
+    source_mesh_data_.material_moments = std::move(material_moments);
+  }
+
+  /// Per-thread utilization of the most recent intersection step
+  ScheduleStats_t const& intersect_schedule_stats() const {
+    return intersect_stats_;
+  }
+
+
+  /*! 
 
     Intersect target mesh cells with source material polygons
     and return the intersecting entities and moments of intersection
@@ -606,6 +1143,12 @@ class CoreDriver : public CoreDriverBase<D,
                                                    cell_mat_centroids);
     interface_reconstructor_->reconstruct(executor_);
 
+    // Material volumes and centroids in the source cells only change
+    // with the reconstruction, so gather them once here for all
+    // material variables
+    source_mesh_data_.material_moments =
+        make_material_moments<D>(source_mesh_, source_state_, *interface_reconstructor_);
+
     // Make an intersector which knows about the source state (to be
     // able to query the number of materials, etc) and also knows
     // about the interface reconstructor so that it can retrieve pure
@@ -615,6 +1158,7 @@ class CoreDriver : public CoreDriverBase<D,
               InterfaceReconstructorType, Matpoly_Splitter, Matpoly_Clipper>
         intersector(source_mesh_, source_state_, target_mesh_, num_tols_,
                     interface_reconstructor_);
+    intersector.set_moment_order(moment_order_);
 
     // Assume (with no harm for sizing purposes) that all materials
     // in source made it into target
@@ -622,6 +1166,21 @@ class CoreDriver : public CoreDriverBase<D,
     std::vector<Portage::vector<std::vector<Weights_t>>>
         source_weights_by_mat(nmats);
 
+    // Intersecting a target cell with mixed source cells costs roughly
+    // one polytope intersection per material polytope, so weight each
+    // candidate by the number of materials in it as well as by the
+    // sizes of the cells
+    std::vector<double> const source_sizes = source_polytope_sizes();
+    auto intersect_cost = [&](int t, std::vector<int> const& ents) {
+      double cost = 0.0;
+      for (auto const& s : ents)
+        cost += std::max(1, source_state_.cell_get_num_mats(s))*source_sizes[s];
+      return cost*polytope_size(target_mesh_, t);
+    };
+
+    // report the utilization over all materials
+    intersect_stats_ = ScheduleStats_t();
+
     for (int m = 0; m < nmats; m++) {
       std::vector<int> matcellstgt;
 
@@ -653,11 +1212,14 @@ class CoreDriver : public CoreDriverBase<D,
 
 
       std::vector<std::vector<Weights_t>> this_mat_sources_and_wts(ntargetcells);
-      Portage::transform(target_mesh_.begin(CELL, PARALLEL_OWNED),
-                         target_mesh_.end(CELL, PARALLEL_OWNED),
-                         candidates.begin(),
-                         this_mat_sources_and_wts.begin(),
-                         intersector);
+      ScheduleStats_t mat_stats;
+      Portage::balanced_transform(target_mesh_.begin(CELL, PARALLEL_OWNED),
+                                  target_mesh_.end(CELL, PARALLEL_OWNED),
+                                  candidates.begin(),
+                                  this_mat_sources_and_wts.begin(),
+                                  intersector, intersect_cost,
+                                  &mat_stats);
+      intersect_stats_.add(mat_stats);
 
       // LOOK AT INTERSECTION WEIGHTS TO DETERMINE WHICH TARGET CELLS
       // WILL GET NEW MATERIALS
@@ -761,6 +1323,9 @@ class CoreDriver : public CoreDriverBase<D,
       target_state_.mat_add_celldata("mat_centroids", m, &(mat_centroids[0]));
 
     }  // for each material m
+#ifdef DEBUG
+    intersect_stats_.print("Mesh-material intersection");
+#endif
 
     return source_weights_by_mat;
 #else
@@ -778,6 +1343,11 @@ class CoreDriver : public CoreDriverBase<D,
     (vols, centroids)
 
     @returns   Whether the meshes are mismatched
+
+    The analysis only depends on the geometry, so it is done once and
+    kept until the whole meshes are intersected again or
+    mesh_geometry_changed() is called. Later calls (e.g. every time
+    step of a run on fixed meshes) reuse it.
   */
 
   bool
@@ -853,7 +1423,7 @@ class CoreDriver : public CoreDriverBase<D,
         InterfaceReconstructorType, Matpoly_Splitter, Matpoly_Clipper, CoordSys>;
 
     interpolator_t interpolator(source_mesh_, target_mesh_, source_state_, num_tols_);
-    interpolator.set_interpolation_variable(srcvarname, limiter, bnd_limiter);
+    set_up_interpolator<T>(interpolator, srcvarname, limiter, bnd_limiter);
 
     // get a handle to a memory location where the target state
     // would like us to write this material variable into.
@@ -887,56 +1457,25 @@ class CoreDriver : public CoreDriverBase<D,
                         part_target_entities.end(),
                         [&](int current){ assert(current <= max_target_id); });
 
-      int const target_mesh_size = sources_and_weights.size();
       int const target_part_size = partition->target_part_size();
 
-      // 2. Filter intersection weights list.
-      // To restrict interpolation only to source-target parts, we need
-      // to filter the intersection weights list to keep only that of the
-      // entities of the source part. Notice that this step can be avoided
-      // when the part-by-part intersection is implemented.
-
-      auto filter_weights = [&](int entity) {
-        // For a given target entity, we aim to filter its source weights
-        // list to keep only those which are in the source part list.
-        // that way, we ensure that only the contribution of source part entities
-        // weights are taken into account when doing the interpolation.
-        // For that, we just iterate on the related weight list, and add the
-        // current couple of entity/weights if it belongs to the source part.
-        // nb: 'auto' may imply unexpected behavior with thrust enabled.
-        entity_weights_t const& entity_weights = sources_and_weights[entity];
-        entity_weights_t heap;
-        heap.reserve(10); // size of a local vicinity
-        for (auto&& weight : entity_weights) {
-          // constant-time lookup in average case.
-          if(partition->is_source_entity(weight.entityID)) {
-            heap.emplace_back(weight);
-          }
-        }
-        heap.shrink_to_fit();
-        return heap;
-      };
-
-      Portage::vector<entity_weights_t> parts_weights(target_part_size);
-      Portage::transform(part_target_entities.begin(), part_target_entities.end(),
-                         parts_weights.begin(), filter_weights);
+      // 2. Filter the intersection weights of the part pair.
+      // To restrict interpolation only to source-target parts, the
+      // weights of each target part entity are restricted to the source
+      // part entities. The given weights are always the ones used; the
+      // overload without weights reuses those that check_mismatch
+      // filtered instead of doing it again for every field.
+      Portage::vector<entity_weights_t> const parts_weights =
+          partition->restrict_weights(sources_and_weights);
+      assert(static_cast<int>(parts_weights.size()) == target_part_size);
 
       // 3. Process interpolation.
       // Now that intersection weights is filtered, perform the interpolation.
-      // Notice that we need to store the interpolated values in a temporary
-      // array since they are indexed with respect to the target part
-      // and not to the target mesh. Hence we need to copy them back in the
-      // target state at their correct (absolute index) memory locations.
-      T temporary_storage[target_part_size];
-      Portage::pointer<T> target_part_field(temporary_storage);
-
-      Portage::transform(part_target_entities.begin(), part_target_entities.end(),
-                         parts_weights.begin(), target_part_field, interpolator);
-
-      for (int i=0; i < target_part_size; ++i) {
-        auto const& j = part_target_entities[i];
-        target_mesh_field[j] = target_part_field[i];
-      }
+      // Values are indexed with respect to the target part, so they are
+      // written straight to their correct (absolute index) locations in
+      // the target state.
+      interpolate_part(interpolator, *partition, parts_weights,
+                       target_mesh_field);
 
       // 4. Fix partially filled and empty cells values if necessary.
       // Notice that mismatch detection should have been already performed.
@@ -947,10 +1486,10 @@ class CoreDriver : public CoreDriverBase<D,
             "Will start fixing interpolated values\n"
           );
         #endif
-        partition->fix_mismatch(srcvarname, trgvarname,
-                                lower_bound, upper_bound,
-                                conservation_tol, max_fixup_iter,
-                                partial_fixup_type, empty_fixup_type);
+        partition->template fix_mismatch<T>(srcvarname, trgvarname,
+                                            lower_bound, upper_bound,
+                                            conservation_tol, max_fixup_iter,
+                                            partial_fixup_type, empty_fixup_type);
       }
     } else /* mesh-mesh interpolation */ {
       Portage::pointer<T> target_field(target_mesh_field);
@@ -961,12 +1500,581 @@ class CoreDriver : public CoreDriverBase<D,
 
       assert(mismatch_fixer_ && "check_mesh_mismatch must be called first");
       if (mismatch_fixer_->has_mismatch()) {
-        mismatch_fixer_->fix_mismatch(srcvarname, trgvarname,
-                                      lower_bound, upper_bound,
-                                      conservation_tol, max_fixup_iter,
-                                      partial_fixup_type, empty_fixup_type);
+        mismatch_fixer_->template fix_mismatch<T>(srcvarname, trgvarname,
+                                                  lower_bound, upper_bound,
+                                                  conservation_tol, max_fixup_iter,
+                                                  partial_fixup_type, empty_fixup_type);
+      }
+    }
+  }
+
+
+  /**
+   * @brief Interpolate a mesh variable on a part pair.
+   *
+   * @param[in] srcvarname          source mesh variable to remap
+   * @param[in] trgvarname          target mesh variable to remap
+   * @param[in] partition           source and target entities lists of the
+   *                                part pair (mismatch already checked)
+   * @param[in] lower_bound         lower bound of variable value when doing fixup
+   * @param[in] upper_bound         upper bound of variable value when doing fixup
+   * @param[in] limiter             limiter to use
+   * @param[in] bnd_limiter         boundary limiter to use
+   * @param[in] partial...          how to fixup partly filled target cells
+   * @param[in] emtpy...            how to fixup empty target cells with this var
+   * @param[in] cons..tol           tolerance for conservation when doing fixup
+   * @param[in] max_fixup_iter      maximum number of iterations for mismatch fixup
+   *
+   * Interpolates with the weights given to the part pair's
+   * check_mismatch, which it has already restricted to the part, so
+   * remapping a field on the part costs the same as on a whole mesh of
+   * that size. Call check_mismatch again whenever the weights change.
+   */
+  template<typename T = double,
+    template<int, Entity_kind, class, class, class,
+    template<class, int, class, class> class,
+    class, class, class> class Interpolate
+  >
+  void interpolate_mesh_var(std::string srcvarname, std::string trgvarname,
+                            PartPair<D, ONWHAT,
+                                     SourceMesh, SourceState,
+                                     TargetMesh, TargetState> const& partition,
+                            T lower_bound, T upper_bound,
+                            Limiter_type limiter = DEFAULT_LIMITER,
+                            Boundary_Limiter_type bnd_limiter = DEFAULT_BND_LIMITER,
+                            Partial_fixup_type partial_fixup_type = DEFAULT_PARTIAL_FIXUP_TYPE,
+                            Empty_fixup_type empty_fixup_type = DEFAULT_EMPTY_FIXUP_TYPE,
+                            double conservation_tol = DEFAULT_CONSERVATION_TOL,
+                            int max_fixup_iter = DEFAULT_MAX_FIXUP_ITER) {
+
+    if (source_state_.get_entity(srcvarname) != ONWHAT) {
+      std::cerr << "Variable " << srcvarname << " not defined on Entity_kind "
+                << ONWHAT << ". Skipping!" << std::endl;
+      return;
+    }
+
+    assert(partition.source_part_size() > 0);
+    assert(partition.target_part_size() > 0);
+    assert(partition.is_mismatch_tested());
+
+    using interpolator_t =
+      Interpolate<D, ONWHAT, SourceMesh, TargetMesh, SourceState,
+        InterfaceReconstructorType, Matpoly_Splitter, Matpoly_Clipper, CoordSys>;
+
+    interpolator_t interpolator(source_mesh_, target_mesh_, source_state_, num_tols_);
+    set_up_interpolator<T>(interpolator, srcvarname, limiter, bnd_limiter);
+
+    T* target_mesh_field = nullptr;
+    target_state_.mesh_get_data(ONWHAT, trgvarname, &target_mesh_field);
+
+    interpolate_part(interpolator, partition, partition.get_part_weights(),
+                     target_mesh_field);
+
+    if (partition.has_mismatch())
+      partition.template fix_mismatch<T>(srcvarname, trgvarname,
+                                         lower_bound, upper_bound,
+                                         conservation_tol, max_fixup_iter,
+                                         partial_fixup_type, empty_fixup_type);
+  }
+
+
+  /**
+   * @brief Interpolate a mesh variable on several part pairs.
+   *
+   * @param[in] srcvarname          source mesh variable to remap
+   * @param[in] trgvarname          target mesh variable to remap
+   * @param[in] partitions          source and target entities lists of each
+   *                                part pair (mismatch already checked)
+   * @param[in] lower_bound         lower bound of variable value when doing fixup
+   * @param[in] upper_bound         upper bound of variable value when doing fixup
+   * @param[in] limiter             limiter to use
+   * @param[in] bnd_limiter         boundary limiter to use
+   * @param[in] partial...          how to fixup partly filled target cells
+   * @param[in] emtpy...            how to fixup empty target cells with this var
+   * @param[in] cons..tol           tolerance for conservation when doing fixup
+   * @param[in] max_fixup_iter      maximum number of iterations for mismatch fixup
+   *
+   * Equivalent to calling interpolate_mesh_var for each part pair in
+   * turn, except that the source field is prepared (e.g. gradients)
+   * once for all parts and that parts with disjoint target entities
+   * are interpolated concurrently: large parts one after the other with
+   * parallel loops over their entities, small ones side by side. The
+   * mismatch fixups, which may involve collective communication, are
+   * then done part by part in order; each only touches the entities of
+   * its own part so none of them sees the result of another. If some
+   * target entity is in several parts, each part is interpolated and
+   * fixed in turn, as by separate calls, so that later parts overwrite
+   * the fixed values of earlier ones.
+   */
+  template<typename T = double,
+    template<int, Entity_kind, class, class, class,
+    template<class, int, class, class> class,
+    class, class, class> class Interpolate
+  >
+  void interpolate_mesh_var(std::string srcvarname, std::string trgvarname,
+                            std::vector<PartPair<D, ONWHAT,
+                                                 SourceMesh, SourceState,
+                                                 TargetMesh, TargetState>> const& partitions,
+                            T lower_bound, T upper_bound,
+                            Limiter_type limiter = DEFAULT_LIMITER,
+                            Boundary_Limiter_type bnd_limiter = DEFAULT_BND_LIMITER,
+                            Partial_fixup_type partial_fixup_type = DEFAULT_PARTIAL_FIXUP_TYPE,
+                            Empty_fixup_type empty_fixup_type = DEFAULT_EMPTY_FIXUP_TYPE,
+                            double conservation_tol = DEFAULT_CONSERVATION_TOL,
+                            int max_fixup_iter = DEFAULT_MAX_FIXUP_ITER) {
+
+    if (source_state_.get_entity(srcvarname) != ONWHAT) {
+      std::cerr << "Variable " << srcvarname << " not defined on Entity_kind "
+                << ONWHAT << ". Skipping!" << std::endl;
+      return;
+    }
+
+    using interpolator_t =
+      Interpolate<D, ONWHAT, SourceMesh, TargetMesh, SourceState,
+        InterfaceReconstructorType, Matpoly_Splitter, Matpoly_Clipper, CoordSys>;
+
+    interpolator_t interpolator(source_mesh_, target_mesh_, source_state_, num_tols_);
+    set_up_interpolator<T>(interpolator, srcvarname, limiter, bnd_limiter);
+
+    T* target_mesh_field = nullptr;
+    target_state_.mesh_get_data(ONWHAT, trgvarname, &target_mesh_field);
+
+    int const nparts = partitions.size();
+    for (auto const& partition : partitions) {
+      assert(partition.source_part_size() > 0);
+      assert(partition.target_part_size() > 0);
+      assert(partition.is_mismatch_tested());
+    }
+
+    // Parts may only be interpolated concurrently if no target entity
+    // belongs to more than one of them
+    bool disjoint = true;
+    {
+      std::vector<char> claimed(target_mesh_.num_entities(ONWHAT, ALL), 0);
+      for (auto const& partition : partitions)
+        for (int entity : partition.get_target_entities()) {
+          if (claimed[entity]) disjoint = false;
+          claimed[entity] = 1;
+        }
+    }
+
+    auto fix_part = [&](PartPair<D, ONWHAT, SourceMesh, SourceState,
+                                 TargetMesh, TargetState> const& partition) {
+      if (partition.has_mismatch())
+        partition.template fix_mismatch<T>(srcvarname, trgvarname,
+                                           lower_bound, upper_bound,
+                                           conservation_tol, max_fixup_iter,
+                                           partial_fixup_type, empty_fixup_type);
+    };
+
+    if (disjoint) {
+      auto interpolate_task = [&](int p, bool inner_parallel) {
+        interpolate_part(interpolator, partitions[p],
+                         partitions[p].get_part_weights(), target_mesh_field,
+                         inner_parallel);
+      };
+      auto part_cost = [&](int p) {
+        return static_cast<double>(partitions[p].target_part_size());
+      };
+      run_tasks(nparts, interpolate_task, part_cost);
+
+      for (auto const& partition : partitions)
+        fix_part(partition);
+    } else {
+      for (auto const& partition : partitions) {
+        interpolate_part(interpolator, partition, partition.get_part_weights(),
+                         target_mesh_field);
+        fix_part(partition);
+      }
+    }
+  }
+
+
+  /**
+   * @brief Interpolate several mesh variables in one pass over the weights.
+   *
+   * Equivalent to calling interpolate_mesh_var for each pair of
+   * source/target variables, except that the intersection weights of
+   * each target entity are traversed once for all variables while they
+   * are hot in cache, instead of being streamed again for every field.
+   *
+   * @param[in] srcvarnames         source mesh variables to remap
+   * @param[in] trgvarnames         target mesh variables to remap
+   * @param[in] sources_and_weights weights for mesh-mesh interpolation
+   * @param[in] lower_bounds        lower bound of each variable when doing fixup
+   * @param[in] upper_bounds        upper bound of each variable when doing fixup
+   * @param[in] limiter             limiter to use
+   * @param[in] bnd_limiter         boundary limiter to use
+   * @param[in] partial...          how to fixup partly filled target cells
+   * @param[in] emtpy...            how to fixup empty target cells with this var
+   * @param[in] cons..tol           tolerance for conservation when doing fixup
+   * @param[in] max_fixup_iter      maximum number of iterations for mismatch fixup
+   */
+  template<typename T = double,
+    template<int, Entity_kind, class, class, class,
+    template<class, int, class, class> class,
+    class, class, class> class Interpolate
+  >
+  void interpolate_mesh_vars(std::vector<std::string> const& srcvarnames,
+                             std::vector<std::string> const& trgvarnames,
+                             Portage::vector<std::vector<Weights_t>> const& sources_and_weights,
+                             std::vector<T> const& lower_bounds,
+                             std::vector<T> const& upper_bounds,
+                             Limiter_type limiter = DEFAULT_LIMITER,
+                             Boundary_Limiter_type bnd_limiter = DEFAULT_BND_LIMITER,
+                             Partial_fixup_type partial_fixup_type = DEFAULT_PARTIAL_FIXUP_TYPE,
+                             Empty_fixup_type empty_fixup_type = DEFAULT_EMPTY_FIXUP_TYPE,
+                             double conservation_tol = DEFAULT_CONSERVATION_TOL,
+                             int max_fixup_iter = DEFAULT_MAX_FIXUP_ITER) {
+
+    assert(srcvarnames.size() == trgvarnames.size());
+    assert(srcvarnames.size() == lower_bounds.size());
+    assert(srcvarnames.size() == upper_bounds.size());
+
+    using entity_weights_t = std::vector<Weights_t>;
+    using interpolator_t =
+      Interpolate<D, ONWHAT, SourceMesh, TargetMesh, SourceState,
+        InterfaceReconstructorType, Matpoly_Splitter, Matpoly_Clipper, CoordSys>;
+
+    // Set up one interpolator per variable (this is where any
+    // per-variable precomputation like gradients happens)
+    std::vector<std::unique_ptr<interpolator_t>> interpolators;
+    std::vector<T*> target_fields;
+    std::vector<int> fields;  // index of each valid variable in the input lists
+
+    int const nvars = srcvarnames.size();
+    for (int i = 0; i < nvars; i++) {
+      if (source_state_.get_entity(srcvarnames[i]) != ONWHAT) {
+        std::cerr << "Variable " << srcvarnames[i] << " not defined on Entity_kind "
+                  << ONWHAT << ". Skipping!" << std::endl;
+        continue;
+      }
+
+      interpolators.emplace_back(new interpolator_t(source_mesh_, target_mesh_,
+                                                    source_state_, num_tols_));
+      set_up_interpolator<T>(*interpolators.back(), srcvarnames[i],
+                             limiter, bnd_limiter);
+
+      T* target_mesh_field = nullptr;
+      target_state_.mesh_get_data(ONWHAT, trgvarnames[i], &target_mesh_field);
+      target_fields.push_back(target_mesh_field);
+      fields.push_back(i);
+    }
+
+    int const nfields = fields.size();
+    if (!nfields) return;
+
+    // Interpolate all fields for a target entity before moving on
+    Portage::for_each(target_mesh_.begin(ONWHAT, PARALLEL_OWNED),
+                      target_mesh_.end(ONWHAT, PARALLEL_OWNED),
+                      [&](int entity) {
+      // nb: 'auto' may imply unexpected behavior with thrust enabled.
+      entity_weights_t const& entity_weights = sources_and_weights[entity];
+      for (int f = 0; f < nfields; f++)
+        target_fields[f][entity] = (*interpolators[f])(entity, entity_weights);
+    });
+
+    fix_remapped_fields(srcvarnames, trgvarnames, fields,
+                        lower_bounds, upper_bounds,
+                        partial_fixup_type, empty_fixup_type,
+                        conservation_tol, max_fixup_iter);
+  }
+
+
+  /**
+   * @brief Interpolate a multi-component mesh variable.
+   *
+   * The components of a vector or tensor field (e.g. the velocity or
+   * stress) are held by separate source and target variables. Each
+   * component is remapped as with interpolate_mesh_var, but the
+   * interpolator packs the source components entity by entity so that
+   * the intersection moments of each source entity are read once and
+   * applied to all components in an inner loop.
+   *
+   * @param[in] srccomponents       source variable of each component
+   * @param[in] trgcomponents       target variable of each component
+   * @param[in] sources_and_weights weights for mesh-mesh interpolation
+   * @param[in] lower_bound         lower bound of the components when doing fixup
+   * @param[in] upper_bound         upper bound of the components when doing fixup
+   *
+   * See interpolate_mesh_var for the remaining parameters. The
+   * interpolator must provide the multi-component set_interpolation_variable
+   * and functor (first, second and third order do).
+   */
+  template<typename T = double,
+    template<int, Entity_kind, class, class, class,
+    template<class, int, class, class> class,
+    class, class, class> class Interpolate
+  >
+  void interpolate_mesh_var(std::vector<std::string> const& srccomponents,
+                            std::vector<std::string> const& trgcomponents,
+                            Portage::vector<std::vector<Weights_t>> const& sources_and_weights,
+                            T lower_bound, T upper_bound,
+                            Limiter_type limiter = DEFAULT_LIMITER,
+                            Boundary_Limiter_type bnd_limiter = DEFAULT_BND_LIMITER,
+                            Partial_fixup_type partial_fixup_type = DEFAULT_PARTIAL_FIXUP_TYPE,
+                            Empty_fixup_type empty_fixup_type = DEFAULT_EMPTY_FIXUP_TYPE,
+                            double conservation_tol = DEFAULT_CONSERVATION_TOL,
+                            int max_fixup_iter = DEFAULT_MAX_FIXUP_ITER) {
+
+    assert(srccomponents.size() == trgcomponents.size());
+
+    int const ncomp = srccomponents.size();
+    if (!ncomp) return;
+
+    for (auto const& name : srccomponents)
+      if (source_state_.get_entity(name) != ONWHAT) {
+        std::cerr << "Variable " << name << " not defined on Entity_kind "
+                  << ONWHAT << ". Skipping!" << std::endl;
+        return;
       }
+
+    using entity_weights_t = std::vector<Weights_t>;
+
+    Interpolate<D, ONWHAT, SourceMesh, TargetMesh, SourceState,
+                InterfaceReconstructorType, Matpoly_Splitter, Matpoly_Clipper, CoordSys>
+        interpolator(source_mesh_, target_mesh_, source_state_, num_tols_);
+    set_up_interpolator<T>(interpolator, srccomponents, limiter, bnd_limiter);
+
+    // Interpolate all components of a target entity together into a
+    // packed buffer, then scatter them to the target variables
+    int const ntarget = target_mesh_.num_entities(ONWHAT, PARALLEL_OWNED);
+    std::vector<double> target_vals(static_cast<size_t>(ntarget)*ncomp);
+    double *packed = target_vals.data();
+
+    Portage::for_each(target_mesh_.begin(ONWHAT, PARALLEL_OWNED),
+                      target_mesh_.end(ONWHAT, PARALLEL_OWNED),
+                      [&](int entity) {
+      // nb: 'auto' may imply unexpected behavior with thrust enabled.
+      entity_weights_t const& entity_weights = sources_and_weights[entity];
+      interpolator(entity, entity_weights,
+                   packed + static_cast<size_t>(entity)*ncomp);
+    });
+
+    for (int k = 0; k < ncomp; k++) {
+      T* target_mesh_field = nullptr;
+      target_state_.mesh_get_data(ONWHAT, trgcomponents[k], &target_mesh_field);
+      Portage::for_each(make_counting_iterator(0), make_counting_iterator(ntarget),
+                        [&](int entity) {
+        target_mesh_field[entity] = packed[static_cast<size_t>(entity)*ncomp + k];
+      });
+    }
+
+    assert(mismatch_fixer_ && "check_mesh_mismatch must be called first");
+    if (mismatch_fixer_->has_mismatch()) {
+      mismatch_fixer_->template fix_mismatch<T>(srccomponents, trgcomponents,
+                                                std::vector<double>(ncomp, lower_bound),
+                                                std::vector<double>(ncomp, upper_bound),
+                                                conservation_tol, max_fixup_iter,
+                                                partial_fixup_type, empty_fixup_type);
+    }
+  }
+
+
+  /**
+   * @brief Assemble the sparse remap operator from intersection weights.
+   *
+   * Row i of the matrix maps source values to the first order value
+   * on target entity i, so that mesh fields can be remapped with a
+   * sparse matrix-vector product (see apply_remap_matrix). The matrix
+   * depends only on the weights and can be kept and reused for any
+   * number of fields. With Real = float the entries are stored in
+   * single precision, which halves the traffic of the products.
+   *
+   * @param[in] sources_and_weights weights for mesh-mesh interpolation
+   * @param[in] gradient_offsets    also store the intersection centroid
+   *                                offsets needed to remap with fixed
+   *                                gradients
+   * @return the remap matrix
+   */
+  template<typename Real = double>
+  RemapMatrix<D, Real>
+  assemble_remap_matrix(Portage::vector<std::vector<Weights_t>> const& sources_and_weights,
+                        bool gradient_offsets = false) const {
+
+    int const nsources = source_mesh_.num_entities(ONWHAT, ALL);
+
+    auto target_volume = [this](int t) {
+      return ONWHAT == CELL ? target_mesh_.cell_volume(t)
+                            : target_mesh_.dual_cell_volume(t);
+    };
+
+    RemapMatrix<D, Real> remap_matrix;
+    if (gradient_offsets) {
+      // the gradient is applied about the source cell centroid or
+      // about the source node, as in Interpolate_2ndOrder
+      auto source_center = [this](int s, Point<D> *center) {
+        if (ONWHAT == CELL)
+          source_mesh_.cell_centroid(s, center);
+        else
+          source_mesh_.node_get_coordinates(s, center);
+      };
+      remap_matrix.template assemble<CoordSys>(sources_and_weights, nsources,
+                                               target_volume,
+                                               num_tols_.min_relative_volume,
+                                               source_center);
+    } else
+      remap_matrix.assemble(sources_and_weights, nsources, target_volume,
+                            num_tols_.min_relative_volume);
+
+    return remap_matrix;
+  }
+
+
+  /**
+   * @brief Remap mesh variables to first order with an assembled remap matrix.
+   *
+   * Gives the same result as interpolate_mesh_var with
+   * Interpolate_1stOrder but replaces the per-entity interpolator calls
+   * by a single sparse product. When several variables are given they
+   * are remapped together with a sparse matrix-matrix product so that
+   * the matrix is streamed only once.
+   *
+   * @param[in] remap_matrix  matrix from assemble_remap_matrix
+   * @param[in] srcvarnames   source mesh variables to remap
+   * @param[in] trgvarnames   target mesh variables to remap
+   * @param[in] lower_bounds  lower bound of each variable when doing fixup
+   * @param[in] upper_bounds  upper bound of each variable when doing fixup
+   * @param[in] partial...    how to fixup partly filled target cells
+   * @param[in] emtpy...      how to fixup empty target cells with this var
+   * @param[in] cons..tol     tolerance for conservation when doing fixup
+   * @param[in] max_fixup_iter maximum number of iterations for mismatch fixup
+   */
+  template<typename T = double, typename Real>
+  void apply_remap_matrix(RemapMatrix<D, Real> const& remap_matrix,
+                          std::vector<std::string> const& srcvarnames,
+                          std::vector<std::string> const& trgvarnames,
+                          std::vector<T> const& lower_bounds,
+                          std::vector<T> const& upper_bounds,
+                          Partial_fixup_type partial_fixup_type = DEFAULT_PARTIAL_FIXUP_TYPE,
+                          Empty_fixup_type empty_fixup_type = DEFAULT_EMPTY_FIXUP_TYPE,
+                          double conservation_tol = DEFAULT_CONSERVATION_TOL,
+                          int max_fixup_iter = DEFAULT_MAX_FIXUP_ITER) {
+
+    assert(srcvarnames.size() == trgvarnames.size());
+    assert(srcvarnames.size() == lower_bounds.size());
+    assert(srcvarnames.size() == upper_bounds.size());
+    assert(remap_matrix.num_cols() == source_mesh_.num_entities(ONWHAT, ALL));
+
+    std::vector<T const*> source_fields;
+    std::vector<T*> target_fields;
+    std::vector<int> fields;  // index of each valid variable in the input lists
+    collect_remap_fields(srcvarnames, trgvarnames,
+                         &source_fields, &target_fields, &fields);
+
+    int const nfields = fields.size();
+    if (nfields == 1)
+      remap_matrix.apply(source_fields[0], target_fields[0]);
+    else if (nfields > 1) {
+      // interleave the fields so that each matrix entry is applied to
+      // all of them at once
+      int const nsources = remap_matrix.num_cols();
+      int const ntargets = remap_matrix.num_rows();
+      std::vector<T> source_block;
+      std::vector<T> target_block(static_cast<size_t>(ntargets)*nfields);
+      T const *tblock = target_block.data();
+
+      pack_components(nsources, source_fields, &source_block);
+
+      remap_matrix.apply(nfields, source_block.data(), target_block.data());
+
+      Portage::for_each(make_counting_iterator(0), make_counting_iterator(ntargets),
+                        [&](int t) {
+                          T const *tvals = tblock + static_cast<size_t>(t)*nfields;
+                          for (int f = 0; f < nfields; f++)
+                            target_fields[f][t] = tvals[f];
+                        });
+    }
+
+    fix_remapped_fields(srcvarnames, trgvarnames, fields,
+                        lower_bounds, upper_bounds,
+                        partial_fixup_type, empty_fixup_type,
+                        conservation_tol, max_fixup_iter);
+  }
+
+
+  /**
+   * @brief Remap mesh variables to second order with an assembled remap matrix.
+   *
+   * The limited gradient of each source variable is computed once, as
+   * Interpolate_2ndOrder does, and applied through the gradient offsets
+   * of the matrix. This gives the same result as interpolate_mesh_var
+   * with Interpolate_2ndOrder while the intersection centroids are read
+   * from the matrix instead of the weights.
+   *
+   * @param[in] remap_matrix  matrix from assemble_remap_matrix with
+   *                          gradient_offsets set
+   * @param[in] srcvarnames   source mesh variables to remap
+   * @param[in] trgvarnames   target mesh variables to remap
+   * @param[in] lower_bounds  lower bound of each variable when doing fixup
+   * @param[in] upper_bounds  upper bound of each variable when doing fixup
+   * @param[in] limiter       limiter to use for the gradients
+   * @param[in] bnd_limiter   limiter to use for the gradients on the boundary
+   * @param[in] partial...    how to fixup partly filled target cells
+   * @param[in] emtpy...      how to fixup empty target cells with this var
+   * @param[in] cons..tol     tolerance for conservation when doing fixup
+   * @param[in] max_fixup_iter maximum number of iterations for mismatch fixup
+   */
+  template<typename T = double, typename Real>
+  void apply_remap_matrix(RemapMatrix<D, Real> const& remap_matrix,
+                          std::vector<std::string> const& srcvarnames,
+                          std::vector<std::string> const& trgvarnames,
+                          std::vector<T> const& lower_bounds,
+                          std::vector<T> const& upper_bounds,
+                          Limiter_type limiter,
+                          Boundary_Limiter_type bnd_limiter,
+                          Partial_fixup_type partial_fixup_type = DEFAULT_PARTIAL_FIXUP_TYPE,
+                          Empty_fixup_type empty_fixup_type = DEFAULT_EMPTY_FIXUP_TYPE,
+                          double conservation_tol = DEFAULT_CONSERVATION_TOL,
+                          int max_fixup_iter = DEFAULT_MAX_FIXUP_ITER) {
+
+    assert(srcvarnames.size() == trgvarnames.size());
+    assert(srcvarnames.size() == lower_bounds.size());
+    assert(srcvarnames.size() == upper_bounds.size());
+    assert(remap_matrix.num_cols() == source_mesh_.num_entities(ONWHAT, ALL));
+    assert(remap_matrix.has_gradient_offsets());
+
+    std::vector<T const*> source_fields;
+    std::vector<T*> target_fields;
+    std::vector<int> fields;  // index of each valid variable in the input lists
+    collect_remap_fields(srcvarnames, trgvarnames,
+                         &source_fields, &target_fields, &fields);
+
+    // Neighbor lists, least squares coefficients and limiter data are
+    // shared with the interpolators
+    SourceMeshData<D>& mesh_data = source_mesh_data_;
+    if (not mesh_data.adjacency)
+      mesh_data.adjacency = make_mesh_adjacency(source_mesh_, ONWHAT);
+    if (not mesh_data.gradient_stencil and
+        std::is_same<CoordSys, Wonton::DefaultCoordSys>::value)
+      mesh_data.gradient_stencil = make_gradient_stencil<D>(source_mesh_, ONWHAT,
+                                                            mesh_data.adjacency);
+    if (not mesh_data.limiter and limiter == BARTH_JESPERSEN)
+      mesh_data.limiter = make_barth_jespersen_limiter<D>(source_mesh_, ONWHAT);
+
+    int const nsources = remap_matrix.num_cols();
+    std::vector<int> source_entities(nsources);
+    std::iota(source_entities.begin(), source_entities.end(), 0);
+    std::vector<Vector<D>> gradients(nsources);
+
+    int const nfields = fields.size();
+    for (int f = 0; f < nfields; f++) {
+      Limited_Gradient<D, ONWHAT, SourceMesh, SourceState,
+                       InterfaceReconstructorType, Matpoly_Splitter,
+                       Matpoly_Clipper, CoordSys, T>
+          limgrad(source_mesh_, source_state_, srcvarnames[fields[f]],
+                  limiter, bnd_limiter, mesh_data.adjacency, mesh_data.limiter);
+      limgrad.set_gradient_stencil(mesh_data.gradient_stencil);
+      limgrad.compute_gradients(nsources, source_entities.data(),
+                                gradients.data());
+
+      remap_matrix.apply(source_fields[f], gradients.data(), target_fields[f]);
     }
+
+    fix_remapped_fields(srcvarnames, trgvarnames, fields,
+                        lower_bounds, upper_bounds,
+                        partial_fixup_type, empty_fixup_type,
+                        conservation_tol, max_fixup_iter);
   }
 
 
@@ -1009,54 +2117,174 @@ class CoreDriver : public CoreDriverBase<D,
                            Empty_fixup_type empty_fixup_type = DEFAULT_EMPTY_FIXUP_TYPE,
                            double conservation_tol = DEFAULT_CONSERVATION_TOL,
                            int max_fixup_iter = DEFAULT_MAX_FIXUP_ITER) {
-    
-    Interpolate<D, ONWHAT, SourceMesh, TargetMesh, SourceState,
-                InterfaceReconstructorType, Matpoly_Splitter, Matpoly_Clipper, CoordSys>
-        interpolator(source_mesh_, target_mesh_, source_state_, num_tols_, interface_reconstructor_);
-      
-    int nmats = source_state_.num_materials();
 
+    using interpolator_t =
+      Interpolate<D, ONWHAT, SourceMesh, TargetMesh, SourceState,
+        InterfaceReconstructorType, Matpoly_Splitter, Matpoly_Clipper, CoordSys>;
+
+    int nmats = source_state_.num_materials();
 
+    // Get a handle to the memory locations where the target state
+    // would like us to write each material's values. State wrappers
+    // may allocate storage in these calls, so they are all made here
+    // rather than from the concurrent material tasks below
+    std::vector<std::vector<int>> matcellstgt(nmats);
+    std::vector<T*> target_fields(nmats, nullptr);
     for (int m = 0; m < nmats; m++) {
+      // if the material has no cells on this partition, then don't bother
+      // interpolating MM variables
+      if (target_state_.mat_get_num_cells(m) == 0) continue;
+      target_state_.mat_get_cells(m, &matcellstgt[m]);
+      target_state_.mat_get_celldata(trgvarname, m, &target_fields[m]);
+      assert (target_fields[m] != nullptr);
+    }
 
-      interpolator.set_material(m);    // We have to do this so we know
-      //                                 // which material values we have
-      //                                 // to grab from the source state
+    // Each material only touches its own cells, so materials are
+    // interpolated as independent tasks with their own interpolator.
+    // The largest material runs first with parallel loops over its
+    // cells and sets up the mesh data (neighbors, limiter vertices)
+    // that the smaller ones, run concurrently, then only read. The
+    // interface reconstruction is complete at this point and is only
+    // queried by the interpolators.
+    auto interpolate_material = [&](int m, bool inner_parallel) {
+      std::vector<int> const& cells = matcellstgt[m];
+      if (cells.empty()) return;
+
+      interpolator_t interpolator(source_mesh_, target_mesh_, source_state_,
+                                  num_tols_, interface_reconstructor_);
+
+      // Have to set interpolation variable AFTER setting the material
+      // for multimaterial variables. Only the first material keeps the
+      // mesh data it builds, the others run concurrently
+      interpolator.set_material(m);
+      set_up_interpolator<T>(interpolator, srcvarname, limiter, bnd_limiter,
+                             inner_parallel);
+
+      if (inner_parallel) {
+        Portage::pointer<T> target_field(target_fields[m]);
+        Portage::transform(cells.begin(), cells.end(),
+                           sources_and_weights_by_mat[m].begin(),
+                           target_field, interpolator);
+      } else {
+        int const ncells = cells.size();
+        for (int i = 0; i < ncells; i++) {
+          std::vector<Weights_t> const& cell_weights = sources_and_weights_by_mat[m][i];
+          target_fields[m][i] = interpolator(cells[i], cell_weights);
+        }
+      }
+    };
 
-      // FEATURE ;-)  Have to set interpolation variable AFTER setting 
-      // the material for multimaterial variables
+    run_tasks(nmats, interpolate_material,
+              [&](int m) { return static_cast<double>(matcellstgt[m].size()); });
 
-      interpolator.set_interpolation_variable(srcvarname, limiter, bnd_limiter);
+    // If the state wrapper knows that the target data is already
+    // laid out in this way and it gave us a pointer to the array
+    // where the values reside, it has to do nothing in this
+    // call. If the storage format is different, however, it may
+    // have to copy the values into their proper locations
+    for (int m = 0; m < nmats; m++)
+      if (target_fields[m])
+        target_state_.mat_add_celldata(trgvarname, m, target_fields[m]);
 
-      // if the material has no cells on this partition, then don't bother
-      // interpolating MM variables
-      if (target_state_.mat_get_num_cells(m) == 0) continue;
+  }  // CoreDriver::interpolate_mat_var
 
-      std::vector<int> matcellstgt;
-      target_state_.mat_get_cells(m, &matcellstgt);
 
-      // Get a handle to a memory location where the target state
-      // would like us to write this material variable into. If it is
-      // NULL, we allocate it ourself
+  /*! CoreDriver::interpolate_mat_var
 
-      T *target_field_raw;
-      target_state_.mat_get_celldata(trgvarname, m, &target_field_raw);
-      assert (target_field_raw != nullptr);
+    @brief interpolate a multi-component material variable
 
-      Portage::pointer<T> target_field(target_field_raw);
+    @param[in] srccomponents  Material variable of each component on the source mesh
 
-      Portage::transform(matcellstgt.begin(), matcellstgt.end(),
-                         sources_and_weights_by_mat[m].begin(),
-                         target_field, interpolator);
+    @param[in] trgcomponents  Material variable of each component on the target mesh
 
-      // If the state wrapper knows that the target data is already
-      // laid out in this way and it gave us a pointer to the array
-      // where the values reside, it has to do nothing in this
-      // call. If the storage format is different, however, it may
-      // have to copy the values into their proper locations
+    The components of each material are interpolated together as in
+    the multi-component interpolate_mesh_var. See the scalar version
+    for the remaining parameters; the fixup parameters are accepted
+    for symmetry but, as there, no fixup is done for material fields.
+  */
+
+  template<typename T = double,
+           template<int, Entity_kind, class, class, class,
+                    template<class, int, class, class> class,
+                    class, class, class> class Interpolate
+           >
+  void interpolate_mat_var(std::vector<std::string> const& srccomponents,
+                           std::vector<std::string> const& trgcomponents,
+                           std::vector<Portage::vector<std::vector<Weights_t>>> const& sources_and_weights_by_mat,
+                           T lower_bound, T upper_bound,
+                           Limiter_type limiter = DEFAULT_LIMITER,
+                           Boundary_Limiter_type bnd_limiter = DEFAULT_BND_LIMITER,
+                           Partial_fixup_type partial_fixup_type = DEFAULT_PARTIAL_FIXUP_TYPE,
+                           Empty_fixup_type empty_fixup_type = DEFAULT_EMPTY_FIXUP_TYPE,
+                           double conservation_tol = DEFAULT_CONSERVATION_TOL,
+                           int max_fixup_iter = DEFAULT_MAX_FIXUP_ITER) {
 
-      target_state_.mat_add_celldata(trgvarname, m, target_field_raw);
-    }  // over all mats
+    assert(srccomponents.size() == trgcomponents.size());
+    int const ncomp = srccomponents.size();
+    if (!ncomp) return;
+
+    using interpolator_t =
+      Interpolate<D, ONWHAT, SourceMesh, TargetMesh, SourceState,
+        InterfaceReconstructorType, Matpoly_Splitter, Matpoly_Clipper, CoordSys>;
+
+    int nmats = source_state_.num_materials();
+
+    // Target storage of each component of each material, fetched up
+    // front as in the scalar version
+    std::vector<std::vector<int>> matcellstgt(nmats);
+    std::vector<std::vector<T*>> target_fields(nmats);
+    for (int m = 0; m < nmats; m++) {
+      if (target_state_.mat_get_num_cells(m) == 0) continue;
+      target_state_.mat_get_cells(m, &matcellstgt[m]);
+      target_fields[m].resize(ncomp);
+      for (int k = 0; k < ncomp; k++) {
+        target_state_.mat_get_celldata(trgcomponents[k], m, &target_fields[m][k]);
+        assert (target_fields[m][k] != nullptr);
+      }
+    }
+
+    // Materials are independent tasks as in the scalar version
+    auto interpolate_material = [&](int m, bool inner_parallel) {
+      std::vector<int> const& cells = matcellstgt[m];
+      int const ncells = cells.size();
+      if (!ncells) return;
+
+      interpolator_t interpolator(source_mesh_, target_mesh_, source_state_,
+                                  num_tols_, interface_reconstructor_);
+
+      // set the material first so that the right component values
+      // are grabbed from the source state
+      interpolator.set_material(m);
+      set_up_interpolator<T>(interpolator, srccomponents, limiter, bnd_limiter,
+                             inner_parallel);
+
+      std::vector<double> target_vals(static_cast<size_t>(ncells)*ncomp);
+      double *packed = target_vals.data();
+      Portage::vector<std::vector<Weights_t>> const& mat_weights =
+          sources_and_weights_by_mat[m];
+
+      auto interpolate_cell = [&](int i) {
+        std::vector<Weights_t> const& cell_weights = mat_weights[i];
+        interpolator(cells[i], cell_weights, packed + static_cast<size_t>(i)*ncomp);
+      };
+      if (inner_parallel)
+        Portage::for_each(make_counting_iterator(0), make_counting_iterator(ncells),
+                          interpolate_cell);
+      else
+        for (int i = 0; i < ncells; i++)
+          interpolate_cell(i);
+
+      for (int k = 0; k < ncomp; k++)
+        for (int i = 0; i < ncells; i++)
+          target_fields[m][k][i] = packed[static_cast<size_t>(i)*ncomp + k];
+    };
+
+    run_tasks(nmats, interpolate_material,
+              [&](int m) { return static_cast<double>(matcellstgt[m].size()); });
+
+    for (int m = 0; m < nmats; m++)
+      for (int k = 0; k < static_cast<int>(target_fields[m].size()); k++)
+        target_state_.mat_add_celldata(trgcomponents[k], m, target_fields[m][k]);
 
   }  // CoreDriver::interpolate_mat_var
 
@@ -1064,6 +2292,174 @@ class CoreDriver : public CoreDriverBase<D,
 
   
  private:
+
+  /**
+   * @brief Number of vertices of the polytope of an entity (the cell,
+   * or the dual cell of a node, approximated by its neighbor nodes).
+   *
+   * @param[in] mesh    source or target mesh wrapper
+   * @param[in] entity  entity of kind ONWHAT
+   * @return the number of vertices, at least 1
+   */
+  template<class Mesh>
+  static double polytope_size(Mesh const& mesh, int entity) {
+    std::vector<int> nodes;
+    if (ONWHAT == CELL)
+      mesh.cell_get_nodes(entity, &nodes);
+    else
+      mesh.node_get_cell_adj_nodes(entity, ALL, &nodes);
+    return std::max(1, static_cast<int>(nodes.size()));
+  }
+
+  /**
+   * @brief Polytope sizes of all source entities of kind ONWHAT, to
+   * weigh intersection candidates without querying the mesh for every
+   * candidate of every target entity.
+   *
+   * @return the polytope size of each source entity
+   */
+  std::vector<double> source_polytope_sizes() const {
+    int const nsources = source_mesh_.num_entities(ONWHAT, ALL);
+    std::vector<double> sizes(nsources);
+    Portage::for_each(make_counting_iterator(0),
+                      make_counting_iterator(nsources),
+                      [&](int s) { sizes[s] = polytope_size(source_mesh_, s); });
+    return sizes;
+  }
+
+  /**
+   * @brief Set the interpolation variable of an interpolator, sharing
+   * the source mesh data with the other interpolators.
+   *
+   * @param[in,out] interpolator  interpolator to set up
+   * @param[in]     variable      source variable (or its components)
+   * @param[in]     limiter       gradient limiter
+   * @param[in]     bnd_limiter   gradient limiter on the boundary
+   * @param[in]     keep          whether to keep what the interpolator
+   *                              builds for the next ones (false for
+   *                              interpolators set up concurrently)
+   */
+  template<typename T, class Interpolator, class Variable>
+  void set_up_interpolator(Interpolator& interpolator, Variable const& variable,
+                           Limiter_type limiter, Boundary_Limiter_type bnd_limiter,
+                           bool keep = true) {
+    interpolator.set_source_mesh_data(source_mesh_data_);
+    interpolator.template set_interpolation_variable<T>(variable, limiter, bnd_limiter);
+    if (keep)
+      source_mesh_data_ = interpolator.source_mesh_data();
+  }
+
+  /**
+   * @brief Gather the source and target data of the mesh variables
+   * remapped with a remap matrix.
+   *
+   * @param[in]  srcvarnames    source mesh variables to remap
+   * @param[in]  trgvarnames    target mesh variables to remap
+   * @param[out] source_fields  source data of each valid variable
+   * @param[out] target_fields  target data of each valid variable
+   * @param[out] fields         index of each valid variable in the lists
+   */
+  template<typename T>
+  void collect_remap_fields(std::vector<std::string> const& srcvarnames,
+                            std::vector<std::string> const& trgvarnames,
+                            std::vector<T const*> *source_fields,
+                            std::vector<T*> *target_fields,
+                            std::vector<int> *fields) const {
+    int const nvars = srcvarnames.size();
+    for (int i = 0; i < nvars; i++) {
+      if (source_state_.get_entity(srcvarnames[i]) != ONWHAT or
+          source_state_.field_type(ONWHAT, srcvarnames[i]) != Field_type::MESH_FIELD) {
+        std::cerr << "Variable " << srcvarnames[i] << " is not a mesh field on "
+                  << "Entity_kind " << ONWHAT << ". Skipping!" << std::endl;
+        continue;
+      }
+
+      T const* source_mesh_field = nullptr;
+      source_state_.mesh_get_data(ONWHAT, srcvarnames[i], &source_mesh_field);
+      T* target_mesh_field = nullptr;
+      target_state_.mesh_get_data(ONWHAT, trgvarnames[i], &target_mesh_field);
+
+      source_fields->push_back(source_mesh_field);
+      target_fields->push_back(target_mesh_field);
+      fields->push_back(i);
+    }
+  }
+
+  /**
+   * @brief Fix the mismatch of several remapped mesh variables, all
+   * fields together so that they share the global reductions.
+   *
+   * See interpolate_mesh_vars for the parameters; fields holds the
+   * index of each remapped variable in the input lists.
+   */
+  template<typename T>
+  void fix_remapped_fields(std::vector<std::string> const& srcvarnames,
+                           std::vector<std::string> const& trgvarnames,
+                           std::vector<int> const& fields,
+                           std::vector<T> const& lower_bounds,
+                           std::vector<T> const& upper_bounds,
+                           Partial_fixup_type partial_fixup_type,
+                           Empty_fixup_type empty_fixup_type,
+                           double conservation_tol,
+                           int max_fixup_iter) {
+    int const nfields = fields.size();
+    assert(mismatch_fixer_ && "check_mesh_mismatch must be called first");
+    if (mismatch_fixer_->has_mismatch()) {
+      // fix all fields together so that they share global reductions
+      std::vector<std::string> src_fixvars(nfields), trg_fixvars(nfields);
+      std::vector<double> lower_fixbounds(nfields), upper_fixbounds(nfields);
+      for (int f = 0; f < nfields; f++) {
+        int const i = fields[f];
+        src_fixvars[f] = srcvarnames[i];
+        trg_fixvars[f] = trgvarnames[i];
+        lower_fixbounds[f] = lower_bounds[i];
+        upper_fixbounds[f] = upper_bounds[i];
+      }
+      mismatch_fixer_->template fix_mismatch<T>(src_fixvars, trg_fixvars,
+                                                lower_fixbounds, upper_fixbounds,
+                                                conservation_tol, max_fixup_iter,
+                                                partial_fixup_type, empty_fixup_type);
+    }
+  }
+
+  /**
+   * @brief Interpolate a mesh field on the entities of a target part.
+   *
+   * @param[in]  interpolator       interpolator set up for the field
+   * @param[in]  partition          part pair
+   * @param[in]  parts_weights      weights of the target part entities
+   *                                restricted to the source part
+   * @param[out] target_mesh_field  field values on the whole target mesh
+   * @param[in]  parallel           whether to loop over entities in parallel
+   *
+   * Values are written straight to their place in the target mesh
+   * field, so no buffer of the size of the part is needed.
+   */
+  template<typename T, class Interpolator>
+  void interpolate_part(Interpolator const& interpolator,
+                        PartPair<D, ONWHAT,
+                                 SourceMesh, SourceState,
+                                 TargetMesh, TargetState> const& partition,
+                        Portage::vector<std::vector<Weights_t>> const& parts_weights,
+                        T* target_mesh_field, bool parallel = true) const {
+    auto const& part_target_entities = partition.get_target_entities();
+    int const target_part_size = partition.target_part_size();
+    assert(static_cast<int>(parts_weights.size()) == target_part_size);
+
+    auto interpolate_entity = [&](int i) {
+      int const entity = part_target_entities[i];
+      target_mesh_field[entity] = interpolator(entity, parts_weights[i]);
+    };
+
+    if (parallel)
+      Portage::for_each(make_counting_iterator(0),
+                        make_counting_iterator(target_part_size),
+                        interpolate_entity);
+    else
+      for (int i = 0; i < target_part_size; i++)
+        interpolate_entity(i);
+  }
+
   SourceMesh const & source_mesh_;
   TargetMesh const & target_mesh_;
   SourceState const & source_state_;
@@ -1071,6 +2467,12 @@ class CoreDriver : public CoreDriverBase<D,
 
   NumericTolerances_t num_tols_;
 
+  // Whether the meshes are known to be made of axis-aligned boxes
+  bool rectangular_mesh_ = false;
+
+  // Highest degree of the intersection moments
+  int moment_order_ = 1;
+
   int comm_rank_ = 0;
   int nprocs_ = 1;
 
@@ -1083,6 +2485,15 @@ class CoreDriver : public CoreDriverBase<D,
                                 SourceMesh, SourceState,
                                 TargetMesh, TargetState>> mismatch_fixer_;
 
+  // Thread utilization of the last intersection step
+  ScheduleStats_t intersect_stats_;
+
+  // Neighbor lists, stencils and limiter data of the source mesh,
+  // built by the first interpolator that needs them and then shared by
+  // all the others, and the material moments gathered after interface
+  // reconstruction
+  SourceMeshData<D> source_mesh_data_;
+
 #ifdef HAVE_TANGRAM
 
   // Pointer to the interface reconstructor object (required by the
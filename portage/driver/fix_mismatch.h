@@ -9,7 +9,9 @@ Please see the license file at the root of this repository, or at:
 
 #include <sys/time.h>
 
+#include <cstdint>
 #include <algorithm>
+#include <cmath>
 #include <vector>
 #include <iterator>
 #include <unordered_set>
@@ -21,6 +23,7 @@ Please see the license file at the root of this repository, or at:
 #include <numeric>
 
 #include "portage/support/portage.h"
+#include "portage/support/mesh_adjacency.h"
 
 /*!
   @file detect_mismatch.h
@@ -42,9 +45,26 @@ using Wonton::Weights_t;
 // calculation, 0 means this entity has been encountered on a previous
 // processor. This is useful for meshes where the partitioning of cells
 // on ranks is not mutually exclusive.
+//
+// Rather than gathering the global IDs of all ranks everywhere, each
+// global ID is hashed to a "home" rank. Every rank sends the global
+// IDs of its entities to their homes, which keep the first instance
+// in rank order (and, within a rank, in entity order) and send back
+// whether each instance is that first one. Memory and work per rank
+// are then proportional to the number of local entities rather than
+// to the number of ranks times the largest partition.
 
 #ifdef PORTAGE_ENABLE_MPI
 
+// Rank responsible for deciding which instance of a global ID is kept
+
+inline int global_id_home_rank(int gid, int nprocs) {
+  // multiplicative hash so that contiguous ranges of IDs are spread
+  // over all ranks
+  uint64_t const h = static_cast<uint64_t>(static_cast<uint32_t>(gid))*2654435761ULL;
+  return static_cast<int>((h >> 16) % static_cast<uint64_t>(nprocs));
+}
+
 template<Entity_kind onwhat, class Mesh_Wrapper>
 void get_unique_entity_masks(Mesh_Wrapper const &mesh,
                              std::vector<int> *unique_mask,
@@ -55,44 +75,64 @@ void get_unique_entity_masks(Mesh_Wrapper const &mesh,
   MPI_Comm_rank(mycomm, &rank);
   MPI_Comm_size(mycomm, &nprocs);
 
-
-  // collect source and target cell volumes because we will need it
-  // a few times for each variable we process
-
   int nents = (onwhat == Entity_kind::CELL) ?
       mesh.num_owned_cells() : mesh.num_owned_nodes();
 
   unique_mask->resize(nents, 1);
 
   if (nprocs > 1) {
-    std::vector<int> nents_all(nprocs, 0);
-    MPI_Allgather(&nents, 1, MPI_INT, &(nents_all[0]), 1, MPI_INT, mycomm);
-    int maxents = *std::max_element(nents_all.begin(), nents_all.end());
-
-    std::vector<int> gids(maxents, -1);
-    for (int e = 0; e < nents; e++)
+    // Bucket the global IDs of our entities by home rank, keeping
+    // entity order within each bucket
+    std::vector<int> gids(nents), home(nents);
+    std::vector<int> sendcounts(nprocs, 0);
+    for (int e = 0; e < nents; e++) {
       gids[e] = mesh.get_global_id(e, onwhat);
+      home[e] = global_id_home_rank(gids[e], nprocs);
+      sendcounts[home[e]]++;
+    }
 
-    std::vector<int> gids_all(nprocs*maxents);
-    MPI_Allgather(&(gids[0]), maxents, MPI_INT, &(gids_all[0]), maxents,
-                  MPI_INT, mycomm);
+    std::vector<int> senddispls(nprocs+1, 0);
+    for (int p = 0; p < nprocs; p++)
+      senddispls[p+1] = senddispls[p] + sendcounts[p];
 
-    // Add gids from all lower ranks into a set (no duplicates)
+    std::vector<int> sendgids(nents), position(nents);
+    {
+      std::vector<int> next(senddispls.begin(), senddispls.end()-1);
+      for (int e = 0; e < nents; e++) {
+        position[e] = next[home[e]]++;
+        sendgids[position[e]] = gids[e];
+      }
+    }
+
+    std::vector<int> recvcounts(nprocs);
+    MPI_Alltoall(sendcounts.data(), 1, MPI_INT, recvcounts.data(), 1, MPI_INT,
+                 mycomm);
+
+    std::vector<int> recvdispls(nprocs+1, 0);
+    for (int p = 0; p < nprocs; p++)
+      recvdispls[p+1] = recvdispls[p] + recvcounts[p];
+
+    std::vector<int> recvgids(recvdispls[nprocs]);
+    MPI_Alltoallv(sendgids.data(), sendcounts.data(), senddispls.data(), MPI_INT,
+                  recvgids.data(), recvcounts.data(), recvdispls.data(), MPI_INT,
+                  mycomm);
 
+    // The receive buffer is ordered by sending rank, so the first
+    // instance of a global ID in it is the one to keep
+    std::vector<int> recvmasks(recvgids.size());
     std::unordered_set<int> unique_gids;
-    for (int p = 0; p < rank; p++)
-      for (int e = 0; e < nents_all[p]; e++) {
-        int gid = gids_all[p*maxents+e];
-        unique_gids.insert(gid);
-      }
+    unique_gids.reserve(recvgids.size());
+    for (size_t i = 0; i < recvgids.size(); i++)
+      recvmasks[i] = unique_gids.insert(recvgids[i]).second ? 1 : 0;
 
-    // Now go through gids of this rank and mask the ones that are already
-    // occurring in other ranks.
-    for (int e = 0; e < nents; e++) {
-      auto itpair = unique_gids.insert(gids[e]);
-      if (!itpair.second)
-        (*unique_mask)[e] = 0;  // ent already in set; mask this instance
-    }
+    // Send the verdicts back along the reverse route
+    std::vector<int> sendmasks(nents);
+    MPI_Alltoallv(recvmasks.data(), recvcounts.data(), recvdispls.data(), MPI_INT,
+                  sendmasks.data(), sendcounts.data(), senddispls.data(), MPI_INT,
+                  mycomm);
+
+    for (int e = 0; e < nents; e++)
+      (*unique_mask)[e] = sendmasks[position[e]];
   }
 }  // get_unique_entity_masks
 
@@ -100,6 +140,360 @@ void get_unique_entity_masks(Mesh_Wrapper const &mesh,
 
 
 
+// Helpers for the bounded shift of the conservative mismatch fixup
+//
+// SHIFTED_CONSERVATIVE repair subtracts the same amount s from every
+// adjustable entity, clipping values that would cross a bound, so that
+// the integral of the target field
+//
+//   F(s) = sum_t V_t min(max(u_t - s, lower), upper)
+//
+// (plus that of the entities that are not adjusted) matches the source
+// integral. F is non-increasing and piecewise linear in s, with a
+// breakpoint wherever an entity reaches a bound (s = u_t - lower or
+// s = u_t - upper). Shifting by the discrepancy per unit volume and
+// then re-shifting the entities that are still free converges slowly
+// when many entities hit the bounds, each iteration sweeping the mesh
+// and reducing over all ranks. Instead, the root of F(s) = source
+// integral is bracketed by a multi-way selection on the breakpoints:
+// each round evaluates F at a handful of shifts in one pass over the
+// entities whose breakpoints lie in the current bracket (and one
+// global reduction), after which entities with breakpoints outside the
+// narrowed bracket are either clipped or free for good and are only
+// accounted for through their sums. Once the root is known to lie in a
+// single linear piece it is solved for exactly.
+
+/*!
+  @class ClippedIntegral fix_mismatch.h
+  @brief Integral of a field shifted by s and clipped to its bounds,
+  evaluated over a shrinking bracket of shifts
+*/
+
+class ClippedIntegral {
+ public:
+
+  /// Number of values returned per shift by evaluate
+  static constexpr int NVALS = 4;
+
+  /*!
+    @brief Set up the clipped integral of a field
+    @param[in] values   Unshifted values of the adjustable entities
+    @param[in] volumes  Volumes of the adjustable entities
+    @param[in] lower    Lower bound (none if infinite or -max double)
+    @param[in] upper    Upper bound (none if infinite or max double)
+    @param[in] fixed    Integral over the entities that are not adjusted
+  */
+  ClippedIntegral(std::vector<double> values, double const *volumes,
+                  double lower, double upper, double fixed)
+      : values_(std::move(values)), volumes_(volumes),
+        lower_(lower), upper_(upper), fixed_(fixed) {
+    int const nentities = values_.size();
+    for (int e = 0; e < nentities; e++) {
+      volume_ += volumes_[e];
+      integral_ += volumes_[e]*values_[e];
+    }
+    if (is_bound(lower)) {
+      lower_.candidates.resize(nentities);
+      std::iota(lower_.candidates.begin(), lower_.candidates.end(), 0);
+    }
+    if (is_bound(upper)) {
+      upper_.candidates.resize(nentities);
+      std::iota(upper_.candidates.begin(), upper_.candidates.end(), 0);
+    }
+  }
+
+  /// Whether a bound can actually clip values
+  static bool is_bound(double bound) {
+    return std::isfinite(bound) &&
+        std::fabs(bound) < std::numeric_limits<double>::max();
+  }
+
+  /*!
+    @brief Restrict the shifts of interest to [sl, sr]
+
+    The entities of which a breakpoint falls outside are dropped from
+    the candidates (on the next evaluation, so as not to make another
+    pass over them), after adding their contribution to the sums of
+    entities clipped over the whole bracket if need be.
+  */
+  void narrow(double sl, double sr) {
+    bracket_ = {sl, sr};
+    narrowed_ = true;
+  }
+
+  /*!
+    @brief Evaluate the clipped integral for shifts within the bracket
+    @param[in]  shifts  Increasing shifts
+    @param[out] vals    For each shift, the integral, the volume of the
+                        entities that are not clipped (minus the slope
+                        of the integral) and the numbers of entities
+                        clipped to the lower and to the upper bound
+  */
+  void evaluate(std::vector<double> const& shifts, double *vals) {
+    int const npoints = shifts.size();
+    double const sl = bracket_.first, sr = bracket_.second;
+
+    // Sums over the candidates clipped at each shift (V, V*u, count),
+    // binned by the first (lower) or last (upper) shift they are
+    // clipped at and then accumulated over the bins
+
+    // clipped to the lower bound if s > u - lower
+    std::vector<double> lower_sums(3*(npoints+1), 0.0);
+    sweep(&lower_, [&](double brk) {
+      return (brk < sl) ? CLIPPED : ((brk >= sr) ? FREE : UNDECIDED);
+    }, [&](int e, double brk) {
+      int const k = std::upper_bound(shifts.begin(), shifts.end(), brk) -
+          shifts.begin();
+      lower_sums[3*k] += volumes_[e];
+      lower_sums[3*k+1] += volumes_[e]*values_[e];
+      lower_sums[3*k+2] += 1;
+    });
+
+    // clipped to the upper bound if s < u - upper
+    std::vector<double> upper_sums(3*(npoints+1), 0.0);
+    sweep(&upper_, [&](double brk) {
+      return (brk > sr) ? CLIPPED : ((brk <= sl) ? FREE : UNDECIDED);
+    }, [&](int e, double brk) {
+      int const k = std::lower_bound(shifts.begin(), shifts.end(), brk) -
+          shifts.begin();
+      upper_sums[3*k] += volumes_[e];
+      upper_sums[3*k+1] += volumes_[e]*values_[e];
+      upper_sums[3*k+2] += 1;
+    });
+    narrowed_ = false;
+
+    for (int k = 1; k <= npoints; k++)
+      for (int j = 0; j < 3; j++)
+        lower_sums[3*k+j] += lower_sums[3*(k-1)+j];
+    for (int k = npoints-1; k >= 0; k--)
+      for (int j = 0; j < 3; j++)
+        upper_sums[3*k+j] += upper_sums[3*(k+1)+j];
+
+    int const nentities = values_.size();
+    for (int k = 0; k < npoints; k++) {
+      // lower: bins 0..k, upper: bins k+1..npoints
+      double const lower_vol = lower_.volume + lower_sums[3*k];
+      double const lower_int = lower_.integral + lower_sums[3*k+1];
+      double const lower_cnt = lower_.count + lower_sums[3*k+2];
+      double const upper_vol = upper_.volume + upper_sums[3*(k+1)];
+      double const upper_int = upper_.integral + upper_sums[3*(k+1)+1];
+      double const upper_cnt = upper_.count + upper_sums[3*(k+1)+2];
+
+      double const free_volume = (lower_cnt + upper_cnt == nentities) ? 0.0 :
+          volume_ - lower_vol - upper_vol;
+      double clipped = fixed_ + integral_ - lower_int - upper_int -
+          shifts[k]*free_volume;
+      if (lower_cnt) clipped += lower_.bound*lower_vol;
+      if (upper_cnt) clipped += upper_.bound*upper_vol;
+
+      double *v = vals + k*NVALS;
+      v[0] = clipped;
+      v[1] = free_volume;
+      v[2] = lower_cnt;
+      v[3] = upper_cnt;
+    }
+  }
+
+ private:
+
+  enum Status {CLIPPED, FREE, UNDECIDED};
+
+  struct Side {
+    explicit Side(double b) : bound(b) {}
+    double bound;
+    std::vector<int> candidates;  // undecided over the bracket
+    // sums over the entities clipped over the whole bracket
+    double volume = 0.0, integral = 0.0;
+    int count = 0;
+  };
+
+  // Pass over the candidates of a side, first dropping those decided
+  // over a newly narrowed bracket
+  template<class Classify, class Visit>
+  void sweep(Side *side, Classify classify, Visit visit) {
+    int nkept = 0;
+    for (int e : side->candidates) {
+      double const brk = values_[e] - side->bound;
+      if (narrowed_) {
+        Status const status = classify(brk);
+        if (status == CLIPPED) {
+          side->volume += volumes_[e];
+          side->integral += volumes_[e]*values_[e];
+          side->count++;
+          continue;
+        } else if (status == FREE) {
+          continue;
+        }
+      }
+      side->candidates[nkept++] = e;
+      visit(e, brk);
+    }
+    side->candidates.resize(nkept);
+  }
+
+  std::vector<double> values_;
+  double const *volumes_;
+  Side lower_, upper_;
+  double fixed_;
+  double volume_ = 0.0, integral_ = 0.0;
+  std::pair<double, double> bracket_ = {-std::numeric_limits<double>::infinity(),
+                                       std::numeric_limits<double>::infinity()};
+  bool narrowed_ = false;  // candidates not yet filtered by the bracket
+};
+
+
+/*!
+  @brief Find the shifts that make clipped fields conservative
+  @param[in,out] integrals      Clipped integral of each field on this rank
+  @param[in]  extremes          Smallest and largest breakpoints of each
+                                field over all ranks
+  @param[in]  source_integrals  Global integral each field should have
+  @param[in]  conservation_tol  Relative tolerance on the integrals
+  @param[in]  maxrounds         Maximum number of bracketing rounds
+  @param[in]  sum_all           Functor (double*, int) summing values over
+                                all ranks in place
+  @param[in,out] shifts         Shift of each field, on input the
+                                unclipped one (discrepancy per unit volume)
+
+  All fields are bracketed together so that each round costs a single
+  reduction. If the root of a field is not isolated within maxrounds,
+  its shift is interpolated within the final bracket.
+*/
+
+template<class SumAll>
+void find_bounded_shifts(std::vector<ClippedIntegral> *integrals,
+                         std::vector<std::pair<double, double>> const& extremes,
+                         std::vector<double> const& source_integrals,
+                         double conservation_tol, int maxrounds,
+                         SumAll sum_all, std::vector<double> *shifts) {
+
+  constexpr int NPOINTS = 8;  // shifts evaluated per field and round
+  constexpr int NVALS = ClippedIntegral::NVALS;
+
+  struct Sample {
+    double s;
+    double vals[NVALS];
+  };
+
+  int const nvars = integrals->size();
+
+  auto converged = [&](int i, Sample const& sample) {
+    double const reldiff =
+        (sample.vals[0] - source_integrals[i])/source_integrals[i];
+    return !(std::fabs(reldiff) > conservation_tol);
+  };
+
+  // Shift at which the integral reaches the source integral assuming
+  // it is linear about a sample
+  auto linear_root = [&](int i, Sample const& sample) {
+    double const free_volume = sample.vals[1];
+    return (free_volume > 0.0) ?
+        sample.s + (sample.vals[0] - source_integrals[i])/free_volume :
+        sample.s;
+  };
+
+  // Beyond the extreme breakpoints the integral is linear
+  std::vector<int> searching;
+  for (int i = 0; i < nvars; i++)
+    if (extremes[i].first <= extremes[i].second)
+      searching.push_back(i);
+
+  std::vector<Sample> left(nvars), right(nvars);
+  std::vector<std::vector<double>> points(nvars);
+  std::vector<double> evals;
+  for (int round = 0; round < maxrounds && !searching.empty(); round++) {
+    int const nsearching = searching.size();
+
+    // The first round spans all breakpoints and includes the unclipped
+    // shift, later ones the bracket of the root, including its regula
+    // falsi estimate and the linear extrapolations from both ends (the
+    // integral is close to linear over a bracket with many small
+    // pieces)
+    for (int i : searching) {
+      std::vector<double>& s = points[i];
+      s.resize(NPOINTS);
+      if (round == 0) {
+        double const smin = extremes[i].first, smax = extremes[i].second;
+        for (int k = 0; k < NPOINTS-1; k++)
+          s[k] = smin + (smax - smin)*k/(NPOINTS - 2);
+        s[NPOINTS-2] = smax;
+        s[NPOINTS-1] = std::min(std::max((*shifts)[i], smin), smax);
+      } else {
+        double const sl = left[i].s, sr = right[i].s;
+        double const fl = left[i].vals[0], fr = right[i].vals[0];
+        s[0] = sl + (sr - sl)*(fl - source_integrals[i])/(fl - fr);
+        s[1] = std::min(linear_root(i, left[i]), sr);
+        s[2] = std::max(linear_root(i, right[i]), sl);
+        for (int k = 3; k < NPOINTS; k++)
+          s[k] = sl + (sr - sl)*(k-2)/(NPOINTS-2);
+      }
+      std::sort(s.begin(), s.end());
+    }
+
+    evals.resize(nsearching*NPOINTS*NVALS);
+    for (int a = 0; a < nsearching; a++) {
+      int const i = searching[a];
+      (*integrals)[i].evaluate(points[i], &(evals[a*NPOINTS*NVALS]));
+    }
+    sum_all(evals.data(), nsearching*NPOINTS*NVALS);
+
+    std::vector<int> still_searching;
+    for (int a = 0; a < nsearching; a++) {
+      int const i = searching[a];
+      std::vector<Sample> samples(NPOINTS);
+      for (int k = 0; k < NPOINTS; k++) {
+        samples[k].s = points[i][k];
+        std::copy_n(&(evals[(a*NPOINTS+k)*NVALS]), NVALS, samples[k].vals);
+      }
+      if (round > 0) {
+        samples.insert(samples.begin(), left[i]);
+        samples.push_back(right[i]);
+      }
+
+      auto hit = std::find_if(samples.begin(), samples.end(),
+                              [&](Sample const& p) { return converged(i, p); });
+      if (hit != samples.end()) {
+        (*shifts)[i] = hit->s;
+        continue;
+      }
+
+      double const source_integral = source_integrals[i];
+      if (source_integral > samples.front().vals[0]) {
+        (*shifts)[i] = linear_root(i, samples.front());
+        continue;
+      }
+      if (source_integral < samples.back().vals[0]) {
+        (*shifts)[i] = linear_root(i, samples.back());
+        continue;
+      }
+
+      int j = 0;
+      while (samples[j+1].vals[0] > source_integral) j++;
+
+      // No breakpoint in between if no entity got clipped or unclipped
+      if (samples[j].vals[2] == samples[j+1].vals[2] &&
+          samples[j].vals[3] == samples[j+1].vals[3]) {
+        (*shifts)[i] = linear_root(i, samples[j]);
+        continue;
+      }
+
+      left[i] = samples[j];
+      right[i] = samples[j+1];
+      (*integrals)[i].narrow(left[i].s, right[i].s);
+      still_searching.push_back(i);
+    }
+    searching.swap(still_searching);
+  }
+
+  for (int i : searching) {
+    double const sl = left[i].s, sr = right[i].s;
+    double const fl = left[i].vals[0], fr = right[i].vals[0];
+    (*shifts)[i] = sl + (sr - sl)*(fl - source_integrals[i])/(fl - fr);
+  }
+}  // find_bounded_shifts
+
+
+
 // Check if we have mismatch of mesh boundaries
 // T is the target mesh, S is the source mesh
 // T_i is the i'th cell of the target mesh and
@@ -350,41 +744,80 @@ class MismatchFixer {
     }
     
     if (nempty) {
-      layernum_.resize(ntargetents_, 0);
-
-      int nlayers = 0;
-      int ntagged = 0, old_ntagged = -1;
-      while (ntagged < nempty && ntagged > old_ntagged) {
-        old_ntagged = ntagged;
+      // The neighbors of empty entities are visited while building
+      // the layers and again for every field that gets fixed up, so
+      // gather them once. Only owned neighbors carry remapped values
+      empty_neighbors_ = MeshAdjacency(ntargetents_,
+                                       [&](int t, std::vector<int> *nbrs) {
+        if (!is_cell_empty_[t]) return;
+        if (onwhat == Entity_kind::CELL)
+          target_mesh_.cell_get_node_adj_cells(t, Entity_type::PARALLEL_OWNED,
+                                               nbrs);
+        else
+          target_mesh_.node_get_cell_adj_nodes(t, Entity_type::PARALLEL_OWNED,
+                                               nbrs);
+      });
+
+      // Breadth first search out from the covered entities. The first
+      // layer is made of the empty entities with a covered neighbor
+      // and each following layer of the untagged empty neighbors of
+      // the previous one (the adjacency is symmetric), so only the
+      // current frontier is visited at each step. Neighbors of the
+      // frontier are scanned in parallel, each frontier entity writing
+      // to its own slots; the new layer is then tagged in a short
+      // serial pass in the order its entities were found
 
-        std::vector<int> curlayerents;
+      layernum_.resize(ntargetents_, 0);
 
-        for (int ent : emptyents) {
-          if (layernum_[ent] != 0) continue;
+      std::vector<char> next_to_covered(nempty);
+      Portage::for_each(make_counting_iterator(0),
+                        make_counting_iterator(nempty),
+                        [&](int i) {
+                          next_to_covered[i] = 0;
+                          for (int nbr : empty_neighbors_[emptyents[i]])
+                            if (!is_cell_empty_[nbr]) {
+                              next_to_covered[i] = 1;
+                              break;
+                            }
+                        });
+
+      std::vector<int> frontier;
+      for (int i = 0; i < nempty; i++)
+        if (next_to_covered[i]) {
+          layernum_[emptyents[i]] = 1;
+          frontier.push_back(emptyents[i]);
+        }
 
-          std::vector<int> nbrs;
-          if (onwhat == Entity_kind::CELL)
-            target_mesh_.cell_get_node_adj_cells(ent, Entity_type::ALL, &nbrs);
-          else
-            target_mesh_.node_get_cell_adj_nodes(ent, Entity_type::ALL, &nbrs);
-          for (int nbr : nbrs)
-            if (!is_cell_empty_[nbr] || layernum_[nbr] != 0) {
-              // At least one neighbor has some material or will
-              // receive some material (indicated by having a +ve
-              // layer number)
-
-              curlayerents.push_back(ent);
-              break;
-            }
-        }  // for (ent in emptyents)
+      int nlayers = 0;
+      std::vector<int> slots, found;
+      while (!frontier.empty()) {
+        nlayers++;
 
-        // Tag the current layer cells with the next layer number
-        for (int ent : curlayerents)
-          layernum_[ent] = nlayers+1;
-        ntagged += curlayerents.size();
+        int const nfrontier = frontier.size();
+        slots.resize(nfrontier + 1);
+        slots[0] = 0;
+        for (int i = 0; i < nfrontier; i++)
+          slots[i+1] = slots[i] + empty_neighbors_.num_neighbors(frontier[i]);
+
+        found.assign(slots[nfrontier], -1);
+        Portage::for_each(make_counting_iterator(0),
+                          make_counting_iterator(nfrontier),
+                          [&](int i) {
+                            int k = slots[i];
+                            for (int nbr : empty_neighbors_[frontier[i]])
+                              if (is_cell_empty_[nbr] && layernum_[nbr] == 0)
+                                found[k++] = nbr;
+                          });
+
+        std::vector<int> nextlayer;
+        for (int ent : found)
+          if (ent >= 0 && layernum_[ent] == 0) {
+            layernum_[ent] = nlayers+1;
+            nextlayer.push_back(ent);
+          }
 
-        emptylayers_.push_back(curlayerents);
-        nlayers++;
+        emptylayers_.push_back(std::move(frontier));
+        frontier = std::move(nextlayer);
       }
     }  // if nempty
 
@@ -398,6 +831,16 @@ class MismatchFixer {
   bool has_mismatch() const {return mismatch_;}
 
 
+  // layer of an empty target entity counted out from the covered ones
+  // (1 next to a covered entity, 0 if the entity is not empty)
+
+  int empty_layer(int t) const {return layernum_.empty() ? 0 : layernum_[t];}
+
+  // number of layers of empty target entities
+
+  int num_empty_layers() const {return emptylayers_.size();}
+
+
 
 
   /// @brief Repair the remapped field to account for boundary mismatch
@@ -430,6 +873,7 @@ class MismatchFixer {
   /// EXTRAPOLATE - Fill empty cells with extrapolated values
   /// FILL        - Fill empty cells with specified values (not yet implemented)
 
+  template<typename T = double>
   bool fix_mismatch(std::string const & src_var_name,
                     std::string const & trg_var_name,
                     double global_lower_bound = -std::numeric_limits<double>::max(),
@@ -444,16 +888,68 @@ class MismatchFixer {
 
     if (source_state_.field_type(onwhat, src_var_name) ==
         Field_type::MESH_FIELD)
-      return fix_mismatch_meshvar(src_var_name, trg_var_name,
-                                  global_lower_bound, global_upper_bound,
-                                  conservation_tol, maxiter,
-                                  partial_fixup_type, empty_fixup_type);
+      return fix_mismatch_meshvar<T>(src_var_name, trg_var_name,
+                                     global_lower_bound, global_upper_bound,
+                                     conservation_tol, maxiter,
+                                     partial_fixup_type, empty_fixup_type);
     return false;
   }
 
 
+  /// @brief Repair several remapped fields to account for boundary mismatch
+  /// @param src_var_names        field variables on source mesh
+  /// @param trg_var_names        field variables on target mesh
+  /// @param global_lower_bounds  lower limit on each variable
+  /// @param global_upper_bounds  upper limit on each variable
+  /// @param partial_fixup_type   type of fixup in case of partial mismatch
+  /// @param empty_fixup_type     type of fixup in empty target entities
+  ///
+  /// Same as calling fix_mismatch for each pair of variables, except
+  /// that the global sums needed by the fixup of all mesh variables are
+  /// gathered in a few collective calls instead of several per variable
+  /// (see fix_mismatch_meshvars). Variables that are not mesh fields
+  /// are skipped. Returns false if the fixup of any variable failed.
+
+  template<typename T = double>
+  bool fix_mismatch(std::vector<std::string> const & src_var_names,
+                    std::vector<std::string> const & trg_var_names,
+                    std::vector<double> const & global_lower_bounds,
+                    std::vector<double> const & global_upper_bounds,
+                    double conservation_tol = 1e2*std::numeric_limits<double>::epsilon(),
+                    int maxiter = 5,
+                    Partial_fixup_type partial_fixup_type =
+                    Partial_fixup_type::SHIFTED_CONSERVATIVE,
+                    Empty_fixup_type empty_fixup_type =
+                    Empty_fixup_type::EXTRAPOLATE) {
+
+    std::vector<std::string> src_mesh_vars, trg_mesh_vars;
+    std::vector<double> lower_bounds, upper_bounds;
+    int const nvars = src_var_names.size();
+    for (int i = 0; i < nvars; i++) {
+      if (source_state_.field_type(onwhat, src_var_names[i]) ==
+          Field_type::MESH_FIELD) {
+        src_mesh_vars.push_back(src_var_names[i]);
+        trg_mesh_vars.push_back(trg_var_names[i]);
+        lower_bounds.push_back(global_lower_bounds[i]);
+        upper_bounds.push_back(global_upper_bounds[i]);
+      }
+    }
+
+    if (src_mesh_vars.empty())
+      return false;
+    return fix_mismatch_meshvars<T>(src_mesh_vars, trg_mesh_vars,
+                                    lower_bounds, upper_bounds,
+                                    conservation_tol, maxiter,
+                                    partial_fixup_type, empty_fixup_type);
+  }
+
+
   /// @brief Repair a remapped mesh field to account for boundary mismatch
+  ///
+  /// The field may be stored as double or float (T); the integrals
+  /// checked for conservation are always accumulated in double
 
+  template<typename T = double>
   bool fix_mismatch_meshvar(std::string const & src_var_name,
                             std::string const & trg_var_name,
                             double global_lower_bound,
@@ -464,173 +960,208 @@ class MismatchFixer {
                             Partial_fixup_type::SHIFTED_CONSERVATIVE,
                             Empty_fixup_type empty_fixup_type =
                             Empty_fixup_type::EXTRAPOLATE) {
+    return fix_mismatch_meshvars<T>({src_var_name}, {trg_var_name},
+                                    {global_lower_bound}, {global_upper_bound},
+                                    conservation_tol, maxiter,
+                                    partial_fixup_type, empty_fixup_type);
+  }
 
-    static bool hit_lobound = false, hit_hibound = false;
-    
-    // Now process remap variables
-    double const *source_data;
-    source_state_.mesh_get_data(onwhat, src_var_name, &source_data);
 
-    double *target_data;
-    target_state_.mesh_get_data(onwhat, trg_var_name, &target_data);
+  /// @brief Repair several remapped mesh fields to account for boundary
+  /// mismatch
+  ///
+  /// The conservative (SHIFTED_CONSERVATIVE) fixup needs global sums of
+  /// the source and target integrals of each field, of the covered
+  /// target volume and, at each repair iteration, of the new target
+  /// integral and of the volume still free to be adjusted. On many ranks
+  /// these small reductions are latency bound, so rather than reducing
+  /// them one variable at a time, the values of all variables are packed
+  /// in one vector per stage. The source integrals do not depend on the
+  /// fixup of empty and partially filled entities, so their reduction
+  /// is started before it and proceeds while the target fields are
+  /// being filled in. Repair iterations only involve the variables that
+  /// have not yet converged.
+
+  template<typename T = double>
+  bool fix_mismatch_meshvars(std::vector<std::string> const & src_var_names,
+                             std::vector<std::string> const & trg_var_names,
+                             std::vector<double> const & global_lower_bounds,
+                             std::vector<double> const & global_upper_bounds,
+                             double conservation_tol = 1e2*std::numeric_limits<double>::epsilon(),
+                             int maxiter = 5,
+                             Partial_fixup_type partial_fixup_type =
+                             Partial_fixup_type::SHIFTED_CONSERVATIVE,
+                             Empty_fixup_type empty_fixup_type =
+                             Empty_fixup_type::EXTRAPOLATE) {
 
-    if (partial_fixup_type == Partial_fixup_type::LOCALLY_CONSERVATIVE) {
-      // In interpolate step, we divided the accumulated integral (U)
-      // in a target cell by the intersection volume (v_i) instead of
-      // the target cell volume (v_c) to give a target field of u_t =
-      // U/v_i. In partially filled cells, this will preserve a
-      // constant source field but fill the cell with too much material
-      // (this is the equivalent of requesting Partial_fixup_type::CONSTANT).
-      // To restore conservation (as requested by
-      // Partial_fixup_type::LOCALLY_CONSERVATIVE), we undo the division by
-      // the intersection volume and then divide by the cell volume
-      // (u'_t = U/v_c = u_t*v_i/v_c). This does not affect the values
-      // in fully filled cells
+    static bool hit_lobound = false, hit_hibound = false;
 
-      for (int t = 0; t < ntargetents_; t++) {
-        if (!is_cell_empty_[t]) {
-          if (fabs(xsect_volumes_[t]-target_ent_volumes_[t])/target_ent_volumes_[t] > voldifftol_)
-            target_data[t] *= xsect_volumes_[t]/target_ent_volumes_[t];
-        }
-      }
+    int const nvars = src_var_names.size();
+
+    // Now process remap variables
+    std::vector<T const *> source_data(nvars);
+    std::vector<T *> target_data(nvars);
+    for (int i = 0; i < nvars; i++) {
+      source_state_.mesh_get_data(onwhat, src_var_names[i], &source_data[i]);
+      target_state_.mesh_get_data(onwhat, trg_var_names[i], &target_data[i]);
     }
 
-    if (empty_fixup_type != Empty_fixup_type::LEAVE_EMPTY) {
-      // Do something here to populate fully uncovered target
-      // cells. We have layers of empty cells starting out from fully
-      // or partially populated cells. We will assign every empty cell
-      // in a layer the average value of all its populated neighbors.
-      // IN A DISTRIBUTED MESH IT _IS_ POSSIBLE THAT AN EMPTY ENTITY
-      // WILL NOT HAVE ANY OWNED NEIGHBOR IN THIS PARTITION THAT HAS
-      // MEANINGFUL DATA TO EXTRAPOLATE FROM (we remap data only to
-      // owned entities)
+    bool const shifted =
+        (partial_fixup_type == Partial_fixup_type::SHIFTED_CONSERVATIVE);
 
-      int curlayernum = 1;
-      for (std::vector<int> const& curlayer : emptylayers_) {
-        for (int ent : curlayer) {
-          std::vector<int> nbrs;
-          if (onwhat == Entity_kind::CELL)
-            target_mesh_.cell_get_node_adj_cells(ent, Entity_type::PARALLEL_OWNED,
-                                                 &nbrs);
-          else
-            target_mesh_.node_get_cell_adj_nodes(ent, Entity_type::PARALLEL_OWNED,
-                                                 &nbrs);
-          
-          double aveval = 0.0;
-          int nave = 0;
-          for (int nbr : nbrs) {
-            if (layernum_[nbr] < curlayernum) {
-              aveval += target_data[nbr];
-              nave++;
-            }
-          }
-          if (nave)
-            aveval /= nave;
-#ifdef DEBUG
-          else
-            std::cerr <<
-                "No owned neighbors of empty entity to extrapolate data from\n";
+    // Local integrals of the source fields followed by the target
+    // volume covered by the source mesh, reduced in place
+    std::vector<double> source_sums;
+    double covered_target_volume = 0.0;
+#ifdef PORTAGE_ENABLE_MPI
+    MPI_Request source_request = MPI_REQUEST_NULL;
 #endif
-          
-          target_data[ent] = aveval;
+    if (shifted) {
+      source_sums.resize(nvars + 1);
+      for (int i = 0; i < nvars; i++)
+        source_sums[i] =
+            std::inner_product(source_data[i], source_data[i] + nsourceents_,
+                               source_ent_volumes_.begin(), 0.0);
+
+      if (empty_fixup_type == Empty_fixup_type::LEAVE_EMPTY) {
+        for (int t = 0; t < ntargetents_; t++) {
+          if (!is_cell_empty_[t]) {
+            covered_target_volume += target_ent_volumes_[t];
+          }
         }
-        curlayernum++;
       }
+      source_sums[nvars] = covered_target_volume;
+
+#ifdef PORTAGE_ENABLE_MPI
+      if (distributed_)
+        MPI_Iallreduce(MPI_IN_PLACE, source_sums.data(), nvars + 1,
+                       MPI_DOUBLE, MPI_SUM, mycomm_, &source_request);
+#endif
     }
 
+    for (int i = 0; i < nvars; i++)
+      fix_partial_and_empty_entities(target_data[i], partial_fixup_type,
+                                     empty_fixup_type);
 
-    if (partial_fixup_type == Partial_fixup_type::CONSTANT || 
+    if (partial_fixup_type == Partial_fixup_type::CONSTANT ||
         partial_fixup_type == Partial_fixup_type::LOCALLY_CONSERVATIVE) {
-
       return true;
+    } else if (!shifted) {
+      std::cerr << "Unknown Partial fixup type\n";
+      return false;
+    }
 
-    } else if (partial_fixup_type == Partial_fixup_type::SHIFTED_CONSERVATIVE) {
-    
-      // At this point assume that all cells have some value in them
-      // for the variable
-
-      // Now compute the net discrepancy between integrals over source
-      // and target. Excess comes from target cells not fully covered by
-      // source cells and deficit from source cells not fully covered by
-      // target cells
-
-      double source_sum =
-          std::inner_product(source_data, source_data + nsourceents_,
-                             source_ent_volumes_.begin(), 0.0);
+    // At this point assume that all cells have some value in them
+    // for the variables
 
-      double global_source_sum = source_sum;
-#ifdef PORTAGE_ENABLE_MPI
-      if (distributed_)
-        MPI_Allreduce(&source_sum, &global_source_sum, 1, MPI_DOUBLE, MPI_SUM,
-                      mycomm_);
-#endif
+    // Now compute the net discrepancy between integrals over source
+    // and target. Excess comes from target cells not fully covered by
+    // source cells and deficit from source cells not fully covered by
+    // target cells
 
-      double target_sum =
-          std::inner_product(target_data, target_data + ntargetents_,
+    std::vector<double> target_sums(nvars);
+    for (int i = 0; i < nvars; i++)
+      target_sums[i] =
+          std::inner_product(target_data[i], target_data[i] + ntargetents_,
                              target_ent_volumes_.begin(), 0.0);
 
-      double global_target_sum = target_sum;
 #ifdef PORTAGE_ENABLE_MPI
-      if (distributed_)
-        MPI_Allreduce(&target_sum, &global_target_sum, 1, MPI_DOUBLE, MPI_SUM,
-                      mycomm_);
+    if (distributed_) {
+      MPI_Request target_request;
+      MPI_Iallreduce(MPI_IN_PLACE, target_sums.data(), nvars,
+                     MPI_DOUBLE, MPI_SUM, mycomm_, &target_request);
+      MPI_Wait(&source_request, MPI_STATUS_IGNORE);
+      MPI_Wait(&target_request, MPI_STATUS_IGNORE);
+    }
 #endif
 
-      double global_diff = global_target_sum - global_source_sum;
-      double reldiff = global_diff/global_source_sum;
+    std::vector<double> const& global_source_sums = source_sums;
+    double const global_covered_target_volume = source_sums[nvars];
+
+    // Now redistribute the discrepancy among cells in proportion to
+    // their volume. This will restore conservation and if the
+    // original distribution was a constant it will make the field a
+    // slightly different constant. If shifting by the discrepancy per
+    // unit volume makes some cells hit the bounds of the field, the
+    // leftover cannot be redistributed in one go. Rather than iterating
+    // over the cells still free to be adjusted, the shift that makes
+    // the clipped field conservative is then searched for directly from
+    // the unshifted values (see find_bounded_shifts) and applied in a
+    // second pass. Further iterations only mop up round-off.
+
+    double const global_full_volume =
+        (empty_fixup_type == Empty_fixup_type::LEAVE_EMPTY) ?
+        global_covered_target_volume : global_target_volume_;
+
+    auto adjustable = [&](int t) {
+      return empty_fixup_type != Empty_fixup_type::LEAVE_EMPTY ||
+          !is_cell_empty_[t];
+    };
+
+    std::vector<double> global_diff(nvars), reldiff(nvars), udiff(nvars);
+    std::vector<int> active;  // variables that still need to be repaired
+    for (int i = 0; i < nvars; i++) {
+      global_diff[i] = target_sums[i] - global_source_sums[i];
+      reldiff[i] = global_diff[i]/global_source_sums[i];
 
-      if (fabs(reldiff) < conservation_tol)
-        return true;  // discrepancy is too small - nothing to do
+      // sort of a "unit" discrepancy or difference per unit volume
+      udiff[i] = global_diff[i]/global_full_volume;
 
-      // Now redistribute the discrepancy among cells in proportion to
-      // their volume. This will restore conservation and if the
-      // original distribution was a constant it will make the field a
-      // slightly different constant. Do multiple iterations because
-      // we may have some leftover quantity that we were not able to
-      // add/subtract from some cells in any given iteration. We don't
-      // expect that process to take more than two iterations at the
-      // most.
+      if (fabs(reldiff[i]) > conservation_tol)
+        active.push_back(i);  // else discrepancy is too small - nothing to do
+    }
 
-      double adj_target_volume;
-      double global_adj_target_volume;
-      double global_covered_target_volume;
-      if (empty_fixup_type == Empty_fixup_type::LEAVE_EMPTY) {
-        double covered_target_volume = 0.0;
+    // Unshifted values of the variables whose bounds may be hit, and
+    // the range of their adjustable values over all ranks (smallest
+    // value negated so that both ends are reduced with MPI_MAX)
+    std::vector<std::vector<T>> unshifted(nvars);
+    std::vector<double> value_ranges(2*nvars,
+                                     -std::numeric_limits<double>::infinity());
+    for (int i : active) {
+      if (ClippedIntegral::is_bound(global_lower_bounds[i]) ||
+          ClippedIntegral::is_bound(global_upper_bounds[i])) {
+        unshifted[i].assign(target_data[i], target_data[i] + ntargetents_);
         for (int t = 0; t < ntargetents_; t++) {
-          if (!is_cell_empty_[t]) {
-            covered_target_volume += target_ent_volumes_[t];
+          if (adjustable(t)) {
+            value_ranges[2*i] = std::max(value_ranges[2*i], -unshifted[i][t]);
+            value_ranges[2*i+1] = std::max(value_ranges[2*i+1], unshifted[i][t]);
           }
         }
-        global_covered_target_volume = covered_target_volume;
+      }
+    }
 #ifdef PORTAGE_ENABLE_MPI
-        if (distributed_)
-          MPI_Allreduce(&covered_target_volume, &global_covered_target_volume,
-                        1, MPI_DOUBLE, MPI_SUM, mycomm_);
+    MPI_Request range_request = MPI_REQUEST_NULL;
+    if (distributed_)
+      MPI_Iallreduce(MPI_IN_PLACE, value_ranges.data(), 2*nvars,
+                     MPI_DOUBLE, MPI_MAX, mycomm_, &range_request);
 #endif
-        adj_target_volume = covered_target_volume;
-        global_adj_target_volume = global_covered_target_volume;
-      }
-      else {
-        adj_target_volume = target_volume_;
-        global_adj_target_volume = global_target_volume_;
-      }
 
-      // sort of a "unit" discrepancy or difference per unit volume
-      double udiff = global_diff/global_adj_target_volume;
+    // New target integral of each active variable followed by its
+    // adjusted target volume and its number of clipped cells, reduced
+    // in place
+    std::vector<double> iter_sums;
+
+    int iter = 0;
+    while (!active.empty() && iter < maxiter) {
+      int const nactive = active.size();
+      iter_sums.resize(3*nactive);
 
-      int iter = 0;
-      while (fabs(reldiff) > conservation_tol && iter < maxiter) {
-        for (auto it = target_mesh_.begin(onwhat, Entity_type::PARALLEL_OWNED);
-             it != target_mesh_.end(onwhat, Entity_type::PARALLEL_OWNED); it++) {
-          int t = *it;
-          if (empty_fixup_type != Empty_fixup_type::LEAVE_EMPTY || !is_cell_empty_[t]) {
+      for (int a = 0; a < nactive; a++) {
+        int const i = active[a];
+        T *data = target_data[i];
+        double adj_target_volume = 0.0;
+        int nclipped = 0;
+
+        for (int t = 0; t < ntargetents_; t++) {
+          if (adjustable(t)) {
 
-            if ((target_data[t]-udiff) < global_lower_bound) {
+            if ((data[t]-udiff[i]) < global_lower_bounds[i]) {
               // Subtracting the full excess will make this cell violate the
               // lower bound. So subtract only as much as will put this cell
               // exactly at the lower bound
 
-              target_data[t] = global_lower_bound;
+              data[t] = global_lower_bounds[i];
+              nclipped++;
 
               if (!hit_lobound) {
                 std::cerr << "Hit lower bound for cell " << t <<
@@ -638,17 +1169,13 @@ class MismatchFixer {
                 hit_lobound = true;
               }
 
-              // this cell is no longer in play for adjustment - so remove its
-              // volume from the adjusted target_volume
-
-              adj_target_volume -= target_ent_volumes_[t];
-
-            } else if ((target_data[t]-udiff) > global_upper_bound) {  // udiff < 0
+            } else if ((data[t]-udiff[i]) > global_upper_bounds[i]) {  // udiff < 0
               // Adding the full deficit will make this cell violate the
               // upper bound. So add only as much as will put this cell
               // exactly at the upper bound
 
-              target_data[t] = global_upper_bound;
+              data[t] = global_upper_bounds[i];
+              nclipped++;
 
               if (!hit_hibound) {
                 std::cerr << "Hit upper bound for cell " << t <<
@@ -656,84 +1183,235 @@ class MismatchFixer {
                 hit_hibound = true;
               }
 
-              // this cell is no longer in play for adjustment - so remove its
-              // volume from the adjusted target_volume
-
-              adj_target_volume -= target_ent_volumes_[t];
-
             } else {
               // This is the equivalent of
               //           [curval*cellvol - diff*cellvol/meshvol]
               // curval = ---------------------------------------
               //                       cellvol
 
-              target_data[t] -= udiff;
+              data[t] -= udiff[i];
 
+              // this cell is still in play for adjustment
+              adj_target_volume += target_ent_volumes_[t];
             }
           }  // only non-empty cells
         }  // iterate through mesh cells
 
         // Compute the new integral over all processors
 
-        target_sum = std::inner_product(target_data, target_data + ntargetents_,
-                                        target_ent_volumes_.begin(), 0.0);
+        iter_sums[a] = std::inner_product(data, data + ntargetents_,
+                                          target_ent_volumes_.begin(), 0.0);
+        iter_sums[nactive + a] = adj_target_volume;
+        iter_sums[2*nactive + a] = nclipped;
+      }
 
-        global_target_sum = target_sum;
 #ifdef PORTAGE_ENABLE_MPI
-        if (distributed_)
-          MPI_Allreduce(&target_sum, &global_target_sum, 1, MPI_DOUBLE, MPI_SUM,
-                        mycomm_);
+      if (distributed_) {
+        MPI_Allreduce(MPI_IN_PLACE, iter_sums.data(), 3*nactive,
+                      MPI_DOUBLE, MPI_SUM, mycomm_);
+        MPI_Wait(&range_request, MPI_STATUS_IGNORE);
+      }
 #endif
 
-        // If we did not hit lower or upper bounds, this should be
-        // zero after the first iteration.  If we did hit some bounds,
-        // then recalculate the discrepancy and discrepancy per unit
-        // volume, but only taking into account volume of cells that
-        // are not already at the bounds - if we use the entire mesh
-        // volume for the recalculation, the convergence slows down
+      // If we did not hit lower or upper bounds, this should be
+      // zero after the first iteration. If we did hit some bounds on
+      // the first iteration, search for the bounded shift. Otherwise
+      // recalculate the discrepancy and discrepancy per unit volume,
+      // but only taking into account volume of cells that are not
+      // already at the bounds
+
+      std::vector<int> still_active, clipped;
+      for (int a = 0; a < nactive; a++) {
+        int const i = active[a];
+        global_diff[i] = iter_sums[a] - global_source_sums[i];
+        udiff[i] = global_diff[i]/iter_sums[nactive + a];
+        reldiff[i] = global_diff[i]/global_source_sums[i];
+        if (fabs(reldiff[i]) > conservation_tol) {
+          still_active.push_back(i);
+          if (iter == 0 && iter_sums[2*nactive + a] > 0 &&
+              !unshifted[i].empty())
+            clipped.push_back(i);
+        }
+      }
+      active.swap(still_active);
+
+      if (!clipped.empty() && iter + 1 < maxiter)
+        find_conservative_shifts(clipped, unshifted, value_ranges,
+                                 global_lower_bounds, global_upper_bounds,
+                                 global_source_sums, adjustable,
+                                 conservation_tol, maxiter, target_data,
+                                 &udiff);
 
-        global_diff = global_target_sum - global_source_sum;
+      iter++;
+    }  // while leftover is not zero
 
-        global_adj_target_volume = adj_target_volume;
 #ifdef PORTAGE_ENABLE_MPI
-        if (distributed_)
-          MPI_Allreduce(&adj_target_volume, &global_adj_target_volume, 1,
-                        MPI_DOUBLE, MPI_SUM, mycomm_);
+    if (distributed_)  // MPI may not even be initialized otherwise
+      MPI_Wait(&range_request, MPI_STATUS_IGNORE);  // if no iteration was done
 #endif
 
-        udiff = global_diff/global_adj_target_volume;
-        reldiff = global_diff/global_source_sum;
+    bool success = true;
+    for (int i : active) {
+      if (rank_ == 0) {
+        std::cerr << "Redistribution not entirely successfully for variable " <<
+            src_var_names[i] << "\n";
+        std::cerr << "Relative conservation error is " << reldiff[i] << "\n";
+        std::cerr << "Absolute conservation error is " << global_diff[i] << "\n";
+        success = false;
+      }
+    }
 
+    return success;
+  }  // fix_mismatch_meshvars
 
-        // Now reset adjusted target mesh volume to be the full volume
-        // in preparation for the next iteration
-        if (empty_fixup_type == Empty_fixup_type::LEAVE_EMPTY)
-          global_adj_target_volume = global_covered_target_volume;
-        else
-          global_adj_target_volume = global_target_volume_;
-
-        iter++;
-      }  // while leftover is not zero
-
-      if (fabs(reldiff) > conservation_tol) {
-        if (rank_ == 0) {
-          std::cerr << "Redistribution not entirely successfully for variable " <<
-              src_var_name << "\n";
-          std::cerr << "Relative conservation error is " << reldiff << "\n";
-          std::cerr << "Absolute conservation error is " << global_diff << "\n";
-          return false;
+ private:
+
+  // Replace the shift of the given variables by the one that makes
+  // their clipped values conservative, and restore their unshifted
+  // values so that it can be applied
+
+  template<typename T, class Adjustable>
+  void find_conservative_shifts(std::vector<int> const& vars,
+                                std::vector<std::vector<T>> const& unshifted,
+                                std::vector<double> const& value_ranges,
+                                std::vector<double> const& global_lower_bounds,
+                                std::vector<double> const& global_upper_bounds,
+                                std::vector<double> const& global_source_sums,
+                                Adjustable adjustable, double conservation_tol,
+                                int maxrounds,
+                                std::vector<T *> const& target_data,
+                                std::vector<double> *udiff) const {
+
+    std::vector<int> adjusted, fixed;
+    for (int t = 0; t < ntargetents_; t++)
+      (adjustable(t) ? adjusted : fixed).push_back(t);
+
+    int const nadjusted = adjusted.size();
+    std::vector<double> volumes(nadjusted);
+    for (int e = 0; e < nadjusted; e++)
+      volumes[e] = target_ent_volumes_[adjusted[e]];
+
+    int const nvars = vars.size();
+    std::vector<ClippedIntegral> integrals;
+    std::vector<std::pair<double, double>> extremes(nvars);
+    std::vector<double> source_integrals(nvars), shifts(nvars);
+    integrals.reserve(nvars);
+    for (int k = 0; k < nvars; k++) {
+      int const i = vars[k];
+      std::vector<double> values(nadjusted);
+      for (int e = 0; e < nadjusted; e++)
+        values[e] = unshifted[i][adjusted[e]];
+      double fixed_integral = 0.0;
+      for (int t : fixed)
+        fixed_integral += unshifted[i][t]*target_ent_volumes_[t];
+      integrals.emplace_back(std::move(values), volumes.data(),
+                             global_lower_bounds[i], global_upper_bounds[i],
+                             fixed_integral);
+
+      // breakpoints are at u - bound for each bound
+      double const umin = -value_ranges[2*i], umax = value_ranges[2*i+1];
+      extremes[k] = {std::numeric_limits<double>::infinity(),
+                     -std::numeric_limits<double>::infinity()};
+      for (double bound : {global_lower_bounds[i], global_upper_bounds[i]}) {
+        if (ClippedIntegral::is_bound(bound) && umin <= umax) {
+          extremes[k].first = std::min(extremes[k].first, umin - bound);
+          extremes[k].second = std::max(extremes[k].second, umax - bound);
         }
       }
 
-      return true;
-    } else {
-      std::cerr << "Unknown Partial fixup type\n";
-      return false;
+      source_integrals[k] = global_source_sums[i];
+      shifts[k] = (*udiff)[i];
+    }
+
+    auto sum_all = [&](double *vals, int n) {
+#ifdef PORTAGE_ENABLE_MPI
+      if (distributed_)
+        MPI_Allreduce(MPI_IN_PLACE, vals, n, MPI_DOUBLE, MPI_SUM, mycomm_);
+#endif
+    };
+
+    find_bounded_shifts(&integrals, extremes, source_integrals,
+                        conservation_tol, maxrounds, sum_all, &shifts);
+
+    for (int k = 0; k < nvars; k++) {
+      int const i = vars[k];
+      std::copy(unshifted[i].begin(), unshifted[i].end(), target_data[i]);
+      (*udiff)[i] = shifts[k];
     }
+  }
 
-  }  // fix_mismatch_meshvar
+  // Undo the division by the intersection volume in partially filled
+  // entities (LOCALLY_CONSERVATIVE) and extrapolate values into empty
+  // entities (unless they are to be left empty)
+
+  template<typename T>
+  void fix_partial_and_empty_entities(T *target_data,
+                                      Partial_fixup_type partial_fixup_type,
+                                      Empty_fixup_type empty_fixup_type) const {
+
+    if (partial_fixup_type == Partial_fixup_type::LOCALLY_CONSERVATIVE) {
+      // In interpolate step, we divided the accumulated integral (U)
+      // in a target cell by the intersection volume (v_i) instead of
+      // the target cell volume (v_c) to give a target field of u_t =
+      // U/v_i. In partially filled cells, this will preserve a
+      // constant source field but fill the cell with too much material
+      // (this is the equivalent of requesting Partial_fixup_type::CONSTANT).
+      // To restore conservation (as requested by
+      // Partial_fixup_type::LOCALLY_CONSERVATIVE), we undo the division by
+      // the intersection volume and then divide by the cell volume
+      // (u'_t = U/v_c = u_t*v_i/v_c). This does not affect the values
+      // in fully filled cells
+
+      for (int t = 0; t < ntargetents_; t++) {
+        if (!is_cell_empty_[t]) {
+          if (fabs(xsect_volumes_[t]-target_ent_volumes_[t])/target_ent_volumes_[t] > voldifftol_)
+            target_data[t] *= xsect_volumes_[t]/target_ent_volumes_[t];
+        }
+      }
+    }
+
+    if (empty_fixup_type != Empty_fixup_type::LEAVE_EMPTY) {
+      // Do something here to populate fully uncovered target
+      // cells. We have layers of empty cells starting out from fully
+      // or partially populated cells. We will assign every empty cell
+      // in a layer the average value of all its populated neighbors.
+      // IN A DISTRIBUTED MESH IT _IS_ POSSIBLE THAT AN EMPTY ENTITY
+      // WILL NOT HAVE ANY OWNED NEIGHBOR IN THIS PARTITION THAT HAS
+      // MEANINGFUL DATA TO EXTRAPOLATE FROM (we remap data only to
+      // owned entities)
+
+      // Entities of a layer only read values from earlier layers, so
+      // each layer is filled in parallel
+
+      int curlayernum = 1;
+      for (std::vector<int> const& curlayer : emptylayers_) {
+        Portage::for_each(make_counting_iterator(0),
+                          make_counting_iterator(static_cast<int>(curlayer.size())),
+                          [&](int i) {
+          int const ent = curlayer[i];
+          double aveval = 0.0;
+          int nave = 0;
+          for (int nbr : empty_neighbors_[ent]) {
+            if (layernum_[nbr] < curlayernum) {
+              aveval += target_data[nbr];
+              nave++;
+            }
+          }
+          if (nave)
+            aveval /= nave;
+#ifdef DEBUG
+          else
+            std::cerr <<
+                "No owned neighbors of empty entity to extrapolate data from\n";
+#endif
+          
+          target_data[ent] = aveval;
+        });
+        curlayernum++;
+      }
+    }
+  }
 
- private:
   SourceMesh_Wrapper const& source_mesh_;
   SourceState_Wrapper const& source_state_;
   TargetMesh_Wrapper const& target_mesh_;
@@ -746,6 +1424,7 @@ class MismatchFixer {
   std::vector<int> layernum_;
   std::vector<bool> is_cell_empty_;
   std::vector<std::vector<int>> emptylayers_;
+  MeshAdjacency empty_neighbors_;  // owned neighbors of empty entities
   bool mismatch_ = false;
   int rank_ = 0, nprocs_ = 1;
   double voldifftol_ = 1e2*std::numeric_limits<double>::epsilon();
@@ -26,12 +26,15 @@ Please see the license file at the root of this repository, or at:
 #include "portage/intersect/dummy_interface_reconstructor.h"
 
 #include "portage/support/portage.h"
+#include "portage/support/scheduler.h"
 
 #include "portage/search/search_kdtree.h"
 #include "portage/intersect/intersect_r2d.h"
 #include "portage/intersect/intersect_r3d.h"
 #include "portage/interpolate/interpolate_1st_order.h"
 #include "portage/interpolate/interpolate_2nd_order.h"
+#include "portage/interpolate/material_moments.h"
+#include "portage/interpolate/source_mesh_data.h"
 #include "wonton/mesh/flat/flat_mesh_wrapper.h"
 #include "wonton/state/flat/flat_state_mm_wrapper.h"
 #include "wonton/support/Point.h"
@@ -295,6 +298,23 @@ class MMDriver {
     num_tols_ = num_tols;
   }
 
+  /*!
+    @brief Declare that both meshes are made of axis-aligned boxes, so
+    that the dual cells of nodes are intersected as boxes
+  */
+  void set_rectangular_mesh(bool rectangular_mesh) {
+    rectangular_mesh_ = rectangular_mesh;
+  }
+
+  /*!
+    @brief Set the highest degree of the intersection moments: 1
+    (default), or 2 for 3rd order remap
+  */
+  void set_moment_order(int moment_order) {
+    assert(moment_order == 1 || moment_order == 2);
+    moment_order_ = moment_order;
+  }
+
   /*!
     @brief set the bounds of variable to be remapped on target
     @param target_var_name Name of variable in target mesh to limit
@@ -592,6 +612,8 @@ class MMDriver {
   double consttol_ =  100*std::numeric_limits<double>::epsilon();
   int max_fixup_iter_ = 5;
   NumericTolerances_t num_tols_;
+  bool rectangular_mesh_ = false;
+  int moment_order_ = 1;
 
 
 #ifdef HAVE_TANGRAM
@@ -783,6 +805,8 @@ int MMDriver<Search, Intersect, Interpolate, D,
   // calling app
   //std::vector<Tangram::IterativeMethodTolerances_t> tols(2, {1000, 1e-12, 1e-12});
 
+  std::shared_ptr<MaterialMoments<D> const> material_moments;
+
   auto interface_reconstructor =
       std::make_shared<Tangram::Driver<InterfaceReconstructorType, D,
                                        SourceMesh_Wrapper2,
@@ -813,6 +837,11 @@ int MMDriver<Search, Intersect, Interpolate, D,
                                                   cell_mat_volfracs,
                                                   cell_mat_centroids);
     interface_reconstructor->reconstruct(executor);
+
+    // Material centroids in mixed cells, shared by the gradients and
+    // reconstructions of all material variables
+    material_moments = make_material_moments<D>(source_mesh2, source_state2,
+                                                *interface_reconstructor);
   }
 
 
@@ -825,7 +854,8 @@ int MMDriver<Search, Intersect, Interpolate, D,
             TargetMesh_Wrapper, InterfaceReconstructorType,
             Matpoly_Splitter, Matpoly_Clipper>
       intersect(source_mesh2, source_state2, target_mesh_, num_tols_,
-                interface_reconstructor);
+                interface_reconstructor, rectangular_mesh_);
+  intersect.set_moment_order(moment_order_);
 
   // Get an instance of the desired interpolate algorithm type
   Interpolate<D, onwhat, SourceMesh_Wrapper2, TargetMesh_Wrapper,
@@ -833,12 +863,17 @@ int MMDriver<Search, Intersect, Interpolate, D,
               Matpoly_Splitter, Matpoly_Clipper>
       interpolate(source_mesh2, target_mesh_, source_state2,
                   num_tols_, interface_reconstructor);
+  SourceMeshData<D> source_mesh_data;
+  source_mesh_data.material_moments = material_moments;
+  interpolate.set_source_mesh_data(source_mesh_data);
 #else
 
   Intersect<onwhat, SourceMesh_Wrapper2, SourceState_Wrapper2,
             TargetMesh_Wrapper, DummyInterfaceReconstructor,
             void, void>
-      intersect(source_mesh2, source_state2, target_mesh_, num_tols_);
+      intersect(source_mesh2, source_state2, target_mesh_, num_tols_,
+                rectangular_mesh_);
+  intersect.set_moment_order(moment_order_);
 
   // Get an instance of the desired interpolate algorithm type
   Interpolate<D, onwhat, SourceMesh_Wrapper2, TargetMesh_Wrapper,
@@ -993,7 +1028,13 @@ int MMDriver<Search, Intersect, Interpolate, D,
 
   if (onwhat != Entity_kind::CELL) return 1;
 
-  // Material centric loop
+  // Material centric loop. Intersections and the updates of the
+  // target state are done one material at a time here; the
+  // interpolation of the materials is done afterwards as independent
+  // tasks
+
+  std::vector<std::vector<int>> matcellstgt_all(nmats);
+  std::vector<std::vector<std::vector<Weights_t>>> mat_sources_and_weights_all(nmats);
 
   for (int m = 0; m < nmats; m++) {
 
@@ -1034,7 +1075,7 @@ int MMDriver<Search, Intersect, Interpolate, D,
 
     int ntargetcells = target_mesh_.num_entities(Entity_kind::CELL,
                                                  Entity_type::ALL);
-    std::vector<int> matcellstgt;
+    std::vector<int>& matcellstgt = matcellstgt_all[m];
 
     for (int c = 0; c < ntargetcells; c++) {
       std::vector<Weights_t> const& cell_sources_and_weights =
@@ -1095,7 +1136,9 @@ int MMDriver<Search, Intersect, Interpolate, D,
       
       std::vector<double> mat_volfracs(nmatcells);
       std::vector<Point<D>> mat_centroids(nmatcells);
-      std::vector<std::vector<Weights_t>> mat_sources_and_weights(nmatcells);
+      std::vector<std::vector<Weights_t>>& mat_sources_and_weights =
+          mat_sources_and_weights_all[m];
+      mat_sources_and_weights.resize(nmatcells);
       
       for (int ic = 0; ic < nmatcells; ic++) {
         int c = matcellstgt[ic];
@@ -1118,65 +1161,101 @@ int MMDriver<Search, Intersect, Interpolate, D,
       
       target_state_.mat_add_celldata("mat_volfracs", m, &(mat_volfracs[0]));
       target_state_.mat_add_celldata("mat_centroids", m, &(mat_centroids[0]));
-      
+    }  // if matcellstgt.size()
+  }  // for nmats
 
-      // INTERPOLATE (one variable at a time)
-      
-      // HERE WE COULD MAKE A NEW LIST BASED ON WHICH TARGET CELLS HAVE ANY
-      // INTERSECTIONS WITH SOURCE CELLS FOR THIS MATERIAL TO AVOID A NULL-OP
-      // AND A WARNING MESSAGE ABOUT NO SOURCE CELLS CONTRIBUTING TO A TARGET -
-      // IS IT WORTH IT?
-      
-      gettimeofday(&begin_timeval, 0);
-      
-      int nmatvars = src_matvar_names.size();
-      if (comm_rank == 0)
-        std::cout << "Number of multi-material variables on entity kind " <<
-            onwhat << " to remap is " << nmatvars << std::endl;
-      
-      interpolate.set_material(m);    // We have to do this so we know
-      //                              // which material values we have
-      //                              // to grab from the source state
-      
 
-      // if the material has no cells on this partition, then don't bother
-      // interpolating MM variables
-        
-      for (int i = 0; i < nmatvars; ++i) {
-        interpolate.set_interpolation_variable(src_matvar_names[i],
-                                               limiters_.at(src_matvar_names[i]),
-                                               bnd_limiters_.at(src_matvar_names[i]));
+  // INTERPOLATE (one variable at a time)
+
+  // HERE WE COULD MAKE A NEW LIST BASED ON WHICH TARGET CELLS HAVE ANY
+  // INTERSECTIONS WITH SOURCE CELLS FOR THIS MATERIAL TO AVOID A NULL-OP
+  // AND A WARNING MESSAGE ABOUT NO SOURCE CELLS CONTRIBUTING TO A TARGET -
+  // IS IT WORTH IT?
+
+  gettimeofday(&begin_timeval, 0);
+
+  int nmatvars = src_matvar_names.size();
+  if (comm_rank == 0)
+    std::cout << "Number of multi-material variables on entity kind " <<
+        onwhat << " to remap is " << nmatvars << std::endl;
 
-        // Get a handle to a memory location where the target state
-        // would like us to write this material variable into. If it is
-        // NULL, we allocate it ourself
+  // Get a handle to the memory locations where the target state would
+  // like us to write each material variable into. This is done here
+  // rather than in the concurrent tasks below since state wrappers may
+  // allocate in this call
 
-        double *target_field_raw;
-        target_state_.mat_get_celldata(trg_matvar_names[i], m, &target_field_raw);
-        assert (target_field_raw != nullptr);
+  std::vector<std::vector<double*>> target_fields(nmats);
+  for (int m = 0; m < nmats; m++) {
+    // if the material has no cells on this partition, then don't bother
+    // interpolating MM variables
+    if (matcellstgt_all[m].empty()) continue;
+    target_fields[m].resize(nmatvars);
+    for (int i = 0; i < nmatvars; ++i) {
+      target_state_.mat_get_celldata(trg_matvar_names[i], m, &target_fields[m][i]);
+      assert (target_fields[m][i] != nullptr);
+    }
+  }
 
+  // Each material writes only its own values, so the materials are
+  // interpolated as independent tasks, each with its own copy of the
+  // interpolator. The largest material goes first with parallel loops
+  // over its cells and leaves the neighbor and limiter data of the
+  // source mesh in the shared interpolator for the smaller materials,
+  // which then run concurrently. The interface reconstruction is
+  // complete by now and is only queried by the interpolators.
+
+  auto interpolate_material = [&](int m, bool inner_parallel) {
+    std::vector<int> const& matcellstgt = matcellstgt_all[m];
+    std::vector<std::vector<Weights_t>> const& mat_sources_and_weights =
+        mat_sources_and_weights_all[m];
+    int const nmatcells = matcellstgt.size();
+    if (!nmatcells) return;
+
+    auto mat_interpolate = interpolate;
+    mat_interpolate.set_material(m);    // We have to do this so we know
+    //                                  // which material values we have
+    //                                  // to grab from the source state
+
+    for (int i = 0; i < nmatvars; ++i) {
+      mat_interpolate.set_interpolation_variable(src_matvar_names[i],
+                                                 limiters_.at(src_matvar_names[i]),
+                                                 bnd_limiters_.at(src_matvar_names[i]));
+
+      double *target_field_raw = target_fields[m][i];
+      if (inner_parallel) {
         Portage::pointer<double> target_field(target_field_raw);
 
         Portage::transform(matcellstgt.begin(), matcellstgt.end(),
                            mat_sources_and_weights.begin(),
-                           target_field, interpolate);
+                           target_field, mat_interpolate);
+      } else {
+        for (int ic = 0; ic < nmatcells; ic++)
+          target_field_raw[ic] = mat_interpolate(matcellstgt[ic],
+                                                 mat_sources_and_weights[ic]);
+      }
+    }  // nmatvars
 
-        // If the state wrapper knows that the target data is already
-        // laid out in this way and it gave us a pointer to the array
-        // where the values reside, it has to do nothing in this
-        // call. If the storage format is different, however, it may
-        // have to copy the values into their proper locations
+    if (inner_parallel) {
+      interpolate.set_source_mesh_data(mat_interpolate.source_mesh_data());
+    }
+  };
 
-        target_state_.mat_add_celldata(trg_matvar_names[i], m, target_field_raw);
+  run_tasks(nmats, interpolate_material,
+            [&](int m) { return static_cast<double>(matcellstgt_all[m].size()); });
 
-      }  // nmatvars
-    }  // if matcellstgt.size()
+  // If the state wrapper knows that the target data is already laid
+  // out in this way and it gave us a pointer to the array where the
+  // values reside, it has to do nothing in this call. If the storage
+  // format is different, however, it may have to copy the values into
+  // their proper locations
 
-    gettimeofday(&end_timeval, 0);
-    timersub(&end_timeval, &begin_timeval, &diff_timeval);
-    tot_seconds_interp += diff_timeval.tv_sec + 1.0E-6*diff_timeval.tv_usec;
+  for (int m = 0; m < nmats; m++)
+    for (int i = 0; i < static_cast<int>(target_fields[m].size()); ++i)
+      target_state_.mat_add_celldata(trg_matvar_names[i], m, target_fields[m][i]);
 
-  }  // for nmats
+  gettimeofday(&end_timeval, 0);
+  timersub(&end_timeval, &begin_timeval, &diff_timeval);
+  tot_seconds_interp += diff_timeval.tv_sec + 1.0E-6*diff_timeval.tv_usec;
 
   tot_seconds = tot_seconds_srch + tot_seconds_xsect + tot_seconds_interp;
 
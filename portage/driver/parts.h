@@ -10,14 +10,13 @@
 #include <sys/time.h>
 #include <algorithm>
 #include <vector>
-#include <map>
 #include <iterator>
-#include <unordered_set>
 #include <string>
 #include <utility>
 #include <iostream>
 #include <type_traits>
 #include <limits>
+#include <numeric>
 
 #include "portage/support/portage.h"
 
@@ -125,21 +124,12 @@ public:
     source_entities_volumes_.resize(source_part_size_);
     target_entities_volumes_.resize(target_part_size_);
     intersection_volumes_.resize(target_part_size_);
-    source_lookup_.reserve(source_part_size_);
-    target_lookup_.reserve(target_part_size_);
 
-    // set relative indexing and populate lookup hashtables
-    for (int i = 0; i < source_part_size_; ++i) {
-      auto const& s = source_entities[i];
-      source_relative_index_[s] = i;
-      source_lookup_.insert(s);
-    }
-
-    for (int i = 0; i < target_part_size_; ++i) {
-      auto const& t = target_entities[i];
-      target_relative_index_[t] = i;
-      target_lookup_.insert(t);
-    }
+    // set relative indexing and populate lookup tables
+    build_lookup(source_entities_, &source_first_id_,
+                 &source_lookup_, &source_relative_index_);
+    build_lookup(target_entities_, &target_first_id_,
+                 &target_lookup_, &target_relative_index_);
   }
 
   /**
@@ -181,7 +171,10 @@ public:
    * @param id entity ID
    * @return true if so, false otherwise.
    */
-  bool is_source_entity(int id) const { return source_lookup_.count(id) == 1; }
+  bool is_source_entity(int id) const {
+    unsigned const k = id - source_first_id_;
+    return k < source_lookup_.size() and source_lookup_[k];
+  }
 
   /**
    * @brief Check if a given entity is in target part list.
@@ -189,7 +182,43 @@ public:
    * @param id entity ID
    * @return true if so, false otherwise.
    */
-  bool is_target_entity(int id) const { return target_lookup_.count(id) == 1; }
+  bool is_target_entity(int id) const {
+    unsigned const k = id - target_first_id_;
+    return k < target_lookup_.size() and target_lookup_[k];
+  }
+
+  /**
+   * @brief Get the intersection weights of the target part entities
+   *        restricted to the source part (set by check_mismatch).
+   *
+   * @return weights of each entity of the target entities list.
+   */
+  Portage::vector<entity_weights_t> const& get_part_weights() const {
+    return part_weights_;
+  }
+
+  /**
+   * @brief Restrict intersection weights to the part pair.
+   *
+   * @param source... source entities ID and weights for each target entity.
+   * @return weights of each entity of the target entities list, restricted
+   *         to the source part entities.
+   */
+  Portage::vector<entity_weights_t>
+  restrict_weights(Portage::vector<entity_weights_t> const& source_ents_and_weights) const {
+    Portage::vector<entity_weights_t> part_weights(target_part_size_);
+    Portage::for_each(make_counting_iterator(0),
+                      make_counting_iterator(target_part_size_),
+                      [&](int i) {
+                        entity_weights_t const& weights =
+                          source_ents_and_weights[target_entities_[i]];
+                        entity_weights_t& restricted = part_weights[i];
+                        for (auto&& sw : weights)
+                          if (is_source_entity(sw.entityID))
+                            restricted.emplace_back(sw);
+                      });
+    return part_weights;
+  }
 
   /**
    * @brief Get source part size.
@@ -224,7 +253,7 @@ public:
     // filter then
     filtered.reserve(neighbors.size());
     for (auto&& neigh : neighbors) {
-      if (target_lookup_.count(neigh)) {
+      if (is_target_entity(neigh)) {
         filtered.emplace_back(neigh);
       }
     }
@@ -261,7 +290,7 @@ public:
     // ------------------------------------------
     // collect volumes of entities that are not masked out and sum them up
     for (auto&& s : source_entities_) {
-      auto const& i = source_relative_index_[s];
+      int const i = source_relative_index(s);
       source_entities_volumes_[i] = (
         onwhat == Entity_kind::CELL
           ? source_entities_masks_[s] * source_mesh_.cell_volume(s)
@@ -275,7 +304,7 @@ public:
     }
 
     for (auto&& t : target_entities_) {
-      auto const& i = target_relative_index_[t];
+      int const i = target_relative_index(t);
       target_entities_volumes_[i] = (
         onwhat == Entity_kind::CELL ? target_mesh_.cell_volume(t)
                                     : target_mesh_.dual_cell_volume(t)
@@ -287,15 +316,24 @@ public:
       #endif
     }
 
+    // keep the weights of the target part entities restricted to the
+    // source part: they are filtered once here rather than for every
+    // remapped field.
+    part_weights_.resize(target_part_size_);
+
     for (auto&& t : target_entities_) {
-      auto const& i = target_relative_index_[t];
+      int const i = target_relative_index(t);
       // accumulate weights
       entity_weights_t const& weights = source_ents_and_weights[t];
+      entity_weights_t& part_weights = part_weights_[i];
+      part_weights.clear();
       intersection_volumes_[i] = 0.;
       for (auto&& sw : weights) {
         // matched source cell should be in the source part
-        if (source_lookup_.count(sw.entityID))
+        if (is_source_entity(sw.entityID)) {
+          part_weights.emplace_back(sw);
           intersection_volumes_[i] += sw.weights[0];
+        }
         #if DEBUG_PART_BY_PART
           std::printf("\tweights[target:%d][source:%d]: %f\n",
                       t, sw.entityID, sw.weights[0]);
@@ -390,7 +428,7 @@ public:
     is_cell_empty_.resize(target_part_size_, false);
 
     for (auto&& entity : target_entities_) {
-      auto const& i = target_relative_index_[entity];
+      int const i = target_relative_index(entity);
       if (std::abs(intersection_volumes_[i]) < epsilon_) {
         empty_entities.emplace_back(entity);
         is_cell_empty_[i] = true;
@@ -435,14 +473,14 @@ public:
         std::vector<int> current_layer_entities;
 
         for (auto&& entity : empty_entities) {
-          auto const& i = target_relative_index_[entity];
+          int const i = target_relative_index(entity);
           // skip already set entities
           if (layer_num_[i] == 0) {
 
             auto neighbors = get_target_filtered_neighbors<Entity_type::ALL>(entity);
 
             for (auto&& neigh : neighbors) {
-              auto const& j = target_relative_index_[neigh];
+              int const j = target_relative_index(neigh);
               // At least one neighbor has some material or will
               // receive some material (indicated by having a +ve
               // layer number)
@@ -456,7 +494,7 @@ public:
 
         // Tag the current layer cells with the next layer number
         for (auto&& entity : current_layer_entities) {
-          auto const& t = target_relative_index_[entity];
+          int const t = target_relative_index(entity);
           layer_num_[t] = nb_layers + 1;
         }
         nb_tagged += current_layer_entities.size();
@@ -508,6 +546,7 @@ public:
    * FILL        - Fill empty cells with specified values (not yet implemented)
    * ---------------------------------------------------------------------------
   */
+  template<typename T = double>
   bool fix_mismatch(std::string src_var_name,
                     std::string trg_var_name,
                     double global_lower_bound = -infinity_,
@@ -518,11 +557,62 @@ public:
                     Empty_fixup_type empty_fixup_type = EXTRAPOLATE) const {
 
     if (source_state_.field_type(onwhat, src_var_name) == Field_type::MESH_FIELD) {
-      return fix_mismatch_meshvar(src_var_name, trg_var_name,
-                                  global_lower_bound, global_upper_bound,
-                                  conservation_tol, maxiter,
-                                  partial_fixup_type, empty_fixup_type);
+      return fix_mismatch_meshvar<T>(src_var_name, trg_var_name,
+                                     global_lower_bound, global_upper_bound,
+                                     conservation_tol, maxiter,
+                                     partial_fixup_type, empty_fixup_type);
     }
+    return false;
+  }
+
+  /**
+   * @brief Repair several remapped fields to account for boundary mismatch.
+   *
+   * @param src_var_names        field variables on source mesh
+   * @param trg_var_names        field variables on target mesh
+   * @param global_lower_bounds  lower limit on each variable
+   * @param global_upper_bounds  upper limit on each variable
+   * @param conservation_tol     conservation tolerance treshold
+   * @param maxiter              max number of iterations
+   * @param partial_fixup_type   type of fixup in case of partial mismatch
+   * @param empty_fixup_type     type of fixup in empty target entities
+   * @return true if all variables were correctly fixed, false otherwise.
+   *
+   * Same as calling fix_mismatch for each pair of variables, except
+   * that the global sums needed by the fixup of all mesh variables are
+   * gathered in a few collective calls (see fix_mismatch_meshvars).
+   * Variables that are not mesh fields are skipped.
+   */
+  template<typename T = double>
+  bool fix_mismatch(std::vector<std::string> const& src_var_names,
+                    std::vector<std::string> const& trg_var_names,
+                    std::vector<double> const& global_lower_bounds,
+                    std::vector<double> const& global_upper_bounds,
+                    double conservation_tol = tolerance_,
+                    int maxiter = 5,
+                    Partial_fixup_type partial_fixup_type = SHIFTED_CONSERVATIVE,
+                    Empty_fixup_type empty_fixup_type = EXTRAPOLATE) const {
+
+    std::vector<std::string> src_mesh_vars, trg_mesh_vars;
+    std::vector<double> lower_bounds, upper_bounds;
+    int const nb_vars = src_var_names.size();
+
+    for (int i = 0; i < nb_vars; ++i) {
+      if (source_state_.field_type(onwhat, src_var_names[i]) == Field_type::MESH_FIELD) {
+        src_mesh_vars.push_back(src_var_names[i]);
+        trg_mesh_vars.push_back(trg_var_names[i]);
+        lower_bounds.push_back(global_lower_bounds[i]);
+        upper_bounds.push_back(global_upper_bounds[i]);
+      }
+    }
+
+    if (src_mesh_vars.empty()) {
+      return false;
+    }
+    return fix_mismatch_meshvars<T>(src_mesh_vars, trg_mesh_vars,
+                                    lower_bounds, upper_bounds,
+                                    conservation_tol, maxiter,
+                                    partial_fixup_type, empty_fixup_type);
   }
 
   /**
@@ -537,7 +627,11 @@ public:
    * @param partial_fixup_type  type of fixup in case of partial mismatch
    * @param empty_fixup_type    type of fixup in empty target entities
    * @return true if correctly fixed, false otherwise.
+   *
+   * The field may be stored as double or float (T); the integrals
+   * checked for conservation are accumulated in double.
    */
+  template<typename T = double>
   bool fix_mismatch_meshvar(std::string const & src_var_name,
                             std::string const & trg_var_name,
                             double global_lower_bound,
@@ -546,208 +640,243 @@ public:
                             int maxiter,
                             Partial_fixup_type partial_fixup_type,
                             Empty_fixup_type empty_fixup_type) const {
+    return fix_mismatch_meshvars<T>({src_var_name}, {trg_var_name},
+                                    {global_lower_bound}, {global_upper_bound},
+                                    conservation_tol, maxiter,
+                                    partial_fixup_type, empty_fixup_type);
+  }
+
+  /**
+   * @brief Repair several remapped mesh fields to account for boundary
+   *        mismatch.
+   *
+   * @param src_var_names        field variables on source mesh
+   * @param trg_var_names        field variables on target mesh
+   * @param global_lower_bounds  lower limit on each variable value
+   * @param global_upper_bounds  upper limit on each variable value
+   * @param conservation_tol     conservation tolerance treshold
+   * @param maxiter              max number of iterations
+   * @param partial_fixup_type   type of fixup in case of partial mismatch
+   * @param empty_fixup_type     type of fixup in empty target entities
+   * @return true if all variables were correctly fixed, false otherwise.
+   *
+   * The per-variable sums of the conservative fixup (source and target
+   * integrals, covered volume, then the new target integral and free
+   * volume at each repair iteration) are packed in one vector per stage
+   * so that each stage costs a single reduction whatever the number of
+   * variables. The reduction of the source integrals is non-blocking
+   * and overlaps the fixup of empty and partially filled entities.
+   */
+  template<typename T = double>
+  bool fix_mismatch_meshvars(std::vector<std::string> const& src_var_names,
+                             std::vector<std::string> const& trg_var_names,
+                             std::vector<double> const& global_lower_bounds,
+                             std::vector<double> const& global_upper_bounds,
+                             double conservation_tol,
+                             int maxiter,
+                             Partial_fixup_type partial_fixup_type,
+                             Empty_fixup_type empty_fixup_type) const {
 
     // valid only for part-by-part scenario
     assert(do_part_by_part_);
     static bool hit_lower_bound  = false;
     static bool hit_higher_bound = false;
 
+    int const nb_vars = src_var_names.size();
+
     // Now process remap variables
     // WARNING: absolute indexing
-    double const* source_data;
-    double*       target_data;
-
-    source_state_.mesh_get_data(onwhat, src_var_name, &source_data);
-    target_state_.mesh_get_data(onwhat, trg_var_name, &target_data);
-
-    if (partial_fixup_type == LOCALLY_CONSERVATIVE) {
-      // In interpolate step, we divided the accumulated integral (U)
-      // in a target cell by the intersection volume (v_i) instead of
-      // the target cell volume (v_c) to give a target field of u_t =
-      // U/v_i. In partially filled cells, this will preserve a
-      // constant source field but fill the cell with too much material
-      // (this is the equivalent of requesting Partial_fixup_type::CONSTANT).
-      // To restore conservation (as requested by
-      // Partial_fixup_type::LOCALLY_CONSERVATIVE), we undo the division by
-      // the intersection volume and then divide by the cell volume
-      // (u'_t = U/v_c = u_t*v_i/v_c). This does not affect the values
-      // in fully filled cells
+    std::vector<T const*> source_data(nb_vars);
+    std::vector<T*>       target_data(nb_vars);
 
-      for (auto&& entity : target_entities_) {
-        auto const& t = target_relative_index_.at(entity);
-        if (not is_cell_empty_[t]) {
+    for (int i = 0; i < nb_vars; ++i) {
+      source_state_.mesh_get_data(onwhat, src_var_names[i], &source_data[i]);
+      target_state_.mesh_get_data(onwhat, trg_var_names[i], &target_data[i]);
+    }
 
-          #if DEBUG_PART_BY_PART
-            std::printf("fixing target_data[%d] with locally conservative fixup\n", entity);
-            std::printf("= before: %.3f", target_data[entity]);
-          #endif
+    bool const shifted = (partial_fixup_type == SHIFTED_CONSERVATIVE);
 
-          auto const relative_voldiff =
-            std::abs(intersection_volumes_[t] - target_entities_volumes_[t])
-            / target_entities_volumes_[t];
+    // source integral of each variable then the covered target volume,
+    // reduced in place while the target fields are being filled in.
+    std::vector<double> source_sums;
+    double covered_target_volume = 0.;
+#ifdef PORTAGE_ENABLE_MPI
+    MPI_Request source_request = MPI_REQUEST_NULL;
+#endif
 
-          if (relative_voldiff > tolerance_) {
-            target_data[entity] *= intersection_volumes_[t] / target_entities_volumes_[t];
-          }
-          #if DEBUG_PART_BY_PART
-            std::printf(", after: %.3f\n", target_data[entity]);
-          #endif
+    if (shifted) {
+      source_sums.assign(nb_vars + 1, 0.);
+      for (int i = 0; i < nb_vars; ++i) {
+        for (auto&& s : source_entities_) {
+          int const j = source_relative_index(s);
+          source_sums[i] += source_data[i][s] * source_entities_volumes_[j];
         }
       }
-    }
-
-
-    if (empty_fixup_type != LEAVE_EMPTY) {
-      // Do something here to populate fully uncovered target
-      // cells. We have layers of empty cells starting out from fully
-      // or partially populated cells. We will assign every empty cell
-      // in a layer the average value of all its populated neighbors.
-      // IN A DISTRIBUTED MESH IT _IS_ POSSIBLE THAT AN EMPTY ENTITY
-      // WILL NOT HAVE ANY OWNED NEIGHBOR IN THIS PARTITION THAT HAS
-      // MEANINGFUL DATA TO EXTRAPOLATE FROM (we remap data only to
-      // owned entities)
-      int current_layer_number = 1;
 
-      for (auto const& current_layer : empty_layers_) {
-        for (auto&& entity : current_layer) {
-
-          double averaged_value = 0.;
-          int nb_extrapol = 0;
-          auto neighbors =
-            get_target_filtered_neighbors<Entity_type::PARALLEL_OWNED>(entity);
-
-          for (auto&& neigh : neighbors) {
-            auto const& i = target_relative_index_.at(neigh);
-            if (layer_num_[i] < current_layer_number) {
-              averaged_value += target_data[neigh];
-              nb_extrapol++;
-            }
-          }
-          if (nb_extrapol > 0) {
-            averaged_value /= nb_extrapol;
+      if (empty_fixup_type == LEAVE_EMPTY) {
+        for (auto&& entity : target_entities_) {
+          int const t = target_relative_index(entity);
+          if (not is_cell_empty_[t]) {
+            covered_target_volume += target_entities_volumes_[t];
           }
-          #if DEBUG_PART_BY_PART
-            else {
-              std::fprintf(stderr,
-                "No owned neighbors of empty entity to extrapolate data from\n"
-              );
-            }
-          #endif
-          target_data[entity] = averaged_value;
         }
-        current_layer_number++;
       }
+      source_sums[nb_vars] = covered_target_volume;
+
+#ifdef PORTAGE_ENABLE_MPI
+      if (distributed_) {
+        MPI_Iallreduce(
+          MPI_IN_PLACE, source_sums.data(), nb_vars + 1,
+          MPI_DOUBLE, MPI_SUM, mycomm_, &source_request
+        );
+      }
+#endif
+    }
+
+    for (int i = 0; i < nb_vars; ++i) {
+      fix_partial_and_empty_entities(target_data[i], partial_fixup_type,
+                                     empty_fixup_type);
     }
 
     // if the fixup scheme is constant or locally conservative then we're done
     if (partial_fixup_type == CONSTANT or partial_fixup_type == LOCALLY_CONSERVATIVE) {
       return true;
-    } else if (partial_fixup_type == SHIFTED_CONSERVATIVE) {
-
-      // At this point assume that all cells have some value in them
-      // for the variable
-      // Now compute the net discrepancy between integrals over source
-      // and target. Excess comes from target cells not fully covered by
-      // source cells and deficit from source cells not fully covered by
-      // target cells
-      double source_sum = 0.;
-      double target_sum = 0.;
-
-      for (auto&& s : source_entities_) {
-        auto const& i = source_relative_index_.at(s);
-        source_sum += source_data[s] * source_entities_volumes_[i];
-      }
+    } else if (not shifted) {
+      std::fprintf(stderr, "Unknown Partial fixup type\n");
+      return false;
+    }
+
+    // At this point assume that all cells have some value in them
+    // for the variables
+    // Now compute the net discrepancy between integrals over source
+    // and target. Excess comes from target cells not fully covered by
+    // source cells and deficit from source cells not fully covered by
+    // target cells
+    std::vector<double> target_sums(nb_vars, 0.);
 
+    for (int i = 0; i < nb_vars; ++i) {
       for (auto&& t : target_entities_) {
-        auto const& i = target_relative_index_.at(t);
-        target_sum += target_data[t] * target_entities_volumes_[i];
+        int const j = target_relative_index(t);
+        target_sums[i] += target_data[i][t] * target_entities_volumes_[j];
       }
-
-      double global_source_sum = source_sum;
-      double global_target_sum = target_sum;
+    }
 
 #ifdef PORTAGE_ENABLE_MPI
-      if (distributed_) {
-        MPI_Allreduce(
-          &source_sum, &global_source_sum, 1, MPI_DOUBLE, MPI_SUM, mycomm_
-        );
-
-        MPI_Allreduce(
-          &target_sum, &global_target_sum, 1, MPI_DOUBLE, MPI_SUM, mycomm_
-        );
-      }
+    if (distributed_) {
+      MPI_Request target_request;
+      MPI_Iallreduce(
+        MPI_IN_PLACE, target_sums.data(), nb_vars,
+        MPI_DOUBLE, MPI_SUM, mycomm_, &target_request
+      );
+      MPI_Wait(&source_request, MPI_STATUS_IGNORE);
+      MPI_Wait(&target_request, MPI_STATUS_IGNORE);
+    }
 #endif
 
-      double absolute_diff = global_target_sum - global_source_sum;
-      double relative_diff = absolute_diff / global_source_sum;
+    std::vector<double> const& global_source_sums = source_sums;
+    double const global_covered_target_volume = source_sums[nb_vars];
+
+    // Now redistribute the discrepancy among cells in proportion to
+    // their volume. This will restore conservation and if the
+    // original distribution was a constant it will make the field a
+    // slightly different constant. If some cells hit the bounds of the
+    // field, the shift that makes the clipped field conservative is
+    // searched for from the unshifted values and applied in a second
+    // pass (see find_bounded_shifts in fix_mismatch.h). Further
+    // iterations only mop up round-off.
+    double const global_full_volume = (
+      empty_fixup_type == LEAVE_EMPTY ? global_covered_target_volume
+                                      : global_target_volume_
+    );
+
+    // get the right entity type
+    auto target_entity_type = [&](int entity) -> Entity_type {
+      return (onwhat == Entity_kind::CELL ? target_mesh_.cell_get_type(entity)
+                                          : target_mesh_.node_get_type(entity));
+    };
+
+    // whether a target part entity is adjusted (relative index)
+    auto adjustable = [&](int t) {
+      int const entity = target_entities_[t];
+      bool is_owned = target_entity_type(entity) == Entity_type::PARALLEL_OWNED;
+      bool should_fix = (empty_fixup_type != LEAVE_EMPTY or not is_cell_empty_[t]);
+      return is_owned and should_fix;
+    };
+
+    std::vector<double> absolute_diff(nb_vars);
+    std::vector<double> relative_diff(nb_vars);
+    std::vector<double> udiff(nb_vars);
+    std::vector<int> active;  // variables still to be repaired
+
+    for (int i = 0; i < nb_vars; ++i) {
+      absolute_diff[i] = target_sums[i] - global_source_sums[i];
+      relative_diff[i] = absolute_diff[i] / global_source_sums[i];
+      // sort of a "unit" discrepancy or difference per unit volume
+      udiff[i] = absolute_diff[i] / global_full_volume;
 
-      if (std::abs(relative_diff) < conservation_tol) {
-        return true;  // discrepancy is too small - nothing to do
+      // otherwise discrepancy is too small - nothing to do
+      if (std::abs(relative_diff[i]) > conservation_tol) {
+        active.push_back(i);
       }
+    }
 
-      // Now redistribute the discrepancy among cells in proportion to
-      // their volume. This will restore conservation and if the
-      // original distribution was a constant it will make the field a
-      // slightly different constant. Do multiple iterations because
-      // we may have some leftover quantity that we were not able to
-      // add/subtract from some cells in any given iteration. We don't
-      // expect that process to take more than two iterations at the
-      // most.
-
-      double adj_target_volume;
-      double global_adj_target_volume;
-      double global_covered_target_volume;
-
-      if (empty_fixup_type == Empty_fixup_type::LEAVE_EMPTY) {
-        double covered_target_volume = 0.;
-        for (auto&& entity : target_entities_) {
-          auto const& t = target_relative_index_.at(entity);
-          if (not is_cell_empty_[t]) {
-            covered_target_volume += target_entities_volumes_[t];
+    // unshifted part values of the variables whose bounds may be hit,
+    // and the range of their adjustable values over all ranks (smallest
+    // value negated so that both ends are reduced with MPI_MAX).
+    std::vector<std::vector<double>> unshifted(nb_vars);
+    std::vector<double> value_ranges(2 * nb_vars,
+                                     -std::numeric_limits<double>::infinity());
+
+    for (int i : active) {
+      if (ClippedIntegral::is_bound(global_lower_bounds[i]) or
+          ClippedIntegral::is_bound(global_upper_bounds[i])) {
+        unshifted[i].resize(target_part_size_);
+        for (int t = 0; t < target_part_size_; ++t) {
+          double const value = target_data[i][target_entities_[t]];
+          unshifted[i][t] = value;
+          if (adjustable(t)) {
+            value_ranges[2 * i]     = std::max(value_ranges[2 * i], -value);
+            value_ranges[2 * i + 1] = std::max(value_ranges[2 * i + 1], value);
           }
         }
-        global_covered_target_volume = covered_target_volume;
+      }
+    }
+
 #ifdef PORTAGE_ENABLE_MPI
-        if (distributed_) {
-          MPI_Allreduce(
-            &covered_target_volume, &global_covered_target_volume,
-            1, MPI_DOUBLE, MPI_SUM, mycomm_
-          );
-        }
+    MPI_Request range_request = MPI_REQUEST_NULL;
+    if (distributed_) {
+      MPI_Iallreduce(
+        MPI_IN_PLACE, value_ranges.data(), 2 * nb_vars,
+        MPI_DOUBLE, MPI_MAX, mycomm_, &range_request
+      );
+    }
 #endif
-        adj_target_volume = covered_target_volume;
-        global_adj_target_volume = global_covered_target_volume;
-      }
-      else {
-        adj_target_volume = std::accumulate(
-          target_entities_volumes_.begin(), target_entities_volumes_.end(), 0
-        );
-        global_adj_target_volume = global_target_volume_;
-      }
 
-      // get the right entity type
-      auto target_entity_type = [&](int entity) -> Entity_type {
-        return (onwhat == Entity_kind::CELL ? target_mesh_.cell_get_type(entity)
-                                            : target_mesh_.node_get_type(entity));
-      };
+    // new target integral of each active variable then its adjusted
+    // target volume and its number of clipped cells, reduced in place.
+    std::vector<double> iter_sums;
 
-      // sort of a "unit" discrepancy or difference per unit volume
-      double udiff = absolute_diff / global_adj_target_volume;
+    int iter = 0;
+    while (not active.empty() and iter < maxiter) {
+      int const nb_active = active.size();
+      iter_sums.assign(3 * nb_active, 0.);
 
-      int iter = 0;
-      while (std::abs(relative_diff) > conservation_tol and iter < maxiter) {
+      for (int a = 0; a < nb_active; ++a) {
+        int const i = active[a];
+        T* data = target_data[i];
+        double adj_target_volume = 0.;
+        int nb_clipped = 0;
 
-        for (auto&& entity : target_entities_) {
-          auto const& t = target_relative_index_.at(entity);
-          bool is_owned = target_entity_type(entity) == Entity_type::PARALLEL_OWNED;
-          bool should_fix = (empty_fixup_type != LEAVE_EMPTY or not is_cell_empty_[t]);
+        for (int t = 0; t < target_part_size_; ++t) {
+          int const entity = target_entities_[t];
 
-          if (is_owned and should_fix) {
-            if ((target_data[entity] - udiff) < global_lower_bound) {
+          if (adjustable(t)) {
+            if ((data[entity] - udiff[i]) < global_lower_bounds[i]) {
               // Subtracting the full excess will make this cell violate the
               // lower bound. So subtract only as much as will put this cell
               // exactly at the lower bound
-              target_data[entity] = global_lower_bound;
+              data[entity] = global_lower_bounds[i];
+              nb_clipped++;
 
               if (not hit_lower_bound) {
                 std::fprintf(stderr,
@@ -756,15 +885,12 @@ public:
                 );
                 hit_lower_bound = true;
               }
-              // this cell is no longer in play for adjustment - so remove its
-              // volume from the adjusted target_volume
-              adj_target_volume -= target_entities_volumes_[t];
-
-            } else if ((target_data[entity] - udiff) > global_upper_bound) {  // udiff < 0
+            } else if ((data[entity] - udiff[i]) > global_upper_bounds[i]) {  // udiff < 0
               // Adding the full deficit will make this cell violate the
               // upper bound. So add only as much as will put this cell
               // exactly at the upper bound
-              target_data[entity] = global_upper_bound;
+              data[entity] = global_upper_bounds[i];
+              nb_clipped++;
 
               if (not hit_higher_bound) {
                 std::fprintf(stderr,
@@ -773,97 +899,361 @@ public:
                 );
                 hit_higher_bound = true;
               }
-
-              // this cell is no longer in play for adjustment - so remove its
-              // volume from the adjusted target_volume
-              adj_target_volume -= target_entities_volumes_[t];
             } else {
               // This is the equivalent of
               //           [curval*cellvol - diff*cellvol/meshvol]
               // curval = ---------------------------------------
               //                       cellvol
-              target_data[entity] -= udiff;
+              data[entity] -= udiff[i];
+              // this cell is still in play for adjustment
+              adj_target_volume += target_entities_volumes_[t];
             }
           }  // only non-empty cells
         }  // iterate through mesh cells
 
         // Compute the new integral over all processors
-        target_sum = 0.;
-        for (auto&& entity : target_entities_) {
-          auto const& t = target_relative_index_.at(entity);
-          target_sum += target_entities_volumes_[t] * target_data[entity];
+        for (int t = 0; t < target_part_size_; ++t) {
+          iter_sums[a] += target_entities_volumes_[t] * data[target_entities_[t]];
         }
+        iter_sums[nb_active + a] = adj_target_volume;
+        iter_sums[2 * nb_active + a] = nb_clipped;
+      }
 
-        global_target_sum = target_sum;
 #ifdef PORTAGE_ENABLE_MPI
-        if (distributed_) {
-          MPI_Allreduce(
-            &target_sum, &global_target_sum, 1, MPI_DOUBLE, MPI_SUM, mycomm_
-          );
-        }
+      if (distributed_) {
+        MPI_Allreduce(
+          MPI_IN_PLACE, iter_sums.data(), 3 * nb_active,
+          MPI_DOUBLE, MPI_SUM, mycomm_
+        );
+        MPI_Wait(&range_request, MPI_STATUS_IGNORE);
+      }
 #endif
 
-        // If we did not hit lower or upper bounds, this should be
-        // zero after the first iteration.  If we did hit some bounds,
-        // then recalculate the discrepancy and discrepancy per unit
-        // volume, but only taking into account volume of cells that
-        // are not already at the bounds - if we use the entire mesh
-        // volume for the recalculation, the convergence slows down
-        absolute_diff = global_target_sum - global_source_sum;
-        global_adj_target_volume = adj_target_volume;
+      // If we did not hit lower or upper bounds, this should be
+      // zero after the first iteration. If we did hit some bounds on
+      // the first iteration, search for the bounded shift. Otherwise
+      // recalculate the discrepancy and discrepancy per unit volume,
+      // but only taking into account volume of cells that are not
+      // already at the bounds.
+      std::vector<int> still_active;
+      std::vector<int> clipped;
+
+      for (int a = 0; a < nb_active; ++a) {
+        int const i = active[a];
+        absolute_diff[i] = iter_sums[a] - global_source_sums[i];
+        udiff[i] = absolute_diff[i] / iter_sums[nb_active + a];
+        relative_diff[i] = absolute_diff[i] / global_source_sums[i];
+
+        if (std::abs(relative_diff[i]) > conservation_tol) {
+          still_active.push_back(i);
+          if (iter == 0 and iter_sums[2 * nb_active + a] > 0 and
+              not unshifted[i].empty()) {
+            clipped.push_back(i);
+          }
+        }
+      }
+      active.swap(still_active);
+
+      if (not clipped.empty() and iter + 1 < maxiter) {
+        find_conservative_shifts(clipped, unshifted, value_ranges,
+                                 global_lower_bounds, global_upper_bounds,
+                                 global_source_sums, adjustable,
+                                 conservation_tol, maxiter, target_data,
+                                 &udiff);
+      }
+
+      iter++;
+    }  // while leftover is not zero
 
 #ifdef PORTAGE_ENABLE_MPI
-        if (distributed_) {
-          MPI_Allreduce(
-            &adj_target_volume, &global_adj_target_volume,
-            1, MPI_DOUBLE, MPI_SUM, mycomm_
-          );
-        }
+    if (distributed_)  // MPI may not even be initialized otherwise
+      MPI_Wait(&range_request, MPI_STATUS_IGNORE);  // if no iteration was done
 #endif
 
-        udiff = absolute_diff / global_adj_target_volume;
-        relative_diff = absolute_diff / global_source_sum;
-
-        // Now reset adjusted target mesh volume to be the full volume
-        // in preparation for the next iteration
-        global_adj_target_volume = (
-          empty_fixup_type == LEAVE_EMPTY ? global_covered_target_volume
-                                          : global_target_volume_
+    bool success = true;
+    for (int i : active) {
+      if (rank_ == 0) {
+        std::fprintf(stderr,
+          "Redistribution not entirely successfully for variable %s\n"
+          "Relative conservation error is %f\n"
+          "Absolute conservation error is %f\n",
+          src_var_names[i].data(), relative_diff[i], absolute_diff[i]
         );
+        success = false;
+      }
+    }
+
+    return success;
+  }
+
+
+private:
+
+  /**
+   * @brief Replace the shift of the given variables by the one that
+   * makes their clipped values conservative, and restore their
+   * unshifted values so that it can be applied.
+   *
+   * @param vars: variables whose shift is searched for.
+   * @param unshifted: unshifted part values of each variable.
+   * @param value_ranges: global range of adjustable values of each variable.
+   * @param global_lower_bounds: lower bound of each variable.
+   * @param global_upper_bounds: upper bound of each variable.
+   * @param global_source_sums: source integral of each variable.
+   * @param adjustable: whether a part entity is adjusted.
+   * @param conservation_tol: relative tolerance on the integrals.
+   * @param max_rounds: maximum number of bracketing rounds.
+   * @param target_data: target field of each variable.
+   * @param udiff: shift of each variable.
+   */
+  template<typename T, class Adjustable>
+  void find_conservative_shifts(std::vector<int> const& vars,
+                                std::vector<std::vector<double>> const& unshifted,
+                                std::vector<double> const& value_ranges,
+                                std::vector<double> const& global_lower_bounds,
+                                std::vector<double> const& global_upper_bounds,
+                                std::vector<double> const& global_source_sums,
+                                Adjustable adjustable, double conservation_tol,
+                                int max_rounds,
+                                std::vector<T*> const& target_data,
+                                std::vector<double>* udiff) const {
+
+    std::vector<int> adjusted;
+    std::vector<int> fixed;
+    for (int t = 0; t < target_part_size_; ++t) {
+      (adjustable(t) ? adjusted : fixed).push_back(t);
+    }
+
+    int const nb_adjusted = adjusted.size();
+    std::vector<double> volumes(nb_adjusted);
+    for (int e = 0; e < nb_adjusted; ++e) {
+      volumes[e] = target_entities_volumes_[adjusted[e]];
+    }
+
+    int const nb_vars = vars.size();
+    std::vector<ClippedIntegral> integrals;
+    std::vector<std::pair<double, double>> extremes(nb_vars);
+    std::vector<double> source_integrals(nb_vars);
+    std::vector<double> shifts(nb_vars);
+    integrals.reserve(nb_vars);
+
+    for (int k = 0; k < nb_vars; ++k) {
+      int const i = vars[k];
+      std::vector<double> values(nb_adjusted);
+      for (int e = 0; e < nb_adjusted; ++e) {
+        values[e] = unshifted[i][adjusted[e]];
+      }
+
+      double fixed_integral = 0.;
+      for (auto&& t : fixed) {
+        fixed_integral += unshifted[i][t] * target_entities_volumes_[t];
+      }
 
-        iter++;
-      }  // while leftover is not zero
-
-      if (std::abs(relative_diff) > conservation_tol) {
-        if (rank_ == 0) {
-          std::fprintf(stderr,
-            "Redistribution not entirely successfully for variable %s\n"
-            "Relative conservation error is %f\n"
-            "Absolute conservation error is %f\n",
-            src_var_name.data(), relative_diff, absolute_diff
-          );
-          return false;
+      integrals.emplace_back(std::move(values), volumes.data(),
+                             global_lower_bounds[i], global_upper_bounds[i],
+                             fixed_integral);
+
+      // breakpoints are at u - bound for each bound
+      double const min_value = -value_ranges[2 * i];
+      double const max_value = value_ranges[2 * i + 1];
+      extremes[k] = { std::numeric_limits<double>::infinity(),
+                      -std::numeric_limits<double>::infinity() };
+      for (double bound : { global_lower_bounds[i], global_upper_bounds[i] }) {
+        if (ClippedIntegral::is_bound(bound) and min_value <= max_value) {
+          extremes[k].first  = std::min(extremes[k].first, min_value - bound);
+          extremes[k].second = std::max(extremes[k].second, max_value - bound);
         }
       }
 
-      return true;
-    } else {
-      std::fprintf(stderr, "Unknown Partial fixup type\n");
-      return false;
+      source_integrals[k] = global_source_sums[i];
+      shifts[k] = (*udiff)[i];
+    }
+
+    auto sum_all = [&](double* values, int size) {
+#ifdef PORTAGE_ENABLE_MPI
+      if (distributed_) {
+        MPI_Allreduce(MPI_IN_PLACE, values, size, MPI_DOUBLE, MPI_SUM, mycomm_);
+      }
+#endif
+    };
+
+    find_bounded_shifts(&integrals, extremes, source_integrals,
+                        conservation_tol, max_rounds, sum_all, &shifts);
+
+    for (int k = 0; k < nb_vars; ++k) {
+      int const i = vars[k];
+      for (int t = 0; t < target_part_size_; ++t) {
+        target_data[i][target_entities_[t]] = unshifted[i][t];
+      }
+      (*udiff)[i] = shifts[k];
     }
   }
 
 
-private:
+
+  /**
+   * @brief Build the dense lookup tables of a part.
+   *
+   * Tables only span the range of entity IDs of the part, so that parts
+   * made of a small region of a large mesh stay cheap.
+   *
+   * @param entities       the part entities list
+   * @param first_id       smallest entity ID of the part
+   * @param lookup         lookup[k]: is entity 'first_id + k' in the part
+   * @param relative_index position of entity 'first_id + k' in the list
+   */
+  static void build_lookup(std::vector<int> const& entities, int* first_id,
+                           std::vector<bool>* lookup,
+                           std::vector<int>* relative_index) {
+    if (entities.empty()) {
+      *first_id = 0;
+      lookup->clear();
+      relative_index->clear();
+      return;
+    }
+
+    auto const range = std::minmax_element(entities.begin(), entities.end());
+    int const span = *range.second - *range.first + 1;
+    *first_id = *range.first;
+    lookup->assign(span, false);
+    relative_index->assign(span, -1);
+
+    int const part_size = entities.size();
+    for (int i = 0; i < part_size; ++i) {
+      int const k = entities[i] - *first_id;
+      (*lookup)[k] = true;
+      (*relative_index)[k] = i;
+    }
+  }
+
+  /**
+   * @brief Relative index of a source part entity.
+   *
+   * @param id entity ID, must be in the source part
+   * @return its index in the source entities list.
+   */
+  int source_relative_index(int id) const {
+    assert(is_source_entity(id));
+    return source_relative_index_[id - source_first_id_];
+  }
+
+  /**
+   * @brief Relative index of a target part entity.
+   *
+   * @param id entity ID, must be in the target part
+   * @return its index in the target entities list.
+   */
+  int target_relative_index(int id) const {
+    assert(is_target_entity(id));
+    return target_relative_index_[id - target_first_id_];
+  }
+
+  /**
+   * @brief Undo the division by the intersection volume in partially
+   *        filled entities (if locally conservative) and extrapolate
+   *        values into empty entities (unless they are left empty).
+   *
+   * @param target_data         field values on the target mesh
+   * @param partial_fixup_type  type of fixup in case of partial mismatch
+   * @param empty_fixup_type    type of fixup in empty target entities
+   */
+  template<typename T>
+  void fix_partial_and_empty_entities(T* target_data,
+                                      Partial_fixup_type partial_fixup_type,
+                                      Empty_fixup_type empty_fixup_type) const {
+    if (partial_fixup_type == LOCALLY_CONSERVATIVE) {
+      // In interpolate step, we divided the accumulated integral (U)
+      // in a target cell by the intersection volume (v_i) instead of
+      // the target cell volume (v_c) to give a target field of u_t =
+      // U/v_i. In partially filled cells, this will preserve a
+      // constant source field but fill the cell with too much material
+      // (this is the equivalent of requesting Partial_fixup_type::CONSTANT).
+      // To restore conservation (as requested by
+      // Partial_fixup_type::LOCALLY_CONSERVATIVE), we undo the division by
+      // the intersection volume and then divide by the cell volume
+      // (u'_t = U/v_c = u_t*v_i/v_c). This does not affect the values
+      // in fully filled cells
+
+      for (auto&& entity : target_entities_) {
+        int const t = target_relative_index(entity);
+        if (not is_cell_empty_[t]) {
+
+          #if DEBUG_PART_BY_PART
+            std::printf("fixing target_data[%d] with locally conservative fixup\n", entity);
+            std::printf("= before: %.3f", target_data[entity]);
+          #endif
+
+          auto const relative_voldiff =
+            std::abs(intersection_volumes_[t] - target_entities_volumes_[t])
+            / target_entities_volumes_[t];
+
+          if (relative_voldiff > tolerance_) {
+            target_data[entity] *= intersection_volumes_[t] / target_entities_volumes_[t];
+          }
+          #if DEBUG_PART_BY_PART
+            std::printf(", after: %.3f\n", target_data[entity]);
+          #endif
+        }
+      }
+    }
+
+
+    if (empty_fixup_type != LEAVE_EMPTY) {
+      // Do something here to populate fully uncovered target
+      // cells. We have layers of empty cells starting out from fully
+      // or partially populated cells. We will assign every empty cell
+      // in a layer the average value of all its populated neighbors.
+      // IN A DISTRIBUTED MESH IT _IS_ POSSIBLE THAT AN EMPTY ENTITY
+      // WILL NOT HAVE ANY OWNED NEIGHBOR IN THIS PARTITION THAT HAS
+      // MEANINGFUL DATA TO EXTRAPOLATE FROM (we remap data only to
+      // owned entities)
+      int current_layer_number = 1;
+
+      for (auto const& current_layer : empty_layers_) {
+        for (auto&& entity : current_layer) {
+
+          double averaged_value = 0.;
+          int nb_extrapol = 0;
+          auto neighbors =
+            get_target_filtered_neighbors<Entity_type::PARALLEL_OWNED>(entity);
+
+          for (auto&& neigh : neighbors) {
+            int const i = target_relative_index(neigh);
+            if (layer_num_[i] < current_layer_number) {
+              averaged_value += target_data[neigh];
+              nb_extrapol++;
+            }
+          }
+          if (nb_extrapol > 0) {
+            averaged_value /= nb_extrapol;
+          }
+          #if DEBUG_PART_BY_PART
+            else {
+              std::fprintf(stderr,
+                "No owned neighbors of empty entity to extrapolate data from\n"
+              );
+            }
+          #endif
+          target_data[entity] = averaged_value;
+        }
+        current_layer_number++;
+      }
+    }
+  }
 
   // references to user-provided entities lists
   std::vector<int> const& source_entities_;
   std::vector<int> const& target_entities_;
 
-  // hashtables to have constant-time parts lookup queries in average case.
+  // dense lookup tables over the range of entity IDs spanned by each part:
+  // membership bits and relative index of entity 'first_id + k' (or -1).
   // remark: for lookup purposes only, not meant to be iterated.
-  std::unordered_set<int> source_lookup_;
-  std::unordered_set<int> target_lookup_;
+  int source_first_id_ = 0;
+  int target_first_id_ = 0;
+  std::vector<bool> source_lookup_ = {};
+  std::vector<bool> target_lookup_ = {};
+  std::vector<int>  source_relative_index_ = {};
+  std::vector<int>  target_relative_index_ = {};
 
 
   bool do_part_by_part_    = false;
@@ -893,6 +1283,9 @@ private:
   std::vector<double> target_entities_volumes_ = {};
   std::vector<double> intersection_volumes_    = {};
 
+  // intersection weights of target part entities within the source part
+  Portage::vector<entity_weights_t> part_weights_ = {};
+
   // data needed for mismatch checks
   double global_source_volume_    = 0.;
   double global_target_volume_    = 0.;
@@ -900,8 +1293,6 @@ private:
   double relative_voldiff_        = 0.;
 
   // empty target cells management
-  std::map<int,int> source_relative_index_    = {};
-  std::map<int,int> target_relative_index_    = {};
   std::vector<int>  layer_num_                = {};
   std::vector<bool> is_cell_empty_            = {};
   std::vector<std::vector<int>> empty_layers_ = {};
@@ -0,0 +1,401 @@
+/*
+This file is part of the Ristra portage project.
+Please see the license file at the root of this repository, or at:
+    https://github.com/laristra/portage/blob/master/LICENSE
+*/
+
+
+#include <iostream>
+#include <memory>
+#include <limits>
+#include <numeric>
+#include <vector>
+#include <cmath>
+
+#include "gtest/gtest.h"
+#include "mpi.h"
+
+#include "portage/support/portage.h"
+
+#include "wonton/mesh/jali/jali_mesh_wrapper.h"
+#include "wonton/state/jali/jali_state_wrapper.h"
+#include "portage/search/search_kdtree.h"
+#include "portage/intersect/intersect_r2d.h"
+#include "portage/interpolate/interpolate_1st_order.h"
+#include "portage/interpolate/interpolate_2nd_order.h"
+#include "portage/interpolate/interpolate_3rd_order.h"
+#include "portage/driver/coredriver.h"
+
+#include "Mesh.hh"
+#include "MeshFactory.hh"
+#include "JaliState.h"
+#include "JaliStateVector.h"
+
+
+// Options of the core driver that change how the remap is done but
+// not its result (or make it more accurate)
+
+double TOL = 1e-12;
+
+
+// Node remap on rectangular meshes with the dual cells intersected as
+// boxes gives the same weights as the general intersection
+
+TEST(CoreDriver, RectangularNodeRemap) {
+  Jali::MeshFactory mf(MPI_COMM_WORLD);
+  if (Jali::framework_available(Jali::MSTK))
+    mf.framework(Jali::MSTK);
+  mf.included_entities({Jali::Entity_kind::CORNER, Jali::Entity_kind::WEDGE});
+  std::shared_ptr<Jali::Mesh> source_mesh = mf(0.0, 0.0, 1.0, 1.0, 4, 4);
+  std::shared_ptr<Jali::Mesh> target_mesh = mf(0.0, 0.0, 1.0, 1.0, 5, 7);
+
+  std::shared_ptr<Jali::State> source_state(Jali::State::create(source_mesh));
+  std::shared_ptr<Jali::State> target_state(Jali::State::create(target_mesh));
+
+  Wonton::Jali_Mesh_Wrapper sourceMeshWrapper(*source_mesh);
+  Wonton::Jali_Mesh_Wrapper targetMeshWrapper(*target_mesh);
+  Wonton::Jali_State_Wrapper sourceStateWrapper(*source_state);
+  Wonton::Jali_State_Wrapper targetStateWrapper(*target_state);
+
+  sourceStateWrapper.mesh_add_data<double>(Wonton::Entity_kind::NODE,
+                                           "pressure", 2.5);
+  targetStateWrapper.mesh_add_data<double>(Wonton::Entity_kind::NODE,
+                                           "pressure", 0.0);
+
+  using Driver = Portage::CoreDriver<2, Wonton::Entity_kind::NODE,
+                                     Wonton::Jali_Mesh_Wrapper,
+                                     Wonton::Jali_State_Wrapper>;
+  Driver general(sourceMeshWrapper, sourceStateWrapper,
+                 targetMeshWrapper, targetStateWrapper);
+  Driver rect(sourceMeshWrapper, sourceStateWrapper,
+              targetMeshWrapper, targetStateWrapper);
+  rect.set_rectangular_mesh(true);
+
+  auto candidates = general.search<Portage::SearchKDTree>();
+  auto general_wts = general.intersect_meshes<Portage::IntersectR2D>(candidates);
+  auto rect_wts = rect.intersect_meshes<Portage::IntersectR2D>(candidates);
+
+  const int nnodes_target =
+      target_mesh->num_entities(Jali::Entity_kind::NODE,
+                                Jali::Entity_type::PARALLEL_OWNED);
+  const int nnodes_source =
+      source_mesh->num_entities(Jali::Entity_kind::NODE,
+                                Jali::Entity_type::ALL);
+  for (int n = 0; n < nnodes_target; n++) {
+    // moments of each source node, zero if it does not intersect
+    std::vector<std::vector<double>> gw(nnodes_source,
+                                        std::vector<double>(3, 0.0));
+    std::vector<std::vector<double>> rw(gw);
+    std::vector<Portage::Weights_t> const& gwts = general_wts[n];
+    std::vector<Portage::Weights_t> const& rwts = rect_wts[n];
+    for (auto const& wt : gwts)
+      gw[wt.entityID] = wt.weights;
+    for (auto const& wt : rwts)
+      rw[wt.entityID] = wt.weights;
+
+    for (int s = 0; s < nnodes_source; s++)
+      for (int k = 0; k < 3; k++)
+        ASSERT_NEAR(gw[s][k], rw[s][k], TOL);
+  }
+
+  ASSERT_FALSE(rect.check_mesh_mismatch(rect_wts));
+
+  double dblmin = -std::numeric_limits<double>::max();
+  double dblmax =  std::numeric_limits<double>::max();
+  rect.interpolate_mesh_var<double, Portage::Interpolate_1stOrder>(
+      "pressure", "pressure", rect_wts, dblmin, dblmax);
+
+  double *target_data;
+  targetStateWrapper.mesh_get_data(Wonton::Entity_kind::NODE, "pressure",
+                                   &target_data);
+  for (int n = 0; n < nnodes_target; n++)
+    ASSERT_NEAR(2.5, target_data[n], TOL);
+}
+
+
+// 3rd order remap with second moments from the intersection integrates
+// the quadratic fits exactly. On coincident meshes the remapped value
+// of an interior cell is then the exact average of a quadratic field
+// sampled at the source centroids, while with first moments only it is
+// the centroid value.
+
+TEST(CoreDriver, SecondMoments3rdOrder) {
+  Jali::MeshFactory mf(MPI_COMM_WORLD);
+  if (Jali::framework_available(Jali::MSTK))
+    mf.framework(Jali::MSTK);
+  int const n = 6;
+  double const h = 1.0/n;
+  std::shared_ptr<Jali::Mesh> source_mesh = mf(0.0, 0.0, 1.0, 1.0, n, n);
+  std::shared_ptr<Jali::Mesh> target_mesh = mf(0.0, 0.0, 1.0, 1.0, n, n);
+
+  std::shared_ptr<Jali::State> source_state(Jali::State::create(source_mesh));
+  std::shared_ptr<Jali::State> target_state(Jali::State::create(target_mesh));
+
+  Wonton::Jali_Mesh_Wrapper sourceMeshWrapper(*source_mesh);
+  Wonton::Jali_Mesh_Wrapper targetMeshWrapper(*target_mesh);
+  Wonton::Jali_State_Wrapper sourceStateWrapper(*source_state);
+  Wonton::Jali_State_Wrapper targetStateWrapper(*target_state);
+
+  const int ncells =
+      source_mesh->num_entities(Jali::Entity_kind::CELL, Jali::Entity_type::ALL);
+  std::vector<double> source_data(ncells);
+  for (int c = 0; c < ncells; c++) {
+    Wonton::Point<2> cen;
+    sourceMeshWrapper.cell_centroid(c, &cen);
+    source_data[c] = cen[0]*cen[0];
+  }
+  sourceStateWrapper.mesh_add_data(Wonton::Entity_kind::CELL, "density",
+                                   source_data.data());
+  targetStateWrapper.mesh_add_data<double>(Wonton::Entity_kind::CELL,
+                                           "first", 0.0);
+  targetStateWrapper.mesh_add_data<double>(Wonton::Entity_kind::CELL,
+                                           "second", 0.0);
+
+  using Driver = Portage::CoreDriver<2, Wonton::Entity_kind::CELL,
+                                     Wonton::Jali_Mesh_Wrapper,
+                                     Wonton::Jali_State_Wrapper>;
+  Driver first(sourceMeshWrapper, sourceStateWrapper,
+               targetMeshWrapper, targetStateWrapper);
+  Driver second(sourceMeshWrapper, sourceStateWrapper,
+                targetMeshWrapper, targetStateWrapper);
+  second.set_moment_order(2);
+
+  auto candidates = first.search<Portage::SearchKDTree>();
+  auto first_wts = first.intersect_meshes<Portage::IntersectR2D>(candidates);
+  auto second_wts = second.intersect_meshes<Portage::IntersectR2D>(candidates);
+  ASSERT_FALSE(first.check_mesh_mismatch(first_wts));
+  ASSERT_FALSE(second.check_mesh_mismatch(second_wts));
+
+  for (int c = 0; c < ncells; c++) {
+    std::vector<Portage::Weights_t> const& fw = first_wts[c];
+    std::vector<Portage::Weights_t> const& sw = second_wts[c];
+    for (auto const& wt : fw) ASSERT_EQ(3, wt.weights.size());
+    for (auto const& wt : sw) ASSERT_EQ(6, wt.weights.size());
+  }
+
+  double dblmin = -std::numeric_limits<double>::max();
+  double dblmax =  std::numeric_limits<double>::max();
+  first.interpolate_mesh_var<double, Portage::Interpolate_3rdOrder>(
+      "density", "first", first_wts, dblmin, dblmax,
+      Portage::NOLIMITER, Portage::BND_NOLIMITER);
+  second.interpolate_mesh_var<double, Portage::Interpolate_3rdOrder>(
+      "density", "second", second_wts, dblmin, dblmax,
+      Portage::NOLIMITER, Portage::BND_NOLIMITER);
+
+  double *first_data, *second_data;
+  targetStateWrapper.mesh_get_data(Wonton::Entity_kind::CELL, "first",
+                                   &first_data);
+  targetStateWrapper.mesh_get_data(Wonton::Entity_kind::CELL, "second",
+                                   &second_data);
+
+  int ninterior = 0;
+  for (int c = 0; c < ncells; c++) {
+    if (targetMeshWrapper.on_exterior_boundary(Wonton::Entity_kind::CELL, c))
+      continue;  // linear fit only
+    ninterior++;
+
+    Wonton::Point<2> cen;
+    targetMeshWrapper.cell_centroid(c, &cen);
+    ASSERT_NEAR(cen[0]*cen[0], first_data[c], TOL);
+    ASSERT_NEAR(cen[0]*cen[0] + h*h/12, second_data[c], TOL);
+  }
+  ASSERT_EQ((n-2)*(n-2), ninterior);
+}
+
+
+// Second order remap with a remap matrix assembled with gradient
+// offsets gives the same result as the Interpolate_2ndOrder
+// interpolator, with and without limiter
+
+TEST(CoreDriver, RemapMatrixWithGradients) {
+  Jali::MeshFactory mf(MPI_COMM_WORLD);
+  if (Jali::framework_available(Jali::MSTK))
+    mf.framework(Jali::MSTK);
+  std::shared_ptr<Jali::Mesh> source_mesh = mf(0.0, 0.0, 1.0, 1.0, 5, 5);
+  std::shared_ptr<Jali::Mesh> target_mesh = mf(0.0, 0.0, 1.0, 1.0, 7, 6);
+
+  std::shared_ptr<Jali::State> source_state(Jali::State::create(source_mesh));
+  std::shared_ptr<Jali::State> target_state(Jali::State::create(target_mesh));
+
+  Wonton::Jali_Mesh_Wrapper sourceMeshWrapper(*source_mesh);
+  Wonton::Jali_Mesh_Wrapper targetMeshWrapper(*target_mesh);
+  Wonton::Jali_State_Wrapper sourceStateWrapper(*source_state);
+  Wonton::Jali_State_Wrapper targetStateWrapper(*target_state);
+
+  const int ncells_source =
+      source_mesh->num_entities(Jali::Entity_kind::CELL, Jali::Entity_type::ALL);
+  std::vector<double> density(ncells_source), energy(ncells_source);
+  for (int c = 0; c < ncells_source; c++) {
+    Wonton::Point<2> cen;
+    sourceMeshWrapper.cell_centroid(c, &cen);
+    density[c] = 1.0 + 2.0*cen[0] + cen[1];
+    energy[c] = cen[0] < 0.5 ? 1.0 : 10.0;  // limiter is active
+  }
+  sourceStateWrapper.mesh_add_data(Wonton::Entity_kind::CELL, "density",
+                                   density.data());
+  sourceStateWrapper.mesh_add_data(Wonton::Entity_kind::CELL, "energy",
+                                   energy.data());
+  for (std::string name : {"density_interp", "energy_interp",
+                           "density_matrix", "energy_matrix"})
+    targetStateWrapper.mesh_add_data<double>(Wonton::Entity_kind::CELL,
+                                             name, 0.0);
+
+  using Driver = Portage::CoreDriver<2, Wonton::Entity_kind::CELL,
+                                     Wonton::Jali_Mesh_Wrapper,
+                                     Wonton::Jali_State_Wrapper>;
+  Driver driver(sourceMeshWrapper, sourceStateWrapper,
+                targetMeshWrapper, targetStateWrapper);
+
+  auto candidates = driver.search<Portage::SearchKDTree>();
+  auto weights = driver.intersect_meshes<Portage::IntersectR2D>(candidates);
+  ASSERT_FALSE(driver.check_mesh_mismatch(weights));
+
+  double dblmin = -std::numeric_limits<double>::max();
+  double dblmax =  std::numeric_limits<double>::max();
+
+  for (auto limiter : {Portage::NOLIMITER, Portage::BARTH_JESPERSEN}) {
+    driver.interpolate_mesh_var<double, Portage::Interpolate_2ndOrder>(
+        "density", "density_interp", weights, dblmin, dblmax,
+        limiter, Portage::BND_NOLIMITER);
+    driver.interpolate_mesh_var<double, Portage::Interpolate_2ndOrder>(
+        "energy", "energy_interp", weights, dblmin, dblmax,
+        limiter, Portage::BND_NOLIMITER);
+
+    auto matrix = driver.assemble_remap_matrix(weights, true);
+    ASSERT_TRUE(matrix.has_gradient_offsets());
+    driver.apply_remap_matrix<double>(matrix, {"density", "energy"},
+                                      {"density_matrix", "energy_matrix"},
+                                      {dblmin, dblmin}, {dblmax, dblmax},
+                                      limiter, Portage::BND_NOLIMITER);
+
+    for (std::string name : {"density", "energy"}) {
+      double *interp_data, *matrix_data;
+      targetStateWrapper.mesh_get_data(Wonton::Entity_kind::CELL,
+                                       name + "_interp", &interp_data);
+      targetStateWrapper.mesh_get_data(Wonton::Entity_kind::CELL,
+                                       name + "_matrix", &matrix_data);
+      const int ncells_target =
+          target_mesh->num_entities(Jali::Entity_kind::CELL,
+                                    Jali::Entity_type::PARALLEL_OWNED);
+      for (int c = 0; c < ncells_target; c++)
+        ASSERT_NEAR(interp_data[c], matrix_data[c], TOL);
+    }
+  }
+}
+
+
+// Fields stored as float are remapped in double and rounded back, so
+// 1st and 2nd order remaps (with the limiter active and a mismatch
+// between the meshes to fix up) agree with the remap of the same field
+// stored as double to float precision, whether the mismatch is fixed
+// on the whole mesh or on a part pair
+
+TEST(CoreDriver, FloatFields) {
+  Jali::MeshFactory mf(MPI_COMM_WORLD);
+  if (Jali::framework_available(Jali::MSTK))
+    mf.framework(Jali::MSTK);
+  std::shared_ptr<Jali::Mesh> source_mesh = mf(0.0, 0.0, 1.0, 1.0, 5, 5);
+  std::shared_ptr<Jali::Mesh> target_mesh = mf(0.0, 0.0, 1.2, 1.0, 7, 6);
+
+  std::shared_ptr<Jali::State> source_state(Jali::State::create(source_mesh));
+  std::shared_ptr<Jali::State> target_state(Jali::State::create(target_mesh));
+
+  Wonton::Jali_Mesh_Wrapper sourceMeshWrapper(*source_mesh);
+  Wonton::Jali_Mesh_Wrapper targetMeshWrapper(*target_mesh);
+  Wonton::Jali_State_Wrapper sourceStateWrapper(*source_state);
+  Wonton::Jali_State_Wrapper targetStateWrapper(*target_state);
+
+  const int ncells_source =
+      source_mesh->num_entities(Jali::Entity_kind::CELL, Jali::Entity_type::ALL);
+  const int ncells_target =
+      target_mesh->num_entities(Jali::Entity_kind::CELL,
+                                Jali::Entity_type::PARALLEL_OWNED);
+
+  std::vector<double> density_double(ncells_source);
+  std::vector<float> density_float(ncells_source);
+  for (int c = 0; c < ncells_source; c++) {
+    Wonton::Point<2> cen;
+    sourceMeshWrapper.cell_centroid(c, &cen);
+    // limiter is active at the jump
+    density_float[c] = cen[0] < 0.5 ? 1.0 + 2.0*cen[0] + cen[1] : 10.0 + cen[1];
+    density_double[c] = density_float[c];
+  }
+  sourceStateWrapper.mesh_add_data(Wonton::Entity_kind::CELL, "density_double",
+                                   density_double.data());
+  sourceStateWrapper.mesh_add_data(Wonton::Entity_kind::CELL, "density_float",
+                                   density_float.data());
+  targetStateWrapper.mesh_add_data<double>(Wonton::Entity_kind::CELL,
+                                           "density_double", 0.0);
+  targetStateWrapper.mesh_add_data<float>(Wonton::Entity_kind::CELL,
+                                          "density_float", 0.0);
+
+  using Driver = Portage::CoreDriver<2, Wonton::Entity_kind::CELL,
+                                     Wonton::Jali_Mesh_Wrapper,
+                                     Wonton::Jali_State_Wrapper>;
+  using PartPair = Portage::PartPair<2, Wonton::Entity_kind::CELL,
+                                     Wonton::Jali_Mesh_Wrapper,
+                                     Wonton::Jali_State_Wrapper>;
+  Driver driver(sourceMeshWrapper, sourceStateWrapper,
+                targetMeshWrapper, targetStateWrapper);
+
+  auto candidates = driver.search<Portage::SearchKDTree>();
+  auto weights = driver.intersect_meshes<Portage::IntersectR2D>(candidates);
+  ASSERT_TRUE(driver.check_mesh_mismatch(weights));
+
+  std::vector<int> source_cells(ncells_source), target_cells(ncells_target);
+  std::iota(source_cells.begin(), source_cells.end(), 0);
+  std::iota(target_cells.begin(), target_cells.end(), 0);
+  PartPair part(sourceMeshWrapper, sourceStateWrapper,
+                targetMeshWrapper, targetStateWrapper,
+                source_cells, target_cells, nullptr);
+  part.check_mismatch(weights);
+  ASSERT_TRUE(part.has_mismatch());
+
+  double dblmin = -std::numeric_limits<double>::max();
+  double dblmax =  std::numeric_limits<double>::max();
+  float fltmin = -std::numeric_limits<float>::max();
+  float fltmax =  std::numeric_limits<float>::max();
+
+  auto compare = [&]() {
+    double* remapped_double;
+    float* remapped_float;
+    targetStateWrapper.mesh_get_data(Wonton::Entity_kind::CELL,
+                                     "density_double", &remapped_double);
+    targetStateWrapper.mesh_get_data(Wonton::Entity_kind::CELL,
+                                     "density_float", &remapped_float);
+    for (int c = 0; c < ncells_target; c++)
+      ASSERT_NEAR(remapped_double[c], remapped_float[c],
+                  1e-6 * std::abs(remapped_double[c]));
+  };
+
+  for (PartPair const* partition : {static_cast<PartPair const*>(nullptr),
+                                    static_cast<PartPair const*>(&part)}) {
+    driver.interpolate_mesh_var<double, Portage::Interpolate_1stOrder>(
+        "density_double", "density_double", weights, dblmin, dblmax,
+        Portage::BARTH_JESPERSEN, Portage::BND_NOLIMITER,
+        Portage::SHIFTED_CONSERVATIVE, Portage::EXTRAPOLATE,
+        Portage::DEFAULT_CONSERVATION_TOL, Portage::DEFAULT_MAX_FIXUP_ITER,
+        partition);
+    driver.interpolate_mesh_var<float, Portage::Interpolate_1stOrder>(
+        "density_float", "density_float", weights, fltmin, fltmax,
+        Portage::BARTH_JESPERSEN, Portage::BND_NOLIMITER,
+        Portage::SHIFTED_CONSERVATIVE, Portage::EXTRAPOLATE,
+        Portage::DEFAULT_CONSERVATION_TOL, Portage::DEFAULT_MAX_FIXUP_ITER,
+        partition);
+    compare();
+
+    driver.interpolate_mesh_var<double, Portage::Interpolate_2ndOrder>(
+        "density_double", "density_double", weights, dblmin, dblmax,
+        Portage::BARTH_JESPERSEN, Portage::BND_NOLIMITER,
+        Portage::SHIFTED_CONSERVATIVE, Portage::EXTRAPOLATE,
+        Portage::DEFAULT_CONSERVATION_TOL, Portage::DEFAULT_MAX_FIXUP_ITER,
+        partition);
+    driver.interpolate_mesh_var<float, Portage::Interpolate_2ndOrder>(
+        "density_float", "density_float", weights, fltmin, fltmax,
+        Portage::BARTH_JESPERSEN, Portage::BND_NOLIMITER,
+        Portage::SHIFTED_CONSERVATIVE, Portage::EXTRAPOLATE,
+        Portage::DEFAULT_CONSERVATION_TOL, Portage::DEFAULT_MAX_FIXUP_ITER,
+        partition);
+    compare();
+  }
+}
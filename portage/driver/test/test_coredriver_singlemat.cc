@@ -214,4 +214,74 @@ TEST(CellDriver, 3D_2ndOrder) {
 }  // CellDriver_3D_2ndOrder
 
 
+// Remap two fields at once with a single pass over the weights
+
+TEST(CellDriver, 2D_2ndOrder_MultiVar) {
+  std::shared_ptr<Jali::Mesh> sourceMesh =
+      Jali::MeshFactory(MPI_COMM_WORLD)(0.0, 0.0, 1.0, 1.0, 5, 5);
+  std::shared_ptr<Jali::Mesh> targetMesh =
+      Jali::MeshFactory(MPI_COMM_WORLD)(0.0, 0.0, 1.0, 1.0, 7, 6);
+
+  std::shared_ptr<Jali::State> sourceState = Jali::State::create(sourceMesh);
+  std::shared_ptr<Jali::State> targetState = Jali::State::create(targetMesh);
+
+  Wonton::Jali_Mesh_Wrapper sourceMeshWrapper(*sourceMesh);
+  Wonton::Jali_Mesh_Wrapper targetMeshWrapper(*targetMesh);
+  Wonton::Jali_State_Wrapper sourceStateWrapper(*sourceState);
+  Wonton::Jali_State_Wrapper targetStateWrapper(*targetState);
+
+  int nsrccells = sourceMeshWrapper.num_entities(Wonton::Entity_kind::CELL,
+                                                 Wonton::Entity_type::ALL);
+
+  std::vector<double> srctemp(nsrccells), srcdens(nsrccells);
+  for (int c = 0; c < nsrccells; c++) {
+    Wonton::Point<2> cen;
+    sourceMeshWrapper.cell_centroid(c, &cen);
+    srctemp[c] = cen[0] + 2*cen[1];
+    srcdens[c] = 3*cen[0] - cen[1] + 1;
+  }
+
+  sourceStateWrapper.mesh_add_data(Wonton::Entity_kind::CELL,
+                                   "temperature", srctemp.data());
+  sourceStateWrapper.mesh_add_data(Wonton::Entity_kind::CELL,
+                                   "density", srcdens.data());
+
+  targetStateWrapper.mesh_add_data<double>(Wonton::Entity_kind::CELL,
+                                           "temperature", 0.0);
+  targetStateWrapper.mesh_add_data<double>(Wonton::Entity_kind::CELL,
+                                           "density", 0.0);
+
+  Portage::CoreDriver<2, Wonton::Entity_kind::CELL,
+                      Wonton::Jali_Mesh_Wrapper, Wonton::Jali_State_Wrapper>
+      d(sourceMeshWrapper, sourceStateWrapper,
+        targetMeshWrapper, targetStateWrapper);
+
+  auto candidates = d.search<Portage::SearchKDTree>();
+  auto srcwts = d.intersect_meshes<Portage::IntersectR2D>(candidates);
+  d.check_mesh_mismatch(srcwts);
+
+  double dblmin = -std::numeric_limits<double>::max();
+  double dblmax =  std::numeric_limits<double>::max();
+
+  std::vector<std::string> varnames = {"temperature", "density"};
+  d.interpolate_mesh_vars<double, Portage::Interpolate_2ndOrder>(
+      varnames, varnames, srcwts, {dblmin, dblmin}, {dblmax, dblmax});
+
+  double *targettemp, *targetdens;
+  targetStateWrapper.mesh_get_data(Wonton::Entity_kind::CELL, "temperature",
+                                   &targettemp);
+  targetStateWrapper.mesh_get_data(Wonton::Entity_kind::CELL, "density",
+                                   &targetdens);
+
+  int ntrgcells = targetMeshWrapper.num_entities(Wonton::Entity_kind::CELL,
+                                                 Wonton::Entity_type::ALL);
+  for (int c = 0; c < ntrgcells; c++) {
+    Wonton::Point<2> cen;
+    targetMeshWrapper.cell_centroid(c, &cen);
+    ASSERT_NEAR(targettemp[c], cen[0] + 2*cen[1], 1.0e-10);
+    ASSERT_NEAR(targetdens[c], 3*cen[0] - cen[1] + 1, 1.0e-10);
+  }
+}  // CellDriver_2D_2ndOrder_MultiVar
+
+
 #endif  // ifdef HAVE_TANGRAM
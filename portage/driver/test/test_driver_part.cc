@@ -6,6 +6,7 @@
 
 #include <iostream>
 #include <memory>
+#include <numeric>
 
 #include "gtest/gtest.h"
 #ifdef PORTAGE_ENABLE_MPI
@@ -19,6 +20,7 @@
 #include "portage/intersect/intersect_r3d.h"
 #include "portage/intersect/simple_intersect_for_tests.h"
 #include "portage/interpolate/interpolate_1st_order.h"
+#include "portage/interpolate/interpolate_2nd_order.h"
 #include "Mesh.hh"
 #include "MeshFactory.hh"
 #include "JaliStateVector.h"
@@ -217,6 +219,101 @@ TEST_F(PartDriverTest, PiecewiseConstantField) {
   }
 }
 
+// sanity check 1b: same as sanity check 1 but with each part pair
+// searched and intersected on its own, so that only the entities of
+// the source part are intersected with those of the target part.
+TEST_F(PartDriverTest, PartRestrictedIntersection) {
+
+  Remapper remapper(source_mesh_wrapper, source_state_wrapper,
+                    target_mesh_wrapper, target_state_wrapper);
+
+  double* original = nullptr;
+  double* remapped = nullptr;
+
+  // assign a piecewise constant field on source mesh
+  source_state_wrapper.mesh_get_data(CELL, "density", &original);
+  for (int c = 0; c < nb_source_cells; c++) {
+    auto centroid = source_mesh->cell_centroid(c);
+    original[c] = (centroid[0] < 0.40 ? 30. : 100.);
+  }
+
+  for (int i = 0; i < 2; ++i) {
+    // process part-restricted search and intersection
+    auto candidates = remapper.search<Portage::SearchKDTree>(parts[i]);
+    auto weights = remapper.intersect_meshes<Portage::IntersectR2D>(candidates, parts[i]);
+
+    // only source part entities are kept
+    for (auto&& c : target_cells[i])
+      for (auto&& weight : weights[c])
+        ASSERT_TRUE(parts[i].is_source_entity(weight.entityID));
+
+    // test for mismatch and compute volumes
+    parts[i].check_mismatch(weights);
+    ASSERT_FALSE(parts[i].has_mismatch());
+
+    // interpolate density for current part with the weights that
+    // check_mismatch restricted to it
+    remapper.interpolate_mesh_var<double, Portage::Interpolate_1stOrder>(
+      "density", "density", parts[i], lower_bound, upper_bound
+    );
+  }
+
+  // compare remapped values with analytically computed ones
+  target_state_wrapper.mesh_get_data(CELL, "density", &remapped);
+
+  for (int i = 0; i < 2; ++i) {
+    for (auto&& c : target_cells[i]) {
+      auto centroid = target_mesh->cell_centroid(c);
+      auto expected = (centroid[0] < 0.40 ? 30. : 100.);
+      ASSERT_NEAR(remapped[c], expected, epsilon);
+    }
+  }
+}
+
+// sanity check 1c: same as sanity check 1 but with all part pairs
+// interpolated in a single call, their target parts being disjoint.
+TEST_F(PartDriverTest, AllPartsInterpolation) {
+
+  Remapper remapper(source_mesh_wrapper, source_state_wrapper,
+                    target_mesh_wrapper, target_state_wrapper);
+
+  double* original = nullptr;
+  double* remapped = nullptr;
+
+  // assign a piecewise constant field on source mesh
+  source_state_wrapper.mesh_get_data(CELL, "density", &original);
+  for (int c = 0; c < nb_source_cells; c++) {
+    auto centroid = source_mesh->cell_centroid(c);
+    original[c] = (centroid[0] < 0.40 ? 30. : 100.);
+  }
+
+  // process remap
+  auto candidates = remapper.search<Portage::SearchKDTree>();
+  auto weights = remapper.intersect_meshes<Portage::IntersectR2D>(candidates);
+
+  // test for mismatch and compute volumes of every part pair
+  for (int i = 0; i < 2; ++i) {
+    parts[i].check_mismatch(weights);
+    ASSERT_FALSE(parts[i].has_mismatch());
+  }
+
+  // interpolate density for all parts
+  remapper.interpolate_mesh_var<double, Portage::Interpolate_1stOrder>(
+    "density", "density", parts, lower_bound, upper_bound
+  );
+
+  // compare remapped values with analytically computed ones
+  target_state_wrapper.mesh_get_data(CELL, "density", &remapped);
+
+  for (int i = 0; i < 2; ++i) {
+    for (auto&& c : target_cells[i]) {
+      auto centroid = target_mesh->cell_centroid(c);
+      auto expected = (centroid[0] < 0.40 ? 30. : 100.);
+      ASSERT_NEAR(remapped[c], expected, epsilon);
+    }
+  }
+}
+
 // sanity check 2: verify that both part-by-part and mesh-mesh
 // interpolation schemes are equivalent for general fields
 // in absence of mismatch between source and target parts.
@@ -278,4 +375,138 @@ TEST_F(PartDriverTest, MeshMeshRemapComparison) {
     #endif
     ASSERT_NEAR(value_mesh_remap, value_part_remap, epsilon);
   }
-}
\ No newline at end of file
+}
+
+// sanity check 3: verify that interpolating on all part pairs in a
+// single call is the same as one call per part pair when their target
+// parts overlap. Here the first target part reaches past its source
+// part (so its values are fixed up) and is then entirely overwritten
+// by the second part pair made of both whole meshes.
+TEST_F(PartDriverTest, OverlappingPartsInterpolation) {
+
+  Remapper remapper(source_mesh_wrapper, source_state_wrapper,
+                    target_mesh_wrapper, target_state_wrapper);
+
+  double* original = nullptr;
+  double* remapped = nullptr;
+  std::vector<double> remapped_parts(nb_target_cells);
+
+  // assign a gaussian density field on source mesh
+  source_state_wrapper.mesh_get_data(CELL, "density", &original);
+  for (int c = 0; c < nb_source_cells; c++) {
+    auto centroid = source_mesh->cell_centroid(c);
+    auto const& x = centroid[0];
+    auto const& y = centroid[1];
+    original[c] = std::exp(-10.*(x*x + y*y));
+  }
+
+  // first target part: the target cells within (0.1,0.1) and (0.7,0.7),
+  // a box enclosing the first part whose outer cells the source part
+  // does not cover
+  std::vector<int> box_cells;
+  for (int c = 0; c < nb_target_cells; c++) {
+    auto centroid = target_mesh->cell_centroid(c);
+    auto const& x = centroid[0];
+    auto const& y = centroid[1];
+    if (x > 0.1 and x < 0.7 and y > 0.1 and y < 0.7)
+      box_cells.emplace_back(c);
+  }
+
+  std::vector<int> all_source_cells(nb_source_cells);
+  std::vector<int> all_target_cells(nb_target_cells);
+  std::iota(all_source_cells.begin(), all_source_cells.end(), 0);
+  std::iota(all_target_cells.begin(), all_target_cells.end(), 0);
+
+  std::vector<PartPair> overlapping;
+  overlapping.emplace_back(source_mesh_wrapper, source_state_wrapper,
+                           target_mesh_wrapper, target_state_wrapper,
+                           source_cells[0], box_cells, nullptr);
+  overlapping.emplace_back(source_mesh_wrapper, source_state_wrapper,
+                           target_mesh_wrapper, target_state_wrapper,
+                           all_source_cells, all_target_cells, nullptr);
+
+  // process remap
+  auto candidates = remapper.search<Portage::SearchKDTree>();
+  auto weights = remapper.intersect_meshes<Portage::IntersectR2D>(candidates);
+  remapper.check_mesh_mismatch(weights);
+
+  for (auto&& part : overlapping)
+    part.check_mismatch(weights);
+  ASSERT_TRUE(overlapping[0].has_mismatch());
+  ASSERT_FALSE(overlapping[1].has_mismatch());
+
+  // interpolate density one part pair after the other
+  for (auto&& part : overlapping) {
+    remapper.interpolate_mesh_var<double, Portage::Interpolate_1stOrder>(
+      "density", "density", weights, lower_bound, upper_bound,
+      Portage::DEFAULT_LIMITER, Portage::DEFAULT_BND_LIMITER,
+      Portage::DEFAULT_PARTIAL_FIXUP_TYPE, Portage::DEFAULT_EMPTY_FIXUP_TYPE,
+      Portage::DEFAULT_CONSERVATION_TOL,
+      Portage::DEFAULT_MAX_FIXUP_ITER, &part
+    );
+  }
+
+  // store the values remapped part by part
+  target_state_wrapper.mesh_get_data(CELL, "density", &remapped);
+  std::copy(remapped, remapped + nb_target_cells, remapped_parts.begin());
+  std::fill(remapped, remapped + nb_target_cells, 0.);
+
+  // interpolate density for all parts in a single call
+  remapper.interpolate_mesh_var<double, Portage::Interpolate_1stOrder>(
+    "density", "density", overlapping, lower_bound, upper_bound
+  );
+
+  for (int c = 0; c < nb_target_cells; ++c)
+    ASSERT_NEAR(remapped_parts[c], remapped[c], epsilon);
+}
+
+// sanity check 4: intersecting part pairs keeps the mismatch analysis
+// and the source mesh data of the whole meshes, so a whole-mesh remap
+// done after them gives the same values as before them.
+TEST_F(PartDriverTest, PartIntersectionKeepsMeshData) {
+
+  Remapper remapper(source_mesh_wrapper, source_state_wrapper,
+                    target_mesh_wrapper, target_state_wrapper);
+
+  double* original = nullptr;
+  double* remapped = nullptr;
+  std::vector<double> remapped_before(nb_target_cells);
+
+  // assign a gaussian density field on source mesh
+  source_state_wrapper.mesh_get_data(CELL, "density", &original);
+  for (int c = 0; c < nb_source_cells; c++) {
+    auto centroid = source_mesh->cell_centroid(c);
+    auto const& x = centroid[0];
+    auto const& y = centroid[1];
+    original[c] = std::exp(-10.*(x*x + y*y));
+  }
+
+  // whole-mesh remap
+  auto candidates = remapper.search<Portage::SearchKDTree>();
+  auto weights = remapper.intersect_meshes<Portage::IntersectR2D>(candidates);
+  remapper.check_mesh_mismatch(weights);
+
+  remapper.interpolate_mesh_var<double, Portage::Interpolate_2ndOrder>(
+    "density", "density", weights, lower_bound, upper_bound
+  );
+
+  target_state_wrapper.mesh_get_data(CELL, "density", &remapped);
+  std::copy(remapped, remapped + nb_target_cells, remapped_before.begin());
+  std::fill(remapped, remapped + nb_target_cells, 0.);
+
+  // part-restricted search and intersection of every part pair
+  for (int i = 0; i < 2; ++i) {
+    auto part_candidates = remapper.search<Portage::SearchKDTree>(parts[i]);
+    auto part_weights =
+      remapper.intersect_meshes<Portage::IntersectR2D>(part_candidates, parts[i]);
+    parts[i].check_mismatch(part_weights);
+  }
+
+  // whole-mesh remap again, without checking the mismatch again
+  remapper.interpolate_mesh_var<double, Portage::Interpolate_2ndOrder>(
+    "density", "density", weights, lower_bound, upper_bound
+  );
+
+  for (int c = 0; c < nb_target_cells; ++c)
+    ASSERT_NEAR(remapped_before[c], remapped[c], epsilon);
+}
@@ -7,6 +7,8 @@ Please see the license file at the root of this repository, or at:
 
 #include <iostream>
 #include <memory>
+#include <algorithm>
+#include <vector>
 
 #include "gtest/gtest.h"
 #include "mpi.h"
@@ -16,6 +18,7 @@ Please see the license file at the root of this repository, or at:
 #include "wonton/mesh/jali/jali_mesh_wrapper.h"
 #include "wonton/state/jali/jali_state_wrapper.h"
 #include "portage/driver/mmdriver.h"
+#include "portage/driver/coredriver.h"
 
 #include "Mesh.hh"
 #include "MeshFactory.hh"
@@ -216,3 +219,276 @@ TEST(Test_Mismatch_Fixup, Test_Methods) {
   }
 
 }
+
+
+// Fix up several fields in one call (sharing the global reductions)
+// and check that each field gets the same fixup as if it were alone
+
+TEST(Test_Mismatch_Fixup, Test_MultiVar) {
+  Jali::MeshFactory mf(MPI_COMM_WORLD);
+  if (Jali::framework_available(Jali::MSTK))
+    mf.framework(Jali::MSTK);
+  std::shared_ptr<Jali::Mesh> source_mesh = mf(-0.8, 0.0, 0.4, 1.0, 1, 1);
+  std::shared_ptr<Jali::Mesh> target_mesh = mf( 0.0, 0.0, 2.0, 1.0, 2, 1);
+
+  std::shared_ptr<Jali::State> source_state(Jali::State::create(source_mesh));
+  std::shared_ptr<Jali::State> target_state(Jali::State::create(target_mesh));
+
+  Wonton::Jali_Mesh_Wrapper sourceMeshWrapper(*source_mesh);
+  Wonton::Jali_Mesh_Wrapper targetMeshWrapper(*target_mesh);
+  Wonton::Jali_State_Wrapper sourceStateWrapper(*source_state);
+  Wonton::Jali_State_Wrapper targetStateWrapper(*target_state);
+
+  // constant fields of 1.0 and 2.5 on the source; the shifted
+  // conservative fixup with extrapolation scales both by 0.6
+  std::vector<std::string> var_names = {"density", "energy"};
+  double source_values[2] = {1.0, 2.5};
+  double exact_S_E[2] = {0.6, 1.5};
+
+  for (int i = 0; i < 2; i++) {
+    sourceStateWrapper.mesh_add_data<double>(Wonton::Entity_kind::CELL,
+                                             var_names[i], source_values[i]);
+    targetStateWrapper.mesh_add_data<double>(Wonton::Entity_kind::CELL,
+                                             var_names[i], 0.0);
+  }
+
+  Portage::CoreDriver<2, Wonton::Entity_kind::CELL,
+                      Wonton::Jali_Mesh_Wrapper, Wonton::Jali_State_Wrapper>
+      d(sourceMeshWrapper, sourceStateWrapper,
+        targetMeshWrapper, targetStateWrapper);
+
+  auto candidates = d.search<Portage::SearchKDTree>();
+  auto srcwts = d.intersect_meshes<Portage::IntersectR2D>(candidates);
+  ASSERT_TRUE(d.check_mesh_mismatch(srcwts));
+
+  double dblmin = -std::numeric_limits<double>::max();
+  double dblmax =  std::numeric_limits<double>::max();
+
+  d.interpolate_mesh_vars<double, Portage::Interpolate_1stOrder>(
+      var_names, var_names, srcwts, {dblmin, dblmin}, {dblmax, dblmax},
+      Portage::DEFAULT_LIMITER, Portage::DEFAULT_BND_LIMITER,
+      Portage::Partial_fixup_type::SHIFTED_CONSERVATIVE,
+      Portage::Empty_fixup_type::EXTRAPOLATE);
+
+  const int ncells_target =
+      target_mesh->num_entities(Jali::Entity_kind::CELL,
+                                Jali::Entity_type::PARALLEL_OWNED);
+  for (int i = 0; i < 2; i++) {
+    double *target_data;
+    targetStateWrapper.mesh_get_data(Wonton::Entity_kind::CELL, var_names[i],
+                                     &target_data);
+    for (int c = 0; c < ncells_target; c++)
+      ASSERT_NEAR(exact_S_E[i], target_data[c], TOL);
+  }
+}
+
+
+// The mismatch analysis is kept across remaps of new field values on
+// the same meshes and rebuilt when the meshes are intersected again
+// after one of them has moved
+
+TEST(Test_Mismatch_Fixup, Test_ReuseAcrossRemaps) {
+  Jali::MeshFactory mf(MPI_COMM_WORLD);
+  if (Jali::framework_available(Jali::MSTK))
+    mf.framework(Jali::MSTK);
+  std::shared_ptr<Jali::Mesh> source_mesh = mf(-0.8, 0.0, 0.4, 1.0, 1, 1);
+  std::shared_ptr<Jali::Mesh> target_mesh = mf( 0.0, 0.0, 2.0, 1.0, 2, 1);
+
+  std::shared_ptr<Jali::State> source_state(Jali::State::create(source_mesh));
+  std::shared_ptr<Jali::State> target_state(Jali::State::create(target_mesh));
+
+  Wonton::Jali_Mesh_Wrapper sourceMeshWrapper(*source_mesh);
+  Wonton::Jali_Mesh_Wrapper targetMeshWrapper(*target_mesh);
+  Wonton::Jali_State_Wrapper sourceStateWrapper(*source_state);
+  Wonton::Jali_State_Wrapper targetStateWrapper(*target_state);
+
+  sourceStateWrapper.mesh_add_data<double>(Wonton::Entity_kind::CELL,
+                                           "density", 1.0);
+  targetStateWrapper.mesh_add_data<double>(Wonton::Entity_kind::CELL,
+                                           "density", 0.0);
+
+  Portage::CoreDriver<2, Wonton::Entity_kind::CELL,
+                      Wonton::Jali_Mesh_Wrapper, Wonton::Jali_State_Wrapper>
+      d(sourceMeshWrapper, sourceStateWrapper,
+        targetMeshWrapper, targetStateWrapper);
+
+  auto candidates = d.search<Portage::SearchKDTree>();
+  auto srcwts = d.intersect_meshes<Portage::IntersectR2D>(candidates);
+  ASSERT_TRUE(d.check_mesh_mismatch(srcwts));
+
+  double dblmin = -std::numeric_limits<double>::max();
+  double dblmax =  std::numeric_limits<double>::max();
+
+  const int ncells_target =
+      target_mesh->num_entities(Jali::Entity_kind::CELL,
+                                Jali::Entity_type::PARALLEL_OWNED);
+
+  double *source_data, *target_data;
+  sourceStateWrapper.mesh_get_data(Wonton::Entity_kind::CELL, "density",
+                                   &source_data);
+  targetStateWrapper.mesh_get_data(Wonton::Entity_kind::CELL, "density",
+                                   &target_data);
+
+  // the fixup spreads the mass of the constant source value over the
+  // target, which scales it by the ratio of the mesh areas: 1.2/2 at
+  // first (see Test_MultiVar) then 1.6/2 once the source is stretched
+  double scale = 0.6;
+  for (int step = 0; step < 3; step++) {
+    double const value = 1.0 + step;
+    source_data[0] = value;
+
+    if (step == 2) {
+      // stretch the source cell from [-0.8,0.4] to [-0.8,0.8] along x
+      const int nnodes_source =
+          source_mesh->num_entities(Jali::Entity_kind::NODE,
+                                    Jali::Entity_type::ALL);
+      for (int n = 0; n < nnodes_source; n++) {
+        JaliGeometry::Point xyz;
+        source_mesh->node_get_coordinates(n, &xyz);
+        if (xyz[0] > 0.0) {
+          xyz[0] = 0.8;
+          source_mesh->node_set_coordinates(n, xyz);
+        }
+      }
+      source_mesh->update_geometric_quantities();
+      scale = 0.8;
+
+      candidates = d.search<Portage::SearchKDTree>();
+      srcwts = d.intersect_meshes<Portage::IntersectR2D>(candidates);
+      ASSERT_TRUE(d.check_mesh_mismatch(srcwts));
+    }
+
+    d.interpolate_mesh_var<double, Portage::Interpolate_1stOrder>(
+        "density", "density", srcwts, dblmin, dblmax,
+        Portage::DEFAULT_LIMITER, Portage::DEFAULT_BND_LIMITER,
+        Portage::Partial_fixup_type::SHIFTED_CONSERVATIVE,
+        Portage::Empty_fixup_type::EXTRAPOLATE);
+
+    for (int c = 0; c < ncells_target; c++)
+      ASSERT_NEAR(scale*value, target_data[c], TOL);
+  }
+}
+
+// A target mesh reaching several cells past the source gets one layer
+// of empty cells per column, each extrapolated from the one before it
+
+TEST(Test_Mismatch_Fixup, Test_EmptyLayers) {
+  Jali::MeshFactory mf(MPI_COMM_WORLD);
+  if (Jali::framework_available(Jali::MSTK))
+    mf.framework(Jali::MSTK);
+  // two columns of source cells under the first two of ten target columns
+  std::shared_ptr<Jali::Mesh> source_mesh = mf(0.0, 0.0, 0.4, 1.0, 2, 2);
+  std::shared_ptr<Jali::Mesh> target_mesh = mf(0.0, 0.0, 2.0, 1.0, 10, 2);
+
+  std::shared_ptr<Jali::State> source_state(Jali::State::create(source_mesh));
+  std::shared_ptr<Jali::State> target_state(Jali::State::create(target_mesh));
+
+  Wonton::Jali_Mesh_Wrapper sourceMeshWrapper(*source_mesh);
+  Wonton::Jali_Mesh_Wrapper targetMeshWrapper(*target_mesh);
+  Wonton::Jali_State_Wrapper sourceStateWrapper(*source_state);
+  Wonton::Jali_State_Wrapper targetStateWrapper(*target_state);
+
+  double const h = 0.2;  // cell width of both meshes
+  auto column = [h](Wonton::Point<2> const& cen) { return int(cen[0]/h); };
+  auto row = [](Wonton::Point<2> const& cen) { return int(cen[1]/0.5); };
+
+  // 1 and 2 in the first source column, 3 and 4 in the second
+  const int ncells_source =
+      source_mesh->num_entities(Jali::Entity_kind::CELL,
+                                Jali::Entity_type::PARALLEL_OWNED);
+  std::vector<double> source_data(ncells_source);
+  for (int c = 0; c < ncells_source; c++) {
+    Wonton::Point<2> cen;
+    sourceMeshWrapper.cell_centroid(c, &cen);
+    source_data[c] = 2*column(cen) + row(cen) + 1;
+  }
+  sourceStateWrapper.mesh_add_data(Wonton::Entity_kind::CELL, "density",
+                                   source_data.data());
+  targetStateWrapper.mesh_add_data<double>(Wonton::Entity_kind::CELL,
+                                           "density", 0.0);
+
+  Portage::CoreDriver<2, Wonton::Entity_kind::CELL,
+                      Wonton::Jali_Mesh_Wrapper, Wonton::Jali_State_Wrapper>
+      d(sourceMeshWrapper, sourceStateWrapper,
+        targetMeshWrapper, targetStateWrapper);
+
+  auto candidates = d.search<Portage::SearchKDTree>();
+  auto srcwts = d.intersect_meshes<Portage::IntersectR2D>(candidates);
+  ASSERT_TRUE(d.check_mesh_mismatch(srcwts));
+
+  // every empty column is a layer, counted from the last covered one
+  Portage::MismatchFixer<2, Wonton::Entity_kind::CELL,
+                         Wonton::Jali_Mesh_Wrapper, Wonton::Jali_State_Wrapper,
+                         Wonton::Jali_Mesh_Wrapper, Wonton::Jali_State_Wrapper>
+      fixer(sourceMeshWrapper, sourceStateWrapper,
+            targetMeshWrapper, targetStateWrapper, srcwts, nullptr);
+  ASSERT_TRUE(fixer.has_mismatch());
+  ASSERT_EQ(8, fixer.num_empty_layers());
+
+  const int ncells_target =
+      target_mesh->num_entities(Jali::Entity_kind::CELL,
+                                Jali::Entity_type::PARALLEL_OWNED);
+  for (int c = 0; c < ncells_target; c++) {
+    Wonton::Point<2> cen;
+    targetMeshWrapper.cell_centroid(c, &cen);
+    ASSERT_EQ(std::max(column(cen) - 1, 0), fixer.empty_layer(c));
+  }
+
+  // the first layer averages the two cells of the last covered column
+  // (cells of the same layer are not used) and each following layer
+  // copies the one before it
+  double dblmin = -std::numeric_limits<double>::max();
+  double dblmax =  std::numeric_limits<double>::max();
+  d.interpolate_mesh_var<double, Portage::Interpolate_1stOrder>(
+      "density", "density", srcwts, dblmin, dblmax,
+      Portage::DEFAULT_LIMITER, Portage::DEFAULT_BND_LIMITER,
+      Portage::Partial_fixup_type::CONSTANT,
+      Portage::Empty_fixup_type::EXTRAPOLATE);
+
+  double *target_data;
+  targetStateWrapper.mesh_get_data(Wonton::Entity_kind::CELL, "density",
+                                   &target_data);
+  for (int c = 0; c < ncells_target; c++) {
+    Wonton::Point<2> cen;
+    targetMeshWrapper.cell_centroid(c, &cen);
+    double const exact = column(cen) < 2 ? 2*column(cen) + row(cen) + 1 : 3.5;
+    ASSERT_NEAR(exact, target_data[c], TOL);
+  }
+}
+
+// The bounded shift found for a field with many values clipped by its
+// bounds restores the target integral, whatever the number of entities
+// that have to be clipped
+
+TEST(Test_Mismatch_Fixup, Test_BoundedShift) {
+  int const n = 1000;
+  std::vector<double> values(n), volumes(n);
+  for (int e = 0; e < n; e++) {
+    values[e] = 1.0 + (e % 97)/96.0;   // in [1, 2]
+    volumes[e] = 0.5 + (e % 13)/12.0;
+  }
+  double const lower = 1.2, upper = 1.9;
+
+  // source integrals well below and well above the unshifted one
+  double integral = 0.0, volume = 0.0;
+  for (int e = 0; e < n; e++) {
+    integral += values[e]*volumes[e];
+    volume += volumes[e];
+  }
+  std::vector<double> const source_integrals = {1.3*volume, 1.8*volume};
+
+  for (double source_integral : source_integrals) {
+    std::vector<Portage::ClippedIntegral> integrals;
+    integrals.emplace_back(values, volumes.data(), lower, upper, 0.0);
+    std::vector<std::pair<double, double>> extremes = {{1.0 - upper, 2.0 - lower}};
+    std::vector<double> shifts = {(integral - source_integral)/volume};
+
+    Portage::find_bounded_shifts(&integrals, extremes, {source_integral},
+                                 1e-14, 10, [](double *, int) {}, &shifts);
+
+    double shifted = 0.0;
+    for (int e = 0; e < n; e++)
+      shifted += std::min(std::max(values[e] - shifts[0], lower), upper)*volumes[e];
+    ASSERT_NEAR(source_integral, shifted, 1e-12*source_integral);
+  }
+}
@@ -6,8 +6,10 @@ Please see the license file at the root of this repository, or at:
 
 #ifdef HAVE_TANGRAM
 
+#include <algorithm>
 #include <iostream>
 #include <memory>
+#include <numeric>
 
 #include "gtest/gtest.h"
 #ifdef PORTAGE_ENABLE_MPI
@@ -787,4 +789,171 @@ TEST(MMDriver, ThreeMat3D_1stOrder) {
 }  // ThreeMat3D_1stOrder
 
 
+// The R2D intersector caches the polygons of a material in the mixed
+// source cells when the material is set. Check that it gives the same
+// moments as intersecting with the polygons taken straight from the
+// interface reconstructor for each target cell
+
+TEST(MMDriver, ThreeMat2D_CachedMatPolys) {
+  std::shared_ptr<Jali::Mesh> sourceMesh =
+      Jali::MeshFactory(MPI_COMM_WORLD)(0.0, 0.0, 1.0, 1.0, 5, 5);
+  std::shared_ptr<Jali::Mesh> targetMesh =
+      Jali::MeshFactory(MPI_COMM_WORLD)(0.0, 0.0, 1.0, 1.0, 7, 6);
+  std::shared_ptr<Jali::State> sourceState = Jali::State::create(sourceMesh);
+
+  Wonton::Jali_Mesh_Wrapper sourceMeshWrapper(*sourceMesh);
+  Wonton::Jali_Mesh_Wrapper targetMeshWrapper(*targetMesh);
+  Wonton::Jali_State_Wrapper sourceStateWrapper(*sourceState);
+
+  // Same T-junction as in ThreeMat2D_1stOrder
+
+  constexpr int nmats = 3;
+  std::string matnames[nmats] = {"mat0", "mat1", "mat2"};
+
+  Portage::Point<2> matlo[nmats], mathi[nmats];
+  matlo[0] = Portage::Point<2>(0.0, 0.0);
+  mathi[0] = Portage::Point<2>(0.5, 1.0);
+  matlo[1] = Portage::Point<2>(0.5, 0.0);
+  mathi[1] = Portage::Point<2>(1.0, 0.5);
+  matlo[2] = Portage::Point<2>(0.5, 0.5);
+  mathi[2] = Portage::Point<2>(1.0, 1.0);
+
+  int nsrccells = sourceMeshWrapper.num_entities(Portage::Entity_kind::CELL,
+                                                 Portage::Entity_type::ALL);
+
+  // Material data of the source cells, both material by material for
+  // the state and cell by cell for the interface reconstructor
+
+  std::vector<int> matcells_src[nmats];
+  std::vector<double> matvf_src[nmats];
+  std::vector<Portage::Point<2>> matcen_src[nmats];
+
+  std::vector<int> cell_num_mats(nsrccells, 0);
+  std::vector<int> cell_mat_ids;
+  std::vector<double> cell_mat_volfracs;
+  std::vector<Wonton::Point<2>> cell_mat_centroids;
+
+  for (int c = 0; c < nsrccells; c++) {
+    std::vector<Portage::Point<2>> ccoords;
+    sourceMeshWrapper.cell_get_coordinates(c, &ccoords);
+
+    double cellvol = sourceMeshWrapper.cell_volume(c);
+
+    Portage::Point<2> cell_lo, cell_hi;
+    BOX_INTERSECT::bounding_box<2>(ccoords, &cell_lo, &cell_hi);
+
+    std::vector<double> xmoments;
+    for (int m = 0; m < nmats; m++) {
+      if (BOX_INTERSECT::intersect_boxes<2>(matlo[m], mathi[m],
+                                            cell_lo, cell_hi, &xmoments)) {
+        if (xmoments[0] > 1.0e-06) {  // non-trivial intersection
+          Portage::Point<2> mcen(xmoments[1]/xmoments[0],
+                                 xmoments[2]/xmoments[0]);
+          matcells_src[m].push_back(c);
+          matvf_src[m].push_back(xmoments[0]/cellvol);
+          matcen_src[m].push_back(mcen);
+
+          cell_num_mats[c]++;
+          cell_mat_ids.push_back(m);
+          cell_mat_volfracs.push_back(xmoments[0]/cellvol);
+          cell_mat_centroids.push_back(mcen);
+        }
+      }
+    }
+  }
+
+  for (int m = 0; m < nmats; m++)
+    sourceStateWrapper.add_material(matnames[m], matcells_src[m]);
+
+  // Reconstruct the interfaces
+
+  using InterfaceReconstructor =
+      Tangram::Driver<Tangram::MOF, 2, Wonton::Jali_Mesh_Wrapper,
+                      Tangram::SplitR2D, Tangram::ClipR2D>;
+
+  std::vector<Tangram::IterativeMethodTolerances_t> tols =
+      {{1000, 1e-12, 1e-12}, {1000, 1e-12, 1e-12}};
+  auto interface_reconstructor =
+      std::make_shared<InterfaceReconstructor>(sourceMeshWrapper, tols, true);
+  interface_reconstructor->set_volume_fractions(cell_num_mats, cell_mat_ids,
+                                                cell_mat_volfracs,
+                                                cell_mat_centroids);
+  interface_reconstructor->reconstruct();
+
+  Portage::NumericTolerances_t num_tols;
+  num_tols.use_default();
+
+  Portage::IntersectR2D<Portage::Entity_kind::CELL,
+                        Wonton::Jali_Mesh_Wrapper, Wonton::Jali_State_Wrapper,
+                        Wonton::Jali_Mesh_Wrapper, Tangram::MOF,
+                        Tangram::SplitR2D, Tangram::ClipR2D>
+      intersector(sourceMeshWrapper, sourceStateWrapper, targetMeshWrapper,
+                  num_tols, interface_reconstructor);
+
+  std::vector<int> candidates(nsrccells);
+  std::iota(candidates.begin(), candidates.end(), 0);
+
+  int ntrgcells = targetMeshWrapper.num_entities(Portage::Entity_kind::CELL,
+                                                 Portage::Entity_type::ALL);
+  int nmixed = 0;
+
+  for (int m = 0; m < nmats; m++) {
+    intersector.set_material(m);
+
+    for (int t = 0; t < ntrgcells; t++) {
+      std::vector<Portage::Point<2>> target_poly;
+      targetMeshWrapper.cell_get_coordinates(t, &target_poly);
+
+      std::vector<Portage::Weights_t> cached = intersector(t, candidates);
+
+      // Moments recomputed from the reconstructor for each source cell
+      std::vector<int> sources;
+      std::vector<std::vector<double>> moments;
+      for (int s : candidates) {
+        std::vector<int> cellmats;
+        sourceStateWrapper.cell_get_mats(s, &cellmats);
+        if (std::find(cellmats.begin(), cellmats.end(), m) == cellmats.end())
+          continue;
+
+        std::vector<double> smoments;
+        if (cellmats.size() == 1) {
+          std::vector<Portage::Point<2>> source_poly;
+          sourceMeshWrapper.cell_get_coordinates(s, &source_poly);
+          smoments = Portage::intersect_polys_r2d(source_poly, target_poly,
+                                                  num_tols);
+        } else {
+          std::vector<Tangram::MatPoly<2>> matpolys =
+              interface_reconstructor->cell_matpoly_data(s).get_matpolys(m);
+          smoments.assign(3, 0.0);
+          for (auto const& matpoly : matpolys) {
+            std::vector<double> pmoments =
+                Portage::intersect_polys_r2d(matpoly.points(), target_poly,
+                                             num_tols);
+            for (int k = 0; k < 3; k++)
+              smoments[k] += pmoments[k];
+          }
+        }
+        if (smoments[0] > 0.0) {
+          sources.push_back(s);
+          moments.push_back(smoments);
+        }
+      }
+
+      ASSERT_EQ(sources.size(), cached.size());
+      for (int i = 0; i < static_cast<int>(cached.size()); i++) {
+        ASSERT_EQ(sources[i], cached[i].entityID);
+        ASSERT_EQ(moments[i].size(), cached[i].weights.size());
+        for (int k = 0; k < static_cast<int>(moments[i].size()); k++)
+          ASSERT_NEAR(moments[i][k], cached[i].weights[k], 1.0e-12);
+        if (sourceStateWrapper.cell_get_num_mats(sources[i]) > 1)
+          nmixed++;
+      }
+    }
+  }
+
+  // the comparison must have gone through mixed cells
+  ASSERT_GT(nmixed, 0);
+}
+
+
 #endif  // ifdef HAVE_TANGRAM
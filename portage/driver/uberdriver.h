@@ -283,7 +283,9 @@ class UberDriver {
   void compute_interpolation_weights() {
 
     Portage::vector<std::vector<int>> intersection_candidates;
-    
+
+    has_mismatch_ = false;  // recomputed from the new weights
+
     for (Entity_kind onwhat : entity_kinds_) {
       switch (onwhat) {
         case CELL: {
@@ -347,6 +349,82 @@ class UberDriver {
   }
 
 
+  /*!
+    @brief Declare that both meshes are made of axis-aligned boxes, so
+    that the dual cells of nodes are intersected as boxes
+
+     @param[in] rectangular_mesh  Whether the meshes are rectangular
+  */
+  void set_rectangular_mesh(bool rectangular_mesh) {
+
+    for (Entity_kind onwhat : entity_kinds_) {
+      switch (onwhat) {
+        case CELL:
+          core_driver_serial_[CELL]->template set_rectangular_mesh<CELL>(rectangular_mesh); break;
+        case NODE:
+          core_driver_serial_[NODE]->template set_rectangular_mesh<NODE>(rectangular_mesh); break;
+        default:
+          std::cerr << "Cannot remap on " << to_string(onwhat) << "\n";
+      }
+    }
+  }
+
+
+  /*!
+    @brief Set the highest degree of the intersection moments
+
+     @param[in] moment_order  1 (default), or 2 when fields are to be
+     remapped at 3rd order, so that the second moments are computed
+     with the weights
+  */
+  void set_moment_order(int moment_order) {
+
+    for (Entity_kind onwhat : entity_kinds_) {
+      switch (onwhat) {
+        case CELL:
+          core_driver_serial_[CELL]->template set_moment_order<CELL>(moment_order); break;
+        case NODE:
+          core_driver_serial_[NODE]->template set_moment_order<NODE>(moment_order); break;
+        default:
+          std::cerr << "Cannot remap on " << to_string(onwhat) << "\n";
+      }
+    }
+  }
+
+
+  /*!
+    @brief Discard the intersection weights and all data derived from
+    the geometry of the meshes
+
+    The weights, the mismatch analysis and the source mesh stencils
+    are kept across interpolations, so fields can be remapped again
+    (e.g. at each time step) without recomputing them. Call this when
+    the source or target mesh has moved or changed, then compute the
+    interpolation weights again before interpolating.
+  */
+  void mesh_geometry_changed() {
+
+    for (Entity_kind onwhat : entity_kinds_) {
+      switch (onwhat) {
+        case CELL:
+          core_driver_serial_[CELL]->template mesh_geometry_changed<CELL>(); break;
+        case NODE:
+          core_driver_serial_[NODE]->template mesh_geometry_changed<NODE>(); break;
+        default:
+          std::cerr << "Cannot remap on " << to_string(onwhat) << "\n";
+      }
+      search_completed_[onwhat] = false;
+      mesh_intersection_completed_[onwhat] = false;
+    }
+
+    source_weights_.clear();
+    remap_matrices_.clear();
+    source_weights_by_mat_.clear();
+    mat_intersection_completed_ = false;
+    has_mismatch_ = false;
+  }
+
+
   /*!
     @brief search for candidate source entities whose control volumes
      (cells, dual cells) overlap the control volumes of target cells
@@ -394,6 +472,7 @@ class UberDriver {
   intersect_meshes(Portage::vector<std::vector<int>> const& candidates) {
 
     mesh_intersection_completed_[ONWHAT] = true;
+    remap_matrices_.erase(ONWHAT);  // assembled from the old weights
 
     return core_driver_serial_[ONWHAT]->template intersect_meshes<ONWHAT, Intersect>(candidates);
 
@@ -658,6 +737,153 @@ class UberDriver {
   }
 
 
+  /*!
+    Sparse remap operator for first order remap of mesh variables on
+    entity kind ONWHAT
+
+    @tparam ONWHAT  Entity_kind of the remap
+
+    @param[in] gradient_offsets  Whether the matrix must also hold what
+    is needed to remap with fixed gradients
+
+    @returns  CSR matrix mapping source values to target values
+
+    The matrix is assembled from the intersection weights on first
+    use and kept until the weights are recomputed. It is assembled
+    again only if gradient offsets are requested and the kept matrix
+    does not have them. It may be used directly by the application to
+    remap its own arrays.
+  */
+
+  template<Entity_kind ONWHAT>
+  RemapMatrix<D> const& remap_matrix(bool gradient_offsets = false) {
+    assert(mesh_intersection_completed_[ONWHAT]);
+
+    auto it = remap_matrices_.find(ONWHAT);
+    if (it == remap_matrices_.end() or
+        (gradient_offsets and not it->second.has_gradient_offsets())) {
+      auto & driver = core_driver_serial_[ONWHAT];
+      remap_matrices_[ONWHAT] =
+          driver->template assemble_remap_matrix<ONWHAT>(source_weights_[ONWHAT],
+                                                         gradient_offsets);
+      it = remap_matrices_.find(ONWHAT);
+    }
+    return it->second;
+  }
+
+
+  /*!
+    Remap mesh variables of type T residing on entity kind ONWHAT to
+    first order with the sparse remap operator
+
+    @tparam T   type of variable
+
+    @tparam ONWHAT  Entity_kind that fields reside on
+
+    @param[in] srcvarnames   Variable names on source mesh
+
+    @param[in] trgvarnames   Variable names on target mesh
+
+    @param[in] lower_bounds  Lower bound for each variable
+
+    @param[in] upper_bounds  Upper bound for each variable
+
+    @param[in] partial_fixup_type Method to populate fields on
+    partially filled target entities (cells or dual cells)
+
+    @param[in] empty_fixup_type Method to populate fields on empty
+    target entities (cells or dual cells)
+
+    @param[in] conservation_tol Tolerance to which source and target
+    integral quantities are to be matched
+
+    @param[in] max_fixup_iter     Max number of iterations for global repair
+
+    Gives the same result as calling interpolate with
+    Interpolate_1stOrder on each variable, but all the variables are
+    remapped together by one sparse matrix product.
+  */
+
+  template<typename T = double, Entity_kind ONWHAT>
+  void interpolate_with_remap_matrix(std::vector<std::string> const& srcvarnames,
+                                     std::vector<std::string> const& trgvarnames,
+                                     std::vector<T> const& lower_bounds,
+                                     std::vector<T> const& upper_bounds,
+                                     Partial_fixup_type partial_fixup_type = DEFAULT_PARTIAL_FIXUP_TYPE,
+                                     Empty_fixup_type empty_fixup_type = DEFAULT_EMPTY_FIXUP_TYPE,
+                                     double conservation_tol = DEFAULT_CONSERVATION_TOL,
+                                     int max_fixup_iter = DEFAULT_MAX_FIXUP_ITER) {
+
+    for (auto const& srcvarname : srcvarnames)
+      if (std::find(source_vars_to_remap_.begin(), source_vars_to_remap_.end(),
+                    srcvarname) == source_vars_to_remap_.end()) {
+        std::cerr << "Cannot remap source variable " << srcvarname <<
+            " - not specified in initial variable list in the constructor \n";
+        return;
+      }
+
+    RemapMatrix<D> const& matrix = remap_matrix<ONWHAT>();
+
+    auto & driver = core_driver_serial_[ONWHAT];
+    driver->template apply_remap_matrix<T, ONWHAT>
+        (matrix, srcvarnames, trgvarnames, lower_bounds, upper_bounds,
+         partial_fixup_type, empty_fixup_type, conservation_tol,
+         max_fixup_iter);
+  }
+
+
+  /*!
+    Remap mesh variables of type T residing on entity kind ONWHAT to
+    second order with the sparse remap operator and the limited
+    gradients of the source variables
+
+    @tparam T   type of variable
+
+    @tparam ONWHAT  Entity_kind that fields reside on
+
+    @param[in] limiter      Limiter to use for the gradients
+
+    @param[in] bnd_limiter  Limiter to use for the gradients on the boundary
+
+    See the first order interpolate_with_remap_matrix for the remaining
+    parameters.
+
+    Gives the same result as calling interpolate with
+    Interpolate_2ndOrder on each variable. The gradients are computed
+    once per variable and applied through the gradient offsets of the
+    remap matrix, so the intersection weights are not read again.
+  */
+
+  template<typename T = double, Entity_kind ONWHAT>
+  void interpolate_with_remap_matrix(std::vector<std::string> const& srcvarnames,
+                                     std::vector<std::string> const& trgvarnames,
+                                     std::vector<T> const& lower_bounds,
+                                     std::vector<T> const& upper_bounds,
+                                     Limiter_type limiter,
+                                     Boundary_Limiter_type bnd_limiter,
+                                     Partial_fixup_type partial_fixup_type = DEFAULT_PARTIAL_FIXUP_TYPE,
+                                     Empty_fixup_type empty_fixup_type = DEFAULT_EMPTY_FIXUP_TYPE,
+                                     double conservation_tol = DEFAULT_CONSERVATION_TOL,
+                                     int max_fixup_iter = DEFAULT_MAX_FIXUP_ITER) {
+
+    for (auto const& srcvarname : srcvarnames)
+      if (std::find(source_vars_to_remap_.begin(), source_vars_to_remap_.end(),
+                    srcvarname) == source_vars_to_remap_.end()) {
+        std::cerr << "Cannot remap source variable " << srcvarname <<
+            " - not specified in initial variable list in the constructor \n";
+        return;
+      }
+
+    RemapMatrix<D> const& matrix = remap_matrix<ONWHAT>(true);
+
+    auto & driver = core_driver_serial_[ONWHAT];
+    driver->template apply_remap_matrix<T, ONWHAT>
+        (matrix, srcvarnames, trgvarnames, lower_bounds, upper_bounds,
+         limiter, bnd_limiter, partial_fixup_type, empty_fixup_type,
+         conservation_tol, max_fixup_iter);
+  }
+
+
 
   /*!
     Interpolate a (multi-)material variable of type T residing on CELLs
@@ -784,6 +1010,9 @@ class UberDriver {
   //   \/                        \/           \/
   std::map<Entity_kind, Portage::vector<std::vector<Weights_t>>> source_weights_;
 
+  // Sparse remap operators assembled from source_weights_ on demand
+  std::map<Entity_kind, RemapMatrix<D>> remap_matrices_;
+
   // Weights of intersection b/w target CELLS and source material polygons
   // Each intersection is between a target cell and material polygon in
   // a source cell for a particular material
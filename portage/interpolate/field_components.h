@@ -0,0 +1,114 @@
+/*
+This file is part of the Ristra portage project.
+Please see the license file at the root of this repository, or at:
+    https://github.com/laristra/portage/blob/master/LICENSE
+*/
+
+#ifndef PORTAGE_INTERPOLATE_FIELD_COMPONENTS_H_
+#define PORTAGE_INTERPOLATE_FIELD_COMPONENTS_H_
+
+#include <string>
+#include <vector>
+
+#include "portage/support/portage.h"
+
+/*!
+  @file field_components.h
+  @brief Layout and precision of fields in the interpolators
+
+  State managers hold one scalar per entity for each variable, so a
+  field with several components (e.g. velocity or stress) reaches the
+  interpolators as the list of variables holding its components, i.e.
+  in SoA layout. The interpolators repack them entity by entity (AoS,
+  component index fastest). Each intersection weight is then read once
+  and applied to all components of a source entity in a short
+  contiguous loop, instead of streaming the weights once per component.
+
+  Source fields may be stored in double or single precision. The
+  interpolators read them through a FieldValues view, which widens
+  each value to double, so the arithmetic is the same for both.
+ */
+
+namespace Portage {
+
+/*!
+  @class FieldValues field_components.h
+  @brief Read-only view of field values stored as double or float
+
+  Values are returned as double whatever the storage type.
+*/
+class FieldValues {
+ public:
+  FieldValues() = default;
+  explicit FieldValues(double const *vals) : dvals_(vals) {}
+  explicit FieldValues(float const *vals) : fvals_(vals) {}
+
+  /// Value on entity i
+  double operator[](int i) const {
+    return fvals_ ? static_cast<double>(fvals_[i]) : dvals_[i];
+  }
+
+  /// Whether the values are stored in single precision
+  bool single_precision() const { return fvals_ != nullptr; }
+
+  /// Whether the view refers to any data
+  explicit operator bool() const { return dvals_ || fvals_; }
+
+ private:
+  double const *dvals_ = nullptr;
+  float const *fvals_ = nullptr;
+};
+
+
+/*!
+  @brief View of a mesh field stored as T in a state manager
+  @param[in] state  State wrapper
+  @param[in] kind   Entity kind the field lives on
+  @param[in] name   Name of the field
+*/
+template <typename T, class StateType>
+FieldValues get_mesh_field(StateType const& state, Entity_kind kind,
+                           std::string const& name) {
+  T const *vals = nullptr;
+  state.mesh_get_data(kind, name, &vals);
+  return FieldValues(vals);
+}
+
+/*!
+  @brief View of the values of a material field stored as T
+  @param[in] state  State wrapper
+  @param[in] name   Name of the field
+  @param[in] matid  Material whose cell values are needed
+*/
+template <typename T, class StateType>
+FieldValues get_mat_field(StateType const& state, std::string const& name,
+                          int matid) {
+  T const *vals = nullptr;
+  state.mat_get_celldata(name, matid, &vals);
+  return FieldValues(vals);
+}
+
+
+/*!
+  @brief Pack separately stored components entity by entity
+  @param[in]  nentities   Number of entities
+  @param[in]  components  Values of each component, indexed by entity
+                          (pointers or FieldValues)
+  @param[out] packed      packed[e*ncomp + k] is component k on entity e
+*/
+template <typename T, typename Values>
+void pack_components(int nentities, std::vector<Values> const& components,
+                     std::vector<T> *packed) {
+  int const ncomp = components.size();
+  packed->resize(static_cast<size_t>(nentities)*ncomp);
+  T *data = packed->data();
+  Portage::for_each(make_counting_iterator(0), make_counting_iterator(nentities),
+                    [&](int e) {
+                      for (int k = 0; k < ncomp; k++)
+                        data[static_cast<size_t>(e)*ncomp + k] = components[k][e];
+                    });
+}
+
+}  // namespace Portage
+
+#endif  // PORTAGE_INTERPOLATE_FIELD_COMPONENTS_H_
@@ -15,6 +15,10 @@
 
 // portage includes
 #include "portage/support/portage.h"
+#include "portage/support/mesh_adjacency.h"
+#include "portage/interpolate/gradient_stencil.h"
+#include "portage/interpolate/limiter.h"
+#include "portage/interpolate/material_moments.h"
 #include "portage/intersect/dummy_interface_reconstructor.h"
 
 // wonton includes
@@ -38,7 +42,8 @@ using Wonton::Vector;
     @tparam MeshType A mesh class that one can query for mesh info
     @tparam StateType A state manager class that one can query for field info
     @tparam on_what An enum type which indicates different entity types
-
+    @tparam FieldT Type in which the field is stored (double or float);
+    gradients and limiting are always computed in double
 
 */
 
@@ -47,7 +52,8 @@ template<int D, Entity_kind on_what, typename MeshType, typename StateType,
     DummyInterfaceReconstructor,
     class Matpoly_Splitter = void,
     class Matpoly_Clipper = void,
-    class CoordSys = Wonton::DefaultCoordSys>
+    class CoordSys = Wonton::DefaultCoordSys,
+    typename FieldT = double>
 class Limited_Gradient {
  public:
   /*! @brief Constructor
@@ -112,7 +118,7 @@ class Limited_Gradient {
   int matid_;
   MeshType const & mesh_;
   StateType const & state_;
-  double const *vals_;
+  FieldT const *vals_;
   std::vector<int> cellids_;
   Field_type field_type_;
 };
@@ -128,10 +134,11 @@ class Limited_Gradient {
 
 template<int D, typename MeshType, typename StateType,
   template<class, int, class, class> class InterfaceReconstructorType,
-  class Matpoly_Splitter, class Matpoly_Clipper, class CoordSys>
+  class Matpoly_Splitter, class Matpoly_Clipper, class CoordSys,
+  typename FieldT>
 class Limited_Gradient<D, Entity_kind::CELL, MeshType, StateType,
                        InterfaceReconstructorType,
-                       Matpoly_Splitter, Matpoly_Clipper, CoordSys> {
+                       Matpoly_Splitter, Matpoly_Clipper, CoordSys, FieldT> {
  public:
 #ifdef HAVE_TANGRAM
   using InterfaceReconstructor =
@@ -145,21 +152,21 @@ class Limited_Gradient<D, Entity_kind::CELL, MeshType, StateType,
                    std::string const var_name,
                    Limiter_type limiter_type,
                    Boundary_Limiter_type Boundary_Limiter_type,
-                   std::shared_ptr<InterfaceReconstructor> ir)
+                   std::shared_ptr<InterfaceReconstructor> ir,
+                   std::shared_ptr<MeshAdjacency const> cell_neighbors = nullptr,
+                   std::shared_ptr<BarthJespersenLimiter<D> const> limiter = nullptr)
     : mesh_(mesh), state_(state), vals_(nullptr), var_name_(var_name),
-      limtype_(limiter_type), bnd_limtype_(Boundary_Limiter_type) {
+      limtype_(limiter_type), bnd_limtype_(Boundary_Limiter_type),
+      cell_neighbors_(cell_neighbors), limiter_(limiter) {
       interface_reconstructor_ = ir;
 
       // Collect and keep the list of neighbors for each CELL as it may
       // be expensive to go to the mesh layer and collect this data for
-      // each cell during the actual gradient calculation
+      // each cell during the actual gradient calculation (unless the
+      // caller already has them for this mesh)
 
-      int ncells = this->mesh_.num_entities(Entity_kind::CELL);
-      cell_neighbors_.resize(ncells);
-      cell_neighbors_.resize(this->mesh_.num_entities(Entity_kind::CELL));
-      Portage::for_each(this->mesh_.begin(Entity_kind::CELL), this->mesh_.end(Entity_kind::CELL),
-                        [this](int c) { this->mesh_.cell_get_node_adj_cells(
-                                         c, Entity_type::ALL, &(cell_neighbors_[c])); } );
+      if (not cell_neighbors_)
+        cell_neighbors_ = make_mesh_adjacency(this->mesh_, Entity_kind::CELL);
 
       //If the field type is a MESH_FIELD, then the corresponding data will
       //be stored. If the field_type is a MULTIMATERIAL_FIELD, then the constructor
@@ -175,19 +182,19 @@ class Limited_Gradient<D, Entity_kind::CELL, MeshType, StateType,
                    StateType const & state,
                    std::string const var_name,
                    Limiter_type limiter_type,
-                   Boundary_Limiter_type Boundary_Limiter_type)
-    : mesh_(mesh),state_(state),vals_(nullptr) {
+                   Boundary_Limiter_type Boundary_Limiter_type,
+                   std::shared_ptr<MeshAdjacency const> cell_neighbors = nullptr,
+                   std::shared_ptr<BarthJespersenLimiter<D> const> limiter = nullptr)
+    : mesh_(mesh),state_(state),vals_(nullptr), cell_neighbors_(cell_neighbors),
+      limiter_(limiter) {
 
       // Collect and keep the list of neighbors for each CELL as it may
       // be expensive to go to the mesh layer and collect this data for
-      // each cell during the actual gradient calculation
+      // each cell during the actual gradient calculation (unless the
+      // caller already has them for this mesh)
 
-      int ncells = this->mesh_.num_entities(Entity_kind::CELL);
-      cell_neighbors_.resize(ncells);
-      cell_neighbors_.resize(this->mesh_.num_entities(Entity_kind::CELL));
-      Portage::for_each(this->mesh_.begin(Entity_kind::CELL), this->mesh_.end(Entity_kind::CELL),
-                        [this](int c) { this->mesh_.cell_get_node_adj_cells(
-                                         c, Entity_type::ALL, &(cell_neighbors_[c])); } );
+      if (not cell_neighbors_)
+        cell_neighbors_ = make_mesh_adjacency(this->mesh_, Entity_kind::CELL);
 
       set_interpolation_variable(var_name, limiter_type, Boundary_Limiter_type);
     }
@@ -215,21 +222,62 @@ class Limited_Gradient<D, Entity_kind::CELL, MeshType, StateType,
       if (this->field_type_ == Field_type::MESH_FIELD) {
         this->state_.mesh_get_data(Entity_kind::CELL, this->var_name_, &this->vals_);
       }
+
+      // Gather the cell vertices once for the limiter (unless the
+      // caller already has them for this mesh)
+      if (this->limtype_ == BARTH_JESPERSEN && not limiter_)
+        limiter_ = make_barth_jespersen_limiter<D>(this->mesh_, Entity_kind::CELL);
     }
 
+    /// Use precomputed least squares coefficients for mesh fields
+    void set_gradient_stencil(std::shared_ptr<GradientStencil<D> const> stencil) {
+      gradient_stencil_ = stencil;
+    }
+
+    /// Use precomputed material centroids of mixed cells for material
+    /// fields instead of summing the moments of their material polygons
+    void set_material_moments(std::shared_ptr<MaterialMoments<D> const> moments) {
+      material_moments_ = moments;
+    }
+
+    /// Limited gradient of one cell
     Vector<D> operator() (int cellid);
 
+    /*! @brief Limited gradients of several cells
+        @param[in]  n        Number of cells
+        @param[in]  cellids  Cells whose gradient is needed
+        @param[out] grads    Limited gradient of each cell
+
+        Cells are processed in blocks; the unlimited gradients of a
+        block are computed first and then limited together.
+    */
+    void compute_gradients(int n, int const *cellids, Vector<D> *grads);
+
   private:
-    std::vector<std::vector<int>> cell_neighbors_;
+    // Unlimited gradient of a cell and what the limiter needs to know
+    // about it. Returns whether the gradient is to be limited
+    bool unlimited_gradient(int cellid, Vector<D> *grad, Point<D> *cellcen,
+                            double *cellcenval, double *minval,
+                            double *maxval) const;
+
+    bool on_boundary(int cellid) const {
+      return limiter_ ? limiter_->on_boundary(cellid) :
+          this->mesh_.on_exterior_boundary(Entity_kind::CELL, cellid);
+    }
+
     Limiter_type limtype_;
     Boundary_Limiter_type bnd_limtype_;
     std::string var_name_;
     int matid_;
     MeshType const & mesh_;
     StateType const & state_;
-    double const *vals_;
+    FieldT const *vals_;
     std::vector<int> cellids_;
     Field_type field_type_;
+    std::shared_ptr<MeshAdjacency const> cell_neighbors_;
+    std::shared_ptr<GradientStencil<D> const> gradient_stencil_;
+    std::shared_ptr<BarthJespersenLimiter<D> const> limiter_;
+    std::shared_ptr<MaterialMoments<D> const> material_moments_;
 
 #ifdef HAVE_TANGRAM
   std::shared_ptr<InterfaceReconstructor> interface_reconstructor_;
@@ -240,29 +288,97 @@ class Limited_Gradient<D, Entity_kind::CELL, MeshType, StateType,
 
 template<int D, typename MeshType, typename StateType,
   template<class, int, class, class> class InterfaceReconstructorType,
-  class Matpoly_Splitter, class Matpoly_Clipper, class CoordSys>
+  class Matpoly_Splitter, class Matpoly_Clipper, class CoordSys,
+  typename FieldT>
 Vector<D> Limited_Gradient <D, Entity_kind::CELL, MeshType, StateType,
   InterfaceReconstructorType, Matpoly_Splitter, Matpoly_Clipper,
-  CoordSys>::operator()(int cellid) {
+  CoordSys, FieldT>::operator()(int cellid) {
+
+    Vector<D> grad;
+    compute_gradients(1, &cellid, &grad);
+    return grad;
+  }
+
+  // @brief Limited gradients of several cells
+
+template<int D, typename MeshType, typename StateType,
+  template<class, int, class, class> class InterfaceReconstructorType,
+  class Matpoly_Splitter, class Matpoly_Clipper, class CoordSys,
+  typename FieldT>
+void Limited_Gradient <D, Entity_kind::CELL, MeshType, StateType,
+  InterfaceReconstructorType, Matpoly_Splitter, Matpoly_Clipper,
+  CoordSys, FieldT>::compute_gradients(int n, int const *cellids, Vector<D> *grads) {
 
     assert(this->vals_);
 
-    double phi = 1.0;
-    Vector<D> grad;
+    constexpr int block_size = 64;
+    int const nblocks = (n + block_size - 1)/block_size;
+
+    Portage::for_each(make_counting_iterator(0), make_counting_iterator(nblocks),
+                      [&](int b) {
+      int const first = b*block_size;
+      int const nb = std::min(block_size, n - first);
+
+      Point<D> cellcens[block_size];
+      double cellcenvals[block_size], minvals[block_size], maxvals[block_size];
+      char active[block_size];
+
+      for (int i = 0; i < nb; i++)
+        active[i] = unlimited_gradient(cellids[first+i], &grads[first+i],
+                                       &cellcens[i], &cellcenvals[i],
+                                       &minvals[i], &maxvals[i]);
+
+      if (limiter_)
+        limiter_->limit(nb, cellids + first, cellcens, cellcenvals,
+                        minvals, maxvals, active, grads + first);
+    });
+  }
+
+  // @brief Unlimited gradient of a cell, along with its center value and
+  // the min and max among its neighbors
+
+template<int D, typename MeshType, typename StateType,
+  template<class, int, class, class> class InterfaceReconstructorType,
+  class Matpoly_Splitter, class Matpoly_Clipper, class CoordSys,
+  typename FieldT>
+bool Limited_Gradient <D, Entity_kind::CELL, MeshType, StateType,
+  InterfaceReconstructorType, Matpoly_Splitter, Matpoly_Clipper,
+  CoordSys, FieldT>::unlimited_gradient(int cellid, Vector<D> *grad,
+                                Point<D> *cellcen, double *cellcenval,
+                                double *minval, double *maxval) const {
 
     // Limit the boundary gradient to enforce monotonicity preservation
-    if (this->bnd_limtype_ == BND_ZERO_GRADIENT &&
-        this->mesh_.on_exterior_boundary(Entity_kind::CELL, cellid)) {
-      grad.zero();
-      return grad;
+    if (this->bnd_limtype_ == BND_ZERO_GRADIENT && on_boundary(cellid)) {
+      grad->zero();
+      return false;
+    }
+
+    bool const limit = (this->limtype_ == BARTH_JESPERSEN &&
+                        (this->bnd_limtype_ == BND_BARTH_JESPERSEN ||
+                         !on_boundary(cellid)));
+
+    // Mesh fields only need a dot product with the precomputed
+    // least squares coefficients
+    if (gradient_stencil_ && this->field_type_ == Field_type::MESH_FIELD &&
+        gradient_stencil_->valid(cellid)) {
+      *grad = (*gradient_stencil_)(cellid, this->vals_);
+
+      if (limit) {
+        *cellcen = gradient_stencil_->center(cellid);
+        *cellcenval = *minval = *maxval = this->vals_[cellid];
+        for (int nbr : gradient_stencil_->adjacency()[cellid]) {
+          *minval = std::min(static_cast<double>(this->vals_[nbr]), *minval);
+          *maxval = std::max(static_cast<double>(this->vals_[nbr]), *maxval);
+        }
+      }
+      return limit;
     }
 
     std::vector<int> nbrids{cellid}; // Include cell where grad is needed as first element
 
-    if(cell_neighbors_.size()) {
-      nbrids.insert(std::end(nbrids),
-                    std::begin(cell_neighbors_[cellid]),
-                    std::end(cell_neighbors_[cellid]));
+    if (cell_neighbors_) {
+      MeshAdjacency::Neighbors const cellnbrs = (*cell_neighbors_)[cellid];
+      nbrids.insert(std::end(nbrids), cellnbrs.begin(), cellnbrs.end());
     }
     std::vector<Point<D>> ls_coords;
     std::vector<double> ls_vals;
@@ -285,7 +401,13 @@ Vector<D> Limited_Gradient <D, Entity_kind::CELL, MeshType, StateType,
         std::vector<int> cellmats;
         this->state_.cell_get_mats(nbrid_g, &cellmats);
 
-        if (this->interface_reconstructor_ && cellmats.size() > 1){ // Multi-material cell
+        Point<D> matcen;
+        if (cellmats.size() > 1 && material_moments_ &&
+            material_moments_->centroid(nbrid_g, this->matid_, &matcen)) {
+          // Multi-material cell whose material centroid is precomputed
+          ls_coords.push_back(matcen);
+          ls_vals.push_back(this->vals_[nbrid_l]);
+        } else if (this->interface_reconstructor_ && cellmats.size() > 1){ // Multi-material cell
           // Get cell's cellmatpoly
           auto cellmatpoly =
             this->interface_reconstructor_->cell_matpoly_data(nbrid_g);
@@ -336,28 +458,21 @@ Vector<D> Limited_Gradient <D, Entity_kind::CELL, MeshType, StateType,
       }
     }
 
-    grad = Wonton::ls_gradient<D,CoordSys>(ls_coords, ls_vals);
-
-    // Limit the gradient to enforce monotonicity preservation
-    if (this->limtype_ == BARTH_JESPERSEN &&
-        (!this->mesh_.on_exterior_boundary(Entity_kind::CELL, cellid) ||
-         this->bnd_limtype_ == BND_BARTH_JESPERSEN)) {
-
-      phi = 1.0;
+    *grad = Wonton::ls_gradient<D,CoordSys>(ls_coords, ls_vals);
 
+    if (limit) {
       // Min and max vals of function (cell centered vals) among neighbors
       // and the cell itself
       /// @todo: must remove assumption the field is scalar
 
-      double minval = ls_vals[0];
-      double maxval = ls_vals[0];
-      double cellcenval = ls_vals[0];
+      *cellcen = ls_coords[0];
+      *cellcenval = *minval = *maxval = ls_vals[0];
 
       // Find min and max values among all neighbors (exlude the first element
       // in nbrids because it corresponds to the cell itself, not a neighbor)
       for (int i = 1; i < ls_vals.size(); ++i) {
-        minval = std::min(ls_vals[i], minval);
-        maxval = std::max(ls_vals[i], maxval);
+        *minval = std::min(ls_vals[i], *minval);
+        *maxval = std::max(ls_vals[i], *maxval);
       }
 
       /* Per page 278 of [Kucharik, M. and Shaskov, M, "Conservative
@@ -375,27 +490,8 @@ Vector<D> Limited_Gradient <D, Entity_kind::CELL, MeshType, StateType,
          bounds that a variable has to satisfy. Then we can impose the global
          limits at multi-material cells and boundary cells without limiting
          the gradient to 0. */
-
-      // Find the min and max of the reconstructed function in the cell
-      // Since the reconstruction is linear, this will occur at one of
-      // the nodes of the cell. So find the values of the reconstructed
-      // function at the nodes of the cell
-
-      int dim = this->mesh_.space_dimension();
-      std::vector<Point<D>> cellcoords;
-      this->mesh_.cell_get_coordinates(cellid, &cellcoords);
-
-      for (auto coord : cellcoords) {
-        Vector<D> vec = coord-ls_coords[0];
-        double diff = dot(grad, vec);
-        double extremeval = (diff > 0.0) ? maxval : minval;
-        double phi_new = (diff == 0.0) ? 1 : (extremeval-cellcenval)/diff;
-        phi = std::min(phi_new, phi);
-      }
     }
-
-    // Limited gradient is phi*grad
-    return phi*grad;
+    return limit;
   }
 
 
@@ -409,10 +505,11 @@ Vector<D> Limited_Gradient <D, Entity_kind::CELL, MeshType, StateType,
 
 template<int D, typename MeshType, typename StateType,
   template<class, int, class, class> class InterfaceReconstructorType,
-  class Matpoly_Splitter, class Matpoly_Clipper, class CoordSys>
+  class Matpoly_Splitter, class Matpoly_Clipper, class CoordSys,
+  typename FieldT>
 class Limited_Gradient<D, Entity_kind::NODE, MeshType, StateType,
                        InterfaceReconstructorType,
-                       Matpoly_Splitter, Matpoly_Clipper, CoordSys> {
+                       Matpoly_Splitter, Matpoly_Clipper, CoordSys, FieldT> {
 
  public:
 
@@ -422,6 +519,8 @@ class Limited_Gradient<D, Entity_kind::NODE, MeshType, StateType,
     @param[in] var_name Name of field for which the gradient is to be computed
     @param[in] limiter_type An enum indicating if the limiter type (none, Barth-Jespersen, Superbee etc)
     @param[in] Boundary_Limiter_type An enum indicating the limiter type on the boundary
+    @param[in] node_neighbors Neighbors of each node if already known for this mesh
+    @param[in] limiter Dual cell vertices for the limiter if already known for this mesh
 
     @todo must remove assumption that field is scalar
   */
@@ -429,13 +528,13 @@ class Limited_Gradient<D, Entity_kind::NODE, MeshType, StateType,
   Limited_Gradient(MeshType const & mesh, StateType const & state,
                    std::string const var_name,
                    Limiter_type limiter_type,
-                   Boundary_Limiter_type Boundary_Limiter_type)
-    : mesh_(mesh),state_(state),vals_(nullptr) {
-      int nnodes = this->mesh_.num_entities(Entity_kind::NODE);
-      node_neighbors_.resize(nnodes);
-      Portage::for_each(this->mesh_.begin(Entity_kind::NODE), this->mesh_.end(Entity_kind::NODE),
-                        [this](int n) { this->mesh_.dual_cell_get_node_adj_cells(
-                                        n, Entity_type::ALL, &(node_neighbors_[n])); } );
+                   Boundary_Limiter_type Boundary_Limiter_type,
+                   std::shared_ptr<MeshAdjacency const> node_neighbors = nullptr,
+                   std::shared_ptr<BarthJespersenLimiter<D> const> limiter = nullptr)
+    : mesh_(mesh),state_(state),vals_(nullptr), node_neighbors_(node_neighbors),
+      limiter_(limiter) {
+      if (not node_neighbors_)
+        node_neighbors_ = make_mesh_adjacency(this->mesh_, Entity_kind::NODE);
       this->set_interpolation_variable(var_name, limiter_type, Boundary_Limiter_type);
     }
 
@@ -450,93 +549,163 @@ class Limited_Gradient<D, Entity_kind::NODE, MeshType, StateType,
       this->limtype_=limtype;
       this->bnd_limtype_=bnd_limtype;
       this->state_.mesh_get_data(Entity_kind::NODE, this->var_name_, &this->vals_);
+
+      // Gather the dual cell vertices once for the limiter (unless the
+      // caller already has them for this mesh)
+      if (this->limtype_ == BARTH_JESPERSEN && not limiter_)
+        limiter_ = make_barth_jespersen_limiter<D>(this->mesh_, Entity_kind::NODE);
+    }
+
+    /// Use precomputed least squares coefficients
+    void set_gradient_stencil(std::shared_ptr<GradientStencil<D> const> stencil) {
+      gradient_stencil_ = stencil;
     }
 
+    /// Limited gradient of one node
     Vector<D> operator() (int nodeid);
 
+    /*! @brief Limited gradients of several nodes
+        @param[in]  n        Number of nodes
+        @param[in]  nodeids  Nodes whose gradient is needed
+        @param[out] grads    Limited gradient of each node
+
+        Nodes are processed in blocks; the unlimited gradients of a
+        block are computed first and then limited together.
+    */
+    void compute_gradients(int n, int const *nodeids, Vector<D> *grads);
+
   private:
+    // Unlimited gradient of a node and what the limiter needs to know
+    // about it. Returns whether the gradient is to be limited
+    bool unlimited_gradient(int nodeid, Vector<D> *grad, Point<D> *nodecoord,
+                            double *nodeval, double *minval,
+                            double *maxval) const;
+
+    bool on_boundary(int nodeid) const {
+      return limiter_ ? limiter_->on_boundary(nodeid) :
+          this->mesh_.on_exterior_boundary(Entity_kind::NODE, nodeid);
+    }
+
     Limiter_type limtype_;
     Boundary_Limiter_type bnd_limtype_;
     std::string var_name_;
     int matid_;
     MeshType const & mesh_;
     StateType const & state_;
-    double const *vals_;
+    FieldT const *vals_;
     std::vector<int> cellids_;
     Field_type field_type_;
-    std::vector<std::vector<int>> node_neighbors_;
+    std::shared_ptr<MeshAdjacency const> node_neighbors_;
+    std::shared_ptr<GradientStencil<D> const> gradient_stencil_;
+    std::shared_ptr<BarthJespersenLimiter<D> const> limiter_;
   };
 
   // @brief Limited gradient functor implementation for NODE
 
 template<int D, typename MeshType, typename StateType,
   template<class, int, class, class> class InterfaceReconstructorType,
-  class Matpoly_Splitter, class Matpoly_Clipper, class CoordSys>
+  class Matpoly_Splitter, class Matpoly_Clipper, class CoordSys,
+  typename FieldT>
 Vector<D> Limited_Gradient <D, Entity_kind::NODE, MeshType, StateType,
   InterfaceReconstructorType, Matpoly_Splitter, Matpoly_Clipper,
-  CoordSys>::operator() (int nodeid) {
+  CoordSys, FieldT>::operator() (int nodeid) {
 
-    assert(this->vals_);
-
-    double phi = 1.0;
     Vector<D> grad;
+    compute_gradients(1, &nodeid, &grad);
+    return grad;
+  }
 
-    if (this->bnd_limtype_ == BND_ZERO_GRADIENT &&
-        this->mesh_.on_exterior_boundary(Entity_kind::NODE, nodeid)) {
-      grad.zero();
-      return grad;
-    }
+  // @brief Limited gradients of several nodes
 
-    std::vector<int> const & nbrids = node_neighbors_[nodeid];
-    std::vector<Point<D>> nodecoords(nbrids.size()+1);
-    std::vector<double> nodevalues(nbrids.size()+1);
-    this->mesh_.node_get_coordinates(nodeid, &(nodecoords[0]));
-    nodevalues[0] = this->vals_[nodeid];
-
-    int i = 1;
-    for (auto const & nbrnode : nbrids) {
-      this->mesh_.node_get_coordinates(nbrnode, &nodecoords[i]);
-      nodevalues[i] = this->vals_[nbrnode];
-      i++;
-    }
+template<int D, typename MeshType, typename StateType,
+  template<class, int, class, class> class InterfaceReconstructorType,
+  class Matpoly_Splitter, class Matpoly_Clipper, class CoordSys,
+  typename FieldT>
+void Limited_Gradient <D, Entity_kind::NODE, MeshType, StateType,
+  InterfaceReconstructorType, Matpoly_Splitter, Matpoly_Clipper,
+  CoordSys, FieldT>::compute_gradients(int n, int const *nodeids, Vector<D> *grads) {
 
-    grad = Wonton::ls_gradient<D,CoordSys>(nodecoords, nodevalues);
+    assert(this->vals_);
 
-    if (this->limtype_ == BARTH_JESPERSEN &&
-        (!this->mesh_.on_exterior_boundary(Entity_kind::NODE, nodeid) ||
-         this->bnd_limtype_ == BND_BARTH_JESPERSEN)) { 
+    constexpr int block_size = 64;
+    int const nblocks = (n + block_size - 1)/block_size;
 
-      // Min and max vals of function (cell centered vals) among neighbors
-      double minval = this->vals_[nodeid];
-      double maxval = this->vals_[nodeid];
+    Portage::for_each(make_counting_iterator(0), make_counting_iterator(nblocks),
+                      [&](int b) {
+      int const first = b*block_size;
+      int const nb = std::min(block_size, n - first);
 
-      for (auto const & val : nodevalues) {
-        minval = std::min(val, minval);
-        maxval = std::max(val, maxval);
-      }
+      Point<D> nodecoords[block_size];
+      double nodevals[block_size], minvals[block_size], maxvals[block_size];
+      char active[block_size];
 
-      // Find the min and max of the reconstructed function in the cell
-      // Since the reconstruction is linear, this will occur at one of
-      // the nodes of the cell. So find the values of the reconstructed
-      // function at the nodes of the cell
+      for (int i = 0; i < nb; i++)
+        active[i] = unlimited_gradient(nodeids[first+i], &grads[first+i],
+                                       &nodecoords[i], &nodevals[i],
+                                       &minvals[i], &maxvals[i]);
 
-      double nodeval = this->vals_[nodeid];
+      if (limiter_)
+        limiter_->limit(nb, nodeids + first, nodecoords, nodevals,
+                        minvals, maxvals, active, grads + first);
+    });
+  }
 
-      std::vector<Point<D>> dualcellcoords;
-      this->mesh_.dual_cell_get_coordinates(nodeid, &dualcellcoords);
+  // @brief Unlimited gradient of a node, along with its value and the
+  // min and max among its neighbors
 
-      for (auto const & coord : dualcellcoords) {
-        Vector<D> vec = coord-nodecoords[0];
-        double diff = dot(grad, vec);
-        double extremeval = (diff > 0.0) ? maxval : minval;
-        double phi_new = (diff == 0.0) ? 1 : (extremeval-nodeval)/diff;
-        phi = std::min(phi_new, phi);
-      }
+template<int D, typename MeshType, typename StateType,
+  template<class, int, class, class> class InterfaceReconstructorType,
+  class Matpoly_Splitter, class Matpoly_Clipper, class CoordSys,
+  typename FieldT>
+bool Limited_Gradient <D, Entity_kind::NODE, MeshType, StateType,
+  InterfaceReconstructorType, Matpoly_Splitter, Matpoly_Clipper,
+  CoordSys, FieldT>::unlimited_gradient(int nodeid, Vector<D> *grad,
+                                Point<D> *nodecoord, double *nodeval,
+                                double *minval, double *maxval) const {
+
+    if (this->bnd_limtype_ == BND_ZERO_GRADIENT && on_boundary(nodeid)) {
+      grad->zero();
+      return false;
     }
 
-    // Limited gradient is phi*grad
+    bool const limit = (this->limtype_ == BARTH_JESPERSEN &&
+                        (this->bnd_limtype_ == BND_BARTH_JESPERSEN ||
+                         !on_boundary(nodeid)));
+
+    MeshAdjacency::Neighbors const nbrids = (*node_neighbors_)[nodeid];
+
+    if (gradient_stencil_ && gradient_stencil_->valid(nodeid)) {
+      // Only a dot product with the precomputed least squares
+      // coefficients
+      *grad = (*gradient_stencil_)(nodeid, this->vals_);
+      *nodecoord = gradient_stencil_->center(nodeid);
+    } else {
+      std::vector<Point<D>> nodecoords(nbrids.size()+1);
+      std::vector<double> nodevalues(nbrids.size()+1);
+      this->mesh_.node_get_coordinates(nodeid, &(nodecoords[0]));
+      nodevalues[0] = this->vals_[nodeid];
+
+      int i = 1;
+      for (auto const & nbrnode : nbrids) {
+        this->mesh_.node_get_coordinates(nbrnode, &nodecoords[i]);
+        nodevalues[i] = this->vals_[nbrnode];
+        i++;
+      }
 
-    return phi*grad;
+      *grad = Wonton::ls_gradient<D,CoordSys>(nodecoords, nodevalues);
+      *nodecoord = nodecoords[0];
+    }
+
+    if (limit) {
+      // Min and max vals of function (node centered vals) among neighbors
+      // and the node itself
+      *nodeval = *minval = *maxval = this->vals_[nodeid];
+      for (auto const & nbrnode : nbrids) {
+        *minval = std::min(static_cast<double>(this->vals_[nbrnode]), *minval);
+        *maxval = std::max(static_cast<double>(this->vals_[nbrnode]), *maxval);
+      }
+    }
+    return limit;
   }
 
 }  // namespace Portage
@@ -0,0 +1,211 @@
+/*
+This file is part of the Ristra portage project.
+Please see the license file at the root of this repository, or at:
+    https://github.com/laristra/portage/blob/master/LICENSE
+*/
+
+#ifndef PORTAGE_INTERPOLATE_GRADIENT_STENCIL_H_
+#define PORTAGE_INTERPOLATE_GRADIENT_STENCIL_H_
+
+#include <cmath>
+#include <memory>
+#include <vector>
+
+// portage includes
+#include "portage/support/portage.h"
+#include "portage/support/mesh_adjacency.h"
+
+// wonton includes
+#include "wonton/support/Point.h"
+#include "wonton/support/Vector.h"
+
+namespace Portage {
+
+using Wonton::Point;
+using Wonton::Vector;
+
+/*!
+  @class GradientStencil gradient_stencil.h
+  @brief Precomputed least squares gradient operator of a mesh
+
+  The least squares gradient at an entity with center x_0 and neighbor
+  centers x_k minimizes sum_k (v_0 + g.(x_k - x_0) - v_k)^2, so that
+
+    g = sum_k c_k (v_k - v_0),  c_k = (A^T A)^{-1} (x_k - x_0)
+
+  where the rows of A are the x_k - x_0. The coefficients c_k depend
+  only on the mesh, so they are computed once here and each field's
+  gradient is then a short dot product over the neighbors. This is the
+  same gradient as Wonton::ls_gradient (Cartesian coordinates) up to
+  roundoff.
+
+  Entities whose neighborhood does not determine a gradient (A^T A
+  singular) are flagged as invalid and must be handled by the caller.
+
+  @tparam D  spatial dimension
+*/
+
+template <int D>
+class GradientStencil {
+ public:
+
+  /*!
+    @brief Compute the stencil coefficients
+    @param[in] adjacency   Neighbors of each entity
+    @param[in] get_center  Functor (int, Point<D>*) returning the point
+                           at which an entity's value is located
+  */
+  template <class GetCenter>
+  GradientStencil(std::shared_ptr<MeshAdjacency const> adjacency,
+                  GetCenter get_center) : adjacency_(adjacency) {
+
+    int const nentities = adjacency_->num_entities();
+    centers_.resize(nentities);
+    Portage::for_each(make_counting_iterator(0),
+                      make_counting_iterator(nentities),
+                      [&](int e) { get_center(e, &(centers_[e])); });
+
+    coefs_.resize(adjacency_->neighbors().size());
+    valid_.resize(nentities);
+
+    Portage::for_each(make_counting_iterator(0),
+                      make_counting_iterator(nentities),
+                      [&](int e) { valid_[e] = compute_coefs(e); });
+  }
+
+  /// Number of entities
+  int num_entities() const { return centers_.size(); }
+
+  /// Neighbors of each entity
+  MeshAdjacency const& adjacency() const { return *adjacency_; }
+
+  /// Point at which the value of an entity is located
+  Point<D> const& center(int e) const { return centers_[e]; }
+
+  /// Whether the stencil of an entity determines a gradient
+  bool valid(int e) const { return valid_[e]; }
+
+  /*!
+    @brief Gradient of a field at an entity
+    @param[in] e     Entity index
+    @param[in] vals  Field values indexed by entity
+  */
+  template <typename T>
+  Vector<D> operator()(int e, T const *vals) const {
+    Vector<D> grad;
+    grad.zero();
+    int const *nbrs = adjacency_->neighbors().data();
+    int const kbeg = adjacency_->offsets()[e];
+    int const kend = adjacency_->offsets()[e+1];
+    T const val0 = vals[e];
+    for (int k = kbeg; k < kend; k++) {
+      double const dv = vals[nbrs[k]] - val0;
+      for (int d = 0; d < D; d++)
+        grad[d] += coefs_[k][d]*dv;
+    }
+    return grad;
+  }
+
+ private:
+
+  // Solve for the coefficients of entity e. Returns false if the
+  // normal matrix is singular
+  bool compute_coefs(int e) {
+    int const *nbrs = adjacency_->neighbors().data();
+    int const kbeg = adjacency_->offsets()[e];
+    int const kend = adjacency_->offsets()[e+1];
+    Point<D> const& x0 = centers_[e];
+
+    // normal matrix A^T A
+    double ata[D][D] = {};
+    for (int k = kbeg; k < kend; k++) {
+      Vector<D> dx = centers_[nbrs[k]] - x0;
+      for (int i = 0; i < D; i++)
+        for (int j = 0; j < D; j++)
+          ata[i][j] += dx[i]*dx[j];
+    }
+
+    double inv[D][D];
+    if (!invert(ata, inv)) {
+      for (int k = kbeg; k < kend; k++)
+        coefs_[k].zero();
+      return false;
+    }
+
+    for (int k = kbeg; k < kend; k++) {
+      Vector<D> dx = centers_[nbrs[k]] - x0;
+      for (int i = 0; i < D; i++) {
+        coefs_[k][i] = 0.0;
+        for (int j = 0; j < D; j++)
+          coefs_[k][i] += inv[i][j]*dx[j];
+      }
+    }
+    return true;
+  }
+
+  // Invert a small symmetric positive semi-definite matrix by
+  // cofactors. Returns false if it is singular relative to its scale
+  static bool invert(double const a[D][D], double inv[D][D]) {
+    double scale = 0.0;
+    for (int i = 0; i < D; i++)
+      scale += std::fabs(a[i][i]);
+    if (scale == 0.0) return false;
+    double const tol = 1.0e-12*std::pow(scale, D);
+
+    if (D == 1) {
+      if (std::fabs(a[0][0]) <= tol) return false;
+      inv[0][0] = 1.0/a[0][0];
+    } else if (D == 2) {
+      double const det = a[0][0]*a[1][1] - a[0][1]*a[1][0];
+      if (std::fabs(det) <= tol) return false;
+      inv[0][0] =  a[1][1]/det;
+      inv[0][1] = -a[0][1]/det;
+      inv[1][0] = -a[1][0]/det;
+      inv[1][1] =  a[0][0]/det;
+    } else {
+      for (int i = 0; i < 3; i++)
+        for (int j = 0; j < 3; j++) {
+          // cofactor of a[j][i] (transposed for the adjugate)
+          int const r0 = (j+1)%3, r1 = (j+2)%3;
+          int const c0 = (i+1)%3, c1 = (i+2)%3;
+          inv[i][j] = a[r0][c0]*a[r1][c1] - a[r0][c1]*a[r1][c0];
+        }
+      double const det = a[0][0]*inv[0][0] + a[0][1]*inv[1][0] + a[0][2]*inv[2][0];
+      if (std::fabs(det) <= tol) return false;
+      for (int i = 0; i < 3; i++)
+        for (int j = 0; j < 3; j++)
+          inv[i][j] /= det;
+    }
+    return true;
+  }
+
+  std::shared_ptr<MeshAdjacency const> adjacency_;
+  std::vector<Point<D>> centers_;
+  std::vector<Vector<D>> coefs_;  // one per entry of adjacency_->neighbors()
+  std::vector<char> valid_;
+};
+
+
+/*!
+  @brief Build the gradient stencil used by Limited_Gradient for mesh fields
+
+  @param[in] mesh       Mesh wrapper
+  @param[in] kind       CELL (centroids of cells sharing a node) or NODE
+                        (coordinates of nodes of adjacent dual cells)
+  @param[in] adjacency  Neighbor lists of the mesh for this entity kind
+*/
+template <int D, class MeshType>
+std::shared_ptr<GradientStencil<D> const>
+make_gradient_stencil(MeshType const& mesh, Entity_kind kind,
+                      std::shared_ptr<MeshAdjacency const> adjacency) {
+  if (kind == Entity_kind::CELL)
+    return std::make_shared<GradientStencil<D> const>(
+        adjacency, [&mesh](int c, Point<D> *p) { mesh.cell_centroid(c, p); });
+  else
+    return std::make_shared<GradientStencil<D> const>(
+        adjacency, [&mesh](int n, Point<D> *p) { mesh.node_get_coordinates(n, p); });
+}
+
+}  // namespace Portage
+
+#endif  // PORTAGE_INTERPOLATE_GRADIENT_STENCIL_H_
@@ -9,6 +9,7 @@ Please see the license file at the root of this repository, or at:
 
 
 #include <cassert>
+#include <algorithm>
 #include <string>
 #include <iostream>
 #include <utility>
@@ -18,6 +19,8 @@ Please see the license file at the root of this repository, or at:
 // portage includes
 #include "portage/intersect/dummy_interface_reconstructor.h"
 #include "portage/support/portage.h"
+#include "portage/interpolate/source_mesh_data.h"
+#include "portage/interpolate/field_components.h"
 
 // wonton includes
 #include "wonton/support/CoordinateSystem.h"
@@ -111,7 +114,7 @@ class Interpolate_1stOrder {
       source_state_(source_state),
       interface_reconstructor_(ir),
       interp_var_name_("VariableNameNotSet"),
-      source_vals_(nullptr),
+      source_vals_(),
       num_tols_(num_tols) {}
 #endif
 
@@ -133,7 +136,7 @@ class Interpolate_1stOrder {
       target_mesh_(target_mesh),
       source_state_(source_state),
       interp_var_name_("VariableNameNotSet"),
-      source_vals_(nullptr),
+      source_vals_(),
       num_tols_(num_tols) {}
 
 
@@ -148,7 +151,7 @@ class Interpolate_1stOrder {
 
   /// Set the material we are operating on
 
-  int set_material(int m) {
+  void set_material(int m) {
     matid_ = m;
   }  // set_material
 
@@ -161,18 +164,30 @@ class Interpolate_1stOrder {
   // order interpolators and so all interpolators need to have a
   // uniform interface
 
+  template <typename T = double>
   void set_interpolation_variable(std::string const & interp_var_name,
                                   Limiter_type limtype=NOLIMITER,
                                   Boundary_Limiter_type bnd_limtype=BND_NOLIMITER) {
     interp_var_name_ = interp_var_name;
     field_type_ = source_state_.field_type(Entity_kind::CELL, interp_var_name);
     if (field_type_ == Field_type::MESH_FIELD)
-      source_state_.mesh_get_data(Entity_kind::CELL, interp_var_name,
-                                  &source_vals_);
+      source_vals_ = get_mesh_field<T>(source_state_, Entity_kind::CELL,
+                                       interp_var_name);
     else
-      source_state_.mat_get_celldata(interp_var_name, matid_, &source_vals_);
+      source_vals_ = get_mat_field<T>(source_state_, interp_var_name, matid_);
   }  // set_interpolation_variable
 
+  /// 1st order interpolation does not need any data of the source
+  /// mesh; what it is given is kept and returned as is
+
+  void set_source_mesh_data(SourceMeshData<D> const& data) {
+    source_mesh_data_ = data;
+  }
+
+  SourceMeshData<D> const& source_mesh_data() const {
+    return source_mesh_data_;
+  }
+
   /*!
     @brief Functor to do the actual interpolation.
     @param[in] sources_and_weights A pair of two vectors.
@@ -201,11 +216,14 @@ class Interpolate_1stOrder {
   TargetMeshType const & target_mesh_;
   SourceStateType const & source_state_;
   std::string interp_var_name_;
-  double const * source_vals_;
+  FieldValues source_vals_;
   int matid_;
   Field_type field_type_;
   NumericTolerances_t num_tols_;
 
+  // Source mesh data held for the driver
+  SourceMeshData<D> source_mesh_data_;
+
 
 #ifdef HAVE_TANGRAM
   std::shared_ptr<InterfaceReconstructor> interface_reconstructor_;
@@ -256,7 +274,7 @@ class Interpolate_1stOrder<D,
       source_state_(source_state),
       interface_reconstructor_(ir),
       interp_var_name_("VariableNameNotSet"),
-      source_vals_(nullptr),
+      source_vals_(),
       num_tols_(num_tols) {}
 #endif
   /*!
@@ -275,7 +293,7 @@ class Interpolate_1stOrder<D,
       target_mesh_(target_mesh),
       source_state_(source_state),
       interp_var_name_("VariableNameNotSet"),
-      source_vals_(nullptr),
+      source_vals_(),
       num_tols_(num_tols) {}
 
 
@@ -291,7 +309,7 @@ class Interpolate_1stOrder<D,
 
   /// Set the material we are operating on
 
-  int set_material(int m) {
+  void set_material(int m) {
     matid_ = m;
   }  // set_material
 
@@ -305,18 +323,63 @@ class Interpolate_1stOrder<D,
   // order interpolators and so all interpolators need to have a
   // uniform interface
 
+  template <typename T = double>
   void set_interpolation_variable(std::string const & interp_var_name,
                                   Limiter_type limtype = NOLIMITER,
                                   Boundary_Limiter_type bnd_limtype=BND_NOLIMITER) {
     interp_var_name_ = interp_var_name;
     field_type_ = source_state_.field_type(Entity_kind::CELL, interp_var_name);
     if (field_type_ == Field_type::MESH_FIELD)
-      source_state_.mesh_get_data(Entity_kind::CELL, interp_var_name,
-                                  &source_vals_);
+      source_vals_ = get_mesh_field<T>(source_state_, Entity_kind::CELL,
+                                       interp_var_name);
     else
-      source_state_.mat_get_celldata(interp_var_name, matid_, &source_vals_);
+      source_vals_ = get_mat_field<T>(source_state_, interp_var_name, matid_);
   }  // set_interpolation_variable
 
+  /*!
+    @brief Set the components of a multi-component variable
+    @param[in] component_names  Source variable holding each component
+
+    The components are packed entity by entity (see
+    field_components.h) and are interpolated together by the
+    multi-component functor.
+  */
+
+  template <typename T = double>
+  void set_interpolation_variable(std::vector<std::string> const & component_names,
+                                  Limiter_type limtype = NOLIMITER,
+                                  Boundary_Limiter_type bnd_limtype=BND_NOLIMITER) {
+    int const ncomp = component_names.size();
+    std::vector<FieldValues> components(ncomp);
+    for (int k = 0; k < ncomp; k++) {
+      set_interpolation_variable<T>(component_names[k], limtype, bnd_limtype);
+      components[k] = source_vals_;
+    }
+
+    int nentities = 0;
+    if (field_type_ == Field_type::MESH_FIELD)
+      nentities = source_mesh_.num_entities(Entity_kind::CELL, Entity_type::ALL);
+    else
+      nentities = source_state_.mat_get_num_cells(matid_);
+    pack_components(nentities, components, &component_vals_);
+    ncomponents_ = ncomp;
+  }  // set_interpolation_variable
+
+  /// Number of components set by the multi-component set_interpolation_variable
+
+  int num_components() const { return ncomponents_; }
+
+  /// 1st order interpolation does not need any data of the source
+  /// mesh; what it is given is kept and returned as is
+
+  void set_source_mesh_data(SourceMeshData<D> const& data) {
+    source_mesh_data_ = data;
+  }
+
+  SourceMeshData<D> const& source_mesh_data() const {
+    return source_mesh_data_;
+  }
+
   /*!
     @brief Functor to do the actual interpolation.
     @param[in] sources_and_weights A pair of two vectors.
@@ -350,7 +413,7 @@ class Interpolate_1stOrder<D,
     if (field_type_ == Field_type::MESH_FIELD) {
       for (auto const& wt : sources_and_weights) {
         int srccell = wt.entityID;
-        std::vector<double> pair_weights = wt.weights;
+        std::vector<double> const& pair_weights = wt.weights;
         if (pair_weights[0]/vol < num_tols_.min_relative_volume)
           continue;  // skip small intersections
         val += source_vals_[srccell] * pair_weights[0];
@@ -360,7 +423,7 @@ class Interpolate_1stOrder<D,
     } else if (field_type_ == Field_type::MULTIMATERIAL_FIELD) {
       for (auto const& wt : sources_and_weights) {
         int srccell = wt.entityID;
-        std::vector<double> pair_weights = wt.weights;
+        std::vector<double> const& pair_weights = wt.weights;
         if (pair_weights[0]/vol < num_tols_.min_relative_volume)
           continue;  // skip small intersections
         int matcell = source_state_.cell_index_in_material(srccell, matid_);
@@ -385,16 +448,66 @@ class Interpolate_1stOrder<D,
     return val;
   }  // operator()
 
+  /*!
+    @brief Interpolate all components of a multi-component variable
+    @param[in]  targetCellID         The index of the target cell
+    @param[in]  sources_and_weights  Source cells and their moments over
+                                     the target cell
+    @param[out] values               num_components() interpolated values
+
+    Same as the scalar functor applied to each component, but each
+    weight is read once for all components.
+  */
+
+  void operator() (int const targetCellID,
+                   std::vector<Weights_t> const & sources_and_weights,
+                   double *values) const
+  {
+    int const ncomp = ncomponents_;
+    std::fill(values, values + ncomp, 0.0);
+
+    double wtsum0 = 0.0;
+    double vol = target_mesh_.cell_volume(targetCellID);
+    double const *compvals = component_vals_.data();
+
+    int nsummed = 0;
+    for (auto const& wt : sources_and_weights) {
+      int srccell = wt.entityID;
+      double const xsect_volume = wt.weights[0];
+      if (xsect_volume/vol < num_tols_.min_relative_volume)
+        continue;  // skip small intersections
+      int const srcindex = (field_type_ == Field_type::MESH_FIELD) ? srccell :
+          source_state_.cell_index_in_material(srccell, matid_);
+      double const *srcvals = compvals + static_cast<size_t>(srcindex)*ncomp;
+      for (int k = 0; k < ncomp; k++)
+        values[k] += srcvals[k] * xsect_volume;
+      wtsum0 += xsect_volume;
+      nsummed++;
+    }
+
+    // Normalize as in the scalar functor
+    if (nsummed)
+      for (int k = 0; k < ncomp; k++)
+        values[k] /= wtsum0;
+  }  // operator()
+
  private:
   SourceMeshType const & source_mesh_;
   TargetMeshType const & target_mesh_;
   SourceStateType const & source_state_;
   std::string interp_var_name_;
-  double const * source_vals_;
+  FieldValues source_vals_;
   int matid_;
   Field_type field_type_;
   NumericTolerances_t num_tols_;
 
+  // Source mesh data held for the driver
+  SourceMeshData<D> source_mesh_data_;
+
+  // Components of a multi-component variable, packed entity by entity
+  int ncomponents_ = 0;
+  std::vector<double> component_vals_;
+
 #ifdef HAVE_TANGRAM
   std::shared_ptr<InterfaceReconstructor> interface_reconstructor_;
 #endif
@@ -447,7 +560,7 @@ class Interpolate_1stOrder<D,
       source_state_(source_state),
       interface_reconstructor_(ir),
       interp_var_name_("VariableNameNotSet"),
-      source_vals_(nullptr),
+      source_vals_(),
       num_tols_(num_tols) {}
 #endif
 
@@ -467,7 +580,7 @@ class Interpolate_1stOrder<D,
       target_mesh_(target_mesh),
       source_state_(source_state),
       interp_var_name_("VariableNameNotSet"),
-      source_vals_(nullptr),
+      source_vals_(),
       num_tols_(num_tols) {}
 
 
@@ -482,7 +595,7 @@ class Interpolate_1stOrder<D,
 
   /// Set the material we are operating on
 
-  int set_material(int m) {
+  void set_material(int m) {
     matid_ = m;
   }  // set_material
 
@@ -495,20 +608,62 @@ class Interpolate_1stOrder<D,
   // order interpolators and so all interpolators need to have a
   // uniform interface
 
+  template <typename T = double>
   void set_interpolation_variable(std::string const & interp_var_name,
                                   Limiter_type limtype = NOLIMITER,
                                   Boundary_Limiter_type bnd_limtype=BND_NOLIMITER) {
     interp_var_name_ = interp_var_name;
     field_type_ = source_state_.field_type(Entity_kind::NODE, interp_var_name);
     if (field_type_ == Field_type::MESH_FIELD)
-      source_state_.mesh_get_data(Entity_kind::NODE, interp_var_name,
-                                  &source_vals_);
+      source_vals_ = get_mesh_field<T>(source_state_, Entity_kind::NODE,
+                                       interp_var_name);
     else {
-      source_state_.mat_get_celldata(interp_var_name, matid_, &source_vals_);
+      source_vals_ = get_mat_field<T>(source_state_, interp_var_name, matid_);
       std::cerr << "Cannot remap NODE-centered multi-material data" << "\n";
     }
   }  // set_interpolation_variable
 
+  /*!
+    @brief Set the components of a multi-component variable
+    @param[in] component_names  Source variable holding each component
+
+    The components are packed entity by entity (see
+    field_components.h) and are interpolated together by the
+    multi-component functor.
+  */
+
+  template <typename T = double>
+  void set_interpolation_variable(std::vector<std::string> const & component_names,
+                                  Limiter_type limtype = NOLIMITER,
+                                  Boundary_Limiter_type bnd_limtype=BND_NOLIMITER) {
+    int const ncomp = component_names.size();
+    std::vector<FieldValues> components(ncomp);
+    for (int k = 0; k < ncomp; k++) {
+      set_interpolation_variable<T>(component_names[k], limtype, bnd_limtype);
+      components[k] = source_vals_;
+    }
+
+    int const nentities = source_mesh_.num_entities(Entity_kind::NODE,
+                                                    Entity_type::ALL);
+    pack_components(nentities, components, &component_vals_);
+    ncomponents_ = ncomp;
+  }  // set_interpolation_variable
+
+  /// Number of components set by the multi-component set_interpolation_variable
+
+  int num_components() const { return ncomponents_; }
+
+  /// 1st order interpolation does not need any data of the source
+  /// mesh; what it is given is kept and returned as is
+
+  void set_source_mesh_data(SourceMeshData<D> const& data) {
+    source_mesh_data_ = data;
+  }
+
+  SourceMeshData<D> const& source_mesh_data() const {
+    return source_mesh_data_;
+  }
+
   /*!
     @brief Functor to do the actual interpolation.
     @param[in] sources_and_weights A pair of two vectors.
@@ -543,7 +698,7 @@ class Interpolate_1stOrder<D,
     int nsummed = 0;
     for (auto const& wt : sources_and_weights) {
       int srcnode = wt.entityID;
-      std::vector<double> pair_weights = wt.weights;
+      std::vector<double> const& pair_weights = wt.weights;
       if (pair_weights[0]/vol < num_tols_.min_relative_volume)
         continue;  // skip small intersections
       val += source_vals_[srcnode] * pair_weights[0];  // 1st order
@@ -567,16 +722,65 @@ class Interpolate_1stOrder<D,
     return val;
   }  // operator()
 
+  /*!
+    @brief Interpolate all components of a multi-component variable
+    @param[in]  targetNodeID         The index of the target node
+    @param[in]  sources_and_weights  Source nodes (dual cells) and their
+                                     moments over the target dual cell
+    @param[out] values               num_components() interpolated values
+
+    Same as the scalar functor applied to each component, but each
+    weight is read once for all components.
+  */
+
+  void operator() (int const targetNodeID,
+                   std::vector<Weights_t> const & sources_and_weights,
+                   double *values) const
+  {
+    int const ncomp = ncomponents_;
+    std::fill(values, values + ncomp, 0.0);
+    if (field_type_ != Field_type::MESH_FIELD) return;
+
+    double wtsum0 = 0.0;
+    double vol = target_mesh_.dual_cell_volume(targetNodeID);
+    double const *compvals = component_vals_.data();
+
+    int nsummed = 0;
+    for (auto const& wt : sources_and_weights) {
+      int srcnode = wt.entityID;
+      double const xsect_volume = wt.weights[0];
+      if (xsect_volume/vol < num_tols_.min_relative_volume)
+        continue;  // skip small intersections
+      double const *srcvals = compvals + static_cast<size_t>(srcnode)*ncomp;
+      for (int k = 0; k < ncomp; k++)
+        values[k] += srcvals[k] * xsect_volume;
+      wtsum0 += xsect_volume;
+      nsummed++;
+    }
+
+    // Normalize as in the scalar functor
+    if (nsummed)
+      for (int k = 0; k < ncomp; k++)
+        values[k] /= wtsum0;
+  }  // operator()
+
  private:
   SourceMeshType const & source_mesh_;
   TargetMeshType const & target_mesh_;
   SourceStateType const & source_state_;
   std::string interp_var_name_;
-  double const * source_vals_;
+  FieldValues source_vals_;
   int matid_;
   Field_type field_type_;
   NumericTolerances_t num_tols_;
 
+  // Source mesh data held for the driver
+  SourceMeshData<D> source_mesh_data_;
+
+  // Components of a multi-component variable, packed entity by entity
+  int ncomponents_ = 0;
+  std::vector<double> component_vals_;
+
 #ifdef HAVE_TANGRAM
   std::shared_ptr<InterfaceReconstructor> interface_reconstructor_;
 #endif
@@ -8,8 +8,11 @@ Please see the license file at the root of this repository, or at:
 #define PORTAGE_INTERPOLATE_INTERPOLATE_2ND_ORDER_H_
 
 #include <cassert>
+#include <memory>
+#include <type_traits>
 #include <stdexcept>
 #include <algorithm>
+#include <numeric>
 #include <string>
 #include <iostream>
 #include <utility>
@@ -17,6 +20,12 @@ Please see the license file at the root of this repository, or at:
 
 // portage includes
 #include "portage/interpolate/gradient.h"
+#include "portage/interpolate/gradient_stencil.h"
+#include "portage/interpolate/limiter.h"
+#include "portage/interpolate/material_moments.h"
+#include "portage/interpolate/source_mesh_data.h"
+#include "portage/interpolate/field_components.h"
+#include "portage/support/mesh_adjacency.h"
 #include "portage/intersect/dummy_interface_reconstructor.h"
 #include "portage/support/portage.h"
 
@@ -98,7 +107,7 @@ class Interpolate_2ndOrder {
       source_state_(source_state),
       interface_reconstructor_(ir),
       interp_var_name_("VariableNameNotSet"),
-      source_vals_(nullptr),
+      source_vals_(),
       num_tols_(num_tols) {
     CoordSys::template verify_coordinate_system<D>();
   }
@@ -119,7 +128,7 @@ class Interpolate_2ndOrder {
       target_mesh_(target_mesh),
       source_state_(source_state),
       interp_var_name_("VariableNameNotSet"),
-      source_vals_(nullptr),
+      source_vals_(),
       num_tols_(num_tols) {
     CoordSys::template verify_coordinate_system<D>();
   }
@@ -135,12 +144,13 @@ class Interpolate_2ndOrder {
 
   /// Set the material we are operating on.
 
-  int set_material(int m) {
+  void set_material(int m) {
     matid_ = m;
   }  // set_material
 
   /// Set the name of the interpolation variable and the limiter type
 
+  template <typename T = double>
   void set_interpolation_variable(std::string const & interp_var_name,
                                   Limiter_type limiter_type = NOLIMITER,
                                   Boundary_Limiter_type Boundary_Limiter_type = BND_NOLIMITER) {
@@ -180,7 +190,7 @@ class Interpolate_2ndOrder {
   TargetMeshType const & target_mesh_;
   StateType const & source_state_;
   std::string interp_var_name_;
-  double const * source_vals_;
+  FieldValues source_vals_;
   NumericTolerances_t num_tols_;
 
   // Portage::vector is generalization of std::vector and
@@ -243,7 +253,7 @@ class Interpolate_2ndOrder<D,
       source_state_(source_state),
       interface_reconstructor_(ir),
       interp_var_name_("VariableNameNotSet"),
-      source_vals_(nullptr),
+      source_vals_(),
       num_tols_(num_tols) {
     CoordSys::template verify_coordinate_system<D>();
   }
@@ -258,14 +268,29 @@ class Interpolate_2ndOrder<D,
       target_mesh_(target_mesh),
       source_state_(source_state),
       interp_var_name_("VariableNameNotSet"),
-      source_vals_(nullptr),
+      source_vals_(),
       num_tols_(num_tols) {
     CoordSys::template verify_coordinate_system<D>();
   }
 
 
+  /// Use source mesh data (neighbor lists, stencils, ...) built
+  /// elsewhere, e.g. by the interpolator of another variable. Whatever
+  /// is missing is built when the interpolation variable is set
+
+  void set_source_mesh_data(SourceMeshData<D> const& data) {
+    mesh_data_ = data;
+  }
+
+  /// Source mesh data given to or built by this interpolator
+
+  SourceMeshData<D> const& source_mesh_data() const {
+    return mesh_data_;
+  }
+
   /// Set the name of the interpolation variable and the limiter type
 
+  template <typename T = double>
   void set_interpolation_variable(std::string const & interp_var_name,
                                   Limiter_type limiter_type = NOLIMITER,
                                   Boundary_Limiter_type boundary_limiter_type = BND_NOLIMITER) {
@@ -279,49 +304,105 @@ class Interpolate_2ndOrder<D,
     field_type_ = source_state_.field_type(Entity_kind::CELL, interp_var_name);
     if (field_type_ == Field_type::MESH_FIELD)
     {
-      source_state_.mesh_get_data(Entity_kind::CELL, interp_var_name, &source_vals_);
+      source_vals_ = get_mesh_field<T>(source_state_, Entity_kind::CELL,
+                                       interp_var_name);
       nentities = source_mesh_.num_entities(Entity_kind::CELL);
+      cellids.resize(nentities);
+      std::iota(cellids.begin(), cellids.end(), 0);
     }
     else
     {
-      source_state_.mat_get_celldata(interp_var_name, matid_, &source_vals_);
+      source_vals_ = get_mat_field<T>(source_state_, interp_var_name, matid_);
       source_state_.mat_get_cells(matid_, &cellids);
       nentities =  cellids.size();
     }
+    // Neighbor lists are the same for every variable and material
+    if (not mesh_data_.adjacency)
+      mesh_data_.adjacency = make_mesh_adjacency(source_mesh_, Entity_kind::CELL);
+
+    // So are the least squares coefficients of mesh fields (the
+    // stencil is only derived for Cartesian coordinates)
+    if (not mesh_data_.gradient_stencil and field_type_ == Field_type::MESH_FIELD and
+        std::is_same<CoordSys, Wonton::DefaultCoordSys>::value)
+      mesh_data_.gradient_stencil = make_gradient_stencil<D>(source_mesh_, Entity_kind::CELL,
+                                                             mesh_data_.adjacency);
+
+    // And the cell vertices used by the limiter
+    if (not mesh_data_.limiter and limiter_type == BARTH_JESPERSEN)
+      mesh_data_.limiter = make_barth_jespersen_limiter<D>(source_mesh_, Entity_kind::CELL);
+
+#ifdef HAVE_TANGRAM
+    // And, for material fields, the material centroids of mixed cells
+    if (not mesh_data_.material_moments and field_type_ == Field_type::MULTIMATERIAL_FIELD and
+        interface_reconstructor_)
+      mesh_data_.material_moments = make_material_moments<D>(source_mesh_, source_state_,
+                                                             *interface_reconstructor_);
+#endif
+
     // Compute the limited gradients for the field
 #ifdef HAVE_TANGRAM
     Limited_Gradient<D, Entity_kind::CELL, SourceMeshType, StateType, InterfaceReconstructorType,
-                     Matpoly_Splitter, Matpoly_Clipper, CoordSys>
+                     Matpoly_Splitter, Matpoly_Clipper, CoordSys, T>
         limgrad(source_mesh_, source_state_, interp_var_name_, limiter_type, boundary_limiter_type,
-                interface_reconstructor_);
+                interface_reconstructor_, mesh_data_.adjacency, mesh_data_.limiter);
     if (field_type_ == Field_type::MULTIMATERIAL_FIELD)
       limgrad.set_material(matid_);
 #else
     Limited_Gradient<D, Entity_kind::CELL, SourceMeshType, StateType,
-      InterfaceReconstructorType, Matpoly_Splitter, Matpoly_Clipper, CoordSys>
-        limgrad(source_mesh_, source_state_, interp_var_name_, limiter_type, boundary_limiter_type);
+      InterfaceReconstructorType, Matpoly_Splitter, Matpoly_Clipper, CoordSys, T>
+        limgrad(source_mesh_, source_state_, interp_var_name_, limiter_type, boundary_limiter_type,
+                mesh_data_.adjacency, mesh_data_.limiter);
 #endif
+    limgrad.set_gradient_stencil(mesh_data_.gradient_stencil);
+    limgrad.set_material_moments(mesh_data_.material_moments);
 
+    // Compute the "limited" gradient of the field on the cells (all
+    // of them for mesh fields, those of the material otherwise). The
+    // gradients are computed and limited in blocks of cells
     gradients_.resize(nentities);
+    limgrad.compute_gradients(nentities, cellids.data(), gradients_.data());
+  }  // set_interpolation_variable
 
-    // call transform functor to take the values of the variable on
-    // the cells and compute a "limited" gradient of the field on the
-    // cells (for transform definition, see portage.h)
+  /*!
+    @brief Set the components of a multi-component variable
+    @param[in] component_names        Source variable holding each component
+    @param[in] limiter_type           Limiter applied to each component
+    @param[in] boundary_limiter_type  Boundary limiter applied to each component
+
+    The limited gradient of each component is computed as for a single
+    variable. Values and gradients are then packed entity by entity (see
+    field_components.h) so that the multi-component functor reads each
+    weight once for all components.
+  */
 
-    // Even though we defined Portage::transform (to be
-    // thrust::transform or boost::transform) in portage.h, the
-    // compiler is not able to disambiguate this call and is getting
-    // confused. So we will explicitly state that this is Portage::transform
-    if (field_type_ == Field_type::MESH_FIELD){
-      Portage::transform(source_mesh_.begin(Entity_kind::CELL), source_mesh_.end(Entity_kind::CELL),
-                         gradients_.begin(), limgrad);
-    }
-    else{
-      Portage::transform(cellids.begin(), cellids.end(),
-                         gradients_.begin(), limgrad);
+  template <typename T = double>
+  void set_interpolation_variable(std::vector<std::string> const & component_names,
+                                  Limiter_type limiter_type = NOLIMITER,
+                                  Boundary_Limiter_type boundary_limiter_type = BND_NOLIMITER) {
+    int const ncomp = component_names.size();
+    std::vector<FieldValues> components(ncomp);
+    std::vector<std::vector<Vector<D>>> component_gradients(ncomp);
+    for (int k = 0; k < ncomp; k++) {
+      set_interpolation_variable<T>(component_names[k], limiter_type,
+                                 boundary_limiter_type);
+      components[k] = source_vals_;
+      component_gradients[k].swap(gradients_);
     }
+
+    int const nentities = ncomp ? component_gradients[0].size() : 0;
+    std::vector<Vector<D> const *> gradient_ptrs(ncomp);
+    for (int k = 0; k < ncomp; k++)
+      gradient_ptrs[k] = component_gradients[k].data();
+
+    pack_components(nentities, components, &component_vals_);
+    pack_components(nentities, gradient_ptrs, &component_gradients_);
+    ncomponents_ = ncomp;
   }  // set_interpolation_variable
 
+  /// Number of components set by the multi-component set_interpolation_variable
+
+  int num_components() const { return ncomponents_; }
+
 
   /// Copy constructor (disabled)
   //  Interpolate_2ndOrder(const Interpolate_2ndOrder &) = delete;
@@ -335,7 +416,7 @@ class Interpolate_2ndOrder<D,
 
   /// Set the material we are operating on (MM interpolate not implemented yet)
 
-  int set_material(int m) {
+  void set_material(int m) {
     matid_ = m ;
   }  // set_material
 
@@ -377,7 +458,7 @@ class Interpolate_2ndOrder<D,
 
       // Get source cell and the intersection weights
       int srccell = sources_and_weights[j].entityID;
-      std::vector<double> xsect_weights = sources_and_weights[j].weights;
+      std::vector<double> const& xsect_weights = sources_and_weights[j].weights;
       double xsect_volume = xsect_weights[0];
 
       if (xsect_volume/vol <= num_tols_.min_relative_volume)
@@ -385,53 +466,7 @@ class Interpolate_2ndOrder<D,
 
       // Obtain source cell centroid
       Point<D> src_centroid;
-      if (field_type_ == Field_type::MESH_FIELD){
-        source_mesh_.cell_centroid(srccell, &src_centroid);
-      }
-      else if (field_type_ == Field_type::MULTIMATERIAL_FIELD){
-#ifdef HAVE_TANGRAM
-    	int nmats = source_state_.cell_get_num_mats(srccell);
-      	std::vector<int> cellmats;
-      	source_state_.cell_get_mats(srccell, &cellmats);
-
-      	if (!nmats || (nmats == 1 && cellmats[0] == matid_))
-      	{ // pure cell
-          source_mesh_.cell_centroid(srccell, &src_centroid);
-      	}
-     	else
-      	{ // multi-material cell
-          assert(interface_reconstructor_ != nullptr);  // cannot be nullptr
-
-          if (std::find(cellmats.begin(), cellmats.end(), matid_) !=
-              cellmats.end())
-          { // mixed cell containing this material
-
-            // Obtain matpoly's for this material
-            Tangram::CellMatPoly<D> const& cellmatpoly =
-                interface_reconstructor_->cell_matpoly_data(srccell);
-            std::vector<Tangram::MatPoly<D>> matpolys =
-                cellmatpoly.get_matpolys(matid_);
-
-            int cnt = 0;
-            for (int k = 0; k < D; k++) src_centroid[k]=0;
-
-            // Compute centroid of all matpoly's by summing all the 
-            // first order moments first, and then dividing by the 
-            // total volume of all matpolys.
-            double mvol = 0.0;  
-            for (int j = 0; j < matpolys.size(); j++)
-            {
-              std::vector<double> moments = matpolys[j].moments();
-              mvol += moments[0];
-              for (int k = 0; k < D; k++)
-                src_centroid[k] += moments[k+1];
-            }
-            for (int k = 0; k < D; k++) src_centroid[k] /=mvol;
-
-          }
-        }
-#endif
-      }
+      source_centroid(srccell, &src_centroid);
 
       // Compute intersection centroid
       Point<D> xsect_centroid;
@@ -471,17 +506,141 @@ class Interpolate_2ndOrder<D,
 
   }  // operator()
 
+  /*!
+    @brief Interpolate all components of a multi-component variable
+    @param[in]  targetCellID         Index of the target cell
+    @param[in]  sources_and_weights  Source cells and their moments over
+                                     the target cell
+    @param[out] values               num_components() interpolated values
+
+    Same as the scalar functor applied to each component, but the
+    intersection centroid and the source centroid are computed once
+    per source cell for all components.
+  */
+
+  void operator() (int const targetCellID,
+                   std::vector<Weights_t> const & sources_and_weights,
+                   double *values) const {
+    int const ncomp = ncomponents_;
+    std::fill(values, values + ncomp, 0.0);
+
+    double wtsum0 = 0.0;
+    double vol = target_mesh_.cell_volume(targetCellID);
+    int nsummed = 0;
+
+    for (auto const& wt : sources_and_weights) {
+      int srcent = wt.entityID;
+      std::vector<double> const& xsect_weights = wt.weights;
+      double xsect_volume = xsect_weights[0];
+
+      if (xsect_volume/vol <= num_tols_.min_relative_volume)
+        continue;  // no intersection
+
+      Point<D> src_centroid;
+      source_centroid(srcent, &src_centroid);
+
+      Point<D> xsect_centroid;
+      for (int i = 0; i < D; ++i)
+        xsect_centroid[i] = xsect_weights[1+i]/xsect_volume;  // (1st moment)/vol
+
+      int const srcindex = (field_type_ == Field_type::MESH_FIELD) ? srcent :
+          source_state_.cell_index_in_material(srcent, matid_);
+
+      Vector<D> dr = xsect_centroid - src_centroid;
+      dr = CoordSys::modify_line_element(dr, src_centroid);
+
+      size_t const offset = static_cast<size_t>(srcindex)*ncomp;
+      double const *srcvals = component_vals_.data() + offset;
+      Vector<D> const *srcgrads = component_gradients_.data() + offset;
+      for (int k = 0; k < ncomp; k++)
+        values[k] += (srcvals[k] + dot(srcgrads[k], dr))*xsect_volume;
+      wtsum0 += xsect_volume;
+      nsummed++;
+    }
+
+    if (nsummed)
+      for (int k = 0; k < ncomp; k++)
+        values[k] /= wtsum0;
+  }  // operator()
+
  private:
+  // Center of a source cell for the purposes of the reconstruction:
+  // the cell centroid, or for material fields in mixed cells the
+  // centroid of the material polygons
+  void source_centroid(int srccell, Point<D> *src_centroid_ptr) const {
+    Point<D>& src_centroid = *src_centroid_ptr;
+    if (field_type_ == Field_type::MESH_FIELD){
+      source_mesh_.cell_centroid(srccell, &src_centroid);
+    }
+    else if (field_type_ == Field_type::MULTIMATERIAL_FIELD){
+#ifdef HAVE_TANGRAM
+      int nmats = source_state_.cell_get_num_mats(srccell);
+      std::vector<int> cellmats;
+      source_state_.cell_get_mats(srccell, &cellmats);
+
+      if (!nmats || (nmats == 1 && cellmats[0] == matid_))
+      { // pure cell
+        source_mesh_.cell_centroid(srccell, &src_centroid);
+      }
+      else
+      { // multi-material cell
+        assert(interface_reconstructor_ != nullptr);  // cannot be nullptr
+
+        if (mesh_data_.material_moments and
+            mesh_data_.material_moments->centroid(srccell, matid_, &src_centroid))
+        { // mixed cell containing this material, centroid precomputed
+        }
+        else if (std::find(cellmats.begin(), cellmats.end(), matid_) !=
+                 cellmats.end())
+        { // mixed cell containing this material
+
+          // Obtain matpoly's for this material
+          Tangram::CellMatPoly<D> const& cellmatpoly =
+              interface_reconstructor_->cell_matpoly_data(srccell);
+          std::vector<Tangram::MatPoly<D>> matpolys =
+              cellmatpoly.get_matpolys(matid_);
+
+          for (int k = 0; k < D; k++) src_centroid[k]=0;
+
+          // Compute centroid of all matpoly's by summing all the
+          // first order moments first, and then dividing by the
+          // total volume of all matpolys.
+          double mvol = 0.0;
+          for (int j = 0; j < matpolys.size(); j++)
+          {
+            std::vector<double> moments = matpolys[j].moments();
+            mvol += moments[0];
+            for (int k = 0; k < D; k++)
+              src_centroid[k] += moments[k+1];
+          }
+          for (int k = 0; k < D; k++) src_centroid[k] /=mvol;
+
+        }
+      }
+#endif
+    }
+  }
+
   SourceMeshType const & source_mesh_;
   TargetMeshType const & target_mesh_;
   StateType const & source_state_;
   std::string interp_var_name_;
-  double const * source_vals_;
+  FieldValues source_vals_;
   NumericTolerances_t num_tols_;
 
-  // Portage::vector is generalization of std::vector and
-  // Wonton::Vector<D> is a geometric vector
-  Portage::vector<Vector<D>> gradients_;
+  // Limited gradients of the source entities, filled in on the host
+  // by Limited_Gradient::compute_gradients
+  std::vector<Vector<D>> gradients_;
+
+  // Components of a multi-component variable and their limited
+  // gradients, packed entity by entity
+  int ncomponents_ = 0;
+  std::vector<double> component_vals_;
+  std::vector<Vector<D>> component_gradients_;
+
+  // Data of the source mesh (neighbor lists, stencils, ...), possibly
+  // shared with other interpolators
+  SourceMeshData<D> mesh_data_;
 
   int matid_;
   Field_type field_type_;
@@ -534,7 +693,7 @@ class Interpolate_2ndOrder<D,
       source_state_(source_state),
       interface_reconstructor_(ir),
       interp_var_name_("VariableNameNotSet"),
-      source_vals_(nullptr),
+      source_vals_(),
       num_tols_(num_tols) {}
 #endif
 
@@ -547,7 +706,7 @@ class Interpolate_2ndOrder<D,
       target_mesh_(target_mesh),
       source_state_(source_state),
       interp_var_name_("VariableNameNotSet"),
-      source_vals_(nullptr),
+      source_vals_(),
       num_tols_(num_tols) {}
 
   /// Copy constructor (disabled)
@@ -560,8 +719,23 @@ class Interpolate_2ndOrder<D,
   ~Interpolate_2ndOrder() {}
 
 
+  /// Use source mesh data (neighbor lists, stencils, ...) built
+  /// elsewhere, e.g. by the interpolator of another variable. Whatever
+  /// is missing is built when the interpolation variable is set
+
+  void set_source_mesh_data(SourceMeshData<D> const& data) {
+    mesh_data_ = data;
+  }
+
+  /// Source mesh data given to or built by this interpolator
+
+  SourceMeshData<D> const& source_mesh_data() const {
+    return mesh_data_;
+  }
+
   /// Set the name of the interpolation variable and the limiter type
 
+  template <typename T = double>
   void set_interpolation_variable(std::string const & interp_var_name,
                                   Limiter_type limiter_type = NOLIMITER,
                                   Boundary_Limiter_type boundary_limiter_type = BND_NOLIMITER) {
@@ -571,38 +745,89 @@ class Interpolate_2ndOrder<D,
     // Extract the field data from the statemanager
     field_type_ = source_state_.field_type(Entity_kind::NODE, interp_var_name);
     if (field_type_ == Field_type::MESH_FIELD)
-      source_state_.mesh_get_data(Entity_kind::NODE, interp_var_name,
-                                  &source_vals_);
+      source_vals_ = get_mesh_field<T>(source_state_, Entity_kind::NODE,
+                                       interp_var_name);
     else {
       std::cerr << "Cannot remap NODE-centered multi-material data" << "\n";
     }
 
 
+    // Neighbor lists are the same for every variable
+    if (not mesh_data_.adjacency)
+      mesh_data_.adjacency = make_mesh_adjacency(source_mesh_, Entity_kind::NODE);
+
+    // So are the least squares coefficients (the stencil is only
+    // derived for Cartesian coordinates)
+    if (not mesh_data_.gradient_stencil and
+        std::is_same<CoordSys, Wonton::DefaultCoordSys>::value)
+      mesh_data_.gradient_stencil = make_gradient_stencil<D>(source_mesh_, Entity_kind::NODE,
+                                                             mesh_data_.adjacency);
+
+    // And the dual cell vertices used by the limiter
+    if (not mesh_data_.limiter and limiter_type == BARTH_JESPERSEN)
+      mesh_data_.limiter = make_barth_jespersen_limiter<D>(source_mesh_, Entity_kind::NODE);
+
     // Compute the limited gradients for the field
     Limited_Gradient<D, Entity_kind::NODE, SourceMeshType, StateType,
-      InterfaceReconstructorType, Matpoly_Splitter, Matpoly_Clipper, CoordSys>
-        limgrad(source_mesh_, source_state_, interp_var_name_, limiter_type, boundary_limiter_type);
+      InterfaceReconstructorType, Matpoly_Splitter, Matpoly_Clipper, CoordSys, T>
+        limgrad(source_mesh_, source_state_, interp_var_name_, limiter_type, boundary_limiter_type,
+                mesh_data_.adjacency, mesh_data_.limiter);
+    limgrad.set_gradient_stencil(mesh_data_.gradient_stencil);
 
     int nentities = source_mesh_.end(Entity_kind::NODE)-source_mesh_.begin(Entity_kind::NODE);
+    std::vector<int> nodeids(nentities);
+    std::iota(nodeids.begin(), nodeids.end(), 0);
+
+    // Compute the "limited" gradient of the field on the nodes, in
+    // blocks of nodes
     gradients_.resize(nentities);
+    limgrad.compute_gradients(nentities, nodeids.data(), gradients_.data());
+  }  // set_interpolation_variable
 
-    // call transform functor to take the values of the variable on
-    // the cells and compute a "limited" gradient of the field on the
-    // cells (for transform definition, see portage.h)
+  /*!
+    @brief Set the components of a multi-component variable
+    @param[in] component_names        Source variable holding each component
+    @param[in] limiter_type           Limiter applied to each component
+    @param[in] boundary_limiter_type  Boundary limiter applied to each component
+
+    The limited gradient of each component is computed as for a single
+    variable. Values and gradients are then packed entity by entity (see
+    field_components.h) so that the multi-component functor reads each
+    weight once for all components.
+  */
 
-    // Even though we defined Portage::transform (to be
-    // thrust::transform or boost::transform) in portage.h, the
-    // compiler is not able to disambiguate this call and is getting
-    // confused. So we will explicitly state that this is Portage::transform
+  template <typename T = double>
+  void set_interpolation_variable(std::vector<std::string> const & component_names,
+                                  Limiter_type limiter_type = NOLIMITER,
+                                  Boundary_Limiter_type boundary_limiter_type = BND_NOLIMITER) {
+    int const ncomp = component_names.size();
+    std::vector<FieldValues> components(ncomp);
+    std::vector<std::vector<Vector<D>>> component_gradients(ncomp);
+    for (int k = 0; k < ncomp; k++) {
+      set_interpolation_variable<T>(component_names[k], limiter_type,
+                                 boundary_limiter_type);
+      components[k] = source_vals_;
+      component_gradients[k].swap(gradients_);
+    }
 
-    Portage::transform(source_mesh_.begin(Entity_kind::NODE), source_mesh_.end(Entity_kind::NODE),
-                       gradients_.begin(), limgrad);
-  }
+    int const nentities = ncomp ? component_gradients[0].size() : 0;
+    std::vector<Vector<D> const *> gradient_ptrs(ncomp);
+    for (int k = 0; k < ncomp; k++)
+      gradient_ptrs[k] = component_gradients[k].data();
+
+    pack_components(nentities, components, &component_vals_);
+    pack_components(nentities, gradient_ptrs, &component_gradients_);
+    ncomponents_ = ncomp;
+  }  // set_interpolation_variable
+
+  /// Number of components set by the multi-component set_interpolation_variable
+
+  int num_components() const { return ncomponents_; }
 
 
   /// Set the material we are operating on.
 
-  int set_material(int m) {
+  void set_material(int m) {
     matid_ = m;
   }  // set_material
 
@@ -646,7 +871,7 @@ class Interpolate_2ndOrder<D,
     int nsummed = 0;
     for (int j = 0; j < nsrcnodes; ++j) {
       int srcnode = sources_and_weights[j].entityID;
-      std::vector<double> xsect_weights = sources_and_weights[j].weights;
+      std::vector<double> const& xsect_weights = sources_and_weights[j].weights;
       double xsect_volume = xsect_weights[0];
 
       if (xsect_volume/vol <= num_tols_.min_relative_volume)
@@ -690,17 +915,83 @@ class Interpolate_2ndOrder<D,
     return totalval;
   }  // operator()
 
+  /*!
+    @brief Interpolate all components of a multi-component variable
+    @param[in]  targetNodeID         Index of the target node
+    @param[in]  sources_and_weights  Source nodes and their moments over
+                                     the target dual cell
+    @param[out] values               num_components() interpolated values
+
+    Same as the scalar functor applied to each component, but the
+    intersection centroid is computed once per source node for all
+    components.
+  */
+
+  void operator() (int const targetNodeID,
+                   std::vector<Weights_t> const & sources_and_weights,
+                   double *values) const {
+    int const ncomp = ncomponents_;
+    std::fill(values, values + ncomp, 0.0);
+
+    double wtsum0 = 0.0;
+    double vol = target_mesh_.dual_cell_volume(targetNodeID);
+    int nsummed = 0;
+
+    for (auto const& wt : sources_and_weights) {
+      int srcent = wt.entityID;
+      std::vector<double> const& xsect_weights = wt.weights;
+      double xsect_volume = xsect_weights[0];
+
+      if (xsect_volume/vol <= num_tols_.min_relative_volume)
+        continue;  // no intersection
+
+      Point<D> src_centroid;
+      source_mesh_.node_get_coordinates(srcent, &src_centroid);
+
+      Point<D> xsect_centroid;
+      for (int i = 0; i < D; ++i)
+        xsect_centroid[i] = xsect_weights[1+i]/xsect_volume;  // (1st moment)/vol
+
+      int const srcindex = srcent;
+
+      Vector<D> dr = xsect_centroid - src_centroid;
+      dr = CoordSys::modify_line_element(dr, src_centroid);
+
+      size_t const offset = static_cast<size_t>(srcindex)*ncomp;
+      double const *srcvals = component_vals_.data() + offset;
+      Vector<D> const *srcgrads = component_gradients_.data() + offset;
+      for (int k = 0; k < ncomp; k++)
+        values[k] += (srcvals[k] + dot(srcgrads[k], dr))*xsect_volume;
+      wtsum0 += xsect_volume;
+      nsummed++;
+    }
+
+    if (nsummed)
+      for (int k = 0; k < ncomp; k++)
+        values[k] /= wtsum0;
+  }  // operator()
+
  private:
   SourceMeshType const & source_mesh_;
   TargetMeshType const & target_mesh_;
   StateType const & source_state_;
   std::string interp_var_name_;
-  double const * source_vals_;
+  FieldValues source_vals_;
   NumericTolerances_t num_tols_;
 
-  // Portage::vector is generalization of std::vector and
-  // Wonton::Vector<D> is a geometric vector
-  Portage::vector<Vector<D>> gradients_;
+  // Limited gradients of the source entities, filled in on the host
+  // by Limited_Gradient::compute_gradients
+  std::vector<Vector<D>> gradients_;
+
+  // Components of a multi-component variable and their limited
+  // gradients, packed entity by entity
+  int ncomponents_ = 0;
+  std::vector<double> component_vals_;
+  std::vector<Vector<D>> component_gradients_;
+
+  // Data of the source mesh (neighbor lists, stencils, ...), possibly
+  // shared with other interpolators
+  SourceMeshData<D> mesh_data_;
 
   int matid_;
   Field_type field_type_;
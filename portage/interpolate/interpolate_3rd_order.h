@@ -13,13 +13,150 @@ Please see the license file at the root of this repository, or at:
 #include <string>
 #include <iostream>
 #include <utility>
+#include <type_traits>
 #include <vector>
 
 #include "portage/support/portage.h"
 #include "portage/interpolate/quadfit.h"
+#include "portage/interpolate/quadfit_stencil.h"
+#include "portage/interpolate/field_components.h"
+#include "portage/support/mesh_adjacency.h"
+#include "portage/interpolate/source_mesh_data.h"
+#include "portage/intersect/dummy_interface_reconstructor.h"
+
+// wonton includes
+#include "wonton/support/CoordinateSystem.h"
 
 namespace Portage {
 
+/*!
+  @class QuadfitIntegrals interpolate_3rd_order.h
+  @brief Integrals of quadratic fits over a block of intersections
+
+  Each intersection of a target entity with a source entity contributes
+  the integral over the intersection of the source's quadratic fit
+
+    v + q.b(x - c)
+
+  where b is the basis of Wonton::ls_quadfit (the D linear terms d_j
+  followed by the products d_k*d_j for k <= j, d = x - c) and c the
+  center of the fit. Given the moments of the intersection this is
+
+    v*m0 + sum_j q_j (m_j - c_j m0)
+         + sum_{k<=j} q_jk (m_kj - c_k m_j - c_j m_k + c_k c_j m0)
+
+  Intersections are gathered in blocks with each of these quantities
+  in its own array, so that the sum over the block is a single loop
+  the compiler can vectorize. If the intersector did not return second
+  moments, m_kj is replaced by m_k m_j/m0, i.e. the quadratic is
+  evaluated at the centroid of the intersection.
+
+  @tparam D  spatial dimension
+*/
+
+template<int D>
+class QuadfitIntegrals {
+ public:
+  /// Number of intersections in a block
+  static constexpr int block_size = 16;
+
+  /// Whether the block is full
+  bool full() const { return n_ == block_size; }
+
+  /*!
+    @brief Add an intersection to the block
+    @param[in] value    Value of the field at the center of the fit
+    @param[in] quadfit  Coefficients of the fit
+    @param[in] center   Point about which the fit was computed
+    @param[in] moments  Moments of the intersection (volume, first moments
+    and optionally second moments as returned by the intersectors)
+  */
+  void add(double value, Vector<D*(D+3)/2> const& quadfit,
+           Point<D> const& center, std::vector<double> const& moments) {
+    int const i = n_++;
+    double const m0 = moments[0];
+    bool const exact = (moments.size() >= 1 + D + NSECOND);
+    vol_[i] = m0;
+    val_[i] = value;
+    for (int j = 0; j < D; j++) {
+      first_[j][i] = moments[1+j];
+      center_[j][i] = center[j];
+    }
+    // R2D/R3D list the second moments as x^2, xy, (xz), y^2, ...
+    for (int k = 0, kj = 0; k < D; k++)
+      for (int j = k; j < D; j++, kj++)
+        second_[kj][i] = exact ? moments[1+D+kj] : moments[1+k]*moments[1+j]/m0;
+    for (int l = 0; l < NCOEF; l++)
+      coefs_[l][i] = quadfit[l];
+  }
+
+  /// Sum of the integrals over the intersections of the block, which
+  /// is then emptied
+  double integrate() {
+    double total = 0.0;
+#ifdef _OPENMP
+#pragma omp simd reduction(+:total)
+#endif
+    for (int i = 0; i < n_; i++) {
+      double const m0 = vol_[i];
+      double integral = val_[i]*m0;
+      for (int j = 0; j < D; j++)
+        integral += coefs_[j][i]*(first_[j][i] - center_[j][i]*m0);
+      int l = D;
+      for (int j = 0; j < D; j++)
+        for (int k = 0; k <= j; k++, l++) {
+          int const kj = k*D - k*(k-1)/2 + (j-k);
+          double const prod = second_[kj][i]
+              - center_[k][i]*first_[j][i] - center_[j][i]*first_[k][i]
+              + m0*center_[k][i]*center_[j][i];
+          integral += coefs_[l][i]*prod;
+        }
+      total += integral;
+    }
+    n_ = 0;
+    return total;
+  }
+
+  /*!
+    @brief Moments of an intersection about the center of a fit
+    @param[in]  center   Point about which the fit was computed
+    @param[in]  moments  Moments of the intersection as for add
+    @param[out] g        D*(D+3)/2 factors such that the integral of the
+                         fit over the intersection is v*moments[0] + q.g
+
+    Used to integrate the fits of several fields of the same source
+    entity, whose moments need only be centered once.
+  */
+  static void centered_moments(Point<D> const& center,
+                               std::vector<double> const& moments,
+                               double *g) {
+    double const m0 = moments[0];
+    bool const exact = (moments.size() >= 1 + D + NSECOND);
+    for (int j = 0; j < D; j++)
+      g[j] = moments[1+j] - center[j]*m0;
+    int l = D;
+    for (int j = 0; j < D; j++)
+      for (int k = 0; k <= j; k++, l++) {
+        int const kj = k*D - k*(k-1)/2 + (j-k);
+        double const second = exact ? moments[1+D+kj] : moments[1+k]*moments[1+j]/m0;
+        g[l] = second - center[k]*moments[1+j] - center[j]*moments[1+k]
+            + m0*center[k]*center[j];
+      }
+  }
+
+ private:
+  static constexpr int NCOEF = D*(D+3)/2;
+  static constexpr int NSECOND = D*(D+1)/2;
+
+  int n_ = 0;
+  double vol_[block_size];
+  double val_[block_size];
+  double first_[D][block_size];
+  double center_[D][block_size];
+  double second_[NSECOND][block_size];
+  double coefs_[NCOEF][block_size];
+};
+
 /*!
   @class Interpolate_3rdOrder interpolate_3rd_order.h
   @brief Interpolate_3rdOrder does a 3rd order interpolation of scalars
@@ -28,6 +165,14 @@ namespace Portage {
   @tparam OnWhatType The type of entity-based data we wish to interpolate;
   e.g. does it live on nodes, cells, edges, etc.
 
+  The interface reconstructor, material polytope and coordinate system
+  parameters are the same as those of the other interpolators so that
+  the drivers can instantiate it; it only remaps single material fields
+  in Cartesian coordinates. The second moments needed to integrate the
+  quadratic fits exactly are only computed by the intersectors on
+  request (see CoreDriver::set_moment_order); with first moments only,
+  they are approximated from the centroids of the intersections.
+
   [1] Margolin, L.G. and Shashkov, M.J. "Second-order sign-preserving
   conservative interpolation (remapping) on general grids." Journal of
   Computational Physics, v 184, n 1, pp. 266-298, 2003.
@@ -42,7 +187,12 @@ namespace Portage {
 
 
 template<int D, Entity_kind on_what,
-         typename SourceMeshType, typename TargetMeshType, typename StateType>
+         typename SourceMeshType, typename TargetMeshType, typename StateType,
+         template<class, int, class, class> class InterfaceReconstructorType =
+         DummyInterfaceReconstructor,
+         class Matpoly_Splitter = void,
+         class Matpoly_Clipper = void,
+         class CoordSys = Wonton::DefaultCoordSys>
 class Interpolate_3rdOrder {
  public:
   /*!
@@ -76,9 +226,12 @@ class Interpolate_3rdOrder {
 
   /// Set the name of the interpolation variable and the limiter type
 
+  template <typename T = double>
   void set_interpolation_variable(std::string const & interp_var_name,
                                   Limiter_type limiter_type = NOLIMITER,
                                   Boundary_Limiter_type boundary_limiter_type = BND_NOLIMITER) {
+    static_assert(std::is_same<T, double>::value,
+                  "3rd order interpolation is only available for double fields");
     interp_var_name_ = interp_var_name;
 
     // Extract the field data from the statemanager
@@ -159,8 +312,12 @@ class Interpolate_3rdOrder {
 */
 
 template<int D,
-         typename SourceMeshType, typename TargetMeshType, typename StateType>
-class Interpolate_3rdOrder<D, Entity_kind::CELL, SourceMeshType, TargetMeshType, StateType> {
+         typename SourceMeshType, typename TargetMeshType, typename StateType,
+         template<class, int, class, class> class InterfaceReconstructorType,
+         class Matpoly_Splitter, class Matpoly_Clipper, class CoordSys>
+class Interpolate_3rdOrder<D, Entity_kind::CELL, SourceMeshType, TargetMeshType,
+                           StateType, InterfaceReconstructorType,
+                           Matpoly_Splitter, Matpoly_Clipper, CoordSys> {
  public:
   Interpolate_3rdOrder(SourceMeshType const & source_mesh,
                        TargetMeshType const & target_mesh,
@@ -174,11 +331,28 @@ class Interpolate_3rdOrder<D, Entity_kind::CELL, SourceMeshType, TargetMeshType,
       num_tols_(num_tols) {}
 
 
+  /// Use source mesh data (neighbor lists, stencils, ...) built
+  /// elsewhere, e.g. by the interpolator of another variable. Whatever
+  /// is missing is built when the interpolation variable is set
+
+  void set_source_mesh_data(SourceMeshData<D> const& data) {
+    mesh_data_ = data;
+  }
+
+  /// Source mesh data given to or built by this interpolator
+
+  SourceMeshData<D> const& source_mesh_data() const {
+    return mesh_data_;
+  }
+
   /// Set the name of the interpolation variable and the limiter type
 
+  template <typename T = double>
   void set_interpolation_variable(std::string const & interp_var_name,
                                   Limiter_type limiter_type = NOLIMITER,
                                   Boundary_Limiter_type boundary_limiter_type = BND_NOLIMITER) {
+    static_assert(std::is_same<T, double>::value,
+                  "3rd order interpolation is only available for double fields");
 
     interp_var_name_ = interp_var_name;
 
@@ -186,10 +360,21 @@ class Interpolate_3rdOrder<D, Entity_kind::CELL, SourceMeshType, TargetMeshType,
 
     source_state_.mesh_get_data(Entity_kind::CELL, interp_var_name, &source_vals_);
 
+    // Neighbor lists are the same for every variable
+    if (not mesh_data_.adjacency)
+      mesh_data_.adjacency = make_mesh_adjacency(source_mesh_, Entity_kind::CELL);
+
+    // So are the coefficients of the least squares quadratic fits
+    if (not mesh_data_.quadfit_stencil)
+      mesh_data_.quadfit_stencil = make_quadfit_stencil<D>(source_mesh_, Entity_kind::CELL,
+                                                           mesh_data_.adjacency);
+
     // Compute the limited quadfits for the field
 
     Limited_Quadfit<D, Entity_kind::CELL, SourceMeshType, StateType>
-        limqfit(source_mesh_, source_state_, interp_var_name_, limiter_type, boundary_limiter_type);
+        limqfit(source_mesh_, source_state_, interp_var_name_, limiter_type, boundary_limiter_type,
+                mesh_data_.adjacency);
+    limqfit.set_quadfit_stencil(mesh_data_.quadfit_stencil);
 
     int nentities = source_mesh_.end(Entity_kind::CELL)-source_mesh_.begin(Entity_kind::CELL);
     quadfits_.resize(nentities);
@@ -208,6 +393,65 @@ class Interpolate_3rdOrder<D, Entity_kind::CELL, SourceMeshType, TargetMeshType,
   }
 
 
+  /*!
+    @brief Set the components of a multi-component variable
+    @param[in] component_names        Source variable holding each component
+    @param[in] limiter_type           Limiter applied to each component
+    @param[in] boundary_limiter_type  Boundary limiter applied to each component
+
+    The quadratic fits of all components of a cell are computed in a
+    single pass over its stencil (QuadfitStencil::fit) and then limited
+    component by component. Values and fits are packed entity by entity
+    (see field_components.h) so that the multi-component functor reads
+    each weight once for all components.
+  */
+
+  template <typename T = double>
+  void set_interpolation_variable(std::vector<std::string> const & component_names,
+                                  Limiter_type limiter_type = NOLIMITER,
+                                  Boundary_Limiter_type boundary_limiter_type = BND_NOLIMITER) {
+    static_assert(std::is_same<T, double>::value,
+                  "3rd order interpolation is only available for double fields");
+
+    int const ncomp = component_names.size();
+
+    if (not mesh_data_.adjacency)
+      mesh_data_.adjacency = make_mesh_adjacency(source_mesh_, Entity_kind::CELL);
+    if (not mesh_data_.quadfit_stencil)
+      mesh_data_.quadfit_stencil = make_quadfit_stencil<D>(source_mesh_, Entity_kind::CELL,
+                                                           mesh_data_.adjacency);
+
+    std::vector<double const *> components(ncomp);
+    std::vector<Limited_Quadfit<D, Entity_kind::CELL, SourceMeshType, StateType>> limqfits;
+    limqfits.reserve(ncomp);
+    for (int k = 0; k < ncomp; k++) {
+      source_state_.mesh_get_data(Entity_kind::CELL, component_names[k], &components[k]);
+      limqfits.emplace_back(source_mesh_, source_state_, component_names[k],
+                            limiter_type, boundary_limiter_type, mesh_data_.adjacency);
+      limqfits.back().set_quadfit_stencil(mesh_data_.quadfit_stencil);
+    }
+
+    int const nentities = source_mesh_.end(Entity_kind::CELL)-source_mesh_.begin(Entity_kind::CELL);
+    component_quadfits_.resize(static_cast<size_t>(nentities)*ncomp);
+
+    QuadfitStencil<D> const& stencil = *mesh_data_.quadfit_stencil;
+    Vector<D*(D+3)/2> *quadfits = component_quadfits_.data();
+    Portage::for_each(make_counting_iterator(0), make_counting_iterator(nentities),
+                      [&](int e) {
+                        Vector<D*(D+3)/2> *qfits = quadfits + static_cast<size_t>(e)*ncomp;
+                        stencil.fit(e, ncomp, components.data(), qfits);
+                        for (int k = 0; k < ncomp; k++)
+                          qfits[k] = limqfits[k].limit(e, qfits[k]);
+                      });
+
+    pack_components(nentities, components, &component_vals_);
+    ncomponents_ = ncomp;
+  }
+
+  /// Number of components set by the multi-component set_interpolation_variable
+
+  int num_components() const { return ncomponents_; }
+
   /// Copy constructor (disabled)
   //  Interpolate_3rdOrder(const Interpolate_3rdOrder &) = delete;
 
@@ -238,6 +482,51 @@ class Interpolate_3rdOrder<D, Entity_kind::CELL, SourceMeshType, TargetMeshType,
   double operator() (int const targetCellID,
                      std::vector<Weights_t> const & sources_and_weights) const;
 
+  /*!
+    @brief Interpolate all components of a multi-component variable
+    @param[in]  target_id            Index of the target cell
+    @param[in]  sources_and_weights  Source entities and their moments over
+                                     the target entity
+    @param[out] values               num_components() interpolated values
+
+    Same as the scalar functor applied to each component, but the
+    moments of each intersection are centered once for all components.
+  */
+
+  void operator() (int const target_id,
+                   std::vector<Weights_t> const & sources_and_weights,
+                   double *values) const {
+    int const ncomp = ncomponents_;
+    std::fill(values, values + ncomp, 0.0);
+
+    double vol = target_mesh_.cell_volume(target_id);
+    for (auto const& wt : sources_and_weights) {
+      int srcent = wt.entityID;
+      std::vector<double> const& xsect_weights = wt.weights;
+      double xsect_volume = xsect_weights[0];
+
+      if (xsect_volume/vol <= num_tols_.min_relative_volume)
+        continue;  // no intersection
+
+      double g[D*(D+3)/2];
+      QuadfitIntegrals<D>::centered_moments(mesh_data_.quadfit_stencil->center(srcent),
+                                            xsect_weights, g);
+
+      size_t const offset = static_cast<size_t>(srcent)*ncomp;
+      double const *srcvals = component_vals_.data() + offset;
+      Vector<D*(D+3)/2> const *srcfits = component_quadfits_.data() + offset;
+      for (int k = 0; k < ncomp; k++) {
+        double integral = srcvals[k]*xsect_volume;
+        for (int l = 0; l < D*(D+3)/2; l++)
+          integral += srcfits[k][l]*g[l];
+        values[k] += integral;
+      }
+    }
+
+    for (int k = 0; k < ncomp; k++)
+      values[k] /= vol;
+  }  // operator()
+
  private:
   SourceMeshType const & source_mesh_;
   TargetMeshType const & target_mesh_;
@@ -249,6 +538,16 @@ class Interpolate_3rdOrder<D, Entity_kind::CELL, SourceMeshType, TargetMeshType,
   // Portage::vector is generalization of std::vector and
   // Wonton::Vector<D> is a geometric vector
   Portage::vector<Vector<D*(D+3)/2>> quadfits_;
+
+  // Data of the source mesh (neighbor lists, stencils, ...), possibly
+  // shared with other interpolators
+  SourceMeshData<D> mesh_data_;
+
+  // Components of a multi-component variable and their limited
+  // quadratic fits, packed entity by entity
+  int ncomponents_ = 0;
+  std::vector<double> component_vals_;
+  std::vector<Vector<D*(D+3)/2>> component_quadfits_;
 };
 
 /*! Implementation of the () operator for 3rd order interpolation on cells
@@ -259,9 +558,13 @@ class Interpolate_3rdOrder<D, Entity_kind::CELL, SourceMeshType, TargetMeshType,
  */
 
 template<int D,
-         typename SourceMeshType, typename TargetMeshType, typename StateType>
+         typename SourceMeshType, typename TargetMeshType, typename StateType,
+         template<class, int, class, class> class InterfaceReconstructorType,
+         class Matpoly_Splitter, class Matpoly_Clipper, class CoordSys>
 double Interpolate_3rdOrder<D, Entity_kind::CELL, SourceMeshType, TargetMeshType,
-                            StateType>::operator()
+                            StateType, InterfaceReconstructorType,
+                            Matpoly_Splitter, Matpoly_Clipper,
+                            CoordSys>::operator()
     (int const targetCellID, std::vector<Weights_t> const & sources_and_weights)
     const {
 
@@ -281,45 +584,30 @@ double Interpolate_3rdOrder<D, Entity_kind::CELL, SourceMeshType, TargetMeshType
 
   /// @todo Should use zip_iterator here but I am not sure I know how to
 
+  // The source centroids are those stored with the quadfit stencil;
+  // the integrals are evaluated a block of intersections at a time
+  QuadfitIntegrals<D> integrals;
+
   double vol = target_mesh_.cell_volume(targetCellID);
   for (int j = 0; j < nsrccells; ++j) {
     int srccell = sources_and_weights[j].entityID;
-    // int N = D*(D+3)/2;
-    std::vector<double> xsect_weights = sources_and_weights[j].weights;
+    std::vector<double> const& xsect_weights = sources_and_weights[j].weights;
     double xsect_volume = xsect_weights[0];
 
     if (xsect_volume/vol <= num_tols_.min_relative_volume)
       continue;  // no intersection
 
-    Point<D> srccell_centroid;
-    source_mesh_.cell_centroid(srccell, &srccell_centroid);
-
-    Point<D> xsect_centroid;
-    for (int i = 0; i < D; ++i)
-      xsect_centroid[i] = xsect_weights[1+i]/xsect_volume;  // (1st moment)/vol
-
-    Vector<D*(D+3)/2> quadfit = quadfits_[srccell];
-    Vector<D> vec = xsect_centroid - srccell_centroid;
-    Vector<D*(D+3)/2> dvec;
-    for (int j = 0; j < D; ++j) {
-      int j1 = D;
-      dvec[j] = vec[j];
-      // Add the quadratic terms
-      for (int k = 0; k <= j; ++k) {
-        dvec[j1] = dvec[k]*dvec[j];
-        j1 += 1;
-        //dvec[D+j+k] = dvec[k]*dvec[j];
-      }
-    }
-    double val = source_vals_[srccell] + dot(quadfit,dvec);
-    val *= xsect_volume;
-    totalval += val;
+    integrals.add(source_vals_[srccell], quadfits_[srccell],
+                  mesh_data_.quadfit_stencil->center(srccell), xsect_weights);
+    if (integrals.full())
+      totalval += integrals.integrate();
   }
+  totalval += integrals.integrate();
 
   // Normalize the value by sum of all the 0th weights (which is the
   // same as the total volume of the source cell)
 
-  totalval /= target_mesh_.cell_volume(targetCellID);
+  totalval /= vol;
 
   return totalval;
 }
@@ -336,8 +624,12 @@ double Interpolate_3rdOrder<D, Entity_kind::CELL, SourceMeshType, TargetMeshType
 */
 
 template<int D,
-         typename SourceMeshType, typename TargetMeshType, typename StateType>
-class Interpolate_3rdOrder<D, Entity_kind::NODE, SourceMeshType, TargetMeshType, StateType> {
+         typename SourceMeshType, typename TargetMeshType, typename StateType,
+         template<class, int, class, class> class InterfaceReconstructorType,
+         class Matpoly_Splitter, class Matpoly_Clipper, class CoordSys>
+class Interpolate_3rdOrder<D, Entity_kind::NODE, SourceMeshType, TargetMeshType,
+                           StateType, InterfaceReconstructorType,
+                           Matpoly_Splitter, Matpoly_Clipper, CoordSys> {
  public:
   Interpolate_3rdOrder(SourceMeshType const & source_mesh,
                        TargetMeshType const & target_mesh,
@@ -360,11 +652,28 @@ class Interpolate_3rdOrder<D, Entity_kind::NODE, SourceMeshType, TargetMeshType,
   ~Interpolate_3rdOrder() {}
 
 
+  /// Use source mesh data (neighbor lists, stencils, ...) built
+  /// elsewhere, e.g. by the interpolator of another variable. Whatever
+  /// is missing is built when the interpolation variable is set
+
+  void set_source_mesh_data(SourceMeshData<D> const& data) {
+    mesh_data_ = data;
+  }
+
+  /// Source mesh data given to or built by this interpolator
+
+  SourceMeshData<D> const& source_mesh_data() const {
+    return mesh_data_;
+  }
+
   /// Set the name of the interpolation variable and the limiter type
 
+  template <typename T = double>
   void set_interpolation_variable(std::string const & interp_var_name,
                                   Limiter_type limiter_type = NOLIMITER,
                                   Boundary_Limiter_type boundary_limiter_type = BND_NOLIMITER) {
+    static_assert(std::is_same<T, double>::value,
+                  "3rd order interpolation is only available for double fields");
 
     interp_var_name_ = interp_var_name;
 
@@ -372,10 +681,21 @@ class Interpolate_3rdOrder<D, Entity_kind::NODE, SourceMeshType, TargetMeshType,
 
     source_state_.mesh_get_data(Entity_kind::NODE, interp_var_name, &source_vals_);
 
+    // Neighbor lists are the same for every variable
+    if (not mesh_data_.adjacency)
+      mesh_data_.adjacency = make_mesh_adjacency(source_mesh_, Entity_kind::NODE);
+
+    // So are the coefficients of the least squares quadratic fits
+    if (not mesh_data_.quadfit_stencil)
+      mesh_data_.quadfit_stencil = make_quadfit_stencil<D>(source_mesh_, Entity_kind::NODE,
+                                                           mesh_data_.adjacency);
+
     // Compute the limited quadfits for the field
 
     Limited_Quadfit<D, Entity_kind::NODE, SourceMeshType, StateType>
-        limqfit(source_mesh_, source_state_, interp_var_name, limiter_type, boundary_limiter_type);
+        limqfit(source_mesh_, source_state_, interp_var_name, limiter_type, boundary_limiter_type,
+                mesh_data_.adjacency);
+    limqfit.set_quadfit_stencil(mesh_data_.quadfit_stencil);
 
     int nentities = source_mesh_.end(Entity_kind::NODE)-source_mesh_.begin(Entity_kind::NODE);
     quadfits_.resize(nentities);
@@ -394,6 +714,65 @@ class Interpolate_3rdOrder<D, Entity_kind::NODE, SourceMeshType, TargetMeshType,
   }
 
 
+  /*!
+    @brief Set the components of a multi-component variable
+    @param[in] component_names        Source variable holding each component
+    @param[in] limiter_type           Limiter applied to each component
+    @param[in] boundary_limiter_type  Boundary limiter applied to each component
+
+    The quadratic fits of all components of a node are computed in a
+    single pass over its stencil (QuadfitStencil::fit) and then limited
+    component by component. Values and fits are packed entity by entity
+    (see field_components.h) so that the multi-component functor reads
+    each weight once for all components.
+  */
+
+  template <typename T = double>
+  void set_interpolation_variable(std::vector<std::string> const & component_names,
+                                  Limiter_type limiter_type = NOLIMITER,
+                                  Boundary_Limiter_type boundary_limiter_type = BND_NOLIMITER) {
+    static_assert(std::is_same<T, double>::value,
+                  "3rd order interpolation is only available for double fields");
+
+    int const ncomp = component_names.size();
+
+    if (not mesh_data_.adjacency)
+      mesh_data_.adjacency = make_mesh_adjacency(source_mesh_, Entity_kind::NODE);
+    if (not mesh_data_.quadfit_stencil)
+      mesh_data_.quadfit_stencil = make_quadfit_stencil<D>(source_mesh_, Entity_kind::NODE,
+                                                           mesh_data_.adjacency);
+
+    std::vector<double const *> components(ncomp);
+    std::vector<Limited_Quadfit<D, Entity_kind::NODE, SourceMeshType, StateType>> limqfits;
+    limqfits.reserve(ncomp);
+    for (int k = 0; k < ncomp; k++) {
+      source_state_.mesh_get_data(Entity_kind::NODE, component_names[k], &components[k]);
+      limqfits.emplace_back(source_mesh_, source_state_, component_names[k],
+                            limiter_type, boundary_limiter_type, mesh_data_.adjacency);
+      limqfits.back().set_quadfit_stencil(mesh_data_.quadfit_stencil);
+    }
+
+    int const nentities = source_mesh_.end(Entity_kind::NODE)-source_mesh_.begin(Entity_kind::NODE);
+    component_quadfits_.resize(static_cast<size_t>(nentities)*ncomp);
+
+    QuadfitStencil<D> const& stencil = *mesh_data_.quadfit_stencil;
+    Vector<D*(D+3)/2> *quadfits = component_quadfits_.data();
+    Portage::for_each(make_counting_iterator(0), make_counting_iterator(nentities),
+                      [&](int e) {
+                        Vector<D*(D+3)/2> *qfits = quadfits + static_cast<size_t>(e)*ncomp;
+                        stencil.fit(e, ncomp, components.data(), qfits);
+                        for (int k = 0; k < ncomp; k++)
+                          qfits[k] = limqfits[k].limit(e, qfits[k]);
+                      });
+
+    pack_components(nentities, components, &component_vals_);
+    ncomponents_ = ncomp;
+  }
+
+  /// Number of components set by the multi-component set_interpolation_variable
+
+  int num_components() const { return ncomponents_; }
+
   /*!
     @brief Functor to do the 3rd order interpolation of node values
     @param[in] sources_and_weights      A pair of two vectors
@@ -419,6 +798,51 @@ class Interpolate_3rdOrder<D, Entity_kind::NODE, SourceMeshType, TargetMeshType,
   double operator() (const int targetCellID,
                      std::vector<Weights_t> const & sources_and_weights) const;
 
+  /*!
+    @brief Interpolate all components of a multi-component variable
+    @param[in]  target_id            Index of the target node
+    @param[in]  sources_and_weights  Source entities and their moments over
+                                     the target entity
+    @param[out] values               num_components() interpolated values
+
+    Same as the scalar functor applied to each component, but the
+    moments of each intersection are centered once for all components.
+  */
+
+  void operator() (int const target_id,
+                   std::vector<Weights_t> const & sources_and_weights,
+                   double *values) const {
+    int const ncomp = ncomponents_;
+    std::fill(values, values + ncomp, 0.0);
+
+    double vol = target_mesh_.dual_cell_volume(target_id);
+    for (auto const& wt : sources_and_weights) {
+      int srcent = wt.entityID;
+      std::vector<double> const& xsect_weights = wt.weights;
+      double xsect_volume = xsect_weights[0];
+
+      if (xsect_volume/vol <= num_tols_.min_relative_volume)
+        continue;  // no intersection
+
+      double g[D*(D+3)/2];
+      QuadfitIntegrals<D>::centered_moments(mesh_data_.quadfit_stencil->center(srcent),
+                                            xsect_weights, g);
+
+      size_t const offset = static_cast<size_t>(srcent)*ncomp;
+      double const *srcvals = component_vals_.data() + offset;
+      Vector<D*(D+3)/2> const *srcfits = component_quadfits_.data() + offset;
+      for (int k = 0; k < ncomp; k++) {
+        double integral = srcvals[k]*xsect_volume;
+        for (int l = 0; l < D*(D+3)/2; l++)
+          integral += srcfits[k][l]*g[l];
+        values[k] += integral;
+      }
+    }
+
+    for (int k = 0; k < ncomp; k++)
+      values[k] /= vol;
+  }  // operator()
+
  private:
   SourceMeshType const & source_mesh_;
   TargetMeshType const & target_mesh_;
@@ -430,6 +854,16 @@ class Interpolate_3rdOrder<D, Entity_kind::NODE, SourceMeshType, TargetMeshType,
   // Portage::vector is generalization of std::vector and
   // Wonton::Vector<D> is a geometric vector
   Portage::vector<Vector<D*(D+3)/2>> quadfits_;
+
+  // Data of the source mesh (neighbor lists, stencils, ...), possibly
+  // shared with other interpolators
+  SourceMeshData<D> mesh_data_;
+
+  // Components of a multi-component variable and their limited
+  // quadratic fits, packed entity by entity
+  int ncomponents_ = 0;
+  std::vector<double> component_vals_;
+  std::vector<Vector<D*(D+3)/2>> component_quadfits_;
 };
 
 /*! implementation of the () operator for 3rd order interpolate on nodes
@@ -440,9 +874,13 @@ class Interpolate_3rdOrder<D, Entity_kind::NODE, SourceMeshType, TargetMeshType,
  */
 
 template<int D,
-         typename SourceMeshType, typename TargetMeshType, typename StateType>
+         typename SourceMeshType, typename TargetMeshType, typename StateType,
+         template<class, int, class, class> class InterfaceReconstructorType,
+         class Matpoly_Splitter, class Matpoly_Clipper, class CoordSys>
 double Interpolate_3rdOrder<D, Entity_kind::NODE, SourceMeshType, TargetMeshType,
-                            StateType> :: operator()
+                            StateType, InterfaceReconstructorType,
+                            Matpoly_Splitter, Matpoly_Clipper,
+                            CoordSys> :: operator()
     (int const targetNodeID, std::vector<Weights_t> const & sources_and_weights)
     const {
 
@@ -462,46 +900,29 @@ double Interpolate_3rdOrder<D, Entity_kind::NODE, SourceMeshType, TargetMeshType
 
   /// @todo Should use zip_iterator here but I am not sure I know how to
 
+  QuadfitIntegrals<D> integrals;
+
   double vol = target_mesh_.dual_cell_volume(targetNodeID);
   for (int j = 0; j < nsrcnodes; ++j) {
     int srcnode = sources_and_weights[j].entityID;
-    std::vector<double> xsect_weights = sources_and_weights[j].weights;
+    std::vector<double> const& xsect_weights = sources_and_weights[j].weights;
     double xsect_volume = xsect_weights[0];
 
     if (xsect_volume/vol <= num_tols_.min_relative_volume)
       continue;  // no intersection
 
-    // note: here we are getting the node coord, not the centroid of
-    // the dual cell
-    Point<D> srcnode_coord;
-    source_mesh_.node_get_coordinates(srcnode, &srcnode_coord);
-
-    Point<D> xsect_centroid;
-    for (int i = 0; i < D; ++i)
-      // (1st moment)/(vol)
-      xsect_centroid[i] = xsect_weights[1+i]/xsect_volume;
-
-    Vector<D*(D+3)/2> quadfit = quadfits_[srcnode];
-    Vector<D> vec = xsect_centroid - srcnode_coord;
-    Vector<D*(D+3)/2> dvec;
-    for (int j = 0; j < D; ++j) {
-      int j1 = D;
-      dvec[j] = vec[j];
-      // Add the quadratic terms
-      for (int k = 0; k <= j; ++k) {
-        dvec[j1] = dvec[k]*dvec[j];
-        j1 += 1;
-        // dvec[D+j+k] = dvec[k]*dvec[j];
-      }
-    }
-    double val = source_vals_[srcnode] + dot(quadfit,dvec);
-    val *= xsect_volume;
-    totalval += val;
+    // note: the fit is about the node coord (stored with the quadfit
+    // stencil), not the centroid of the dual cell
+    integrals.add(source_vals_[srcnode], quadfits_[srcnode],
+                  mesh_data_.quadfit_stencil->center(srcnode), xsect_weights);
+    if (integrals.full())
+      totalval += integrals.integrate();
   }
+  totalval += integrals.integrate();
 
   // Normalize the value by volume of the target dual cell
 
-  totalval /= target_mesh_.dual_cell_volume(targetNodeID);
+  totalval /= vol;
 
   return totalval;
 }
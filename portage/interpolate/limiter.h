@@ -0,0 +1,189 @@
+/*
+This file is part of the Ristra portage project.
+Please see the license file at the root of this repository, or at:
+    https://github.com/laristra/portage/blob/master/LICENSE
+*/
+
+#ifndef PORTAGE_INTERPOLATE_LIMITER_H_
+#define PORTAGE_INTERPOLATE_LIMITER_H_
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+// portage includes
+#include "portage/support/portage.h"
+
+// wonton includes
+#include "wonton/support/Point.h"
+#include "wonton/support/Vector.h"
+
+namespace Portage {
+
+using Wonton::Point;
+using Wonton::Vector;
+
+/*!
+  @class BarthJespersenLimiter limiter.h
+  @brief Barth-Jespersen limiting of linear reconstructions in blocks
+
+  The limiter scales the gradient of an entity so that the linear
+  reconstruction stays within the min and max of the neighboring values
+  at the vertices of the entity (cell nodes, or dual cell corners for
+  nodes). Rather than asking the mesh for the vertices and boundary
+  status of every entity each time a field is limited, they are gathered
+  once per mesh into flat per-dimension arrays. The limiter then works
+  on blocks of entities whose centers, values and neighbor min/max are
+  also laid out as flat arrays, and the loop over the vertices of an
+  entity is a branch-free min reduction that the compiler can vectorize.
+
+  The same kernel serves mesh and material fields; only the center of
+  the reconstruction (centroid or material centroid) and the values
+  differ.
+
+  @tparam D  spatial dimension
+*/
+
+template <int D>
+class BarthJespersenLimiter {
+ public:
+
+  /// Default constructor (no entities)
+  BarthJespersenLimiter() : offsets_(1, 0) {}
+
+  /*!
+    @brief Gather the vertices and boundary status of entities 0 to nentities-1
+    @param[in] nentities     Number of entities
+    @param[in] get_vertices  Functor (int, std::vector<Point<D>>*) returning
+                             the vertices of an entity
+    @param[in] on_boundary   Functor (int) returning whether an entity is
+                             on the exterior boundary
+  */
+  template <class GetVertices, class OnBoundary>
+  BarthJespersenLimiter(int nentities, GetVertices get_vertices,
+                        OnBoundary on_boundary) {
+    std::vector<std::vector<Point<D>>> vertices(nentities);
+    boundary_.resize(nentities);
+    Portage::for_each(make_counting_iterator(0),
+                      make_counting_iterator(nentities),
+                      [&](int e) {
+                        get_vertices(e, &(vertices[e]));
+                        boundary_[e] = on_boundary(e);
+                      });
+
+    offsets_.assign(nentities + 1, 0);
+    for (int e = 0; e < nentities; e++)
+      offsets_[e+1] = offsets_[e] + vertices[e].size();
+
+    for (int d = 0; d < D; d++)
+      coords_[d].resize(offsets_[nentities]);
+    Portage::for_each(make_counting_iterator(0),
+                      make_counting_iterator(nentities),
+                      [&](int e) {
+                        int k = offsets_[e];
+                        for (auto const& p : vertices[e]) {
+                          for (int d = 0; d < D; d++)
+                            coords_[d][k] = p[d];
+                          k++;
+                        }
+                      });
+  }
+
+  /// Number of entities
+  int num_entities() const { return boundary_.size(); }
+
+  /// Whether an entity is on the exterior boundary
+  bool on_boundary(int e) const { return boundary_[e]; }
+
+  /*!
+    @brief Limit the gradients of a block of entities in place
+    @param[in]     n         Number of entities in the block
+    @param[in]     entities  Mesh index of each entity
+    @param[in]     centers   Point about which each reconstruction is linear
+    @param[in]     vals      Value of the field at each center
+    @param[in]     minvals   Min of the value and its neighbors' values
+    @param[in]     maxvals   Max of the value and its neighbors' values
+    @param[in]     active    Whether each entity is to be limited at all
+    @param[in,out] grads     Gradient of each entity
+  */
+  void limit(int n, int const *entities, Point<D> const *centers,
+             double const *vals, double const *minvals, double const *maxvals,
+             char const *active, Vector<D> *grads) const {
+    double const *x[D];
+    for (int i = 0; i < n; i++) {
+      if (!active[i]) continue;
+      int const e = entities[i];
+      int const k0 = offsets_[e];
+      for (int d = 0; d < D; d++)
+        x[d] = coords_[d].data() + k0;
+      double const phi = limiter_value(offsets_[e+1] - k0, x, grads[i], centers[i],
+                                       minvals[i] - vals[i], maxvals[i] - vals[i]);
+      grads[i] = phi*grads[i];
+    }
+  }
+
+  /*!
+    @brief Barth-Jespersen factor of one reconstruction
+    @param[in] nverts  Number of vertices
+    @param[in] x       Coordinates of the vertices, x[d][k] is the d'th
+                       coordinate of vertex k
+    @param[in] grad    Gradient of the reconstruction
+    @param[in] center  Point about which the reconstruction is linear
+    @param[in] dumin   Min of the neighbor values minus the center value
+    @param[in] dumax   Max of the neighbor values minus the center value
+    @returns   Factor in [0,1] to scale the gradient by
+  */
+  static double limiter_value(int nverts, double const * const *x,
+                              Vector<D> const& grad, Point<D> const& center,
+                              double dumin, double dumax) {
+    double phi = 1.0;
+#ifdef _OPENMP
+#pragma omp simd reduction(min:phi)
+#endif
+    for (int k = 0; k < nverts; k++) {
+      double diff = 0.0;
+      for (int d = 0; d < D; d++)
+        diff += grad[d]*(x[d][k] - center[d]);
+      double const du = (diff > 0.0) ? dumax : dumin;
+      double const phi_k = (diff == 0.0) ? 1.0 : du/diff;
+      phi = std::min(phi, phi_k);
+    }
+    return phi;
+  }
+
+ private:
+  std::vector<int> offsets_;
+  std::vector<double> coords_[D];
+  std::vector<char> boundary_;
+};
+
+
+/*!
+  @brief Build the limiter data used by Limited_Gradient
+  @param[in] mesh  Mesh wrapper
+  @param[in] kind  CELL (vertices are the cell nodes) or NODE (vertices
+                   are the corners of the dual cell)
+*/
+template <int D, class MeshType>
+std::shared_ptr<BarthJespersenLimiter<D> const>
+make_barth_jespersen_limiter(MeshType const& mesh, Entity_kind kind) {
+  int const nentities = mesh.num_entities(kind, Entity_type::ALL);
+  if (kind == Entity_kind::CELL)
+    return std::make_shared<BarthJespersenLimiter<D> const>(
+        nentities,
+        [&mesh](int c, std::vector<Point<D>> *pts) {
+          mesh.cell_get_coordinates(c, pts);
+        },
+        [&mesh](int c) { return mesh.on_exterior_boundary(Entity_kind::CELL, c); });
+  else
+    return std::make_shared<BarthJespersenLimiter<D> const>(
+        nentities,
+        [&mesh](int n, std::vector<Point<D>> *pts) {
+          mesh.dual_cell_get_coordinates(n, pts);
+        },
+        [&mesh](int n) { return mesh.on_exterior_boundary(Entity_kind::NODE, n); });
+}
+
+}  // namespace Portage
+
+#endif  // PORTAGE_INTERPOLATE_LIMITER_H_
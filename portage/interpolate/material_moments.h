@@ -0,0 +1,184 @@
+/*
+This file is part of the Ristra portage project.
+Please see the license file at the root of this repository, or at:
+    https://github.com/laristra/portage/blob/master/LICENSE
+*/
+
+#ifndef PORTAGE_INTERPOLATE_MATERIAL_MOMENTS_H_
+#define PORTAGE_INTERPOLATE_MATERIAL_MOMENTS_H_
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+// portage includes
+#include "portage/support/portage.h"
+
+// wonton includes
+#include "wonton/support/Point.h"
+
+#ifdef HAVE_TANGRAM
+#include "tangram/driver/CellMatPoly.h"
+#include "tangram/support/MatPoly.h"
+#endif
+
+namespace Portage {
+
+using Wonton::Point;
+
+/*!
+  @class MaterialMoments material_moments.h
+  @brief Volume and centroid of each material in each cell
+
+  Second order material remap needs the centroid of a material in a
+  mixed cell both for the least squares gradient (of every neighbor of
+  every cell of the material) and for the reconstruction about the
+  source cell. Getting it from the interface reconstructor means
+  copying the material polygons of the cell and summing their moments,
+  for every such use and for every material variable. Instead the
+  moments are gathered once, after interface reconstruction, into a
+  compact cell-material table (the materials of cell c are entries
+  offsets[c] to offsets[c+1]-1) which is then shared read-only.
+
+  @tparam D  spatial dimension
+*/
+
+template <int D>
+class MaterialMoments {
+ public:
+
+  /// Default constructor (no cells)
+  MaterialMoments() : offsets_(1, 0) {}
+
+  /*!
+    @brief Gather the material moments of cells 0 to ncells-1
+    @param[in] ncells         Number of cells
+    @param[in] get_materials  Functor (int, std::vector<int>*) returning the
+                              materials in a cell
+    @param[in] get_moments    Functor (int, std::vector<int> const&, double*,
+                              Point<D>*) returning the volume and centroid of
+                              each of these materials in a cell
+  */
+  template <class GetMaterials, class GetMoments>
+  MaterialMoments(int ncells, GetMaterials get_materials,
+                  GetMoments get_moments) {
+    std::vector<std::vector<int>> cellmats(ncells);
+    Portage::for_each(make_counting_iterator(0),
+                      make_counting_iterator(ncells),
+                      [&](int c) { get_materials(c, &(cellmats[c])); });
+
+    offsets_.assign(ncells + 1, 0);
+    for (int c = 0; c < ncells; c++)
+      offsets_[c+1] = offsets_[c] + cellmats[c].size();
+
+    int const nentries = offsets_[ncells];
+    matids_.resize(nentries);
+    volumes_.resize(nentries);
+    centroids_.resize(nentries);
+    Portage::for_each(make_counting_iterator(0),
+                      make_counting_iterator(ncells),
+                      [&](int c) {
+                        int const k0 = offsets_[c];
+                        std::copy(cellmats[c].begin(), cellmats[c].end(),
+                                  matids_.begin() + k0);
+                        if (!cellmats[c].empty())
+                          get_moments(c, cellmats[c], &(volumes_[k0]),
+                                      &(centroids_[k0]));
+                      });
+  }
+
+  /// Number of cells
+  int num_cells() const { return offsets_.size() - 1; }
+
+  /// Index of the entry for material m in cell c (-1 if m is not in c)
+  int find(int c, int m) const {
+    for (int k = offsets_[c]; k < offsets_[c+1]; k++)
+      if (matids_[k] == m) return k;
+    return -1;
+  }
+
+  /// Volume of material m in cell c (0 if m is not in c)
+  double volume(int c, int m) const {
+    int const k = find(c, m);
+    return (k < 0) ? 0.0 : volumes_[k];
+  }
+
+  /*!
+    @brief Centroid of material m in cell c
+    @returns false (leaving centroid untouched) if m is not in c
+  */
+  bool centroid(int c, int m, Point<D> *centroid) const {
+    int const k = find(c, m);
+    if (k < 0) return false;
+    *centroid = centroids_[k];
+    return true;
+  }
+
+ private:
+  std::vector<int> offsets_;
+  std::vector<int> matids_;
+  std::vector<double> volumes_;
+  std::vector<Point<D>> centroids_;
+};
+
+
+#ifdef HAVE_TANGRAM
+
+/*!
+  @brief Build the material moments of the source mesh after interface
+  reconstruction
+  @param[in] mesh   Mesh wrapper
+  @param[in] state  State wrapper (knows which materials are in each cell)
+  @param[in] ir     Interface reconstructor that has done its reconstruction
+
+  Pure cells take the volume and centroid of the cell; in mixed cells
+  the moments of all material polygons of a material are summed.
+*/
+template <int D, class MeshType, class StateType, class InterfaceReconstructor>
+std::shared_ptr<MaterialMoments<D> const>
+make_material_moments(MeshType const& mesh, StateType const& state,
+                      InterfaceReconstructor const& ir) {
+  int const ncells = mesh.num_entities(Entity_kind::CELL, Entity_type::ALL);
+  return std::make_shared<MaterialMoments<D> const>(
+      ncells,
+      [&state](int c, std::vector<int> *mats) { state.cell_get_mats(c, mats); },
+      [&mesh, &ir](int c, std::vector<int> const& mats,
+                   double *vols, Point<D> *cens) {
+        if (mats.size() == 1) {
+          vols[0] = mesh.cell_volume(c);
+          mesh.cell_centroid(c, &(cens[0]));
+          return;
+        }
+
+        Tangram::CellMatPoly<D> const& cellmatpoly = ir.cell_matpoly_data(c);
+        for (int i = 0; i < static_cast<int>(mats.size()); i++) {
+          std::vector<Tangram::MatPoly<D>> matpolys =
+              cellmatpoly.get_matpolys(mats[i]);
+
+          double mvol = 0.0;
+          Point<D> centroid;
+          for (auto const& matpoly : matpolys) {
+            std::vector<double> moments = matpoly.moments();
+            mvol += moments[0];
+            for (int d = 0; d < D; d++)
+              centroid[d] += moments[d+1];
+          }
+          // a material with no volume left after the reconstruction
+          // gets the cell centroid, as in pure cells
+          if (mvol > 0.0)
+            for (int d = 0; d < D; d++)
+              centroid[d] /= mvol;
+          else
+            mesh.cell_centroid(c, &centroid);
+
+          vols[i] = mvol;
+          cens[i] = centroid;
+        }
+      });
+}
+
+#endif  // HAVE_TANGRAM
+
+}  // namespace Portage
+
+#endif  // PORTAGE_INTERPOLATE_MATERIAL_MOMENTS_H_
@@ -16,6 +16,8 @@ Please see the license file at the root of this repository, or at:
 
 // portage includes
 #include "portage/support/portage.h"
+#include "portage/support/mesh_adjacency.h"
+#include "portage/interpolate/quadfit_stencil.h"
 
 // wonton includes
 #include "wonton/support/lsfits.h"
@@ -113,6 +115,7 @@ class Limited_Quadfit<D, Entity_kind::CELL, MeshType, StateType> {
       @param[in] var_name Name of field for which the quadfit is to be computed
       @param[in] limiter_type An enum indicating if the limiter type (none, Barth-Jespersen, Superbee etc)
       @param[in] Boundary_Limiter_type An enum indicating the limiter type on the boundary
+      @param[in] cell_neighbors Neighbors of each cell if already known for this mesh
 
       @todo must remove assumption that field is scalar
    */
@@ -120,23 +123,22 @@ class Limited_Quadfit<D, Entity_kind::CELL, MeshType, StateType> {
   Limited_Quadfit(MeshType const & mesh, StateType const & state,
                    std::string const var_name,
                    Limiter_type limiter_type,
-                   Boundary_Limiter_type Boundary_Limiter_type) :
+                   Boundary_Limiter_type Boundary_Limiter_type,
+                   std::shared_ptr<MeshAdjacency const> cell_neighbors = nullptr) :
       mesh_(mesh), state_(state), var_name_(var_name),
-      limtype_(limiter_type), bnd_limtype_(Boundary_Limiter_type) {
+      limtype_(limiter_type), bnd_limtype_(Boundary_Limiter_type),
+      cell_neighbors_(cell_neighbors) {
 
     // Extract the field data from the statemanager
     state.mesh_get_data(Entity_kind::CELL, var_name, &vals_);
 
     // Collect and keep the list of neighbors for each NODE as it may
     // be expensive to go to the mesh layer and collect this data for
-    // each cell during the actual quadfit calculation
-
-    int ncells = mesh_.num_entities(Entity_kind::CELL);
-    cell_neighbors_.resize(ncells);
+    // each cell during the actual quadfit calculation (unless the
+    // caller already has them for this mesh)
 
-    Portage::for_each(mesh_.begin(Entity_kind::CELL), mesh_.end(Entity_kind::CELL),
-                      [this](int c) { mesh_.cell_get_node_adj_cells(
-                             c, Entity_type::ALL, &(cell_neighbors_[c])); } );
+    if (not cell_neighbors_)
+      cell_neighbors_ = make_mesh_adjacency(mesh_, Entity_kind::CELL);
   }
 
   /// @todo Seems to be needed when using this in a Thrust transform call?
@@ -153,10 +155,22 @@ class Limited_Quadfit<D, Entity_kind::CELL, MeshType, StateType> {
 
   ~Limited_Quadfit() {}
 
+  /// Use precomputed least squares quadratic fit coefficients
+  /// instead of solving the least squares problem of each entity
+
+  void set_quadfit_stencil(std::shared_ptr<QuadfitStencil<D> const> stencil) {
+    quadfit_stencil_ = stencil;
+  }
+
   /// Functor
 
   Vector<D*(D+3)/2> operator()(int cellid);
 
+  /// Limit a quadratic fit of the field at a cell, e.g. one computed
+  /// for several fields at once with QuadfitStencil::fit
+
+  Vector<D*(D+3)/2> limit(int cellid, Vector<D*(D+3)/2> const& qfit) const;
+
  private:
   Limiter_type limtype_;
   Boundary_Limiter_type bnd_limtype_;
@@ -164,7 +178,8 @@ class Limited_Quadfit<D, Entity_kind::CELL, MeshType, StateType> {
   StateType const & state_;
   std::string var_name_;
   double const *vals_;
-  std::vector<std::vector<int>> cell_neighbors_;
+  std::shared_ptr<MeshAdjacency const> cell_neighbors_;
+  std::shared_ptr<QuadfitStencil<D> const> quadfit_stencil_;
 };
 
   /*! @brief Implementation of Limited_Quadfit functor for CELLs
@@ -172,7 +187,8 @@ class Limited_Quadfit<D, Entity_kind::CELL, MeshType, StateType> {
       multinomial using a Least-Squared fit. Returns an
       array of parameters.  If the CELL is on a boundary
       the stencil is too small, so it drops to linear order.
-      Uses an SVD decomposition for the LS regression.
+      Uses an SVD decomposition for the LS regression, or the
+      precomputed pseudo-inverse of a QuadfitStencil if one is set.
 
   */
 template<int D, typename MeshType, typename StateType>
@@ -181,9 +197,7 @@ Limited_Quadfit<D, Entity_kind::CELL, MeshType, StateType>::operator() (int cons
 
   assert(D == mesh_.space_dimension());
   assert(D == 2 || D == 3);
-  double phi = 1.0;
   Vector<D*(D+3)/2> qfit;
-  Vector<D*(D+3)/2> dvec;
 
   bool boundary_cell =  mesh_.on_exterior_boundary(Entity_kind::CELL, cellid);
   // Limit the boundary gradient to enforce monotonicity preservation
@@ -192,24 +206,45 @@ Limited_Quadfit<D, Entity_kind::CELL, MeshType, StateType>::operator() (int cons
     return qfit;
   }
 
-  std::vector<int> const & nbrids = cell_neighbors_[cellid];
+  if (quadfit_stencil_) {
+    // The fit is a mat-vec with the precomputed coefficients
+    qfit = (*quadfit_stencil_)(cellid, vals_);
+  } else {
+    MeshAdjacency::Neighbors const nbrids = (*cell_neighbors_)[cellid];
+
+    std::vector<Point<D>> cellcenters(nbrids.size()+1);
+    std::vector<double> cellvalues(nbrids.size()+1);
+
+    // get centroid for cellid at center of point cloud
+    mesh_.cell_centroid(cellid, &(cellcenters[0]));
+    cellvalues[0] = vals_[cellid];
+    int i = 1;
+    for (auto nbrcell : nbrids) {
+      mesh_.cell_centroid(nbrcell, &(cellcenters[i]));
+      cellvalues[i++] = vals_[nbrcell];
+    }
 
-  std::vector<Point<D>> cellcenters(nbrids.size()+1);
-  std::vector<double> cellvalues(nbrids.size()+1);
+    qfit = Wonton::ls_quadfit(cellcenters, cellvalues, boundary_cell);
+  }
 
-  // get centroid and value for cellid at center of point cloud
-  mesh_.cell_centroid(cellid, &(cellcenters[0]));
+  return limit(cellid, qfit);
+}
 
-  cellvalues[0] = vals_[cellid];
+template<int D, typename MeshType, typename StateType>
+  Vector<D*(D+3)/2>
+Limited_Quadfit<D, Entity_kind::CELL, MeshType, StateType>::limit(int const cellid,
+    Vector<D*(D+3)/2> const& qfit) const {
+
+  double phi = 1.0;
+  Vector<D*(D+3)/2> dvec;
 
-  int i = 1;
-  for (auto nbrcell : nbrids) {
-    mesh_.cell_centroid(nbrcell, &(cellcenters[i]));
-    cellvalues[i] = vals_[nbrcell];
-    i++;
+  bool boundary_cell =  mesh_.on_exterior_boundary(Entity_kind::CELL, cellid);
+  if (bnd_limtype_ == BND_ZERO_GRADIENT && boundary_cell) {
+    Vector<D*(D+3)/2> zero;
+    zero.zero();
+    return zero;
   }
 
-  qfit = Wonton::ls_quadfit(cellcenters, cellvalues, boundary_cell);
   // Limit the gradient to enforce monotonicity preservation
 
   if (limtype_ == BARTH_JESPERSEN && 
@@ -218,13 +253,16 @@ Limited_Quadfit<D, Entity_kind::CELL, MeshType, StateType>::operator() (int cons
     // Min and max vals of function (cell centered vals) among neighbors
     /// @todo: must remove assumption the field is scalar
 
+    MeshAdjacency::Neighbors const nbrids = (*cell_neighbors_)[cellid];
+
     double minval = vals_[cellid];
     double maxval = vals_[cellid];
 
+    // the cell itself and all its neighbors but the last
     int nnbr = nbrids.size();
-    for (int i = 0; i < nnbr; ++i) {
-      minval = std::min(cellvalues[i], minval);
-      maxval = std::max(cellvalues[i], maxval);
+    for (int i = 0; i < nnbr-1; ++i) {
+      minval = std::min(vals_[nbrids[i]], minval);
+      maxval = std::max(vals_[nbrids[i]], maxval);
     }
 
     // Find the min and max of the reconstructed function in the cell
@@ -232,14 +270,18 @@ Limited_Quadfit<D, Entity_kind::CELL, MeshType, StateType>::operator() (int cons
     // the nodes of the cell. So find the values of the reconstructed
     // function at the nodes of the cell
 
-    int dim = mesh_.space_dimension();
+    Point<D> cellcenter;
+    if (quadfit_stencil_)
+      cellcenter = quadfit_stencil_->center(cellid);
+    else
+      mesh_.cell_centroid(cellid, &cellcenter);
 
     double cellcenval = vals_[cellid];
     std::vector<Point<D>> cellcoords;
     mesh_.cell_get_coordinates(cellid, &cellcoords);
 
     for (auto coord : cellcoords) {
-      Vector<D> vec = coord-cellcenters[0];
+      Vector<D> vec = coord-cellcenter;
       //Vector<D*(D+3)/2> dvec;
       for (int j = 0; j < D; ++j) {
 	dvec[j] = vec[j];
@@ -280,6 +322,7 @@ class Limited_Quadfit<D, Entity_kind::NODE, MeshType, StateType> {
       @param[in] var_name Name of field for which the quadfit is to be computed
       @param[in] limiter_type An enum indicating if the limiter type (none, Barth-Jespersen, Superbee etc)
       @param[in] Boundary_Limiter_type An enum indicating the limiter type on the boundary
+      @param[in] node_neighbors Neighbors of each node if already known for this mesh
 
       @todo must remove assumption that field is scalar
    */
@@ -287,23 +330,22 @@ class Limited_Quadfit<D, Entity_kind::NODE, MeshType, StateType> {
   Limited_Quadfit(MeshType const & mesh, StateType const & state,
                    std::string const var_name,
                    Limiter_type limiter_type, 
-                   Boundary_Limiter_type Boundary_Limiter_type) :
+                   Boundary_Limiter_type Boundary_Limiter_type,
+                   std::shared_ptr<MeshAdjacency const> node_neighbors = nullptr) :
       mesh_(mesh), state_(state), var_name_(var_name),
-      limtype_(limiter_type), bnd_limtype_(Boundary_Limiter_type) {
+      limtype_(limiter_type), bnd_limtype_(Boundary_Limiter_type),
+      node_neighbors_(node_neighbors) {
 
     // Extract the field data from the statemanager
     state.mesh_get_data(Entity_kind::NODE, var_name, &vals_);
 
     // Collect and keep the list of neighbors for each NODE as it may
     // be expensive to go to the mesh layer and collect this data for
-    // each cell during the actual quadfit calculation
+    // each cell during the actual quadfit calculation (unless the
+    // caller already has them for this mesh)
 
-    int nnodes = mesh_.num_entities(Entity_kind::NODE);
-    node_neighbors_.resize(nnodes);
-
-    Portage::for_each(mesh_.begin(Entity_kind::NODE), mesh_.end(Entity_kind::NODE),
-                      [this](int n) { mesh_.dual_cell_get_node_adj_cells(
-                             n, Entity_type::ALL, &(node_neighbors_[n])); } );
+    if (not node_neighbors_)
+      node_neighbors_ = make_mesh_adjacency(mesh_, Entity_kind::NODE);
   }
 
   /// \todo Seems to be needed when using this in a Thrust transform call?
@@ -320,10 +362,22 @@ class Limited_Quadfit<D, Entity_kind::NODE, MeshType, StateType> {
 
   ~Limited_Quadfit() {}
 
+  /// Use precomputed least squares quadratic fit coefficients
+  /// instead of solving the least squares problem of each entity
+
+  void set_quadfit_stencil(std::shared_ptr<QuadfitStencil<D> const> stencil) {
+    quadfit_stencil_ = stencil;
+  }
+
   /// Functor
 
   Vector<D*(D+3)/2> operator()(int nodeid);
 
+  /// Limit a quadratic fit of the field at a node, e.g. one computed
+  /// for several fields at once with QuadfitStencil::fit
+
+  Vector<D*(D+3)/2> limit(int nodeid, Vector<D*(D+3)/2> const& qfit) const;
+
  private:
 
   Limiter_type limtype_;
@@ -332,7 +386,8 @@ class Limited_Quadfit<D, Entity_kind::NODE, MeshType, StateType> {
   StateType const & state_;
   std::string var_name_;
   double const *vals_;
-  std::vector<std::vector<int>> node_neighbors_;
+  std::shared_ptr<MeshAdjacency const> node_neighbors_;
+  std::shared_ptr<QuadfitStencil<D> const> quadfit_stencil_;
 };
 
   /*! @brief Implementation of Limited_Quadfit functor for NODEs
@@ -340,7 +395,8 @@ class Limited_Quadfit<D, Entity_kind::NODE, MeshType, StateType> {
    *  multinomial using a Least-Squared fit. Returns an
    *  array of parameters.  If the MODE is on a boundary,
    *  the stencil is too small, so it drops to linear order.
-   *  Uses an SVD decomposition for the LS regression.
+   *  Uses an SVD decomposition for the LS regression, or the
+   *  precomputed pseudo-inverse of a QuadfitStencil if one is set.
    */
 
 
@@ -350,9 +406,7 @@ Limited_Quadfit<D, Entity_kind::NODE, MeshType, StateType>::operator() (int cons
 
   assert(D == mesh_.space_dimension());
   assert(D == 2 || D == 3);
-  double phi = 1.0;
   Vector<D*(D+3)/2> qfit;
-  Vector<D*(D+3)/2> dvec;
 
   bool boundary_node =  mesh_.on_exterior_boundary(Entity_kind::NODE, nodeid);
   if (bnd_limtype_ == BND_ZERO_GRADIENT && boundary_node) {
@@ -360,37 +414,57 @@ Limited_Quadfit<D, Entity_kind::NODE, MeshType, StateType>::operator() (int cons
     return qfit;
   }
 
-  std::vector<int> const & nbrids = node_neighbors_[nodeid];
-  int j = 1;
+  if (quadfit_stencil_) {
+    // The fit is a mat-vec with the precomputed coefficients
+    qfit = (*quadfit_stencil_)(nodeid, vals_);
+  } else {
+    MeshAdjacency::Neighbors const nbrids = (*node_neighbors_)[nodeid];
+
+    std::vector<Point<D>> nodecoords(nbrids.size()+1);
+    std::vector<double> nodevalues(nbrids.size()+1);
+
+    mesh_.node_get_coordinates(nodeid, &(nodecoords[0]));
+    nodevalues[0] = vals_[nodeid];
+    int i = 1;
+    for (auto const & nbrnode : nbrids) {
+      mesh_.node_get_coordinates(nbrnode, &nodecoords[i]);
+      nodevalues[i++] = vals_[nbrnode];
+    }
 
-  std::vector<Point<D>> nodecoords(nbrids.size()+1);
-  std::vector<double> nodevalues(nbrids.size()+1);
+    qfit = Wonton::ls_quadfit(nodecoords, nodevalues, boundary_node);
+  }
 
-  Point<D> point;
+  return limit(nodeid, qfit);
+}
 
-  mesh_.node_get_coordinates(nodeid, &(nodecoords[0]));
-  nodevalues[0] = vals_[nodeid];
+template<int D, typename MeshType, typename StateType>
+  Vector<D*(D+3)/2>
+Limited_Quadfit<D, Entity_kind::NODE, MeshType, StateType>::limit(int const nodeid,
+    Vector<D*(D+3)/2> const& qfit) const {
 
-  int i = 1;
-  for (auto const & nbrnode : nbrids) {
-    mesh_.node_get_coordinates(nbrnode, &nodecoords[i]);
-    nodevalues[i] = vals_[nbrnode];
-    i++;
-  }
+  double phi = 1.0;
+  Vector<D*(D+3)/2> dvec;
 
-  qfit = Wonton::ls_quadfit(nodecoords, nodevalues, boundary_node);
+  bool boundary_node =  mesh_.on_exterior_boundary(Entity_kind::NODE, nodeid);
+  if (bnd_limtype_ == BND_ZERO_GRADIENT && boundary_node) {
+    Vector<D*(D+3)/2> zero;
+    zero.zero();
+    return zero;
+  }
 
   if (limtype_ == BARTH_JESPERSEN && 
       (!boundary_node || bnd_limtype_ == BND_BARTH_JESPERSEN)) {
 
     // Min and max vals of function (cell centered vals) among neighbors
 
+    MeshAdjacency::Neighbors const nbrids = (*node_neighbors_)[nodeid];
+
     double minval = vals_[nodeid];
     double maxval = vals_[nodeid];
 
-    for (auto const & val : nodevalues) {
-      minval = std::min(val, minval);
-      maxval = std::max(val, maxval);
+    for (auto const & nbrnode : nbrids) {
+      minval = std::min(vals_[nbrnode], minval);
+      maxval = std::max(vals_[nbrnode], maxval);
     }
 
     // Find the min and max of the reconstructed function in the cell
@@ -398,13 +472,19 @@ Limited_Quadfit<D, Entity_kind::NODE, MeshType, StateType>::operator() (int cons
     // the nodes of the cell. So find the values of the reconstructed
     // function at the nodes of the cell
 
+    Point<D> nodecoord;
+    if (quadfit_stencil_)
+      nodecoord = quadfit_stencil_->center(nodeid);
+    else
+      mesh_.node_get_coordinates(nodeid, &nodecoord);
+
     double nodeval = vals_[nodeid];
 
     std::vector<Point<D>> dualcellcoords;
     mesh_.dual_cell_get_coordinates(nodeid, &dualcellcoords);
 
     for (auto const & coord : dualcellcoords) {
-      Vector<D> vec = coord-nodecoords[0];
+      Vector<D> vec = coord-nodecoord;
       // Vector<D*(D+3)/2> dvec;
 	for (int j = 0; j < D; ++j) {
 	  dvec[j] = vec[j];
@@ -0,0 +1,308 @@
+/*
+This file is part of the Ristra portage project.
+Please see the license file at the root of this repository, or at:
+    https://github.com/laristra/portage/blob/master/LICENSE
+*/
+
+#ifndef PORTAGE_INTERPOLATE_QUADFIT_STENCIL_H_
+#define PORTAGE_INTERPOLATE_QUADFIT_STENCIL_H_
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+// portage includes
+#include "portage/support/portage.h"
+#include "portage/support/mesh_adjacency.h"
+
+// wonton includes
+#include "wonton/support/Point.h"
+#include "wonton/support/Vector.h"
+
+namespace Portage {
+
+using Wonton::Point;
+using Wonton::Vector;
+
+/*!
+  @class QuadfitStencil quadfit_stencil.h
+  @brief Precomputed least squares quadratic fit operator of a mesh
+
+  The quadratic fit at an entity with center x_0 and neighbor centers
+  x_k minimizes sum_k (q.b(x_k - x_0) - (v_k - v_0))^2 where b(d) is
+  the basis of Wonton::ls_quadfit: the D linear terms d_j followed by
+  the products d_k*d_j for k <= j. The solution
+
+    q = sum_k c_k (v_k - v_0),  c_k = A^+ e_k
+
+  only depends on the mesh through the pseudo-inverse A^+ of the matrix
+  whose rows are b(x_k - x_0). Rather than factorizing A for every
+  entity of every field, A^+ is computed once here and each fit is a
+  short mat-vec over the neighbors. As with ls_quadfit, entities on the
+  boundary (or with too few neighbors) get a linear fit only.
+
+  The pseudo-inverse is obtained from a one-sided Jacobi SVD of the
+  column scaled matrix itself (not of its normal matrix, which would
+  square its condition number), discarding directions whose singular
+  values are negligible, so rank deficient stencils are handled as by
+  a truncated SVD.
+
+  @tparam D  spatial dimension
+*/
+
+template <int D>
+class QuadfitStencil {
+ public:
+
+  /// Number of coefficients of a quadratic fit
+  static constexpr int NCOEF = D*(D+3)/2;
+
+  /*!
+    @brief Compute the stencil coefficients
+    @param[in] adjacency    Neighbors of each entity
+    @param[in] get_center   Functor (int, Point<D>*) returning the point
+                            at which an entity's value is located
+    @param[in] on_boundary  Functor (int) returning whether an entity is
+                            on the exterior boundary
+  */
+  template <class GetCenter, class OnBoundary>
+  QuadfitStencil(std::shared_ptr<MeshAdjacency const> adjacency,
+                 GetCenter get_center, OnBoundary on_boundary)
+      : adjacency_(adjacency) {
+
+    int const nentities = adjacency_->num_entities();
+    centers_.resize(nentities);
+    boundary_.resize(nentities);
+    Portage::for_each(make_counting_iterator(0),
+                      make_counting_iterator(nentities),
+                      [&](int e) {
+                        get_center(e, &(centers_[e]));
+                        boundary_[e] = on_boundary(e);
+                      });
+
+    coefs_.resize(adjacency_->neighbors().size());
+    Portage::for_each(make_counting_iterator(0),
+                      make_counting_iterator(nentities),
+                      [&](int e) { compute_coefs(e); });
+  }
+
+  /// Number of entities
+  int num_entities() const { return centers_.size(); }
+
+  /// Neighbors of each entity
+  MeshAdjacency const& adjacency() const { return *adjacency_; }
+
+  /// Point at which the value of an entity is located
+  Point<D> const& center(int e) const { return centers_[e]; }
+
+  /// Whether an entity is on the exterior boundary
+  bool on_boundary(int e) const { return boundary_[e]; }
+
+  /*!
+    @brief Quadratic fit of a field at an entity
+    @param[in] e     Entity index
+    @param[in] vals  Field values indexed by entity
+  */
+  Vector<NCOEF> operator()(int e, double const *vals) const {
+    Vector<NCOEF> qfit;
+    fit(e, 1, &vals, &qfit);
+    return qfit;
+  }
+
+  /*!
+    @brief Quadratic fits of several fields at an entity in one pass
+    over the stencil
+    @param[in]  e        Entity index
+    @param[in]  nfields  Number of fields
+    @param[in]  vals     Values of each field indexed by entity
+    @param[out] qfits    Fit of each field
+  */
+  void fit(int e, int nfields, double const * const *vals,
+           Vector<NCOEF> *qfits) const {
+    int const *nbrs = adjacency_->neighbors().data();
+    int const kbeg = adjacency_->offsets()[e];
+    int const kend = adjacency_->offsets()[e+1];
+    for (int f = 0; f < nfields; f++)
+      qfits[f].zero();
+    for (int k = kbeg; k < kend; k++) {
+      Vector<NCOEF> const& c = coefs_[k];
+      for (int f = 0; f < nfields; f++) {
+        double const dv = vals[f][nbrs[k]] - vals[f][e];
+        for (int i = 0; i < NCOEF; i++)
+          qfits[f][i] += c[i]*dv;
+      }
+    }
+  }
+
+ private:
+
+  // Coefficients of entity e: a quadratic fit in the interior, a
+  // linear one on the boundary or if there are too few neighbors
+  void compute_coefs(int e) {
+    int const *nbrs = adjacency_->neighbors().data();
+    int const kbeg = adjacency_->offsets()[e];
+    int const nrows = adjacency_->offsets()[e+1] - kbeg;
+    int const ncols = (boundary_[e] || nrows < NCOEF) ? D : NCOEF;
+    Point<D> const& x0 = centers_[e];
+
+    // rows of A are the basis functions at the neighbors
+    std::vector<double> a(static_cast<size_t>(nrows)*ncols);
+    for (int r = 0; r < nrows; r++) {
+      Vector<D> dx = centers_[nbrs[kbeg+r]] - x0;
+      double *row = &(a[static_cast<size_t>(r)*ncols]);
+      int icnt = D;
+      for (int j = 0; j < D; j++) {
+        row[j] = dx[j];
+        if (ncols == NCOEF)
+          for (int k = 0; k <= j; k++)
+            row[icnt++] = dx[k]*dx[j];
+      }
+    }
+
+    std::vector<double> pinv(static_cast<size_t>(ncols)*nrows);
+    pseudo_inverse(nrows, ncols, a.data(), pinv.data());
+
+    for (int r = 0; r < nrows; r++) {
+      Vector<NCOEF>& c = coefs_[kbeg+r];
+      c.zero();
+      for (int i = 0; i < ncols; i++)
+        c[i] = pinv[static_cast<size_t>(i)*nrows + r];
+    }
+  }
+
+  // Pseudo-inverse (ncols x nrows, row major) of a (nrows x ncols, row
+  // major) with ncols <= NCOEF
+  static void pseudo_inverse(int nrows, int ncols, double const *a,
+                             double *pinv) {
+    std::fill(pinv, pinv + static_cast<size_t>(ncols)*nrows, 0.0);
+
+    // scale the columns so that the linear and quadratic terms are
+    // comparable
+    double scale[NCOEF];
+    for (int j = 0; j < ncols; j++) {
+      double s = 0.0;
+      for (int r = 0; r < nrows; r++)
+        s += a[r*ncols+j]*a[r*ncols+j];
+      scale[j] = (s > 0.0) ? 1.0/std::sqrt(s) : 0.0;
+    }
+
+    // scaled columns, stored column by column
+    std::vector<double> u(static_cast<size_t>(ncols)*nrows);
+    for (int j = 0; j < ncols; j++)
+      for (int r = 0; r < nrows; r++)
+        u[static_cast<size_t>(j)*nrows + r] = a[r*ncols+j]*scale[j];
+
+    double v[NCOEF][NCOEF];
+    jacobi_svd(nrows, ncols, u.data(), v);
+
+    // the columns of u are now sigma_l u_l
+    double sigma[NCOEF];
+    double smax = 0.0;
+    for (int l = 0; l < ncols; l++) {
+      double s = 0.0;
+      for (int r = 0; r < nrows; r++)
+        s += u[static_cast<size_t>(l)*nrows + r]*u[static_cast<size_t>(l)*nrows + r];
+      sigma[l] = std::sqrt(s);
+      smax = std::max(smax, sigma[l]);
+    }
+    if (smax <= 0.0) return;
+
+    // A^+ = S V Sigma^+ U^T with S the column scaling, keeping the
+    // singular values above ~1e-7 of the largest
+    for (int l = 0; l < ncols; l++) {
+      if (sigma[l] <= 1.0e-7*smax) continue;
+      double const rl = 1.0/(sigma[l]*sigma[l]);
+      double const *ul = &(u[static_cast<size_t>(l)*nrows]);
+      for (int i = 0; i < ncols; i++) {
+        double const w = scale[i]*v[i][l]*rl;
+        double *row = pinv + static_cast<size_t>(i)*nrows;
+        for (int r = 0; r < nrows; r++)
+          row[r] += w*ul[r];
+      }
+    }
+  }
+
+  // One-sided (Hestenes) Jacobi SVD of a small dense matrix whose ncols
+  // columns of nrows entries are stored one after the other in u. The
+  // columns are rotated until they are mutually orthogonal; on return
+  // column l of u is sigma_l times the l-th left singular vector and
+  // the columns of v are the right singular vectors. Working on the
+  // matrix itself rather than on its normal matrix keeps the accuracy
+  // of a QR based least squares solve on ill-conditioned stencils
+  static void jacobi_svd(int nrows, int ncols, double *u,
+                         double v[NCOEF][NCOEF]) {
+    for (int i = 0; i < ncols; i++)
+      for (int j = 0; j < ncols; j++)
+        v[i][j] = (i == j) ? 1.0 : 0.0;
+
+    for (int sweep = 0; sweep < 50; sweep++) {
+      bool rotated = false;
+      for (int p = 0; p < ncols-1; p++)
+        for (int q = p+1; q < ncols; q++) {
+          double *up = u + static_cast<size_t>(p)*nrows;
+          double *uq = u + static_cast<size_t>(q)*nrows;
+          double alpha = 0.0, beta = 0.0, gamma = 0.0;
+          for (int r = 0; r < nrows; r++) {
+            alpha += up[r]*up[r];
+            beta += uq[r]*uq[r];
+            gamma += up[r]*uq[r];
+          }
+          if (std::fabs(gamma) <= 1.0e-15*std::sqrt(alpha*beta))
+            continue;
+          rotated = true;
+
+          double const zeta = 0.5*(beta - alpha)/gamma;
+          double const t = ((zeta >= 0.0) ? 1.0 : -1.0)/
+              (std::fabs(zeta) + std::sqrt(zeta*zeta + 1.0));
+          double const c = 1.0/std::sqrt(t*t + 1.0);
+          double const s = t*c;
+          for (int r = 0; r < nrows; r++) {
+            double const urp = up[r], urq = uq[r];
+            up[r] = c*urp - s*urq;
+            uq[r] = s*urp + c*urq;
+          }
+          for (int k = 0; k < ncols; k++) {
+            double const vkp = v[k][p], vkq = v[k][q];
+            v[k][p] = c*vkp - s*vkq;
+            v[k][q] = s*vkp + c*vkq;
+          }
+        }
+      if (!rotated) break;
+    }
+  }
+
+  std::shared_ptr<MeshAdjacency const> adjacency_;
+  std::vector<Point<D>> centers_;
+  std::vector<char> boundary_;
+  std::vector<Vector<NCOEF>> coefs_;  // one per entry of adjacency_->neighbors()
+};
+
+
+/*!
+  @brief Build the quadratic fit stencil used by Limited_Quadfit
+
+  @param[in] mesh       Mesh wrapper
+  @param[in] kind       CELL (centroids of cells sharing a node) or NODE
+                        (coordinates of nodes of adjacent dual cells)
+  @param[in] adjacency  Neighbor lists of the mesh for this entity kind
+*/
+template <int D, class MeshType>
+std::shared_ptr<QuadfitStencil<D> const>
+make_quadfit_stencil(MeshType const& mesh, Entity_kind kind,
+                     std::shared_ptr<MeshAdjacency const> adjacency) {
+  if (kind == Entity_kind::CELL)
+    return std::make_shared<QuadfitStencil<D> const>(
+        adjacency,
+        [&mesh](int c, Point<D> *p) { mesh.cell_centroid(c, p); },
+        [&mesh](int c) { return mesh.on_exterior_boundary(Entity_kind::CELL, c); });
+  else
+    return std::make_shared<QuadfitStencil<D> const>(
+        adjacency,
+        [&mesh](int n, Point<D> *p) { mesh.node_get_coordinates(n, p); },
+        [&mesh](int n) { return mesh.on_exterior_boundary(Entity_kind::NODE, n); });
+}
+
+}  // namespace Portage
+
+#endif  // PORTAGE_INTERPOLATE_QUADFIT_STENCIL_H_
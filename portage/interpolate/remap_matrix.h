@@ -0,0 +1,301 @@
+/*
+This file is part of the Ristra portage project.
+Please see the license file at the root of this repository, or at:
+    https://github.com/laristra/portage/blob/master/LICENSE
+*/
+
+#ifndef PORTAGE_INTERPOLATE_REMAP_MATRIX_H_
+#define PORTAGE_INTERPOLATE_REMAP_MATRIX_H_
+
+#include <cassert>
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+// portage includes
+#include "portage/support/portage.h"
+
+// wonton includes
+#include "wonton/support/Point.h"
+#include "wonton/support/Vector.h"
+#include "wonton/support/CoordinateSystem.h"
+
+namespace Portage {
+
+using Wonton::Point;
+using Wonton::Vector;
+
+/*!
+  @class RemapMatrix remap_matrix.h
+  @brief Sparse operator mapping source entity values to target entity values
+
+  Once the intersection weights are known, first order remap of a mesh
+  field is linear in the source values, i.e. u_t = A u_s where row i of
+  A holds the intersection volumes of target entity i normalized by
+  their sum. RemapMatrix stores A in compressed sparse row (CSR) form so
+  that any number of fields can be remapped with a sparse matrix-vector
+  (or matrix-matrix) product instead of one interpolator call per field
+  and per entity.
+
+  If requested at assembly, the matrix also stores for each nonzero the
+  offset of the intersection centroid from the source entity center,
+  scaled by the matrix entry. This allows remapping with precomputed
+  (fixed) gradients as u_t = A u_s + sum_j B_ij . grad_j, which is what
+  Interpolate_2ndOrder computes for a given set of gradients.
+
+  Small intersections are dropped with the same relative volume
+  criterion as the interpolators, so the result matches
+  Interpolate_1stOrder (and Interpolate_2ndOrder for the same gradients)
+  up to roundoff.
+
+  The entries may be stored in single precision (Real = float) to
+  halve the memory traffic of remapping large sets of fields that do
+  not need full accuracy. The entries are widened to double in the
+  products, and the single field products accumulate in double.
+
+  @tparam D     spatial dimension of problem
+  @tparam Real  type in which the matrix entries are stored
+*/
+
+template <int D, typename Real = double>
+class RemapMatrix {
+ public:
+
+  /// Default constructor (empty matrix)
+  RemapMatrix() = default;
+
+  /*!
+    @brief Assemble the matrix from intersection weights
+    @param[in] sources_and_weights  Intersection moments of each target entity
+    @param[in] num_source_entities  Number of columns (source entities)
+    @param[in] target_volume        Functor returning the volume of the
+                                    control volume of a target entity
+    @param[in] min_relative_volume  Intersections smaller than this
+                                    fraction of the target volume are ignored
+  */
+  template <class TargetVolume>
+  void assemble(Portage::vector<std::vector<Weights_t>> const& sources_and_weights,
+                int num_source_entities, TargetVolume target_volume,
+                double min_relative_volume) {
+    auto no_center = [](int, Point<D>*) {};
+    build<Wonton::DefaultCoordSys>(sources_and_weights, num_source_entities,
+                                   target_volume, min_relative_volume,
+                                   no_center, false);
+  }
+
+  /*!
+    @brief Assemble the matrix and the gradient offsets from intersection weights
+    @param[in] sources_and_weights  Intersection moments of each target entity
+    @param[in] num_source_entities  Number of columns (source entities)
+    @param[in] target_volume        Functor returning the volume of the
+                                    control volume of a target entity
+    @param[in] min_relative_volume  Intersections not larger than this
+                                    fraction of the target volume are ignored
+    @param[in] source_center        Functor (int, Point<D>*) returning the
+                                    point about which the source gradient
+                                    is applied (cell centroid or node)
+
+    @tparam CoordSys  Coordinate system used to modify line elements
+  */
+  template <class CoordSys = Wonton::DefaultCoordSys,
+            class TargetVolume, class SourceCenter>
+  void assemble(Portage::vector<std::vector<Weights_t>> const& sources_and_weights,
+                int num_source_entities, TargetVolume target_volume,
+                double min_relative_volume, SourceCenter source_center) {
+    build<CoordSys>(sources_and_weights, num_source_entities,
+                    target_volume, min_relative_volume,
+                    source_center, true);
+  }
+
+  /// Number of rows (target entities)
+  int num_rows() const { return row_offsets_.empty() ? 0 : row_offsets_.size() - 1; }
+
+  /// Number of columns (source entities)
+  int num_cols() const { return num_cols_; }
+
+  /// Number of stored nonzeros
+  int num_nonzeros() const { return columns_.size(); }
+
+  /// Whether gradient offsets were assembled
+  bool has_gradient_offsets() const { return !offsets_.empty(); }
+
+  /// Start of each row in columns() and values(), plus the end of the last row
+  std::vector<int> const& row_offsets() const { return row_offsets_; }
+
+  /// Column (source entity) of each nonzero
+  std::vector<int> const& columns() const { return columns_; }
+
+  /// Value of each nonzero
+  std::vector<Real> const& values() const { return values_; }
+
+  /// Gradient offsets of each nonzero (D per nonzero, empty if not assembled)
+  std::vector<Real> const& gradient_offsets() const { return offsets_; }
+
+  /*!
+    @brief Sparse matrix-vector product y = A x
+    @param[in]  x  Source values (num_cols() entries)
+    @param[out] y  Target values (num_rows() entries)
+  */
+  template <typename T>
+  void apply(T const *x, T *y) const {
+    int const nrows = num_rows();
+    int const *rowptr = row_offsets_.data();
+    int const *cols = columns_.data();
+    Real const *vals = values_.data();
+
+    Portage::for_each(make_counting_iterator(0), make_counting_iterator(nrows),
+                      [=](int i) {
+                        double sum = 0.0;
+                        for (int k = rowptr[i]; k < rowptr[i+1]; k++)
+                          sum += vals[k]*x[cols[k]];
+                        y[i] = sum;
+                      });
+  }
+
+  /*!
+    @brief Remap with fixed gradients y = A x + B g
+    @param[in]  x          Source values (num_cols() entries)
+    @param[in]  gradients  Gradient of each source entity
+    @param[out] y          Target values (num_rows() entries)
+  */
+  template <typename T>
+  void apply(T const *x, Vector<D> const *gradients, T *y) const {
+    assert(has_gradient_offsets());
+    int const nrows = num_rows();
+    int const *rowptr = row_offsets_.data();
+    int const *cols = columns_.data();
+    Real const *vals = values_.data();
+    Real const *offs = offsets_.data();
+
+    Portage::for_each(make_counting_iterator(0), make_counting_iterator(nrows),
+                      [=](int i) {
+                        double sum = 0.0;
+                        for (int k = rowptr[i]; k < rowptr[i+1]; k++) {
+                          int const j = cols[k];
+                          sum += vals[k]*x[j];
+                          for (int d = 0; d < D; d++)
+                            sum += offs[k*D+d]*gradients[j][d];
+                        }
+                        y[i] = sum;
+                      });
+  }
+
+  /*!
+    @brief Sparse matrix-matrix product Y = A X for several fields at once
+    @param[in]  nfields  Number of fields
+    @param[in]  X        Source values, X[j*nfields + f] is field f on entity j
+    @param[out] Y        Target values, Y[i*nfields + f] is field f on entity i
+
+    Each nonzero is loaded once for all fields and the inner loop over
+    fields is contiguous, so this is considerably cheaper than nfields
+    separate products.
+  */
+  template <typename T>
+  void apply(int nfields, T const *X, T *Y) const {
+    int const nrows = num_rows();
+    int const *rowptr = row_offsets_.data();
+    int const *cols = columns_.data();
+    Real const *vals = values_.data();
+
+    Portage::for_each(make_counting_iterator(0), make_counting_iterator(nrows),
+                      [=](int i) {
+                        T *yi = Y + static_cast<size_t>(i)*nfields;
+                        std::fill(yi, yi + nfields, T(0));
+                        for (int k = rowptr[i]; k < rowptr[i+1]; k++) {
+                          double const a = vals[k];
+                          T const *xj = X + static_cast<size_t>(cols[k])*nfields;
+                          for (int f = 0; f < nfields; f++)
+                            yi[f] += a*xj[f];
+                        }
+                      });
+  }
+
+ private:
+
+  template <class CoordSys, class TargetVolume, class SourceCenter>
+  void build(Portage::vector<std::vector<Weights_t>> const& sources_and_weights,
+             int num_source_entities, TargetVolume target_volume,
+             double min_relative_volume, SourceCenter source_center,
+             bool with_offsets) {
+
+    int const nrows = sources_and_weights.size();
+    num_cols_ = num_source_entities;
+
+    // Intersections are kept under the same condition as in the
+    // interpolator the matrix stands in for: the first order one keeps
+    // those at the threshold, the second order one skips them
+    auto keep = [&](double xsect_volume, double volume) {
+      double const relvol = xsect_volume/volume;
+      return with_offsets ? relvol > min_relative_volume
+                          : !(relvol < min_relative_volume);
+    };
+
+    // First pass - count the nonzeros of each row
+    std::vector<double> volumes(nrows);
+    row_offsets_.assign(nrows + 1, 0);
+    Portage::for_each(make_counting_iterator(0), make_counting_iterator(nrows),
+                      [&](int i) {
+                        // nb: 'auto' may imply unexpected behavior with thrust enabled.
+                        std::vector<Weights_t> const& row = sources_and_weights[i];
+                        volumes[i] = target_volume(i);
+                        int n = 0;
+                        for (auto const& wt : row)
+                          if (keep(wt.weights[0], volumes[i])) n++;
+                        row_offsets_[i+1] = n;
+                      });
+    std::partial_sum(row_offsets_.begin(), row_offsets_.end(),
+                     row_offsets_.begin());
+
+    int const nnz = row_offsets_[nrows];
+    columns_.resize(nnz);
+    values_.resize(nnz);
+    if (with_offsets)
+      offsets_.resize(static_cast<size_t>(nnz)*D);
+    else
+      offsets_.clear();
+
+    // Second pass - fill in the normalized weights
+    Portage::for_each(make_counting_iterator(0), make_counting_iterator(nrows),
+                      [&](int i) {
+                        std::vector<Weights_t> const& row = sources_and_weights[i];
+                        int k = row_offsets_[i];
+                        double wtsum0 = 0.0;
+                        for (auto const& wt : row) {
+                          double const xsect_volume = wt.weights[0];
+                          if (!keep(xsect_volume, volumes[i]))
+                            continue;  // skip small intersections
+                          columns_[k] = wt.entityID;
+                          values_[k] = xsect_volume;
+                          if (with_offsets) {
+                            Point<D> src_center, xsect_centroid;
+                            source_center(wt.entityID, &src_center);
+                            for (int d = 0; d < D; d++)
+                              xsect_centroid[d] = wt.weights[1+d]/xsect_volume;
+                            Vector<D> dr = xsect_centroid - src_center;
+                            dr = CoordSys::modify_line_element(dr, src_center);
+                            for (int d = 0; d < D; d++)
+                              offsets_[k*D+d] = xsect_volume*dr[d];
+                          }
+                          wtsum0 += xsect_volume;
+                          k++;
+                        }
+
+                        for (int n = row_offsets_[i]; n < k; n++) {
+                          values_[n] /= wtsum0;
+                          if (with_offsets)
+                            for (int d = 0; d < D; d++)
+                              offsets_[n*D+d] /= wtsum0;
+                        }
+                      });
+  }
+
+  int num_cols_ = 0;
+  std::vector<int> row_offsets_;
+  std::vector<int> columns_;
+  std::vector<Real> values_;
+  std::vector<Real> offsets_;
+};  // class RemapMatrix
+
+}  // namespace Portage
+
+#endif  // PORTAGE_INTERPOLATE_REMAP_MATRIX_H_
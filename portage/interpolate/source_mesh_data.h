@@ -0,0 +1,58 @@
+/*
+This file is part of the Ristra portage project.
+Please see the license file at the root of this repository, or at:
+    https://github.com/laristra/portage/blob/master/LICENSE
+*/
+
+#ifndef PORTAGE_INTERPOLATE_SOURCE_MESH_DATA_H_
+#define PORTAGE_INTERPOLATE_SOURCE_MESH_DATA_H_
+
+#include <memory>
+
+// portage includes
+#include "portage/support/mesh_adjacency.h"
+#include "portage/interpolate/gradient_stencil.h"
+#include "portage/interpolate/quadfit_stencil.h"
+#include "portage/interpolate/limiter.h"
+#include "portage/interpolate/material_moments.h"
+
+namespace Portage {
+
+/*!
+  @struct SourceMeshData source_mesh_data.h
+  @brief Data of the source mesh that interpolators derive from its
+  geometry and may share
+
+  Neighbor lists, least squares coefficients, limiter vertices and
+  material moments only depend on the source mesh (and on the
+  interface reconstruction), not on the variable being remapped. An
+  interpolator builds whatever it needs and is missing here when its
+  interpolation variable is set; the driver hands the result to the
+  interpolators of the following variables. Each interpolator uses
+  only the parts it needs, so all of them take and return this struct
+  in the same way.
+
+  @tparam D  Dimension of the source mesh
+*/
+
+template<int D>
+struct SourceMeshData {
+  /// Neighbor lists of the source entities
+  std::shared_ptr<MeshAdjacency const> adjacency;
+
+  /// Least squares gradient coefficients for mesh fields
+  std::shared_ptr<GradientStencil<D> const> gradient_stencil;
+
+  /// Cell (or dual cell) vertices and boundary flags for the limiter
+  std::shared_ptr<BarthJespersenLimiter<D> const> limiter;
+
+  /// Least squares quadratic fit coefficients for mesh fields
+  std::shared_ptr<QuadfitStencil<D> const> quadfit_stencil;
+
+  /// Volume and centroid of each material in each source cell
+  std::shared_ptr<MaterialMoments<D> const> material_moments;
+};
+
+}  // namespace Portage
+
+#endif  // PORTAGE_INTERPOLATE_SOURCE_MESH_DATA_H_
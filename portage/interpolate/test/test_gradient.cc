@@ -5,12 +5,16 @@ Please see the license file at the root of this repository, or at:
 */
 
 
+#include <cmath>
 #include <iostream>
+#include <vector>
 
 #include "gtest/gtest.h"
 
 // portage includes
 #include "portage/interpolate/gradient.h"
+#include "portage/interpolate/gradient_stencil.h"
+#include "portage/support/mesh_adjacency.h"
 #include "portage/support/portage.h"
 
 // wonton includes
@@ -258,3 +262,105 @@ TEST(Gradient, Fields_Node_Ctr) {
     }
   }
 }
+
+
+/// Gradients from a precomputed stencil match the ones computed on
+/// the fly, with and without limiting
+
+TEST(Gradient, Stencil_Cell_Ctr) {
+  std::shared_ptr<Wonton::Simple_Mesh> mesh1 =
+      std::make_shared<Wonton::Simple_Mesh>(0.0, 0.0, 1.0, 1.0, 5, 4);
+  Wonton::Simple_Mesh_Wrapper meshwrapper(*mesh1);
+  Wonton::Simple_State mystate(mesh1);
+  Wonton::Simple_State_Wrapper statewrapper(mystate);
+
+  const int nc1 = meshwrapper.num_owned_cells();
+
+  // nonlinear field, so that the least squares fit is not exact
+  std::vector<double> data(nc1);
+  for (int c = 0; c < nc1; c++) {
+    Wonton::Point<2> ccen;
+    meshwrapper.cell_centroid(c, &ccen);
+    data[c] = ccen[0]*ccen[0] + 2*ccen[1];
+  }
+  mystate.add("cellvars", Portage::Entity_kind::CELL, &(data[0]));
+
+  auto adjacency = Portage::make_mesh_adjacency(meshwrapper,
+                                                Portage::Entity_kind::CELL);
+  auto stencil = Portage::make_gradient_stencil<2>(meshwrapper,
+                                                   Portage::Entity_kind::CELL,
+                                                   adjacency);
+
+  for (auto limiter : {Portage::NOLIMITER, Portage::BARTH_JESPERSEN}) {
+    Portage::Limited_Gradient<2, Portage::Entity_kind::CELL,
+                              Wonton::Simple_Mesh_Wrapper,
+                              Wonton::Simple_State_Wrapper>
+        gradcalc1(meshwrapper, statewrapper, "cellvars",
+                  limiter, Portage::BND_NOLIMITER);
+
+    Portage::Limited_Gradient<2, Portage::Entity_kind::CELL,
+                              Wonton::Simple_Mesh_Wrapper,
+                              Wonton::Simple_State_Wrapper>
+        gradcalc2(meshwrapper, statewrapper, "cellvars",
+                  limiter, Portage::BND_NOLIMITER, adjacency);
+    gradcalc2.set_gradient_stencil(stencil);
+
+    for (int c = 0; c < nc1; ++c) {
+      ASSERT_TRUE(stencil->valid(c));
+      Wonton::Vector<2> grad1 = gradcalc1(c);
+      Wonton::Vector<2> grad2 = gradcalc2(c);
+      ASSERT_NEAR(grad1[0], grad2[0], 1.0e-10);
+      ASSERT_NEAR(grad1[1], grad2[1], 1.0e-10);
+    }
+  }
+}
+
+
+/// Limiting cells in blocks gives the same gradients as limiting them
+/// one at a time, and never increases the gradient
+
+TEST(Gradient, Batched_Limiter_Cell_Ctr) {
+  std::shared_ptr<Wonton::Simple_Mesh> mesh1 =
+      std::make_shared<Wonton::Simple_Mesh>(0.0, 0.0, 1.0, 1.0, 12, 10);
+  Wonton::Simple_Mesh_Wrapper meshwrapper(*mesh1);
+  Wonton::Simple_State mystate(mesh1);
+  Wonton::Simple_State_Wrapper statewrapper(mystate);
+
+  const int nc1 = meshwrapper.num_owned_cells();
+
+  // field with a kink, so that the limiter is active in some cells
+  std::vector<double> data(nc1);
+  for (int c = 0; c < nc1; c++) {
+    Wonton::Point<2> ccen;
+    meshwrapper.cell_centroid(c, &ccen);
+    data[c] = std::fabs(ccen[0] - 0.5) + ccen[1]*ccen[1];
+  }
+  mystate.add("cellvars", Portage::Entity_kind::CELL, &(data[0]));
+
+  Portage::Limited_Gradient<2, Portage::Entity_kind::CELL,
+                            Wonton::Simple_Mesh_Wrapper,
+                            Wonton::Simple_State_Wrapper>
+      unlimited(meshwrapper, statewrapper, "cellvars",
+                Portage::NOLIMITER, Portage::BND_NOLIMITER);
+
+  Portage::Limited_Gradient<2, Portage::Entity_kind::CELL,
+                            Wonton::Simple_Mesh_Wrapper,
+                            Wonton::Simple_State_Wrapper>
+      limited(meshwrapper, statewrapper, "cellvars",
+              Portage::BARTH_JESPERSEN, Portage::BND_BARTH_JESPERSEN);
+
+  std::vector<int> cellids(nc1);
+  for (int c = 0; c < nc1; c++)
+    cellids[c] = c;
+  std::vector<Wonton::Vector<2>> grads(nc1);
+  limited.compute_gradients(nc1, cellids.data(), grads.data());
+
+  for (int c = 0; c < nc1; ++c) {
+    Wonton::Vector<2> grad1 = limited(c);
+    ASSERT_NEAR(grad1[0], grads[c][0], 1.0e-12);
+    ASSERT_NEAR(grad1[1], grads[c][1], 1.0e-12);
+
+    Wonton::Vector<2> grad2 = unlimited(c);
+    ASSERT_LE(grads[c].norm(), grad2.norm() + 1.0e-12);
+  }
+}
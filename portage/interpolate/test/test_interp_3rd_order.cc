@@ -740,6 +740,94 @@ TEST(Interpolate_3rd_Order, Cell_Ctr_Quad_BJ_Limiter_2D) {
 
 }
 
+/*!
+  @brief Third order interpolate of a 3-component cell-centered field
+  with Barth-Jespersen limiting in 2D, checked against the interpolation
+  of each component on its own
+ */
+
+TEST(Interpolate_3rd_Order, Cell_Ctr_Multi_Component_BJ_Limiter_2D) {
+  std::shared_ptr<Wonton::Simple_Mesh> source_mesh =
+    std::make_shared<Wonton::Simple_Mesh>(0.0, 0.0, 1.0, 1.0, 4, 4);
+  std::shared_ptr<Wonton::Simple_Mesh> target_mesh =
+    std::make_shared<Wonton::Simple_Mesh>(0.0, 0.0, 1.0, 1.0, 5, 5);
+
+  Wonton::Simple_Mesh_Wrapper sourceMeshWrapper(*source_mesh);
+  Wonton::Simple_Mesh_Wrapper targetMeshWrapper(*target_mesh);
+
+  const int ncells_source = sourceMeshWrapper.num_owned_cells();
+  const int ncells_target = targetMeshWrapper.num_owned_cells();
+
+  // Components: quadratic, discontinuous quadratic (limited) and constant
+
+  std::vector<std::string> components = {"u", "v", "w"};
+  std::vector<std::vector<double>> data(3, std::vector<double>(ncells_source));
+  for (int c = 0; c < ncells_source; ++c) {
+    Wonton::Point<2> cen;
+    sourceMeshWrapper.cell_centroid(c, &cen);
+    data[0][c] = cen[0]*cen[0] + cen[0]*cen[1] + 3*cen[1];
+    data[1][c] = (cen[0] < 0.5 ? 1 : 100)*(cen[0]*cen[0] + cen[1]*cen[1]);
+    data[2][c] = 2.0;
+  }
+
+  Wonton::Simple_State source_state(source_mesh);
+  for (int k = 0; k < 3; ++k)
+    source_state.add(components[k], Wonton::Entity_kind::CELL, &(data[k][0]));
+  Wonton::Simple_State_Wrapper sourceStateWrapper(source_state);
+
+  std::vector<std::vector<Wonton::Point<2>>> source_cell_coords(ncells_source);
+  std::vector<std::vector<Wonton::Point<2>>> target_cell_coords(ncells_target);
+  for (int c = 0; c < ncells_source; ++c)
+    sourceMeshWrapper.cell_get_coordinates(c, &(source_cell_coords[c]));
+  for (int c = 0; c < ncells_target; ++c)
+    targetMeshWrapper.cell_get_coordinates(c, &(target_cell_coords[c]));
+
+  std::vector<std::vector<Portage::Weights_t>> sources_and_weights(ncells_target);
+  for (int c = 0; c < ncells_target; ++c) {
+    std::vector<int> xcells;
+    std::vector<std::vector<double>> xwts;
+    BOX_INTERSECT::intersection_moments<2>(target_cell_coords[c],
+                                           source_cell_coords,
+                                           &xcells, &xwts);
+    sources_and_weights[c].resize(xcells.size());
+    for (int i = 0; i < xcells.size(); ++i) {
+      sources_and_weights[c][i].entityID = xcells[i];
+      sources_and_weights[c][i].weights = xwts[i];
+    }
+  }
+
+  Portage::NumericTolerances_t num_tols;
+  num_tols.use_default();
+
+  Portage::Interpolate_3rdOrder<2, Wonton::Entity_kind::CELL,
+                                Wonton::Simple_Mesh_Wrapper,
+                                Wonton::Simple_Mesh_Wrapper,
+                                Wonton::Simple_State_Wrapper>
+      interpolator(sourceMeshWrapper, targetMeshWrapper, sourceStateWrapper,
+                   num_tols);
+
+  // Interpolate each component on its own
+
+  std::vector<std::vector<double>> stdvals(3, std::vector<double>(ncells_target));
+  for (int k = 0; k < 3; ++k) {
+    interpolator.set_interpolation_variable(components[k], Portage::BARTH_JESPERSEN);
+    for (int c = 0; c < ncells_target; ++c)
+      stdvals[k][c] = interpolator(c, sources_and_weights[c]);
+  }
+
+  // And all of them together, fitting them in one pass over each stencil
+
+  interpolator.set_interpolation_variable(components, Portage::BARTH_JESPERSEN);
+  ASSERT_EQ(3, interpolator.num_components());
+
+  double outvals[3];
+  for (int c = 0; c < ncells_target; ++c) {
+    interpolator(c, sources_and_weights[c], outvals);
+    for (int k = 0; k < 3; ++k)
+      ASSERT_NEAR(stdvals[k][c], outvals[k], TOL);
+  }
+}
+
 /// Third order interpolation of constant node-centered field with no
 /// limiting in 2D
 
@@ -0,0 +1,49 @@
+/*
+This file is part of the Ristra portage project.
+Please see the license file at the root of this repository, or at:
+    https://github.com/laristra/portage/blob/master/LICENSE
+*/
+
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+// portage includes
+#include "portage/interpolate/material_moments.h"
+
+// wonton includes
+#include "wonton/support/Point.h"
+
+/// Test lookup of precomputed material moments in a cell-material table
+
+TEST(MaterialMoments, Table) {
+  // cell 0 is pure, cell 1 has materials 2 and 0, cell 2 is empty
+  std::vector<std::vector<int>> cellmats = {{0}, {2, 0}, {}};
+
+  Portage::MaterialMoments<2> moments(
+      3,
+      [&](int c, std::vector<int> *mats) { *mats = cellmats[c]; },
+      [&](int c, std::vector<int> const& mats, double *vols,
+          Wonton::Point<2> *cens) {
+        for (int i = 0; i < static_cast<int>(mats.size()); i++) {
+          vols[i] = 0.25*(i+1);
+          cens[i] = Wonton::Point<2>(c + 0.5, mats[i] + 0.5);
+        }
+      });
+
+  ASSERT_EQ(3, moments.num_cells());
+  ASSERT_EQ(-1, moments.find(2, 0));
+  ASSERT_EQ(-1, moments.find(0, 2));
+  ASSERT_DOUBLE_EQ(0.25, moments.volume(0, 0));
+  ASSERT_DOUBLE_EQ(0.5, moments.volume(1, 0));
+  ASSERT_DOUBLE_EQ(0.25, moments.volume(1, 2));
+  ASSERT_DOUBLE_EQ(0.0, moments.volume(1, 1));
+
+  Wonton::Point<2> cen;
+  ASSERT_TRUE(moments.centroid(1, 2, &cen));
+  ASSERT_DOUBLE_EQ(1.5, cen[0]);
+  ASSERT_DOUBLE_EQ(2.5, cen[1]);
+  ASSERT_FALSE(moments.centroid(2, 1, &cen));
+  ASSERT_DOUBLE_EQ(1.5, cen[0]);
+}
@@ -11,6 +11,8 @@ Please see the license file at the root of this repository, or at:
 
 // portage includes
 #include "portage/interpolate/quadfit.h"
+#include "portage/interpolate/quadfit_stencil.h"
+#include "portage/support/mesh_adjacency.h"
 #include "portage/support/portage.h"
 
 // wonton includes
@@ -209,6 +211,76 @@ TEST(Quadfit, Fields_Cell_Ctr) {
   }
 }
 
+/// Test precomputed quadfit coefficients against per-cell fits
+
+TEST(Quadfit, Stencil_Cell_Ctr) {
+  std::shared_ptr<Wonton::Simple_Mesh> mesh1 =
+      std::make_shared<Wonton::Simple_Mesh>(0.0, 0.0, 1.0, 1.0, 5, 5);
+  Wonton::Simple_Mesh_Wrapper meshWrapper(*mesh1);
+  Wonton::Simple_State mystate(mesh1);
+  Wonton::Simple_State_Wrapper stateWrapper(mystate);
+
+  const int nc1 = meshWrapper.num_owned_cells();
+
+  // x+2y and x*x+0.5*x*y+y*y
+  std::vector<double> data1(nc1), data2(nc1);
+  for (int c = 0; c < nc1; c++) {
+    Wonton::Point<2> ccen;
+    meshWrapper.cell_centroid(c, &ccen);
+    data1[c] = ccen[0] + 2*ccen[1];
+    data2[c] = ccen[0]*ccen[0] + 0.5*ccen[0]*ccen[1] + ccen[1]*ccen[1];
+  }
+  mystate.add("cellvars1", Portage::Entity_kind::CELL, &(data1[0]));
+  mystate.add("cellvars2", Portage::Entity_kind::CELL, &(data2[0]));
+
+  auto adjacency = Portage::make_mesh_adjacency(meshWrapper,
+                                                Portage::Entity_kind::CELL);
+  auto stencil = Portage::make_quadfit_stencil<2>(meshWrapper,
+                                                  Portage::Entity_kind::CELL,
+                                                  adjacency);
+
+  Portage::Limited_Quadfit<2, Portage::Entity_kind::CELL,
+                           Wonton::Simple_Mesh_Wrapper,
+                           Wonton::Simple_State_Wrapper>
+      qfitcalc(meshWrapper, stateWrapper, "cellvars2",
+               Portage::BARTH_JESPERSEN, Portage::BND_NOLIMITER, adjacency);
+  Portage::Limited_Quadfit<2, Portage::Entity_kind::CELL,
+                           Wonton::Simple_Mesh_Wrapper,
+                           Wonton::Simple_State_Wrapper>
+      qfitcalc_stencil(meshWrapper, stateWrapper, "cellvars2",
+                       Portage::BARTH_JESPERSEN, Portage::BND_NOLIMITER, adjacency);
+  qfitcalc_stencil.set_quadfit_stencil(stencil);
+
+  double const *vals[2] = {data1.data(), data2.data()};
+  Wonton::Vector<5> qfits[2];
+
+  for (int c = 0; c < nc1; ++c) {
+    // both fields in one pass
+    stencil->fit(c, 2, vals, qfits);
+
+    ASSERT_NEAR(1.0, qfits[0][0], 1.0e-10);
+    ASSERT_NEAR(2.0, qfits[0][1], 1.0e-10);
+    for (int i = 2; i < 5; i++)
+      ASSERT_NEAR(0.0, qfits[0][i], 1.0e-10);
+
+    if (stencil->on_boundary(c)) continue;
+
+    Wonton::Point<2> ccen;
+    meshWrapper.cell_centroid(c, &ccen);
+    ASSERT_NEAR(2.0*ccen[0] + 0.5*ccen[1], qfits[1][0], 1.0e-10);
+    ASSERT_NEAR(0.5*ccen[0] + 2.0*ccen[1], qfits[1][1], 1.0e-10);
+    ASSERT_NEAR(1.0, qfits[1][2], 1.0e-10);
+    ASSERT_NEAR(0.5, qfits[1][3], 1.0e-10);
+    ASSERT_NEAR(1.0, qfits[1][4], 1.0e-10);
+
+    // limited fits agree with those solved cell by cell
+    Wonton::Vector<5> qfit1 = qfitcalc(c);
+    Wonton::Vector<5> qfit2 = qfitcalc_stencil(c);
+    for (int i = 0; i < 5; i++)
+      ASSERT_NEAR(qfit1[i], qfit2[i], 1.0e-10);
+  }
+}
+
 /// Test quadfit computation with node centered fields
 
 TEST(Quadfit, Fields_Node_Ctr) {
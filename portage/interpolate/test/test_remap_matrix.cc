@@ -0,0 +1,276 @@
+/*
+This file is part of the Ristra portage project.
+Please see the license file at the root of this repository, or at:
+    https://github.com/laristra/portage/blob/master/LICENSE
+*/
+
+
+#include <iostream>
+
+#include "gtest/gtest.h"
+
+// portage includes
+#include "portage/interpolate/remap_matrix.h"
+#include "portage/interpolate/interpolate_1st_order.h"
+#include "portage/intersect/simple_intersect_for_tests.h"
+#include "portage/support/portage.h"
+
+// wonton includes
+#include "wonton/mesh/simple/simple_mesh.h"
+#include "wonton/mesh/simple/simple_mesh_wrapper.h"
+#include "wonton/state/simple/simple_state.h"
+#include "wonton/state/simple/simple_state_wrapper.h"
+#include "wonton/support/Point.h"
+
+double TOL = 1e-12;
+
+// Intersection weights of the target cells with the source cells,
+// computed independently in simple_intersect_for_tests.h
+
+std::vector<std::vector<Portage::Weights_t>>
+get_weights(Wonton::Simple_Mesh_Wrapper const& sourceMeshWrapper,
+            Wonton::Simple_Mesh_Wrapper const& targetMeshWrapper) {
+
+  const int ncells_source = sourceMeshWrapper.num_owned_cells();
+  const int ncells_target = targetMeshWrapper.num_owned_cells();
+
+  std::vector<std::vector<Wonton::Point<2>>> source_cell_coords(ncells_source);
+  std::vector<std::vector<Wonton::Point<2>>> target_cell_coords(ncells_target);
+
+  for (int c = 0; c < ncells_source; ++c)
+    sourceMeshWrapper.cell_get_coordinates(c, &(source_cell_coords[c]));
+  for (int c = 0; c < ncells_target; ++c)
+    targetMeshWrapper.cell_get_coordinates(c, &(target_cell_coords[c]));
+
+  std::vector<std::vector<Portage::Weights_t>> sources_and_weights(ncells_target);
+
+  for (int c = 0; c < ncells_target; ++c) {
+    std::vector<int> xcells;
+    std::vector<std::vector<double>> xwts;
+
+    BOX_INTERSECT::intersection_moments<2>(target_cell_coords[c],
+                                           source_cell_coords,
+                                           &xcells, &xwts);
+
+    std::vector<Portage::Weights_t> wtsvec(xcells.size());
+    for (int i = 0; i < xcells.size(); ++i) {
+      wtsvec[i].entityID = xcells[i];
+      wtsvec[i].weights = xwts[i];
+    }
+    sources_and_weights[c] = wtsvec;
+  }
+
+  return sources_and_weights;
+}
+
+
+/// The assembled matrix gives the same result as the 1st order interpolator
+
+TEST(RemapMatrix, Cell_1stOrder_2D) {
+
+  std::shared_ptr<Wonton::Simple_Mesh> source_mesh =
+    std::make_shared<Wonton::Simple_Mesh>(0.0, 0.0, 1.0, 1.0, 4, 4);
+  std::shared_ptr<Wonton::Simple_Mesh> target_mesh =
+    std::make_shared<Wonton::Simple_Mesh>(0.0, 0.0, 1.0, 1.0, 5, 5);
+
+  Wonton::Simple_Mesh_Wrapper sourceMeshWrapper(*source_mesh);
+  Wonton::Simple_Mesh_Wrapper targetMeshWrapper(*target_mesh);
+
+  const int ncells_source = sourceMeshWrapper.num_owned_cells();
+  const int ncells_target = targetMeshWrapper.num_owned_cells();
+
+  // Linear field, so that 1st order remap is not trivially exact
+
+  Wonton::Simple_State source_state(source_mesh);
+  std::vector<double> data(ncells_source);
+  for (int c = 0; c < ncells_source; ++c) {
+    Wonton::Point<2> cen;
+    sourceMeshWrapper.cell_centroid(c, &cen);
+    data[c] = cen[0] + 2*cen[1];
+  }
+  source_state.add("cellvars", Wonton::Entity_kind::CELL, &(data[0]));
+  Wonton::Simple_State_Wrapper sourceStateWrapper(source_state);
+
+  auto sources_and_weights = get_weights(sourceMeshWrapper, targetMeshWrapper);
+
+  Portage::NumericTolerances_t num_tols;
+  num_tols.use_default();
+
+  Portage::Interpolate_1stOrder<2, Wonton::Entity_kind::CELL,
+                                Wonton::Simple_Mesh_Wrapper,
+                                Wonton::Simple_Mesh_Wrapper,
+                                Wonton::Simple_State_Wrapper>
+      interpolator(sourceMeshWrapper, targetMeshWrapper, sourceStateWrapper,
+                   num_tols);
+  interpolator.set_interpolation_variable("cellvars");
+
+  Portage::RemapMatrix<2> remap_matrix;
+  remap_matrix.assemble(sources_and_weights, ncells_source,
+                        [&](int c) { return targetMeshWrapper.cell_volume(c); },
+                        num_tols.min_relative_volume);
+
+  ASSERT_EQ(remap_matrix.num_rows(), ncells_target);
+  ASSERT_EQ(remap_matrix.num_cols(), ncells_source);
+  ASSERT_FALSE(remap_matrix.has_gradient_offsets());
+
+  std::vector<double> outvals(ncells_target);
+  remap_matrix.apply(data.data(), outvals.data());
+
+  for (int c = 0; c < ncells_target; ++c)
+    ASSERT_NEAR(outvals[c], interpolator(c, sources_and_weights[c]), TOL);
+
+  // Rows sum to one (constant preserving)
+
+  auto const& rowptr = remap_matrix.row_offsets();
+  auto const& values = remap_matrix.values();
+  for (int c = 0; c < ncells_target; ++c) {
+    double rowsum = 0.0;
+    for (int k = rowptr[c]; k < rowptr[c+1]; ++k)
+      rowsum += values[k];
+    ASSERT_NEAR(rowsum, 1.0, TOL);
+  }
+
+  // Remapping several fields at once gives the same result as one at a time
+
+  const int nfields = 3;
+  std::vector<double> X(ncells_source*nfields), Y(ncells_target*nfields);
+  for (int c = 0; c < ncells_source; ++c)
+    for (int f = 0; f < nfields; ++f)
+      X[c*nfields+f] = (f+1)*data[c];
+
+  remap_matrix.apply(nfields, X.data(), Y.data());
+
+  for (int c = 0; c < ncells_target; ++c)
+    for (int f = 0; f < nfields; ++f)
+      ASSERT_NEAR(Y[c*nfields+f], (f+1)*outvals[c], TOL);
+}
+
+
+/// With exact gradients, the matrix with gradient offsets reproduces
+/// linear fields
+
+TEST(RemapMatrix, Cell_FixedGradient_2D) {
+
+  std::shared_ptr<Wonton::Simple_Mesh> source_mesh =
+    std::make_shared<Wonton::Simple_Mesh>(0.0, 0.0, 1.0, 1.0, 4, 4);
+  std::shared_ptr<Wonton::Simple_Mesh> target_mesh =
+    std::make_shared<Wonton::Simple_Mesh>(0.0, 0.0, 1.0, 1.0, 7, 6);
+
+  Wonton::Simple_Mesh_Wrapper sourceMeshWrapper(*source_mesh);
+  Wonton::Simple_Mesh_Wrapper targetMeshWrapper(*target_mesh);
+
+  const int ncells_source = sourceMeshWrapper.num_owned_cells();
+  const int ncells_target = targetMeshWrapper.num_owned_cells();
+
+  std::vector<double> data(ncells_source);
+  std::vector<Wonton::Vector<2>> gradients(ncells_source,
+                                           Wonton::Vector<2>(1.0, 2.0));
+  for (int c = 0; c < ncells_source; ++c) {
+    Wonton::Point<2> cen;
+    sourceMeshWrapper.cell_centroid(c, &cen);
+    data[c] = cen[0] + 2*cen[1];
+  }
+
+  auto sources_and_weights = get_weights(sourceMeshWrapper, targetMeshWrapper);
+
+  Portage::NumericTolerances_t num_tols;
+  num_tols.use_default();
+
+  Portage::RemapMatrix<2> remap_matrix;
+  remap_matrix.assemble(sources_and_weights, ncells_source,
+                        [&](int c) { return targetMeshWrapper.cell_volume(c); },
+                        num_tols.min_relative_volume,
+                        [&](int c, Wonton::Point<2> *cen) {
+                          sourceMeshWrapper.cell_centroid(c, cen);
+                        });
+  ASSERT_TRUE(remap_matrix.has_gradient_offsets());
+
+  std::vector<double> outvals(ncells_target);
+  remap_matrix.apply(data.data(), gradients.data(), outvals.data());
+
+  for (int c = 0; c < ncells_target; ++c) {
+    Wonton::Point<2> cen;
+    targetMeshWrapper.cell_centroid(c, &cen);
+    ASSERT_NEAR(outvals[c], cen[0] + 2*cen[1], TOL);
+  }
+}
+
+
+/// A matrix stored in single precision remaps single precision fields
+/// to single precision accuracy
+
+TEST(RemapMatrix, Cell_1stOrder_Float_2D) {
+
+  std::shared_ptr<Wonton::Simple_Mesh> source_mesh =
+    std::make_shared<Wonton::Simple_Mesh>(0.0, 0.0, 1.0, 1.0, 4, 4);
+  std::shared_ptr<Wonton::Simple_Mesh> target_mesh =
+    std::make_shared<Wonton::Simple_Mesh>(0.0, 0.0, 1.0, 1.0, 5, 5);
+
+  Wonton::Simple_Mesh_Wrapper sourceMeshWrapper(*source_mesh);
+  Wonton::Simple_Mesh_Wrapper targetMeshWrapper(*target_mesh);
+
+  const int ncells_source = sourceMeshWrapper.num_owned_cells();
+  const int ncells_target = targetMeshWrapper.num_owned_cells();
+
+  std::vector<double> data(ncells_source);
+  std::vector<float> fdata(ncells_source);
+  for (int c = 0; c < ncells_source; ++c) {
+    Wonton::Point<2> cen;
+    sourceMeshWrapper.cell_centroid(c, &cen);
+    data[c] = cen[0] + 2*cen[1];
+    fdata[c] = data[c];
+  }
+
+  auto sources_and_weights = get_weights(sourceMeshWrapper, targetMeshWrapper);
+
+  Portage::NumericTolerances_t num_tols;
+  num_tols.use_default();
+  auto target_volume = [&](int c) { return targetMeshWrapper.cell_volume(c); };
+
+  Portage::RemapMatrix<2> remap_matrix;
+  remap_matrix.assemble(sources_and_weights, ncells_source, target_volume,
+                        num_tols.min_relative_volume);
+  Portage::RemapMatrix<2, float> float_matrix;
+  float_matrix.assemble(sources_and_weights, ncells_source, target_volume,
+                        num_tols.min_relative_volume);
+
+  ASSERT_EQ(float_matrix.num_nonzeros(), remap_matrix.num_nonzeros());
+
+  std::vector<double> outvals(ncells_target);
+  std::vector<float> foutvals(ncells_target);
+  remap_matrix.apply(data.data(), outvals.data());
+  float_matrix.apply(fdata.data(), foutvals.data());
+
+  for (int c = 0; c < ncells_target; ++c)
+    ASSERT_NEAR(foutvals[c], outvals[c], 1.0e-6);
+}
+
+
+/// Intersections at the relative volume threshold are kept by the
+/// first order matrix and dropped with gradient offsets, as by the
+/// first and second order interpolators
+
+TEST(RemapMatrix, Relative_Volume_Threshold) {
+
+  std::vector<std::vector<Portage::Weights_t>> sources_and_weights(1);
+  sources_and_weights[0].resize(2);
+  sources_and_weights[0][0].entityID = 0;
+  sources_and_weights[0][0].weights = {0.75, 0.375, 0.375};
+  sources_and_weights[0][1].entityID = 1;
+  sources_and_weights[0][1].weights = {0.25, 0.125, 0.125};
+
+  auto target_volume = [](int) { return 1.0; };
+  auto source_center = [](int, Wonton::Point<2> *center) {
+    *center = Wonton::Point<2>(0.5, 0.5);
+  };
+
+  Portage::RemapMatrix<2> first_order;
+  first_order.assemble(sources_and_weights, 2, target_volume, 0.25);
+  ASSERT_EQ(2, first_order.num_nonzeros());
+
+  Portage::RemapMatrix<2> with_offsets;
+  with_offsets.assemble(sources_and_weights, 2, target_volume, 0.25,
+                        source_center);
+  ASSERT_EQ(1, with_offsets.num_nonzeros());
+  ASSERT_NEAR(1.0, with_offsets.values()[0], TOL);
+}
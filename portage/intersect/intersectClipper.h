@@ -11,6 +11,8 @@ Please see the license file at the root of this repository, or at:
 #include <cmath>
 #include <cfloat>
 #include <algorithm>
+#include <vector>
+#include <memory>
 
 // portage includes
 #include "portage/intersect/clipper.hpp"
@@ -25,7 +27,7 @@ namespace Portage {
   @returns std::vector<double>--area, mx, my
 */
 inline
-std::vector<double> areaAndMomentPolygon(const std::vector<Wonton::Point<2>> poly){
+std::vector<double> areaAndMomentPolygon(const std::vector<Wonton::Point<2>>& poly){
   double area = 0;
   double cx = 0;
   double cy = 0;
@@ -71,6 +73,114 @@ typedef std::pair<double, Wonton::Point<2>> Moment;
 /// Constructor taking a source mesh @c s and a target mesh @c t.
 IntersectClipper(const SourceMeshType &s, const TargetMeshType &t):sourceMeshWrapper(s), targetMeshWrapper(t){}
 
+/*!
+  @brief Convert all source cells to integer paths once for batched intersection
+
+  Computes a single integer scaling for all cells of both meshes and
+  converts every source cell with it. After this call, the batched
+  operator() reuses the converted source paths instead of converting
+  each source polygon for every target cell it overlaps.
+*/
+void cache_source_paths() {
+  int nsrc = sourceMeshWrapper.num_entities(Entity_kind::CELL, Entity_type::ALL);
+  int ntgt = targetMeshWrapper.num_entities(Entity_kind::CELL, Entity_type::ALL);
+
+  std::vector<Poly> srcpolys(nsrc);
+  double max_size_poly = 0;
+  for (int c = 0; c < nsrc; c++) {
+    sourceMeshWrapper.cell_get_coordinates(c, &srcpolys[c]);
+    max_size_poly = IntersectClipper::updateMaxSize(srcpolys[c], max_size_poly);
+  }
+  for (int c = 0; c < ntgt; c++) {
+    Poly poly;
+    targetMeshWrapper.cell_get_coordinates(c, &poly);
+    max_size_poly = IntersectClipper::updateMaxSize(poly, max_size_poly);
+  }
+
+  auto paths = std::make_shared<std::vector<ClipperLib::Path>>(nsrc);
+  Portage::for_each(make_counting_iterator(0), make_counting_iterator(nsrc),
+                    [&](int c) {
+      (*paths)[c] = IntersectClipper::convertPoly2int(srcpolys[c], max_size_poly);
+    });
+
+  source_paths_ = paths;
+  max_size_poly_ = max_size_poly;
+}
+
+/*!
+  @brief Intersect a target cell with all its candidate source cells
+  @param[in] tgt_cell  target cell index
+  @param[in] src_cells candidate source cells
+  @return moments (area, first moments) of the intersection with each
+  source cell that overlaps the target cell
+
+  The target polygon is converted to integer coordinates once and a
+  single Clipper instance per thread is reused for all candidates. If
+  cache_source_paths() was called, the source paths are not
+  converted again either.
+*/
+std::vector<Weights_t> operator() (const int tgt_cell,
+                                   const std::vector<int>& src_cells) const {
+  int nsrc = src_cells.size();
+
+  Poly polyB;
+  targetMeshWrapper.cell_get_coordinates(tgt_cell, &polyB);
+
+  // Without cached source paths, find a common scaling for this batch
+  std::vector<Poly> polysA;
+  double max_size_poly = max_size_poly_;
+  if (!source_paths_) {
+    polysA.resize(nsrc);
+    max_size_poly = IntersectClipper::updateMaxSize(polyB, 0);
+    for (int i = 0; i < nsrc; i++) {
+      sourceMeshWrapper.cell_get_coordinates(src_cells[i], &polysA[i]);
+      max_size_poly = IntersectClipper::updateMaxSize(polysA[i], max_size_poly);
+    }
+  }
+
+  const ClipperLib::Path intPolyB = IntersectClipper::convertPoly2int(polyB, max_size_poly);
+
+  static thread_local ClipperLib::Clipper clpr;
+  ClipperLib::Paths solution;
+  ClipperLib::Path intPolyA;
+
+  std::vector<Weights_t> sources_and_weights;
+  sources_and_weights.reserve(nsrc);
+  for (int i = 0; i < nsrc; i++) {
+    if (!source_paths_)
+      intPolyA = IntersectClipper::convertPoly2int(polysA[i], max_size_poly);
+    ClipperLib::Path const& pathA =
+        source_paths_ ? (*source_paths_)[src_cells[i]] : intPolyA;
+
+    clpr.Clear();
+    clpr.AddPath(pathA, ClipperLib::ptSubject, true);
+    clpr.AddPath(intPolyB, ClipperLib::ptClip, true);
+    solution.clear();
+    clpr.Execute(ClipperLib::ctIntersection, solution,
+                 ClipperLib::pftEvenOdd, ClipperLib::pftEvenOdd);
+
+    std::vector<double> moments(3, 0.0);
+    Poly poly;
+    for (auto const &path : solution) {
+      poly.clear();
+      for (auto const &j : path)
+        poly.emplace_back(integer2real(j.X, max_size_poly),
+                          integer2real(j.Y, max_size_poly));
+      std::vector<double> pmoments = areaAndMomentPolygon(poly);
+      for (int k = 0; k < 3; k++)
+        moments[k] += pmoments[k];
+    }
+
+    if (moments[0] > 0.0) {
+      Weights_t wt;
+      wt.entityID = src_cells[i];
+      wt.weights = moments;
+      sources_and_weights.push_back(wt);
+    }
+  }
+  return sources_and_weights;
+}
+
 /*!
   @brief Intersect two cells and return the first two moments.
   @param[in] cellA first cell index to intersect
@@ -120,8 +230,9 @@ std::vector<std::vector<double> > operator() (const int cellA, const int cellB)
 /// Default constructor.
 IntersectClipper() {}
 
-/// Copy constructor (disabled)
-IntersectClipper(const IntersectClipper &) = delete;
+/// Copy constructor (copies share any cached source paths; needed
+/// to hand the batched operator to Portage::transform)
+IntersectClipper(const IntersectClipper &) = default;
 
 /// Assignment operator (disabled)
 IntersectClipper & operator = (const IntersectClipper &) = delete;
@@ -130,7 +241,7 @@ IntersectClipper & operator = (const IntersectClipper &) = delete;
 private:
 
 //We must use the same max size for all the polygons, so the number we are looking for is the maximum value in the set--all the X and Y values will be converted using this value
-static double updateMaxSize( const std::vector<Wonton::Point<2>> poly, double max_size_poly){
+static double updateMaxSize(const std::vector<Wonton::Point<2>>& poly, double max_size_poly){
   for(auto const &i: poly){
     double m = std::max(std::abs(i[0]), std::abs(i[1]));
     if (m > max_size_poly) max_size_poly = m;
@@ -174,9 +285,9 @@ static double integer2real(long a, const double max_size){
 }
 
 //Convert an entire polygon (specifiied as a std::vector<Wonton::Point>) to a std::vector<IntPoint>
-static std::vector<ClipperLib::IntPoint> convertPoly2int(std::vector<Wonton::Point<2>> poly, double max_size_poly){
+static std::vector<ClipperLib::IntPoint> convertPoly2int(const std::vector<Wonton::Point<2>>& poly, double max_size_poly){
   std::vector<ClipperLib::IntPoint> intpoly(poly.size());
-  std::transform(poly.begin(), poly.end(), intpoly.begin(), [max_size_poly](Wonton::Point<2> point){
+  std::transform(poly.begin(), poly.end(), intpoly.begin(), [max_size_poly](Wonton::Point<2> const& point){
       return ClipperLib::IntPoint(real2integer(point[0], max_size_poly), real2integer(point[1], max_size_poly));});
   return intpoly;
 }
@@ -185,6 +296,11 @@ private:
 const SourceMeshType &sourceMeshWrapper;
 const TargetMeshType &targetMeshWrapper;
 
+// Source cells converted to integer paths with the common scaling
+// max_size_poly_ (see cache_source_paths)
+std::shared_ptr<std::vector<ClipperLib::Path>> source_paths_;
+double max_size_poly_ = 0;
+
 };  // class IntersectClipper
 
 }  // namespace Portage
@@ -35,6 +35,37 @@ TEST(intersectClipper, simple){
   ASSERT_EQ(moments[0][2], 1.5);
 }
 
+/*!
+ * @brief Intersect one target cell with all cells of a 2x2 source mesh
+ * in a single batched call, with and without cached source paths.
+ * The target (1,1)-(2,2) exactly covers the upper right source cell.
+ */
+TEST(intersectClipper, batched){
+  Jali::MeshFactory mf(MPI_COMM_WORLD);
+  std::shared_ptr<Jali::Mesh> sm = mf(0, 0, 2, 2, 2, 2);
+  std::shared_ptr<Jali::Mesh> tm = mf(1, 1, 2, 2, 1, 1);
+  Wonton::Jali_Mesh_Wrapper s(*sm);
+  Wonton::Jali_Mesh_Wrapper t(*tm);
+  Portage::IntersectClipper<Wonton::Jali_Mesh_Wrapper> isect{s, t};
+
+  std::vector<int> srccells({0, 1, 2, 3});
+  for (int pass = 0; pass < 2; pass++) {
+    if (pass == 1) isect.cache_source_paths();
+
+    std::vector<Portage::Weights_t> srcwts = isect(0, srccells);
+    ASSERT_EQ(1, srcwts.size());
+
+    Wonton::Point<2> cen;
+    s.cell_centroid(srcwts[0].entityID, &cen);
+    ASSERT_NEAR(cen[0], 1.5, 1.0e-12);
+    ASSERT_NEAR(cen[1], 1.5, 1.0e-12);
+
+    ASSERT_NEAR(srcwts[0].weights[0], 1, 1.0e-12);
+    ASSERT_NEAR(srcwts[0].weights[1], 1.5, 1.0e-12);
+    ASSERT_NEAR(srcwts[0].weights[2], 1.5, 1.0e-12);
+  }
+}
+
 //@todo Figure out a way to convert this older test to an intersection test in the current framework
 // TEST(intersectClipper, convex){
 //   std::vector<JaliGeometry::Point> cellA, cellB;
@@ -0,0 +1,90 @@
+/*
+This file is part of the Ristra portage project.
+Please see the license file at the root of this repository, or at:
+    https://github.com/laristra/portage/blob/master/LICENSE
+*/
+
+#ifndef PORTAGE_INTERSECT_INTERSECT_BOXES_H_
+#define PORTAGE_INTERSECT_INTERSECT_BOXES_H_
+
+#include <vector>
+#include <algorithm>
+#include <limits>
+
+#include "wonton/support/Point.h"
+
+namespace Portage {
+
+using Wonton::Point;
+
+/*!
+  @brief Compute the axis-aligned bounding box of a set of points
+  @param[in] points  Points whose bounding box we want
+  @param[out] pmin   Lower corner of the bounding box
+  @param[out] pmax   Upper corner of the bounding box
+*/
+template <int D>
+inline
+void get_bounding_box(std::vector<Point<D>> const& points,
+                      Point<D> *pmin, Point<D> *pmax) {
+  for (int k = 0; k < D; k++) {
+    (*pmin)[k] = std::numeric_limits<double>::max();
+    (*pmax)[k] = -std::numeric_limits<double>::max();
+  }
+  for (auto const& p : points)
+    for (int k = 0; k < D; k++) {
+      (*pmin)[k] = std::min((*pmin)[k], p[k]);
+      (*pmax)[k] = std::max((*pmax)[k], p[k]);
+    }
+}
+
+/*!
+  @brief Intersect two axis-aligned boxes analytically
+  @param[in] amin, amax  Lower and upper corners of the first box
+  @param[in] bmin, bmax  Lower and upper corners of the second box
+  @param[in] order       Highest degree of moments to compute (1 or 2)
+  @return Moments of the intersection in the same layout as
+  intersect_polys_r2d/r3d (volume, first moments, then second moments
+  x^2, xy, ... if order is 2), or an empty vector if the boxes do not
+  overlap
+
+  This is exact only when both control volumes are boxes aligned with
+  the coordinate axes, e.g. cells or dual cells of rectangular meshes
+*/
+template <int D>
+inline
+std::vector<double> intersect_boxes(Point<D> const& amin, Point<D> const& amax,
+                                    Point<D> const& bmin, Point<D> const& bmax,
+                                    int order = 1) {
+  double lo[D], hi[D], cen[D];
+  double volume = 1.0;
+  for (int k = 0; k < D; k++) {
+    lo[k] = std::max(amin[k], bmin[k]);
+    hi[k] = std::min(amax[k], bmax[k]);
+    if (hi[k] <= lo[k])
+      return std::vector<double>();
+    volume *= (hi[k] - lo[k]);
+    cen[k] = 0.5*(lo[k] + hi[k]);
+  }
+
+  std::vector<double> moments(1 + D + (order > 1 ? D*(D+1)/2 : 0));
+  moments[0] = volume;
+  for (int k = 0; k < D; k++)
+    moments[k+1] = volume*cen[k];
+
+  if (order > 1) {
+    int n = D+1;
+    for (int j = 0; j < D; j++)
+      for (int k = j; k < D; k++) {
+        if (j == k)  // mean of x^2 over [lo,hi] is (lo^2 + lo*hi + hi^2)/3
+          moments[n++] = volume*(lo[j]*lo[j] + lo[j]*hi[j] + hi[j]*hi[j])/3.0;
+        else
+          moments[n++] = volume*cen[j]*cen[k];
+      }
+  }
+  return moments;
+}
+
+}  // namespace Portage
+
+#endif  // PORTAGE_INTERSECT_INTERSECT_BOXES_H_
@@ -23,19 +23,23 @@ namespace Portage {
 
 // intersect one source polygon (possibly non-convex) with a
 // triangular decomposition of a target polygon
+//
+// POLY_ORDER is the highest degree of the moments returned. All
+// R2D_NUM_MOMENTS(POLY_ORDER) moments are computed from the same clipped
+// polygon, ordered as 1, x, y, x^2, xy, y^2, ...
 
-inline
+template <int POLY_ORDER = 1>
 std::vector<double>
 intersect_polys_r2d(std::vector<Wonton::Point<2>> const & source_poly,
                     std::vector<Wonton::Point<2>> const & target_poly,
                     NumericTolerances_t num_tols) {
 
-  std::vector<double> moments(3, 0);
+  const int NUM_MOMENTS = R2D_NUM_MOMENTS(POLY_ORDER);
+
+  std::vector<double> moments(NUM_MOMENTS, 0);
   bool src_convex = true;
   bool trg_convex = true;
 
-  const int POLY_ORDER = 1;  // max degree of moments to calculate
-
   // Initialize source polygon
 
   const int size1 = source_poly.size();
@@ -88,8 +92,8 @@ intersect_polys_r2d(std::vector<Wonton::Point<2>> const & source_poly,
     // clip the first poly against the faces of the second
     r2d_clip(&srcpoly_r2d, &faces[0], size2);
 
-    // find the moments (up to quadratic order) of the clipped poly
-    r2d_real om[R2D_NUM_MOMENTS(POLY_ORDER)];
+    // find the moments (up to POLY_ORDER) of the clipped poly
+    r2d_real om[NUM_MOMENTS];
     r2d_reduce(&srcpoly_r2d, om, POLY_ORDER);
 
     // Check that the returned volume is positive (if the volume is zero,
@@ -99,7 +103,7 @@ intersect_polys_r2d(std::vector<Wonton::Point<2>> const & source_poly,
        throw std::runtime_error("Negative volume");
 
     // Copy moments:
-    for (int j = 0; j < 3; ++j)
+    for (int j = 0; j < NUM_MOMENTS; ++j)
       moments[j] = om[j];
 
   } else {  // case 2:  target_poly is non-convex
@@ -114,7 +118,7 @@ intersect_polys_r2d(std::vector<Wonton::Point<2>> const & source_poly,
     // call the routine with the polygons reversed
 
     if (src_convex)
-      return intersect_polys_r2d(target_poly, source_poly, num_tols);
+      return intersect_polys_r2d<POLY_ORDER>(target_poly, source_poly, num_tols);
     else {
 
       // Must divide target_poly into triangles for clipping.  Choice
@@ -161,8 +165,8 @@ intersect_polys_r2d(std::vector<Wonton::Point<2>> const & source_poly,
         // Have R2D compute first and second moments of polygon and
         // get its centroid from that
 
-        r2d_real fspoly_moments[R2D_NUM_MOMENTS(POLY_ORDER)];
-        r2d_reduce(&fspoly, fspoly_moments, POLY_ORDER);
+        r2d_real fspoly_moments[R2D_NUM_MOMENTS(1)];
+        r2d_reduce(&fspoly, fspoly_moments, 1);
 
         cen[0] = cenr2d.xy[0] = fspoly_moments[1]/fspoly_moments[0];
         cen[1] = cenr2d.xy[1] = fspoly_moments[2]/fspoly_moments[0];
@@ -197,13 +201,8 @@ intersect_polys_r2d(std::vector<Wonton::Point<2>> const & source_poly,
         // clip the first poly against the faces of the second
         r2d_clip(&srcpoly_r2d_copy, &faces[0], 3);
 
-        // find the moments (up to quadratic order) of the clipped poly
-        // Only do this check in Debug mode:
-#ifdef DEBUG
-        if (R2D_NUM_MOMENTS(POLY_ORDER) != 3)
-          throw std::runtime_error("Invalid number of moments");
-#endif
-        r2d_real om[R2D_NUM_MOMENTS(POLY_ORDER)];
+        // find the moments (up to POLY_ORDER) of the clipped poly
+        r2d_real om[NUM_MOMENTS];
         r2d_reduce(&srcpoly_r2d_copy, om, POLY_ORDER);
 
         // Check that the returned volume is positive (if the volume is zero,
@@ -213,7 +212,7 @@ intersect_polys_r2d(std::vector<Wonton::Point<2>> const & source_poly,
           throw std::runtime_error("Negative volume for triangle of polygon");
 
         // Accumulate moments:
-        for (int j = 0; j < 3; ++j)
+        for (int j = 0; j < NUM_MOMENTS; ++j)
           moments[j] += om[j];
       }  // for i
     }  // if (src_convex) ... else ...
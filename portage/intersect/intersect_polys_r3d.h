@@ -66,9 +66,13 @@ facetedpoly_t get_faceted_matpoly(const Tangram::MatPoly<3>& matpoly) {
 // Intersect one source polyhedron (possibly non-convex but with
 // triangular facets only) with a bunch of tets forming a target
 // polyhedron
+//
+// POLY_ORDER is the highest degree of the moments returned. All
+// R3D_NUM_MOMENTS(POLY_ORDER) moments are computed from the same
+// clipped polyhedra, ordered as 1, x, y, z, x^2, xy, xz, y^2, yz, z^2, ...
 
+template <int POLY_ORDER = 1>
 std::vector<double>
-inline
 intersect_polys_r3d(const facetedpoly_t &srcpoly,
                     const std::vector<std::array<Point<3>, 4>> &target_tet_coords,
                     NumericTolerances_t num_tols) {
@@ -158,7 +162,9 @@ intersect_polys_r3d(const facetedpoly_t &srcpoly,
 
   // Finished building source poly; now intersect with tets of target cell
 
-  std::vector<double> moments(4, 0);
+  const int NUM_MOMENTS = R3D_NUM_MOMENTS(POLY_ORDER);
+
+  std::vector<double> moments(NUM_MOMENTS, 0);
   for (auto const & target_cell_tet : target_tet_coords) {
     std::vector<r3d_plane> faces(4);
 
@@ -201,9 +207,8 @@ intersect_polys_r3d(const facetedpoly_t &srcpoly,
     r3d_poly src_r3dpoly_copy = src_r3dpoly;
     r3d_clip(&src_r3dpoly_copy, &faces[0], 4);
 
-    // find the moments (up to quadratic order) of the clipped poly
-    const int POLY_ORDER = 1;
-    r3d_real om[R3D_NUM_MOMENTS(POLY_ORDER)];
+    // find the moments (up to POLY_ORDER) of the clipped poly
+    r3d_real om[NUM_MOMENTS];
     r3d_reduce(&src_r3dpoly_copy, om, POLY_ORDER);
 
     // Check that the returned volume is positive (if the volume is
@@ -214,7 +219,7 @@ intersect_polys_r3d(const facetedpoly_t &srcpoly,
       throw std::runtime_error("Negative volume");
 
     // Accumulate moments:
-    for (int i = 0; i < 4; i++)
+    for (int i = 0; i < NUM_MOMENTS; i++)
       moments[i] += om[i];
   }
 
@@ -12,6 +12,8 @@ Please see the license file at the root of this repository, or at:
 #include <stdexcept>
 #include <vector>
 #include <algorithm>
+#include <cassert>
+#include <memory>
 
 // portage includes
 extern "C" {
@@ -20,6 +22,7 @@ extern "C" {
 #include "portage/support/portage.h"
 #include "portage/intersect/dummy_interface_reconstructor.h"
 #include "portage/intersect/intersect_polys_r2d.h"
+#include "portage/intersect/intersect_boxes.h"
 
 #ifdef HAVE_TANGRAM
 #include "tangram/driver/CellMatPoly.h"
@@ -58,10 +61,11 @@ class IntersectR2D {
                SourceStateType const & source_state,
                TargetMeshType const & target_mesh,
                NumericTolerances_t num_tols,
-               std::shared_ptr<InterfaceReconstructor2D> ir)
+               std::shared_ptr<InterfaceReconstructor2D> ir,
+               bool rectangular_mesh = false)
       : sourceMeshWrapper(source_mesh), sourceStateWrapper(source_state),
         targetMeshWrapper(target_mesh), interface_reconstructor(ir),
-        num_tols_(num_tols) {}
+        rectangular_mesh_(rectangular_mesh), num_tols_(num_tols) {}
 #endif
 
   /// Constructor WITHOUT interface reconstructor
@@ -69,16 +73,28 @@ class IntersectR2D {
   IntersectR2D(SourceMeshType const & source_mesh,
                SourceStateType const & source_state,
                TargetMeshType const & target_mesh,
-               NumericTolerances_t num_tols)
+               NumericTolerances_t num_tols,
+               bool rectangular_mesh = false)
       : sourceMeshWrapper(source_mesh), sourceStateWrapper(source_state),
-        targetMeshWrapper(target_mesh), num_tols_(num_tols) {}
+        targetMeshWrapper(target_mesh), rectangular_mesh_(rectangular_mesh),
+        num_tols_(num_tols) {}
 
   /// \brief Set the source mesh material that we have to intersect against
 
-  int set_material(int m) {
+  void set_material(int m) {
     matid_ = m;
   }
 
+  /// \brief Set the highest degree of the moments to compute (1 or 2)
+  ///
+  /// Second moments allow quadratic reconstructions (3rd order remap)
+  /// to be integrated exactly over the intersection
+
+  void set_moment_order(int order) {
+    assert(order == 1 || order == 2);
+    moment_order_ = order;
+  }
+
   /// \brief Intersect control volume of a target entity with control volumes of a set of source entities
   /// \param[in] tgt_entity  Entity of target mesh to intersect
   /// \param[in] src_entities Entities of source mesh to intersect against
@@ -99,7 +115,9 @@ class IntersectR2D {
   SourceMeshType const & sourceMeshWrapper;
   SourceStateType const & sourceStateWrapper;
   TargetMeshType const & targetMeshWrapper;
+  bool rectangular_mesh_;
   int matid_ = -1;
+  int moment_order_ = 1;
   NumericTolerances_t num_tols_;
 
 #ifdef HAVE_TANGRAM
@@ -134,10 +152,11 @@ class IntersectR2D<Entity_kind::CELL, SourceMeshType, SourceStateType, TargetMes
                SourceStateType const & source_state,
                TargetMeshType const & target_mesh,
                NumericTolerances_t num_tols,
-               std::shared_ptr<InterfaceReconstructor2D> ir)
+               std::shared_ptr<InterfaceReconstructor2D> ir,
+               bool rectangular_mesh = false)
       : sourceMeshWrapper(source_mesh), sourceStateWrapper(source_state),
         targetMeshWrapper(target_mesh), interface_reconstructor(ir),
-        num_tols_(num_tols) {}
+        rectangular_mesh_(rectangular_mesh), num_tols_(num_tols) {}
 #endif
 
   /// Constructor WITHOUT interface reconstructor
@@ -145,14 +164,34 @@ class IntersectR2D<Entity_kind::CELL, SourceMeshType, SourceStateType, TargetMes
   IntersectR2D(SourceMeshType const & source_mesh,
                SourceStateType const & source_state,
                TargetMeshType const & target_mesh,
-               NumericTolerances_t num_tols)
+               NumericTolerances_t num_tols,
+               bool rectangular_mesh = false)
       : sourceMeshWrapper(source_mesh), sourceStateWrapper(source_state),
-        targetMeshWrapper(target_mesh), num_tols_(num_tols) {}
+        targetMeshWrapper(target_mesh), rectangular_mesh_(rectangular_mesh),
+        num_tols_(num_tols) {}
 
   /// \brief Set the source mesh material that we have to intersect against
+  ///
+  /// When an interface reconstructor is available, the polygons of
+  /// material m in every mixed source cell are extracted here once and
+  /// cached so that they need not be recomputed for each target cell
+  /// that overlaps the source cell
 
-  int set_material(int m) {
+  void set_material(int m) {
     matid_ = m;
+#ifdef HAVE_TANGRAM
+    cache_material_polys();
+#endif
+  }
+
+  /// \brief Set the highest degree of the moments to compute (1 or 2)
+  ///
+  /// Second moments allow quadratic reconstructions (3rd order remap)
+  /// to be integrated exactly over the intersection
+
+  void set_moment_order(int order) {
+    assert(order == 1 || order == 2);
+    moment_order_ = order;
   }
 
   /// \brief Intersect target cell with a set of source cell
@@ -189,8 +228,7 @@ class IntersectR2D<Entity_kind::CELL, SourceMeshType, SourceStateType, TargetMes
         std::vector<Wonton::Point<2>> source_poly;
         sourceMeshWrapper.cell_get_coordinates(s, &source_poly);
 
-        this_wt.weights = intersect_polys_r2d(source_poly, target_poly,
-                                              num_tols_);
+        this_wt.weights = intersect_polys(source_poly, target_poly);
 
       } else {  // multi-material case
         // How can I check that I didn't get DummyInterfaceReconstructor
@@ -206,21 +244,13 @@ class IntersectR2D<Entity_kind::CELL, SourceMeshType, SourceStateType, TargetMes
           // polygon approximation of this material in the cell
           // (obtained from interface reconstruction)
 
-          Tangram::CellMatPoly<2> const& cellmatpoly =
-              interface_reconstructor->cell_matpoly_data(s);
-          std::vector<Tangram::MatPoly<2>> matpolys =
-              cellmatpoly.get_matpolys(matid_);
-
-          this_wt.weights.resize(3, 0.0);
-          for (int j = 0; j < matpolys.size(); j++) {
-            std::vector<Wonton::Point<2>> tpnts = matpolys[j].points();
-            std::vector<Wonton::Point<2>> source_poly;
-            source_poly.reserve(tpnts.size());
-            for (auto const & p : tpnts) source_poly.push_back(p);
-
-            std::vector<double> momvec = intersect_polys_r2d(source_poly,
-                                                  target_poly, num_tols_);
-            for (int k = 0; k < 3; k++)
+          std::vector<std::vector<Wonton::Point<2>>> const& source_polys =
+              (*matpolys_)[s];
+
+          this_wt.weights.assign(R2D_NUM_MOMENTS(moment_order_), 0.0);
+          for (auto const& source_poly : source_polys) {
+            std::vector<double> momvec = intersect_polys(source_poly, target_poly);
+            for (int k = 0; k < momvec.size(); k++)
               this_wt.weights[k] += momvec[k];
           }
         }
@@ -229,8 +259,7 @@ class IntersectR2D<Entity_kind::CELL, SourceMeshType, SourceStateType, TargetMes
       std::vector<Wonton::Point<2>> source_poly;
       sourceMeshWrapper.cell_get_coordinates(s, &source_poly);
 
-      this_wt.weights = intersect_polys_r2d(source_poly, target_poly,
-                                            num_tols_);
+      this_wt.weights = intersect_polys(source_poly, target_poly);
 #endif
 
       // Increment if vol of intersection > 0; otherwise, allow overwrite
@@ -251,11 +280,64 @@ class IntersectR2D<Entity_kind::CELL, SourceMeshType, SourceStateType, TargetMes
   SourceMeshType const & sourceMeshWrapper;
   SourceStateType const & sourceStateWrapper;
   TargetMeshType const & targetMeshWrapper;
+  bool rectangular_mesh_;
   int matid_ = -1;
+  int moment_order_ = 1;
   NumericTolerances_t num_tols_;
 
+  /// \brief Intersect two polygons computing moments up to moment_order_
+
+  std::vector<double>
+  intersect_polys(std::vector<Wonton::Point<2>> const& source_poly,
+                  std::vector<Wonton::Point<2>> const& target_poly) const {
+    return (moment_order_ == 2) ?
+        intersect_polys_r2d<2>(source_poly, target_poly, num_tols_) :
+        intersect_polys_r2d<1>(source_poly, target_poly, num_tols_);
+  }
+
 #ifdef HAVE_TANGRAM
   std::shared_ptr<InterfaceReconstructor2D> interface_reconstructor;
+
+  // Polygons of the current material in each source cell (empty for
+  // cells that are pure or do not contain the material). Held through
+  // a shared pointer so that copies of this functor made by the
+  // parallel transform share one read-only cache
+  std::shared_ptr<std::vector<std::vector<std::vector<Wonton::Point<2>>>>>
+  matpolys_;
+
+  /// \brief Extract the matpolys of material matid_ in all mixed source cells
+
+  void cache_material_polys() {
+    matpolys_.reset();
+    if (matid_ == -1 || !interface_reconstructor)
+      return;
+
+    int ncells = sourceMeshWrapper.num_entities(Entity_kind::CELL,
+                                                Entity_type::ALL);
+    auto matpolys = std::make_shared<
+      std::vector<std::vector<std::vector<Wonton::Point<2>>>>>(ncells);
+
+    std::vector<int> matcells;
+    sourceStateWrapper.mat_get_cells(matid_, &matcells);
+
+    Portage::for_each(matcells.begin(), matcells.end(),
+                      [this, &matpolys](int s) {
+      if (sourceStateWrapper.cell_get_num_mats(s) < 2)
+        return;
+
+      Tangram::CellMatPoly<2> const& cellmatpoly =
+          interface_reconstructor->cell_matpoly_data(s);
+      std::vector<Tangram::MatPoly<2>> cellpolys =
+          cellmatpoly.get_matpolys(matid_);
+
+      auto& source_polys = (*matpolys)[s];
+      source_polys.reserve(cellpolys.size());
+      for (auto const& matpoly : cellpolys)
+        source_polys.push_back(matpoly.points());
+    });
+
+    matpolys_ = matpolys;
+  }
 #endif
 };  // class IntersectR2D
 
@@ -287,10 +369,11 @@ class IntersectR2D<Entity_kind::NODE, SourceMeshType, SourceStateType, TargetMes
                SourceStateType const & source_state,
                TargetMeshType const & target_mesh,
                NumericTolerances_t num_tols,
-               std::shared_ptr<InterfaceReconstructor2D> ir)
+               std::shared_ptr<InterfaceReconstructor2D> ir,
+               bool rectangular_mesh = false)
       : sourceMeshWrapper(source_mesh), sourceStateWrapper(source_state),
         targetMeshWrapper(target_mesh), interface_reconstructor(ir),
-        num_tols_(num_tols) {}
+        rectangular_mesh_(rectangular_mesh), num_tols_(num_tols) {}
 #endif
 
 
@@ -299,16 +382,28 @@ class IntersectR2D<Entity_kind::NODE, SourceMeshType, SourceStateType, TargetMes
   IntersectR2D(SourceMeshType const & source_mesh,
                SourceStateType const & source_state,
                TargetMeshType const & target_mesh,
-               NumericTolerances_t num_tols)
+               NumericTolerances_t num_tols,
+               bool rectangular_mesh = false)
       : sourceMeshWrapper(source_mesh), sourceStateWrapper(source_state),
-        targetMeshWrapper(target_mesh), num_tols_(num_tols) {}
+        targetMeshWrapper(target_mesh), rectangular_mesh_(rectangular_mesh),
+        num_tols_(num_tols) {}
 
   /// \brief Set the source mesh material that we have to intersect against
 
-  int set_material(int m) {
+  void set_material(int m) {
     matid_ = m;
   }
 
+  /// \brief Set the highest degree of the moments to compute (1 or 2)
+  ///
+  /// Second moments allow quadratic reconstructions (3rd order remap)
+  /// to be integrated exactly over the intersection
+
+  void set_moment_order(int order) {
+    assert(order == 1 || order == 2);
+    moment_order_ = order;
+  }
+
   /// \brief Intersect control volume of a target node with control volumes of
   /// a set of source nodes
   /// \param[in] tgt_node  Target mesh node whose control volume we consider
@@ -320,6 +415,12 @@ class IntersectR2D<Entity_kind::NODE, SourceMeshType, SourceStateType, TargetMes
     std::vector<Wonton::Point<2>> target_poly;
     targetMeshWrapper.dual_cell_get_coordinates(tgt_node, &target_poly);
 
+    // Dual cells of a rectangular mesh are axis-aligned boxes which we
+    // can intersect analytically instead of clipping the polygons
+    Wonton::Point<2> tgtmin, tgtmax;
+    if (rectangular_mesh_)
+      get_bounding_box<2>(target_poly, &tgtmin, &tgtmax);
+
     int nsrc = src_nodes.size();
     std::vector<Weights_t> sources_and_weights(nsrc);
     int ninserted = 0;
@@ -330,8 +431,13 @@ class IntersectR2D<Entity_kind::NODE, SourceMeshType, SourceStateType, TargetMes
 
       Weights_t & this_wt = sources_and_weights[ninserted];
       this_wt.entityID = s;
-      this_wt.weights = intersect_polys_r2d(source_poly, target_poly,
-                                            num_tols_);
+      if (rectangular_mesh_) {
+        Wonton::Point<2> srcmin, srcmax;
+        get_bounding_box<2>(source_poly, &srcmin, &srcmax);
+        this_wt.weights = intersect_boxes<2>(srcmin, srcmax, tgtmin, tgtmax,
+                                             moment_order_);
+      } else
+        this_wt.weights = intersect_polys(source_poly, target_poly);
 
       // Increment if vol of intersection > 0; otherwise, allow overwrite
       if (this_wt.weights.size() && this_wt.weights[0] > 0.0)
@@ -352,9 +458,21 @@ class IntersectR2D<Entity_kind::NODE, SourceMeshType, SourceStateType, TargetMes
   SourceMeshType const & sourceMeshWrapper;
   SourceStateType const & sourceStateWrapper;
   TargetMeshType const & targetMeshWrapper;
+  bool rectangular_mesh_;
   int matid_ = -1;
+  int moment_order_ = 1;
   NumericTolerances_t num_tols_;
 
+  /// \brief Intersect two polygons computing moments up to moment_order_
+
+  std::vector<double>
+  intersect_polys(std::vector<Wonton::Point<2>> const& source_poly,
+                  std::vector<Wonton::Point<2>> const& target_poly) const {
+    return (moment_order_ == 2) ?
+        intersect_polys_r2d<2>(source_poly, target_poly, num_tols_) :
+        intersect_polys_r2d<1>(source_poly, target_poly, num_tols_);
+  }
+
 #ifdef HAVE_TANGRAM
   std::shared_ptr<InterfaceReconstructor2D> interface_reconstructor;
 #endif
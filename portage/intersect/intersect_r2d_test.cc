@@ -56,3 +56,89 @@ TEST(intersectR2D, simple1) {
   ASSERT_NEAR(moments[1], 1.5, eps);
   ASSERT_NEAR(moments[2], 1.5, eps);
 }
+
+/*!
+ * @brief Intersect dual cells of nodes on two rectangular meshes with
+ * and without the rectangular mesh fast path and check that both give
+ * the same moments for every pair of target and source nodes.
+ */
+TEST(intersectR2D, rectangular_dual_cells) {
+  auto sourcemesh = std::make_shared<Wonton::Simple_Mesh>(0, 0, 2, 2, 2, 2);
+  auto targetmesh = std::make_shared<Wonton::Simple_Mesh>(0.5, 0.5, 2.5, 2.5,
+                                                          3, 3);
+  auto sourcestate = std::make_shared<Wonton::Simple_State>(sourcemesh);
+  const Wonton::Simple_Mesh_Wrapper sm(*sourcemesh);
+  const Wonton::Simple_Mesh_Wrapper tm(*targetmesh);
+  const Wonton::Simple_State_Wrapper ss(*sourcestate);
+
+  Portage::NumericTolerances_t num_tols;
+  num_tols.use_default();
+
+  using Intersector =
+      Portage::IntersectR2D<Portage::Entity_kind::NODE,
+                            Wonton::Simple_Mesh_Wrapper,
+                            Wonton::Simple_State_Wrapper,
+                            Wonton::Simple_Mesh_Wrapper>;
+  Intersector isect_general{sm, ss, tm, num_tols};
+  Intersector isect_rect{sm, ss, tm, num_tols, true};
+
+  std::vector<int> srcnodes(sm.num_owned_nodes());
+  for (int i = 0; i < srcnodes.size(); i++) srcnodes[i] = i;
+
+  double eps = 1.0e-12;
+  for (int t = 0; t < tm.num_owned_nodes(); t++) {
+    // moments of each source node, zero if it does not intersect
+    std::vector<std::vector<double>> general(srcnodes.size(),
+                                             std::vector<double>(3, 0.0));
+    std::vector<std::vector<double>> rect(general);
+    for (auto const& wt : isect_general(t, srcnodes))
+      general[wt.entityID] = wt.weights;
+    for (auto const& wt : isect_rect(t, srcnodes))
+      rect[wt.entityID] = wt.weights;
+
+    for (int s = 0; s < srcnodes.size(); s++) {
+      ASSERT_EQ(general[s].size(), rect[s].size());
+      for (int k = 0; k < 3; k++)
+        ASSERT_NEAR(general[s][k], rect[s][k], eps);
+    }
+  }
+}
+
+/*!
+ * @brief Intersect the same cells as in simple1 but also ask for second
+ * moments. Over [1,2]x[1,2] the integrals of x^2, xy and y^2 are 7/3,
+ * 9/4 and 7/3.
+ */
+TEST(intersectR2D, second_moments) {
+  auto sourcemesh = std::make_shared<Wonton::Simple_Mesh>(0, 0, 2, 2, 1, 1);
+  auto targetmesh = std::make_shared<Wonton::Simple_Mesh>(1, 1, 2, 2, 1, 1);
+  auto sourcestate = std::make_shared<Wonton::Simple_State>(sourcemesh);
+  const Wonton::Simple_Mesh_Wrapper sm(*sourcemesh);
+  const Wonton::Simple_Mesh_Wrapper tm(*targetmesh);
+  const Wonton::Simple_State_Wrapper ss(*sourcestate);
+
+  Portage::NumericTolerances_t num_tols;
+  num_tols.use_default();
+
+  Portage::IntersectR2D<Portage::Entity_kind::CELL,
+                        Wonton::Simple_Mesh_Wrapper,
+                        Wonton::Simple_State_Wrapper,
+                        Wonton::Simple_Mesh_Wrapper>
+      isect{sm, ss, tm, num_tols};
+  isect.set_moment_order(2);
+
+  std::vector<int> srccells({0});
+
+  std::vector<Portage::Weights_t> srcwts = isect(0, srccells);
+  ASSERT_EQ(1, srcwts.size());
+  std::vector<double> moments = srcwts[0].weights;
+  ASSERT_EQ(6, moments.size());
+
+  double eps = 1.0e-12;
+  ASSERT_NEAR(moments[0], 1, eps);
+  ASSERT_NEAR(moments[1], 1.5, eps);
+  ASSERT_NEAR(moments[2], 1.5, eps);
+  ASSERT_NEAR(moments[3], 7.0/3.0, eps);
+  ASSERT_NEAR(moments[4], 2.25, eps);
+  ASSERT_NEAR(moments[5], 7.0/3.0, eps);
+}
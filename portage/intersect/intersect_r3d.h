@@ -11,6 +11,8 @@ Please see the license file at the root of this repository, or at:
 #include <stdexcept>
 #include <vector>
 #include <algorithm>
+#include <cassert>
+#include <memory>
 
 // portage includes
 extern "C" {
@@ -19,6 +21,7 @@ extern "C" {
 #include "portage/support/portage.h"
 #include "portage/intersect/dummy_interface_reconstructor.h"
 #include "portage/intersect/intersect_polys_r3d.h"
+#include "portage/intersect/intersect_boxes.h"
 
 #ifdef HAVE_TANGRAM
 #include "tangram/driver/CellMatPoly.h"
@@ -89,10 +92,20 @@ class IntersectR3D {
 
   /// \brief Set the source mesh material that we have to intersect against
 
-  int set_material(int m) {
+  void set_material(int m) {
     matid_ = m;
   }
 
+  /// \brief Set the highest degree of the moments to compute (1 or 2)
+  ///
+  /// Second moments allow quadratic reconstructions (3rd order remap)
+  /// to be integrated exactly over the intersection
+
+  void set_moment_order(int order) {
+    assert(order == 1 || order == 2);
+    moment_order_ = order;
+  }
+
   /// \brief Intersect a control volume of a target_entity with control volumes of a set of source entities
   /// \param[in] tgt_entity Entity of target mesh to intersect
   /// \param[in] src_entities Entity of source cells to intersect against
@@ -117,6 +130,7 @@ class IntersectR3D {
   TargetMeshType const & targetMeshWrapper;
   bool rectangular_mesh_;
   int matid_ = -1;
+  int moment_order_ = 1;
   NumericTolerances_t num_tols_;
 
 #ifdef HAVE_TANGRAM
@@ -170,9 +184,27 @@ class IntersectR3D<Entity_kind::CELL, SourceMeshType, SourceStateType, TargetMes
 
 
   /// \brief Set the source mesh material that we have to intersect against
+  ///
+  /// When an interface reconstructor is available, the faceted
+  /// polyhedra of material m in every mixed source cell are computed
+  /// here once and cached so that they need not be recomputed for each
+  /// target cell that overlaps the source cell
 
-  int set_material(int m) {
+  void set_material(int m) {
     matid_ = m;
+#ifdef HAVE_TANGRAM
+    cache_material_polys();
+#endif
+  }
+
+  /// \brief Set the highest degree of the moments to compute (1 or 2)
+  ///
+  /// Second moments allow quadratic reconstructions (3rd order remap)
+  /// to be integrated exactly over the intersection
+
+  void set_moment_order(int order) {
+    assert(order == 1 || order == 2);
+    moment_order_ = order;
   }
 
   /// \brief Intersect a cell with a set of candidate cells
@@ -218,8 +250,7 @@ class IntersectR3D<Entity_kind::CELL, SourceMeshType, SourceStateType, TargetMes
         sourceMeshWrapper.cell_get_facetization(s, &srcpoly.facetpoints,
                                                 &srcpoly.points);
 
-        this_wt.weights = intersect_polys_r3d(srcpoly, target_tet_coords,
-                                              num_tols_);
+        this_wt.weights = intersect_polys(srcpoly, target_tet_coords);
 
       } else if (std::find(cellmats.begin(), cellmats.end(), matid_) !=
                  cellmats.end()) {
@@ -227,18 +258,12 @@ class IntersectR3D<Entity_kind::CELL, SourceMeshType, SourceStateType, TargetMes
         // polygon approximation of this material in the cell
         // (obtained from interface reconstruction)
 
-        Tangram::CellMatPoly<3> const& cellmatpoly =
-            interface_reconstructor->cell_matpoly_data(s);
-        std::vector<Tangram::MatPoly<3>> matpolys =
-            cellmatpoly.get_matpolys(matid_);
-
-        this_wt.weights.resize(4,0.0);
-        for (int j = 0; j < matpolys.size(); j++) {
-          facetedpoly_t srcpoly = get_faceted_matpoly(matpolys[j]);
+        std::vector<facetedpoly_t> const& srcpolys = (*matpolys_)[s];
 
-          std::vector<double> momvec = intersect_polys_r3d(srcpoly,
-                                          target_tet_coords, num_tols_);
-          for (int k = 0; k < 4; k++)
+        this_wt.weights.assign(R3D_NUM_MOMENTS(moment_order_), 0.0);
+        for (auto const& srcpoly : srcpolys) {
+          std::vector<double> momvec = intersect_polys(srcpoly, target_tet_coords);
+          for (int k = 0; k < momvec.size(); k++)
             this_wt.weights[k] += momvec[k];
         }
 
@@ -248,8 +273,7 @@ class IntersectR3D<Entity_kind::CELL, SourceMeshType, SourceStateType, TargetMes
       sourceMeshWrapper.cell_get_facetization(s, &srcpoly.facetpoints,
                                               &srcpoly.points);
 
-      this_wt.weights = intersect_polys_r3d(srcpoly, target_tet_coords,
-                                            num_tols_);
+      this_wt.weights = intersect_polys(srcpoly, target_tet_coords);
 #endif
       // Increment if vol of intersection > 0; otherwise, allow overwrite
       if (this_wt.weights.size() && this_wt.weights[0] > 0.0)
@@ -272,10 +296,61 @@ class IntersectR3D<Entity_kind::CELL, SourceMeshType, SourceStateType, TargetMes
   TargetMeshType const & targetMeshWrapper;
   bool rectangular_mesh_;
   int matid_ = -1;
+  int moment_order_ = 1;
   NumericTolerances_t num_tols_;
 
+  /// \brief Intersect a faceted polyhedron with a tet decomposition
+  /// computing moments up to moment_order_
+
+  std::vector<double>
+  intersect_polys(facetedpoly_t const& srcpoly,
+                  std::vector<std::array<Point<3>, 4>> const& tets) const {
+    return (moment_order_ == 2) ?
+        intersect_polys_r3d<2>(srcpoly, tets, num_tols_) :
+        intersect_polys_r3d<1>(srcpoly, tets, num_tols_);
+  }
+
 #ifdef HAVE_TANGRAM
   std::shared_ptr<InterfaceReconstructor3D> interface_reconstructor;
+
+  // Faceted polyhedra of the current material in each source cell
+  // (empty for cells that are pure or do not contain the material).
+  // Held through a shared pointer so that copies of this functor made
+  // by the parallel transform share one read-only cache
+  std::shared_ptr<std::vector<std::vector<facetedpoly_t>>> matpolys_;
+
+  /// \brief Facetize the matpolys of material matid_ in all mixed source cells
+
+  void cache_material_polys() {
+    matpolys_.reset();
+    if (matid_ == -1 || !interface_reconstructor)
+      return;
+
+    int ncells = sourceMeshWrapper.num_entities(Entity_kind::CELL,
+                                                Entity_type::ALL);
+    auto matpolys = std::make_shared<std::vector<std::vector<facetedpoly_t>>>(ncells);
+
+    std::vector<int> matcells;
+    sourceStateWrapper.mat_get_cells(matid_, &matcells);
+
+    Portage::for_each(matcells.begin(), matcells.end(),
+                      [this, &matpolys](int s) {
+      if (sourceStateWrapper.cell_get_num_mats(s) < 2)
+        return;
+
+      Tangram::CellMatPoly<3> const& cellmatpoly =
+          interface_reconstructor->cell_matpoly_data(s);
+      std::vector<Tangram::MatPoly<3>> cellpolys =
+          cellmatpoly.get_matpolys(matid_);
+
+      std::vector<facetedpoly_t>& srcpolys = (*matpolys)[s];
+      srcpolys.reserve(cellpolys.size());
+      for (auto const& matpoly : cellpolys)
+        srcpolys.push_back(get_faceted_matpoly(matpoly));
+    });
+
+    matpolys_ = matpolys;
+  }
 #endif
 };
 
@@ -325,10 +400,20 @@ class IntersectR3D<Entity_kind::NODE, SourceMeshType, SourceStateType, TargetMes
 
   /// \brief Set the source mesh material that we have to intersect against
 
-  int set_material(int m) {
+  void set_material(int m) {
     matid_ = m;
   }
 
+  /// \brief Set the highest degree of the moments to compute (1 or 2)
+  ///
+  /// Second moments allow quadratic reconstructions (3rd order remap)
+  /// to be integrated exactly over the intersection
+
+  void set_moment_order(int order) {
+    assert(order == 1 || order == 2);
+    moment_order_ = order;
+  }
+
   /// \brief Intersect a control volume corresponding to a target node
   /// with a set of control volumes corresponding to candidate source
   /// nodes
@@ -340,23 +425,46 @@ class IntersectR3D<Entity_kind::NODE, SourceMeshType, SourceStateType, TargetMes
   std::vector<Weights_t> operator() (const int tgt_node,
                                      const std::vector<int> src_nodes) const {
 
-    // for debug
-    Point<3> tgtxyz;
-    targetMeshWrapper.node_get_coordinates(tgt_node, &tgtxyz);
+    int nsrc = src_nodes.size();
+    std::vector<Weights_t> sources_and_weights(nsrc);
+    int ninserted = 0;
+
+    // Dual cells of a rectangular mesh are axis-aligned boxes, so we
+    // can skip the facetization, the wedge decomposition and the
+    // clipping entirely and intersect their bounding boxes analytically
 
-    std::vector<std::array<Point<3>, 4>> target_tet_coords;
+    if (rectangular_mesh_) {
+      std::vector<Point<3>> tgtpoints;
+      targetMeshWrapper.dual_cell_get_coordinates(tgt_node, &tgtpoints);
+      Point<3> tgtmin, tgtmax;
+      get_bounding_box<3>(tgtpoints, &tgtmin, &tgtmax);
 
-    // We should avoid any decomposition for duall cells of a
-    // rectangular mesh but for now we will decompose the target all
-    // the time
+      std::vector<Point<3>> srcpoints;
+      for (int i = 0; i < nsrc; i++) {
+        int s = src_nodes[i];
 
-    targetMeshWrapper.dual_wedges_get_coordinates(tgt_node, &target_tet_coords);
+        srcpoints.clear();
+        sourceMeshWrapper.dual_cell_get_coordinates(s, &srcpoints);
+        Point<3> srcmin, srcmax;
+        get_bounding_box<3>(srcpoints, &srcmin, &srcmax);
+
+        Weights_t & this_wt = sources_and_weights[ninserted];
+        this_wt.entityID = s;
+        this_wt.weights = intersect_boxes<3>(srcmin, srcmax, tgtmin, tgtmax,
+                                             moment_order_);
 
+        if (this_wt.weights.size() && this_wt.weights[0] > 0.0)
+          ninserted++;
+      }
+
+      sources_and_weights.resize(ninserted);
+      return sources_and_weights;
+    }
+
+    std::vector<std::array<Point<3>, 4>> target_tet_coords;
+    targetMeshWrapper.dual_wedges_get_coordinates(tgt_node, &target_tet_coords);
 
     // CAN MAKE THIS INTO A THRUST TRANSFORM CALL
-    int nsrc = src_nodes.size();
-    std::vector<Weights_t> sources_and_weights(nsrc);
-    int ninserted = 0;
     for (int i = 0; i < nsrc; i++) {
       int s = src_nodes[i];
 
@@ -366,8 +474,7 @@ class IntersectR3D<Entity_kind::NODE, SourceMeshType, SourceStateType, TargetMes
 
       Weights_t & this_wt = sources_and_weights[ninserted];
       this_wt.entityID = s;
-      this_wt.weights = intersect_polys_r3d(srcpoly, target_tet_coords,
-                                            num_tols_);
+      this_wt.weights = intersect_polys(srcpoly, target_tet_coords);
 
       // Increment if vol of intersection > 0; otherwise, allow overwrite
       if (this_wt.weights.size() && this_wt.weights[0] > 0.0)
@@ -390,8 +497,20 @@ class IntersectR3D<Entity_kind::NODE, SourceMeshType, SourceStateType, TargetMes
   TargetMeshType const & targetMeshWrapper;
   bool rectangular_mesh_;
   int matid_ = -1;
+  int moment_order_ = 1;
   NumericTolerances_t num_tols_;
 
+  /// \brief Intersect a faceted polyhedron with a tet decomposition
+  /// computing moments up to moment_order_
+
+  std::vector<double>
+  intersect_polys(facetedpoly_t const& srcpoly,
+                  std::vector<std::array<Point<3>, 4>> const& tets) const {
+    return (moment_order_ == 2) ?
+        intersect_polys_r3d<2>(srcpoly, tets, num_tols_) :
+        intersect_polys_r3d<1>(srcpoly, tets, num_tols_);
+  }
+
 #ifdef HAVE_TANGRAM
   std::shared_ptr<InterfaceReconstructor3D> interface_reconstructor;
 #endif
@@ -433,3 +433,49 @@ TEST(intersectR3D, cube_0_1) {
     ASSERT_NEAR(moments[3], 0, eps);
   }
 }
+
+// intersect dual cells of nodes on two rectangular meshes with and
+// without the rectangular mesh fast path and check that both give the
+// same moments for every pair of target and source nodes
+TEST(intersectR3D, rectangular_dual_cells) {
+
+  auto sourcemesh = std::make_shared<Wonton::Simple_Mesh>(0, 0, 0, 2, 2, 2, 2, 2, 2);
+  auto targetmesh = std::make_shared<Wonton::Simple_Mesh>(0.5, 0.5, 0.5, 2.5, 2.5, 2.5, 3, 3, 3);
+  const Wonton::Simple_Mesh_Wrapper sm(*sourcemesh);
+  const Wonton::Simple_Mesh_Wrapper tm(*targetmesh);
+
+  auto sourcestate = std::make_shared<Wonton::Simple_State>(sourcemesh);
+  const Wonton::Simple_State_Wrapper ss(*sourcestate);
+
+  const double eps = 1e-12;
+
+  Portage::NumericTolerances_t num_tols;
+  num_tols.use_default();
+
+  using Intersector = Portage::IntersectR3D<Portage::Entity_kind::NODE,
+                                            Wonton::Simple_Mesh_Wrapper,
+                                            Wonton::Simple_State_Wrapper,
+                                            Wonton::Simple_Mesh_Wrapper>;
+  const Intersector isect_general{sm, ss, tm, num_tols};
+  const Intersector isect_rect{sm, ss, tm, num_tols, true};
+
+  std::vector<int> srcnodes(sm.num_owned_nodes());
+  for (int i = 0; i < srcnodes.size(); i++) srcnodes[i] = i;
+
+  for (int t = 0; t < tm.num_owned_nodes(); t++) {
+    // moments of each source node, zero if it does not intersect
+    std::vector<std::vector<double>> general(srcnodes.size(),
+                                             std::vector<double>(4, 0.0));
+    std::vector<std::vector<double>> rect(general);
+    for (auto const& wt : isect_general(t, srcnodes))
+      general[wt.entityID] = wt.weights;
+    for (auto const& wt : isect_rect(t, srcnodes))
+      rect[wt.entityID] = wt.weights;
+
+    for (int s = 0; s < srcnodes.size(); s++) {
+      ASSERT_EQ(general[s].size(), rect[s].size());
+      for (int k = 0; k < 4; k++)
+        ASSERT_NEAR(general[s][k], rect[s][k], eps);
+    }
+  }
+}
@@ -0,0 +1,132 @@
+/*
+This file is part of the Ristra portage project.
+Please see the license file at the root of this repository, or at:
+    https://github.com/laristra/portage/blob/master/LICENSE
+*/
+
+#ifndef PORTAGE_SUPPORT_MESH_ADJACENCY_H_
+#define PORTAGE_SUPPORT_MESH_ADJACENCY_H_
+
+#include <memory>
+#include <numeric>
+#include <vector>
+
+#include "portage/support/portage.h"
+
+/*!
+  @file mesh_adjacency.h
+  @brief Neighbor lists of mesh entities in compressed (CSR) form.
+
+  Gradient and quadfit reconstructions and the mismatch fixup all walk
+  the neighbors of mesh entities. Querying the mesh wrapper for them is
+  expensive and storing them as a vector of vectors costs one
+  allocation per entity, so the lists are gathered once per mesh into
+  two flat arrays and shared read-only by everyone who needs them.
+ */
+
+namespace Portage {
+
+/*!
+  @class MeshAdjacency
+  @brief Read-only neighbor lists of all entities of one kind
+*/
+class MeshAdjacency {
+ public:
+
+  /// Lightweight view of the neighbors of one entity
+  struct Neighbors {
+    int const *first;
+    int const *last;
+
+    int const* begin() const { return first; }
+    int const* end() const { return last; }
+    int size() const { return last - first; }
+    bool empty() const { return first == last; }
+    int operator[](int i) const { return first[i]; }
+  };
+
+  /// Default constructor (no entities)
+  MeshAdjacency() : offsets_(1, 0) {}
+
+  /*!
+    @brief Gather the neighbor lists of entities 0 to nentities-1
+    @param[in] nentities      Number of entities
+    @param[in] get_neighbors  Functor (int, std::vector<int>*) filling in
+                              the neighbors of an entity
+  */
+  template <class GetNeighbors>
+  MeshAdjacency(int nentities, GetNeighbors get_neighbors) {
+    std::vector<std::vector<int>> lists(nentities);
+    Portage::for_each(make_counting_iterator(0),
+                      make_counting_iterator(nentities),
+                      [&](int e) { get_neighbors(e, &(lists[e])); });
+
+    offsets_.assign(nentities + 1, 0);
+    for (int e = 0; e < nentities; e++)
+      offsets_[e+1] = offsets_[e] + lists[e].size();
+
+    neighbors_.resize(offsets_[nentities]);
+    Portage::for_each(make_counting_iterator(0),
+                      make_counting_iterator(nentities),
+                      [&](int e) {
+                        std::copy(lists[e].begin(), lists[e].end(),
+                                  neighbors_.begin() + offsets_[e]);
+                      });
+  }
+
+  /// Number of entities
+  int num_entities() const { return offsets_.size() - 1; }
+
+  /// Number of neighbors of an entity
+  int num_neighbors(int e) const { return offsets_[e+1] - offsets_[e]; }
+
+  /// Neighbors of an entity
+  Neighbors operator[](int e) const {
+    return {neighbors_.data() + offsets_[e], neighbors_.data() + offsets_[e+1]};
+  }
+
+  /// Start of each entity's list in neighbors(), plus the total size
+  std::vector<int> const& offsets() const { return offsets_; }
+
+  /// Concatenated neighbor lists
+  std::vector<int> const& neighbors() const { return neighbors_; }
+
+ private:
+  std::vector<int> offsets_;
+  std::vector<int> neighbors_;
+};
+
+
+/*!
+  @brief Build the neighbor lists used by gradient and quadfit
+  reconstructions
+
+  @param[in] mesh  Mesh wrapper
+  @param[in] kind  CELL (cells sharing a node with the cell) or NODE
+                   (nodes whose dual cells are adjacent to the dual cell)
+  @returns   Shared read-only adjacency, or nullptr for other entity kinds
+*/
+template <class MeshType>
+std::shared_ptr<MeshAdjacency const>
+make_mesh_adjacency(MeshType const& mesh, Entity_kind kind) {
+  switch (kind) {
+    case Entity_kind::CELL:
+      return std::make_shared<MeshAdjacency const>(
+          mesh.num_entities(Entity_kind::CELL, Entity_type::ALL),
+          [&mesh](int c, std::vector<int> *nbrs) {
+            mesh.cell_get_node_adj_cells(c, Entity_type::ALL, nbrs);
+          });
+    case Entity_kind::NODE:
+      return std::make_shared<MeshAdjacency const>(
+          mesh.num_entities(Entity_kind::NODE, Entity_type::ALL),
+          [&mesh](int n, std::vector<int> *nbrs) {
+            mesh.dual_cell_get_node_adj_cells(n, Entity_type::ALL, nbrs);
+          });
+    default:
+      return nullptr;
+  }
+}
+
+}  // namespace Portage
+
+#endif  // PORTAGE_SUPPORT_MESH_ADJACENCY_H_
@@ -0,0 +1,307 @@
+/*
+This file is part of the Ristra portage project.
+Please see the license file at the root of this repository, or at:
+    https://github.com/laristra/portage/blob/master/LICENSE
+*/
+
+#ifndef PORTAGE_SUPPORT_SCHEDULER_H_
+#define PORTAGE_SUPPORT_SCHEDULER_H_
+
+#include <vector>
+#include <numeric>
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <utility>
+#include <chrono>
+#include <thread>
+#include <cstdio>
+
+#if defined(PORTAGE_ENABLE_THRUST) && defined(_OPENMP)
+#include <omp.h>
+#endif
+
+#include "portage/support/portage.h"
+
+/*!
+  @file scheduler.h
+  @brief Cost-aware scheduling of irregular per-entity work.
+
+  Portage::transform hands out entities to threads in fixed blocks,
+  which is fine when every entity costs about the same. Some steps
+  (intersection of target cells near material interfaces, or of large
+  target cells with many candidates) have per-entity costs that vary by
+  orders of magnitude. For those, balanced_transform sorts the work
+  from most to least expensive using a user-supplied cost estimate and
+  deals it into chunks of about equal cost, which are then run with
+  Portage::for_each on whatever backend Thrust is configured with;
+  when the estimates show no expensive outliers the chunks are simply
+  equal blocks of entities.
+
+  run_tasks does the same for coarser, independent tasks (e.g. the
+  materials of a multi-material remap) that each have their own inner
+  loops: large tasks run one after the other with parallel inner loops,
+  small ones run concurrently with serial inner loops.
+ */
+
+namespace Portage {
+
+/*!
+  @struct ScheduleStats_t
+  @brief Busy time and task counts per chunk of a scheduled transform
+
+  The backend decides which thread runs which chunk, so times are
+  recorded per chunk; chunks hold about the same estimated cost, so
+  their spread shows how good the estimate was.
+*/
+struct ScheduleStats_t {
+  std::vector<double> busy;   // seconds spent inside the functor per chunk
+  std::vector<int> ntasks;    // number of tasks executed per chunk
+  int nthreads = 1;           // number of threads the chunks ran on
+  double wall = 0.0;          // elapsed time of the whole transform
+
+  /// Mean fraction of the wall time that the threads spent doing work
+  double utilization() const {
+    if (busy.empty() || wall <= 0.0) return 1.0;
+    double total = std::accumulate(busy.begin(), busy.end(), 0.0);
+    return std::min(1.0, total/(wall*nthreads));
+  }
+
+  /// Add the times and task counts of another scheduled transform
+  void add(ScheduleStats_t const& other) {
+    if (busy.size() < other.busy.size()) {
+      busy.resize(other.busy.size(), 0.0);
+      ntasks.resize(other.ntasks.size(), 0);
+    }
+    for (size_t c = 0; c < other.busy.size(); c++) {
+      busy[c] += other.busy[c];
+      ntasks[c] += other.ntasks[c];
+    }
+    nthreads = std::max(nthreads, other.nthreads);
+    wall += other.wall;
+  }
+
+  /// Print a per-chunk summary to stdout
+  void print(char const *label) const {
+    std::printf("%s: %d threads, %zu chunks, %.3f s, utilization %.1f %%\n",
+                label, nthreads, busy.size(), wall, 100.0*utilization());
+    for (size_t c = 0; c < busy.size(); c++)
+      std::printf("  chunk %3zu: %8d tasks, busy %.3f s (%.1f %%)\n",
+                  c, ntasks[c], busy[c],
+                  wall > 0.0 ? 100.0*busy[c]/wall : 100.0);
+  }
+};
+
+
+/// Number of threads the Portage::for_each backend runs on (1 without
+/// Thrust, since the std backend is serial)
+inline int scheduler_threads() {
+#if defined(PORTAGE_ENABLE_THRUST) && defined(_OPENMP)
+  return omp_get_max_threads();
+#elif defined(PORTAGE_ENABLE_THRUST)
+  return std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+#else
+  return 1;
+#endif
+}
+
+
+/*!
+  @brief Deal tasks into chunks of about equal total cost
+
+  Tasks are taken from most to least expensive and each goes to the
+  chunk with the smallest cost so far (longest processing time first),
+  so that no chunk ends up with a tail of expensive tasks.
+
+  @param[in] costs    Estimated cost of each task
+  @param[in] tasks    Tasks to deal, sorted by decreasing cost
+  @param[in] nchunks  Number of chunks
+
+  @returns  Tasks of each chunk, in decreasing cost order
+*/
+inline std::vector<std::vector<int>>
+deal_by_cost(std::vector<double> const& costs, std::vector<int> const& tasks,
+             int nchunks) {
+  std::vector<std::vector<int>> chunks(nchunks);
+  using load_t = std::pair<double, int>;  // (cost so far, chunk)
+  std::priority_queue<load_t, std::vector<load_t>,
+                      std::greater<load_t>> loads;
+  for (int c = 0; c < nchunks; c++)
+    loads.emplace(0.0, c);
+  for (int const i : tasks) {
+    load_t least = loads.top();
+    loads.pop();
+    chunks[least.second].push_back(i);
+    least.first += costs[i];
+    loads.push(least);
+  }
+  return chunks;
+}
+
+
+/*!
+  @brief Transform a range with cost-ordered scheduling
+
+  Computes result[i] = op(first1[i], first2[i]) for every i in
+  [0, last1-first1), like the binary Portage::transform. The task costs
+  cost(first1[i], first2[i]) are estimated first (in parallel). If no
+  task costs much more than the average, the tasks are split in equal
+  blocks, one per thread, as Portage::transform would. Otherwise they
+  are sorted by decreasing cost and dealt into a few chunks per thread
+  of about equal total cost, so that a few very expensive entities do
+  not end up serialized at the tail of one thread's block. The chunks
+  run through Portage::for_each.
+
+  @param[in]  first1, last1  Random access range of entities
+  @param[in]  first2         Random access iterator to per-entity data
+  @param[out] result         Random access iterator to the output
+  @param[in]  op             Binary functor to apply
+  @param[in]  cost           Binary functor estimating the cost of a
+                             task from its entity and per-entity data
+  @param[out] stats          Optional per-chunk utilization report
+*/
+template<typename InputIterator1, typename InputIterator2,
+         typename OutputIterator, typename BinaryFunction,
+         typename CostFunction>
+void balanced_transform(InputIterator1 first1, InputIterator1 last1,
+                        InputIterator2 first2, OutputIterator result,
+                        BinaryFunction op, CostFunction cost,
+                        ScheduleStats_t *stats = nullptr) {
+
+  using clock = std::chrono::steady_clock;
+  auto seconds = [](clock::time_point a, clock::time_point b) {
+    return std::chrono::duration<double>(b - a).count();
+  };
+
+  int const n = static_cast<int>(last1 - first1);
+  int const nthreads = scheduler_threads();
+  auto const start = clock::now();
+
+  std::vector<std::vector<int>> chunks;
+
+  if (nthreads == 1 || n <= nthreads) {
+    // nothing to balance
+    Portage::transform(first1, last1, first2, result, op);
+    if (stats) {
+      stats->busy.assign(1, seconds(start, clock::now()));
+      stats->ntasks.assign(1, n);
+      stats->nthreads = nthreads;
+      stats->wall = stats->busy[0];
+    }
+    return;
+  }
+
+  std::vector<double> costs(n);
+  Portage::for_each(make_counting_iterator(0), make_counting_iterator(n),
+                    [&](int i) { costs[i] = cost(first1[i], first2[i]); });
+  double const total = std::accumulate(costs.begin(), costs.end(), 0.0);
+  double const maxcost = *std::max_element(costs.begin(), costs.end());
+
+  // Tasks at most twice as expensive as the average cannot unbalance
+  // equal blocks by much, so skip the sort
+  bool const uniform = (maxcost*n <= 2.0*total);
+
+  if (uniform) {
+    chunks.resize(nthreads);
+    for (int c = 0; c < nthreads; c++) {
+      int const begin = static_cast<int>((static_cast<long>(n)*c)/nthreads);
+      int const end = static_cast<int>((static_cast<long>(n)*(c+1))/nthreads);
+      chunks[c].resize(end - begin);
+      std::iota(chunks[c].begin(), chunks[c].end(), begin);
+    }
+  } else {
+    // order tasks from most to least expensive
+    std::vector<int> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(),
+                     [&](int a, int b) { return costs[a] > costs[b]; });
+
+    // a few chunks per thread let a backend that hands out work
+    // dynamically make up for errors in the cost estimates
+    chunks = deal_by_cost(costs, order, std::min(n, 4*nthreads));
+  }
+
+  int const nchunks = chunks.size();
+  std::vector<double> busy(nchunks, 0.0);
+  std::vector<int> ntasks(nchunks, 0);
+
+  Portage::for_each(make_counting_iterator(0),
+                    make_counting_iterator(nchunks),
+                    [&](int c) {
+                      auto const tic = clock::now();
+                      for (int const i : chunks[c])
+                        result[i] = op(first1[i], first2[i]);
+                      busy[c] = seconds(tic, clock::now());
+                      ntasks[c] = chunks[c].size();
+                    });
+
+  if (stats) {
+    stats->busy = busy;
+    stats->ntasks = ntasks;
+    stats->nthreads = nthreads;
+    stats->wall = seconds(start, clock::now());
+  }
+}
+
+
+/*!
+  @brief Run independent tasks of uneven size concurrently
+
+  Calls task(i, inner_parallel) once for every i in [0, ntasks), in
+  order of decreasing cost(i). The most expensive task, and any other
+  task worth at least a 1/nthreads share of the total cost, runs on its
+  own with inner_parallel set, so that it can use parallel loops over
+  its own entities. The remaining tasks are then dealt into one chunk
+  per thread of about equal cost and the chunks run concurrently
+  through Portage::for_each, with inner_parallel unset; these tasks
+  must loop serially and must not modify anything shared.
+
+  Since the most expensive task always completes before the concurrent
+  ones start, it is a safe place to set up data that the other tasks
+  then only read.
+
+  @param[in] ntasks  Number of tasks
+  @param[in] task    Functor (int, bool) running a task
+  @param[in] cost    Functor (int) estimating the cost of a task
+*/
+template<typename TaskFunction, typename CostFunction>
+void run_tasks(int ntasks, TaskFunction task, CostFunction cost) {
+
+  int const nthreads = scheduler_threads();
+
+  std::vector<double> costs(ntasks);
+  for (int i = 0; i < ntasks; i++)
+    costs[i] = cost(i);
+  double const total = std::accumulate(costs.begin(), costs.end(), 0.0);
+
+  std::vector<int> order(ntasks);
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(),
+                   [&](int a, int b) { return costs[a] > costs[b]; });
+
+  // large tasks, each with the whole thread team
+  int nlarge = 0;
+  while (nlarge < ntasks &&
+         (nlarge == 0 || nthreads == 1 ||
+          costs[order[nlarge]]*nthreads >= total))
+    task(order[nlarge++], true);
+
+  if (nlarge == ntasks)
+    return;
+
+  // small tasks, concurrently
+  std::vector<int> const small(order.begin() + nlarge, order.end());
+  auto const chunks =
+      deal_by_cost(costs, small,
+                   std::min(nthreads, static_cast<int>(small.size())));
+  Portage::for_each(make_counting_iterator(0),
+                    make_counting_iterator(chunks.size()),
+                    [&](int c) {
+                      for (int const i : chunks[c])
+                        task(i, false);
+                    });
+}
+
+}  // namespace Portage
+
+#endif  // PORTAGE_SUPPORT_SCHEDULER_H_
@@ -0,0 +1,62 @@
+/*
+This file is part of the Ristra portage project.
+Please see the license file at the root of this repository, or at:
+    https://github.com/laristra/portage/blob/master/LICENSE
+*/
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "portage/support/mesh_adjacency.h"
+
+#include "wonton/mesh/simple/simple_mesh.h"
+#include "wonton/mesh/simple/simple_mesh_wrapper.h"
+
+// The compressed lists hold the same neighbors as the vector of
+// vectors they are gathered from
+TEST(MeshAdjacency, Gather) {
+  int const n = 10;
+
+  // entity i has i neighbors 0, 1, ... i-1
+  auto get_neighbors = [](int i, std::vector<int> *nbrs) {
+    nbrs->resize(i);
+    for (int j = 0; j < i; j++)
+      (*nbrs)[j] = j;
+  };
+
+  Portage::MeshAdjacency adjacency(n, get_neighbors);
+
+  ASSERT_EQ(adjacency.num_entities(), n);
+  ASSERT_EQ(adjacency.neighbors().size(), n*(n-1)/2);
+  for (int i = 0; i < n; i++) {
+    ASSERT_EQ(adjacency.num_neighbors(i), i);
+    Portage::MeshAdjacency::Neighbors const nbrs = adjacency[i];
+    ASSERT_EQ(nbrs.size(), i);
+    int j = 0;
+    for (int nbr : nbrs)
+      ASSERT_EQ(nbr, j++);
+  }
+
+  Portage::MeshAdjacency empty;
+  ASSERT_EQ(empty.num_entities(), 0);
+}
+
+// Cell adjacency of a mesh matches what the mesh wrapper returns
+TEST(MeshAdjacency, MeshCells) {
+  Wonton::Simple_Mesh mesh(0.0, 0.0, 1.0, 1.0, 4, 3);
+  Wonton::Simple_Mesh_Wrapper mesh_wrapper(mesh);
+
+  auto adjacency = Portage::make_mesh_adjacency(mesh_wrapper,
+                                                Wonton::Entity_kind::CELL);
+
+  int const ncells = mesh_wrapper.num_entities(Wonton::Entity_kind::CELL,
+                                               Wonton::Entity_type::ALL);
+  ASSERT_EQ(adjacency->num_entities(), ncells);
+  for (int c = 0; c < ncells; c++) {
+    std::vector<int> expected;
+    mesh_wrapper.cell_get_node_adj_cells(c, Wonton::Entity_type::ALL, &expected);
+    Portage::MeshAdjacency::Neighbors const nbrs = (*adjacency)[c];
+    ASSERT_EQ(std::vector<int>(nbrs.begin(), nbrs.end()), expected);
+  }
+}
@@ -0,0 +1,140 @@
+/*
+This file is part of the Ristra portage project.
+Please see the license file at the root of this repository, or at:
+    https://github.com/laristra/portage/blob/master/LICENSE
+*/
+
+#include <vector>
+#include <numeric>
+#include <algorithm>
+
+#include "gtest/gtest.h"
+
+#include "portage/support/scheduler.h"
+
+// Check that the scheduled transform gives the same result as a plain
+// transform regardless of the order in which tasks are executed
+TEST(Scheduler, BalancedTransform) {
+  int const n = 1000;
+
+  std::vector<int> entities(n);
+  std::iota(entities.begin(), entities.end(), 0);
+
+  // very uneven amount of work per entity
+  std::vector<std::vector<int>> work(n);
+  for (int i = 0; i < n; i++)
+    work[i].assign((i % 17 == 0) ? 500 : 1, i);
+
+  auto op = [](int i, std::vector<int> const& w) {
+    return i + std::accumulate(w.begin(), w.end(), 0);
+  };
+  auto cost = [](int, std::vector<int> const& w) {
+    return static_cast<double>(w.size());
+  };
+
+  std::vector<int> result(n, -1);
+  Portage::ScheduleStats_t stats;
+  Portage::balanced_transform(entities.begin(), entities.end(), work.begin(),
+                              result.begin(), op, cost, &stats);
+
+  for (int i = 0; i < n; i++)
+    ASSERT_EQ(op(i, work[i]), result[i]);
+
+  ASSERT_FALSE(stats.ntasks.empty());
+  ASSERT_EQ(stats.busy.size(), stats.ntasks.size());
+  ASSERT_EQ(n, std::accumulate(stats.ntasks.begin(), stats.ntasks.end(), 0));
+  ASSERT_GE(stats.wall, 0.0);
+}
+
+// Tasks of about the same cost take the static path and still give
+// the same result; the stats of several transforms add up
+TEST(Scheduler, UniformCosts) {
+  int const n = 1000;
+
+  std::vector<int> entities(n), work(n);
+  std::iota(entities.begin(), entities.end(), 0);
+  for (int i = 0; i < n; i++)
+    work[i] = 3 + i % 2;
+
+  auto op = [](int i, int w) { return i*w; };
+  auto cost = [](int, int w) { return static_cast<double>(w); };
+
+  std::vector<int> result(n, -1);
+  Portage::ScheduleStats_t stats, total;
+  for (int pass = 0; pass < 2; pass++) {
+    Portage::balanced_transform(entities.begin(), entities.end(),
+                                work.begin(), result.begin(), op, cost,
+                                &stats);
+    total.add(stats);
+  }
+
+  for (int i = 0; i < n; i++)
+    ASSERT_EQ(op(i, work[i]), result[i]);
+
+  ASSERT_EQ(stats.busy.size(), total.busy.size());
+  ASSERT_EQ(2*n, std::accumulate(total.ntasks.begin(), total.ntasks.end(), 0));
+  ASSERT_GE(total.wall, stats.wall);
+}
+
+// Every task runs exactly once, and the most expensive one runs first
+// with parallel inner loops allowed
+TEST(Scheduler, RunTasks) {
+  int const ntasks = 50;
+
+  std::vector<double> costs(ntasks);
+  for (int i = 0; i < ntasks; i++)
+    costs[i] = (i == 7) ? 1000.0 : 1.0 + i;
+
+  std::vector<int> count(ntasks, 0);
+  std::vector<char> parallel(ntasks, 0);
+  int first = -1;
+
+  Portage::run_tasks(ntasks,
+                     [&](int i, bool inner_parallel) {
+                       if (inner_parallel && first < 0) first = i;
+                       count[i]++;
+                       parallel[i] = inner_parallel;
+                     },
+                     [&](int i) { return costs[i]; });
+
+  for (int i = 0; i < ntasks; i++)
+    ASSERT_EQ(1, count[i]);
+  ASSERT_EQ(7, first);
+  ASSERT_TRUE(parallel[7]);
+}
+
+// Chunks dealt from tasks sorted by decreasing cost hold every task
+// once and differ in total cost by at most the cost of one task
+TEST(Scheduler, DealByCost) {
+  int const ntasks = 200;
+  int const nchunks = 8;
+
+  std::vector<double> costs(ntasks);
+  for (int i = 0; i < ntasks; i++)
+    costs[i] = (i % 23 == 0) ? 100.0 : 1.0 + i % 5;
+
+  std::vector<int> order(ntasks);
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(),
+                   [&](int a, int b) { return costs[a] > costs[b]; });
+
+  auto chunks = Portage::deal_by_cost(costs, order, nchunks);
+  ASSERT_EQ(nchunks, static_cast<int>(chunks.size()));
+
+  std::vector<int> count(ntasks, 0);
+  std::vector<double> loads;
+  for (auto const& chunk : chunks) {
+    double load = 0.0;
+    for (int i : chunk) {
+      count[i]++;
+      load += costs[i];
+    }
+    loads.push_back(load);
+  }
+  for (int i = 0; i < ntasks; i++)
+    ASSERT_EQ(1, count[i]);
+
+  double const maxcost = *std::max_element(costs.begin(), costs.end());
+  auto minmax = std::minmax_element(loads.begin(), loads.end());
+  ASSERT_LE(*minmax.second - *minmax.first, maxcost);
+}